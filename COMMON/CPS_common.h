@@ -25,6 +25,7 @@
 /* Defines */
 
 /* Communication Definitions */
+//Single byte commands of the first link version. The link now carries CPS_frame.h frames.
 #define CPS_COMMON_SCI_SHIFTUP      0xAAu
 #define CPS_COMMON_SCI_SHIFTDN      0xBFu
 #define CPS_COMMON_SCI_HORNON       0xFu
@@ -0,0 +1,510 @@
+/** @file CPS_frame.c
+*   @brief Framed binary protocol of the CPS/SCT link
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   The CRC runs a byte at a time from a 256 entry table, so the parser does a fixed amount of work per received byte
+*   and can be fed straight from the receive ring. The parser keeps no more than one frame and never backtracks: a
+*   bad LEN or CRC drops it back to hunting for SOF from the next byte on. A SOF inside the payload of a corrupted
+*   frame is therefore missed and the frame after it is lost as well; the SEQ gap shows it.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_frame.h"
+#if CPS_FRAME_BENCHMARK
+#include "sys_pmu.h"
+#endif
+
+/* Defines */
+#define FRAME_CRC_INIT 0xFFFFu
+#define FRAME_HEADER 4u //SOF, LEN, SEQ, TYPE
+#define FRAME_OFFSET_MAX 0xFFFFu //Largest record offset, 6.5ms in RTI counts
+#define FRAME_VARINT_MORE 0x80u //Set on every token byte but the last
+#define FRAME_TOKEN_RUN 1u //Token value bit 0: repeat count instead of a delta
+
+#define PARSE_HUNT 0u
+#define PARSE_LEN 1u
+#define PARSE_SEQ 2u
+#define PARSE_TYPE 3u
+#define PARSE_PAYLOAD 4u
+#define PARSE_CRCHI 5u
+#define PARSE_CRCLO 6u
+
+/* Global Vars */
+#if CPS_FRAME_BENCHMARK
+xCPSFrameBench_t CPS_xFrameBench;
+#endif
+
+/* Internal Vars */
+static uint8_t u8FrameSeq; //SEQ of the next frame this processor sends
+static const uint16_t au16CrcTable[256u] =
+{
+  0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+  0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu,
+  0x1231u, 0x0210u, 0x3273u, 0x2252u, 0x52B5u, 0x4294u, 0x72F7u, 0x62D6u,
+  0x9339u, 0x8318u, 0xB37Bu, 0xA35Au, 0xD3BDu, 0xC39Cu, 0xF3FFu, 0xE3DEu,
+  0x2462u, 0x3443u, 0x0420u, 0x1401u, 0x64E6u, 0x74C7u, 0x44A4u, 0x5485u,
+  0xA56Au, 0xB54Bu, 0x8528u, 0x9509u, 0xE5EEu, 0xF5CFu, 0xC5ACu, 0xD58Du,
+  0x3653u, 0x2672u, 0x1611u, 0x0630u, 0x76D7u, 0x66F6u, 0x5695u, 0x46B4u,
+  0xB75Bu, 0xA77Au, 0x9719u, 0x8738u, 0xF7DFu, 0xE7FEu, 0xD79Du, 0xC7BCu,
+  0x48C4u, 0x58E5u, 0x6886u, 0x78A7u, 0x0840u, 0x1861u, 0x2802u, 0x3823u,
+  0xC9CCu, 0xD9EDu, 0xE98Eu, 0xF9AFu, 0x8948u, 0x9969u, 0xA90Au, 0xB92Bu,
+  0x5AF5u, 0x4AD4u, 0x7AB7u, 0x6A96u, 0x1A71u, 0x0A50u, 0x3A33u, 0x2A12u,
+  0xDBFDu, 0xCBDCu, 0xFBBFu, 0xEB9Eu, 0x9B79u, 0x8B58u, 0xBB3Bu, 0xAB1Au,
+  0x6CA6u, 0x7C87u, 0x4CE4u, 0x5CC5u, 0x2C22u, 0x3C03u, 0x0C60u, 0x1C41u,
+  0xEDAEu, 0xFD8Fu, 0xCDECu, 0xDDCDu, 0xAD2Au, 0xBD0Bu, 0x8D68u, 0x9D49u,
+  0x7E97u, 0x6EB6u, 0x5ED5u, 0x4EF4u, 0x3E13u, 0x2E32u, 0x1E51u, 0x0E70u,
+  0xFF9Fu, 0xEFBEu, 0xDFDDu, 0xCFFCu, 0xBF1Bu, 0xAF3Au, 0x9F59u, 0x8F78u,
+  0x9188u, 0x81A9u, 0xB1CAu, 0xA1EBu, 0xD10Cu, 0xC12Du, 0xF14Eu, 0xE16Fu,
+  0x1080u, 0x00A1u, 0x30C2u, 0x20E3u, 0x5004u, 0x4025u, 0x7046u, 0x6067u,
+  0x83B9u, 0x9398u, 0xA3FBu, 0xB3DAu, 0xC33Du, 0xD31Cu, 0xE37Fu, 0xF35Eu,
+  0x02B1u, 0x1290u, 0x22F3u, 0x32D2u, 0x4235u, 0x5214u, 0x6277u, 0x7256u,
+  0xB5EAu, 0xA5CBu, 0x95A8u, 0x8589u, 0xF56Eu, 0xE54Fu, 0xD52Cu, 0xC50Du,
+  0x34E2u, 0x24C3u, 0x14A0u, 0x0481u, 0x7466u, 0x6447u, 0x5424u, 0x4405u,
+  0xA7DBu, 0xB7FAu, 0x8799u, 0x97B8u, 0xE75Fu, 0xF77Eu, 0xC71Du, 0xD73Cu,
+  0x26D3u, 0x36F2u, 0x0691u, 0x16B0u, 0x6657u, 0x7676u, 0x4615u, 0x5634u,
+  0xD94Cu, 0xC96Du, 0xF90Eu, 0xE92Fu, 0x99C8u, 0x89E9u, 0xB98Au, 0xA9ABu,
+  0x5844u, 0x4865u, 0x7806u, 0x6827u, 0x18C0u, 0x08E1u, 0x3882u, 0x28A3u,
+  0xCB7Du, 0xDB5Cu, 0xEB3Fu, 0xFB1Eu, 0x8BF9u, 0x9BD8u, 0xABBBu, 0xBB9Au,
+  0x4A75u, 0x5A54u, 0x6A37u, 0x7A16u, 0x0AF1u, 0x1AD0u, 0x2AB3u, 0x3A92u,
+  0xFD2Eu, 0xED0Fu, 0xDD6Cu, 0xCD4Du, 0xBDAAu, 0xAD8Bu, 0x9DE8u, 0x8DC9u,
+  0x7C26u, 0x6C07u, 0x5C64u, 0x4C45u, 0x3CA2u, 0x2C83u, 0x1CE0u, 0x0CC1u,
+  0xEF1Fu, 0xFF3Eu, 0xCF5Du, 0xDF7Cu, 0xAF9Bu, 0xBFBAu, 0x8FD9u, 0x9FF8u,
+  0x6E17u, 0x7E36u, 0x4E55u, 0x5E74u, 0x2E93u, 0x3EB2u, 0x0ED1u, 0x1EF0u
+};
+#if CPS_FRAME_BENCHMARK
+static const uint32_t au32FrameBauds[CPS_FRAME_BAUDS] = {9600u, 19200u, 57600u, 115200u}; //sciSetBaudrate values
+#endif
+
+/* Local Function Prototypes */
+static uint32_t u32FrameSeal(uint8_t *pu8Frame, uint8_t u8Seq, xCPSFrameType_t xType, uint32_t u32Length);
+static uint32_t u32VarintBytes(uint32_t u32Value);
+static void vSamplesToken(xCPSFrameSamples_t *pxSamples, uint32_t u32Value);
+
+/* Global Functions */
+
+/* uint16_t CPS_u16FrameCrc(uint16_t u16Crc, const uint8_t *pu8Data, uint32_t u32Length)
+*   Continues a CRC-16/CCITT-FALSE over u32Length bytes. Start a new one with 0xFFFF.
+*
+*/
+uint16_t CPS_u16FrameCrc(uint16_t u16Crc, const uint8_t *pu8Data, uint32_t u32Length)
+{
+  uint32_t u32Byte;
+  for(u32Byte = 0u; u32Byte < u32Length; u32Byte++)
+  {
+    u16Crc = (uint16_t)(u16Crc << 8u) ^ au16CrcTable[((u16Crc >> 8u) ^ pu8Data[u32Byte]) & 0xFFu];
+  }
+  return(u16Crc);
+}
+
+/* uint32_t CPS_u32FrameEncode(uint8_t *pu8Frame, uint8_t u8Seq, xCPSFrameType_t xType, const uint8_t *pu8Payload,
+*                              uint32_t u32Length)
+*   Builds a frame around u32Length payload bytes in pu8Frame, which must hold CPS_FRAME_MAX bytes. Returns the
+*   frame length, 0 when the payload is too long.
+*
+*/
+uint32_t CPS_u32FrameEncode(uint8_t *pu8Frame, uint8_t u8Seq, xCPSFrameType_t xType, const uint8_t *pu8Payload,
+                            uint32_t u32Length)
+{
+  uint32_t u32Byte;
+  if(u32Length > CPS_FRAME_PAYLOAD_MAX)
+  {
+    return(0u);
+  }
+  for(u32Byte = 0u; u32Byte < u32Length; u32Byte++)
+  {
+    pu8Frame[FRAME_HEADER + u32Byte] = pu8Payload[u32Byte];
+  }
+  return(u32FrameSeal(pu8Frame, u8Seq, xType, u32Length));
+}
+
+/* void CPS_vFrameBatchStart(xCPSFrameBatch_t *pxBatch)
+*   Empties an event batch.
+*
+*/
+void CPS_vFrameBatchStart(xCPSFrameBatch_t *pxBatch)
+{
+  pxBatch->u32Records = 0u;
+}
+
+/* bool CPS_bFrameBatchAdd(xCPSFrameBatch_t *pxBatch, xCPSLinkEvent_t xEvent, uint8_t u8Data, uint32_t u32Stamp)
+*   Adds one event with its RTI FRC0 stamp to the batch. False when the batch is full or the event is too far from
+*   the first one to be offset from its stamp; end the batch and start a new one then.
+*
+*/
+bool CPS_bFrameBatchAdd(xCPSFrameBatch_t *pxBatch, xCPSLinkEvent_t xEvent, uint8_t u8Data, uint32_t u32Stamp)
+{
+  uint8_t *pu8Record;
+  uint32_t u32Offset;
+  if(pxBatch->u32Records == 0u)
+  {
+    pxBatch->u32Stamp = u32Stamp;
+  }
+  u32Offset = u32Stamp - pxBatch->u32Stamp;
+  if((pxBatch->u32Records >= CPS_FRAME_RECORDS_MAX) || (u32Offset > FRAME_OFFSET_MAX))
+  {
+    return(false);
+  }
+  pu8Record = &pxBatch->au8Frame[FRAME_HEADER + CPS_FRAME_STAMP_BYTES +
+                                 (pxBatch->u32Records*CPS_FRAME_RECORD_BYTES)];
+  pu8Record[0u] = (uint8_t)xEvent;
+  pu8Record[1u] = u8Data;
+  pu8Record[2u] = (uint8_t)u32Offset;
+  pu8Record[3u] = (uint8_t)(u32Offset >> 8u);
+  pxBatch->u32Records++;
+  return(true);
+}
+
+/* uint32_t CPS_u32FrameBatchEnd(xCPSFrameBatch_t *pxBatch, uint8_t u8Seq)
+*   Turns the batch into an event frame in pxBatch->au8Frame and returns its length, 0 for an empty batch. The batch
+*   has to be started again before the next event is added.
+*
+*/
+uint32_t CPS_u32FrameBatchEnd(xCPSFrameBatch_t *pxBatch, uint8_t u8Seq)
+{
+  uint8_t *pu8Stamp = &pxBatch->au8Frame[FRAME_HEADER];
+  if(pxBatch->u32Records == 0u)
+  {
+    return(0u);
+  }
+  pu8Stamp[0u] = (uint8_t)pxBatch->u32Stamp;
+  pu8Stamp[1u] = (uint8_t)(pxBatch->u32Stamp >> 8u);
+  pu8Stamp[2u] = (uint8_t)(pxBatch->u32Stamp >> 16u);
+  pu8Stamp[3u] = (uint8_t)(pxBatch->u32Stamp >> 24u);
+  return(u32FrameSeal(pxBatch->au8Frame, u8Seq, eFRAME_Events,
+                      CPS_FRAME_STAMP_BYTES + (pxBatch->u32Records*CPS_FRAME_RECORD_BYTES)));
+}
+
+/* void CPS_vFrameSamplesStart(xCPSFrameSamples_t *pxSamples, uint32_t u32Stamp, uint16_t u16Sample)
+*   Opens a samples frame with its first sample and the RTI FRC0 stamp of that sample.
+*
+*/
+void CPS_vFrameSamplesStart(xCPSFrameSamples_t *pxSamples, uint32_t u32Stamp, uint16_t u16Sample)
+{
+  uint8_t *pu8Header = &pxSamples->au8Frame[FRAME_HEADER];
+  pu8Header[0u] = (uint8_t)u32Stamp;
+  pu8Header[1u] = (uint8_t)(u32Stamp >> 8u);
+  pu8Header[2u] = (uint8_t)(u32Stamp >> 16u);
+  pu8Header[3u] = (uint8_t)(u32Stamp >> 24u);
+  pu8Header[4u] = (uint8_t)u16Sample;
+  pu8Header[5u] = (uint8_t)(u16Sample >> 8u);
+  pxSamples->u32Index = CPS_FRAME_SAMPLES_HEADER;
+  pxSamples->u32Samples = 1u;
+  pxSamples->u32Run = 0u;
+  pxSamples->u16Last = u16Sample;
+}
+
+/* bool CPS_bFrameSamplesAdd(xCPSFrameSamples_t *pxSamples, uint16_t u16Sample)
+*   Appends the next sample. False when its token would not fit; end the frame and start a new one with the sample
+*   then. Repeats are only counted here, the run token is written by the next change or the end of the frame, and
+*   room for it is kept at all times.
+*
+*/
+bool CPS_bFrameSamplesAdd(xCPSFrameSamples_t *pxSamples, uint16_t u16Sample)
+{
+  int32_t s32Delta = (int32_t)u16Sample - (int32_t)pxSamples->u16Last;
+  uint32_t u32Free = CPS_FRAME_PAYLOAD_MAX - pxSamples->u32Index;
+  uint32_t u32RunBytes = 0u;
+  uint32_t u32Token;
+  if(s32Delta == 0)
+  {
+    if(u32VarintBytes(((pxSamples->u32Run + 1u) << 1u) | FRAME_TOKEN_RUN) > u32Free)
+    {
+      return(false);
+    }
+    pxSamples->u32Run++;
+  }
+  else
+  {
+    u32Token = (s32Delta < 0) ? ((((uint32_t)-s32Delta) << 1u) - 1u) : ((uint32_t)s32Delta << 1u); //Zig-zag
+    u32Token <<= 1u;
+    if(pxSamples->u32Run != 0u)
+    {
+      u32RunBytes = u32VarintBytes((pxSamples->u32Run << 1u) | FRAME_TOKEN_RUN);
+    }
+    if((u32RunBytes + u32VarintBytes(u32Token)) > u32Free)
+    {
+      return(false);
+    }
+    if(pxSamples->u32Run != 0u)
+    {
+      vSamplesToken(pxSamples, (pxSamples->u32Run << 1u) | FRAME_TOKEN_RUN);
+      pxSamples->u32Run = 0u;
+    }
+    vSamplesToken(pxSamples, u32Token);
+    pxSamples->u16Last = u16Sample;
+  }
+  pxSamples->u32Samples++;
+  return(true);
+}
+
+/* uint32_t CPS_u32FrameSamplesEnd(xCPSFrameSamples_t *pxSamples, uint8_t u8Seq)
+*   Writes the pending run and turns the samples into a frame in pxSamples->au8Frame. Returns its length. The frame
+*   has to be started again before the next sample is added.
+*
+*/
+uint32_t CPS_u32FrameSamplesEnd(xCPSFrameSamples_t *pxSamples, uint8_t u8Seq)
+{
+  if(pxSamples->u32Run != 0u)
+  {
+    vSamplesToken(pxSamples, (pxSamples->u32Run << 1u) | FRAME_TOKEN_RUN);
+    pxSamples->u32Run = 0u;
+  }
+  return(u32FrameSeal(pxSamples->au8Frame, u8Seq, eFRAME_Samples, pxSamples->u32Index));
+}
+
+/* uint32_t CPS_u32FrameSamplesDecode(const uint8_t *pu8Payload, uint32_t u32Length, uint32_t *pu32Stamp,
+*                                     uint16_t *pu16Samples, uint32_t u32Max)
+*   Rebuilds the samples of a samples frame payload into pu16Samples and returns how many there are. The stamp of
+*   the first one goes to pu32Stamp; the rest follow at the sender's sample period. Returns 0 for a payload that is
+*   cut short, steps outside 16 bits or holds more than u32Max samples.
+*
+*/
+uint32_t CPS_u32FrameSamplesDecode(const uint8_t *pu8Payload, uint32_t u32Length, uint32_t *pu32Stamp,
+                                   uint16_t *pu16Samples, uint32_t u32Max)
+{
+  uint32_t u32Index = CPS_FRAME_SAMPLES_HEADER;
+  uint32_t u32Count = 1u;
+  uint32_t u32Value;
+  uint32_t u32Shift;
+  int32_t s32Sample;
+  if((u32Length < CPS_FRAME_SAMPLES_HEADER) || (u32Max == 0u))
+  {
+    return(0u);
+  }
+  *pu32Stamp = (uint32_t)pu8Payload[0u] | ((uint32_t)pu8Payload[1u] << 8u) | ((uint32_t)pu8Payload[2u] << 16u) |
+               ((uint32_t)pu8Payload[3u] << 24u);
+  s32Sample = (int32_t)((uint32_t)pu8Payload[4u] | ((uint32_t)pu8Payload[5u] << 8u));
+  pu16Samples[0u] = (uint16_t)s32Sample;
+  while(u32Index < u32Length)
+  {
+    u32Value = 0u;
+    u32Shift = 0u;
+    do
+    {
+      if((u32Index >= u32Length) || (u32Shift > 28u))
+      {
+        return(0u);
+      }
+      u32Value |= (uint32_t)(pu8Payload[u32Index] & ~FRAME_VARINT_MORE) << u32Shift;
+      u32Shift += 7u;
+      u32Index++;
+    } while((pu8Payload[u32Index - 1u] & FRAME_VARINT_MORE) != 0u);
+    if((u32Value & FRAME_TOKEN_RUN) != 0u)
+    {
+      u32Value >>= 1u;
+      if(u32Value > (u32Max - u32Count))
+      {
+        return(0u);
+      }
+      for(; u32Value != 0u; u32Value--)
+      {
+        pu16Samples[u32Count] = (uint16_t)s32Sample;
+        u32Count++;
+      }
+    }
+    else
+    {
+      u32Value >>= 1u;
+      s32Sample += ((u32Value & 1u) != 0u) ? -(int32_t)((u32Value + 1u) >> 1u) : (int32_t)(u32Value >> 1u);
+      if((s32Sample < 0) || (s32Sample > 0xFFFF) || (u32Count >= u32Max))
+      {
+        return(0u);
+      }
+      pu16Samples[u32Count] = (uint16_t)s32Sample;
+      u32Count++;
+    }
+  }
+  return(u32Count);
+}
+
+/* uint8_t CPS_u8FrameSeq(void)
+*   Hands out the SEQ of the next frame this processor sends. Every frame type shares the one count, so the receiver
+*   sees a lost frame of any type as a gap. Call it from one interrupt level only.
+*
+*/
+uint8_t CPS_u8FrameSeq(void)
+{
+  uint8_t u8Seq = u8FrameSeq;
+  u8FrameSeq++;
+  return(u8Seq);
+}
+
+/* void CPS_vFrameParserReset(xCPSFrameParser_t *pxParser)
+*   Clears the parser state and its statistics.
+*
+*/
+void CPS_vFrameParserReset(xCPSFrameParser_t *pxParser)
+{
+  pxParser->u32State = PARSE_HUNT;
+  pxParser->bSeqValid = false;
+  pxParser->u32Frames = 0u;
+  pxParser->u32CrcErrors = 0u;
+  pxParser->u32LengthErrors = 0u;
+  pxParser->u32Skipped = 0u;
+  pxParser->u32SeqGaps = 0u;
+}
+
+/* bool CPS_bFrameParse(xCPSFrameParser_t *pxParser, uint8_t u8Byte)
+*   Feeds one received byte. Returns true when it completed an intact frame; u8Seq, u8Type, u8Length and au8Payload
+*   then hold it until the next byte is fed.
+*
+*/
+bool CPS_bFrameParse(xCPSFrameParser_t *pxParser, uint8_t u8Byte)
+{
+  switch(pxParser->u32State)
+  {
+  case PARSE_HUNT:
+    if(u8Byte == CPS_FRAME_SOF)
+    {
+      pxParser->u16Crc = FRAME_CRC_INIT;
+      pxParser->u32State = PARSE_LEN;
+    }
+    else
+    {
+      pxParser->u32Skipped++;
+    }
+    return(false);
+  case PARSE_LEN:
+    if(u8Byte > CPS_FRAME_PAYLOAD_MAX)
+    {
+      pxParser->u32LengthErrors++;
+      pxParser->u32State = PARSE_HUNT;
+      return(false);
+    }
+    pxParser->u8Length = u8Byte;
+    pxParser->u32Index = 0u;
+    pxParser->u32State = PARSE_SEQ;
+    break;
+  case PARSE_SEQ:
+    pxParser->u8Seq = u8Byte;
+    pxParser->u32State = PARSE_TYPE;
+    break;
+  case PARSE_TYPE:
+    pxParser->u8Type = u8Byte;
+    pxParser->u32State = (pxParser->u8Length != 0u) ? PARSE_PAYLOAD : PARSE_CRCHI;
+    break;
+  case PARSE_PAYLOAD:
+    pxParser->au8Payload[pxParser->u32Index] = u8Byte;
+    pxParser->u32Index++;
+    if(pxParser->u32Index >= pxParser->u8Length)
+    {
+      pxParser->u32State = PARSE_CRCHI;
+    }
+    break;
+  case PARSE_CRCHI:
+    pxParser->u16CrcRx = (uint16_t)((uint16_t)u8Byte << 8u);
+    pxParser->u32State = PARSE_CRCLO;
+    return(false);
+  default:
+    pxParser->u32State = PARSE_HUNT;
+    if((pxParser->u16CrcRx | u8Byte) != pxParser->u16Crc)
+    {
+      pxParser->u32CrcErrors++;
+      return(false);
+    }
+    if(pxParser->bSeqValid && (pxParser->u8Seq != pxParser->u8NextSeq))
+    {
+      pxParser->u32SeqGaps += (uint8_t)(pxParser->u8Seq - pxParser->u8NextSeq);
+    }
+    pxParser->u8NextSeq = (uint8_t)(pxParser->u8Seq + 1u);
+    pxParser->bSeqValid = true;
+    pxParser->u32Frames++;
+    return(true);
+  }
+  pxParser->u16Crc = (uint16_t)(pxParser->u16Crc << 8u) ^ au16CrcTable[((pxParser->u16Crc >> 8u) ^ u8Byte) & 0xFFu];
+  return(false);
+}
+
+#if CPS_FRAME_BENCHMARK
+/* void CPS_vFrameBenchmark(void)
+*   Times building and parsing a full event frame with the PMU and works out how many such frames, and events, the
+*   line carries per second at each baud of the table. The line figures are the wire limit; the measured costs show
+*   what is left of it once the CPU side is added. Needs the PMU cycle counter running.
+*
+*/
+void CPS_vFrameBenchmark(void)
+{
+  static xCPSFrameBatch_t xBatch;
+  static xCPSFrameParser_t xParser;
+  uint32_t u32StartCycles;
+  uint32_t u32Length;
+  uint32_t u32Byte;
+  uint32_t u32Baud;
+  u32StartCycles = _pmuGetCycleCount_();
+  CPS_vFrameBatchStart(&xBatch);
+  while(CPS_bFrameBatchAdd(&xBatch, eLINK_HornOn, (uint8_t)xBatch.u32Records, 1000u*xBatch.u32Records))
+  {
+    //Fill the batch
+  }
+  u32Length = CPS_u32FrameBatchEnd(&xBatch, 0u);
+  CPS_xFrameBench.u32EncodeCycles = _pmuGetCycleCount_() - u32StartCycles;
+  CPS_vFrameParserReset(&xParser);
+  u32StartCycles = _pmuGetCycleCount_();
+  for(u32Byte = 0u; u32Byte < u32Length; u32Byte++)
+  {
+    (void)CPS_bFrameParse(&xParser, xBatch.au8Frame[u32Byte]);
+  }
+  CPS_xFrameBench.u32ParseCycles = _pmuGetCycleCount_() - u32StartCycles;
+  CPS_xFrameBench.u32FrameBytes = u32Length;
+  for(u32Baud = 0u; u32Baud < CPS_FRAME_BAUDS; u32Baud++)
+  {
+    CPS_xFrameBench.au32Baud[u32Baud] = au32FrameBauds[u32Baud];
+    CPS_xFrameBench.au32FramesPerSecond[u32Baud] = au32FrameBauds[u32Baud]/(u32Length*CPS_FRAME_BITS_PER_BYTE);
+    CPS_xFrameBench.au32EventsPerSecond[u32Baud] = CPS_xFrameBench.au32FramesPerSecond[u32Baud]*xBatch.u32Records;
+  }
+}
+#endif
+
+/* Local Functions */
+
+/* uint32_t u32FrameSeal(uint8_t *pu8Frame, uint8_t u8Seq, xCPSFrameType_t xType, uint32_t u32Length)
+*   Writes the header and the CRC around a payload already in place. Returns the frame length.
+*
+*/
+static uint32_t u32FrameSeal(uint8_t *pu8Frame, uint8_t u8Seq, xCPSFrameType_t xType, uint32_t u32Length)
+{
+  uint16_t u16Crc;
+  pu8Frame[0u] = CPS_FRAME_SOF;
+  pu8Frame[1u] = (uint8_t)u32Length;
+  pu8Frame[2u] = u8Seq;
+  pu8Frame[3u] = (uint8_t)xType;
+  u16Crc = CPS_u16FrameCrc(FRAME_CRC_INIT, &pu8Frame[1u], u32Length + (FRAME_HEADER - 1u));
+  pu8Frame[FRAME_HEADER + u32Length] = (uint8_t)(u16Crc >> 8u);
+  pu8Frame[FRAME_HEADER + u32Length + 1u] = (uint8_t)u16Crc;
+  return(u32Length + CPS_FRAME_OVERHEAD);
+}
+
+/* uint32_t u32VarintBytes(uint32_t u32Value)
+*   Bytes a token of this value takes.
+*
+*/
+static uint32_t u32VarintBytes(uint32_t u32Value)
+{
+  uint32_t u32Bytes = 1u;
+  while(u32Value > 0x7Fu)
+  {
+    u32Value >>= 7u;
+    u32Bytes++;
+  }
+  return(u32Bytes);
+}
+
+/* void vSamplesToken(xCPSFrameSamples_t *pxSamples, uint32_t u32Value)
+*   Appends one token to the payload. The caller has checked it fits.
+*
+*/
+static void vSamplesToken(xCPSFrameSamples_t *pxSamples, uint32_t u32Value)
+{
+  uint8_t *pu8Payload = &pxSamples->au8Frame[FRAME_HEADER];
+  while(u32Value > 0x7Fu)
+  {
+    pu8Payload[pxSamples->u32Index] = (uint8_t)(u32Value | FRAME_VARINT_MORE);
+    pxSamples->u32Index++;
+    u32Value >>= 7u;
+  }
+  pu8Payload[pxSamples->u32Index] = (uint8_t)u32Value;
+  pxSamples->u32Index++;
+}
@@ -0,0 +1,145 @@
+/** @file CPS_frame.h
+*   @brief Framed binary protocol of the CPS/SCT link
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the frame encoder and the incremental parser shared by both processors. A frame is
+*
+*     SOF | LEN | SEQ | TYPE | LEN payload bytes | CRC16 (high byte first)
+*
+*   with the CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) taken over LEN to the end of the payload.
+*   Multi byte payload fields are little endian. SEQ counts frames per sender and lets the receiver spot lost frames
+*   and acknowledge the ones it got.
+*
+*   An event frame carries every event of one control cycle: the RTI FRC0 stamp of the first event (u32) and one
+*   record per event (type, data, u16 offset in RTI counts from the frame stamp). The CPS also sends one every
+*   CPS_FRAME_KEEPALIVE_MS, with a horn on record while the horn is on and no record otherwise. The SCT drops every
+*   output when a SEQ gap shows a lost frame or nothing arrives for CPS_FRAME_TIMEOUT_MS; the keepalive puts a held
+*   horn back on.
+*
+*   A samples frame carries a run of equally spaced 12 bit ADC samples: the RTI FRC0 stamp of the first sample (u32),
+*   the first sample (u16) and one varint token per change. A token is little endian, 7 bits per byte with the top
+*   bit set on all but the last byte. Bit 0 of its value selects the meaning: 0, the rest is the zig-zag coded delta
+*   to the next sample; 1, the rest counts the following samples that repeat the last one. A still signal therefore
+*   costs well under a byte per sample and a moving one at most two.
+*
+*   Nothing in here touches the hardware or allocates, so the same file builds into a host tool as the encoder and
+*   decoder for link captures. The benchmark is the only target specific part and is compiled out on a host.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_FRAME_H__
+#define __CPS_FRAME_H__
+
+/* Include Files */
+#include "hal_stdtypes.h"
+
+/* Defines */
+#define CPS_FRAME_SOF 0xA5u
+#define CPS_FRAME_PAYLOAD_MAX 32u
+#define CPS_FRAME_OVERHEAD 6u //SOF, LEN, SEQ, TYPE and the CRC
+#define CPS_FRAME_MAX (CPS_FRAME_PAYLOAD_MAX + CPS_FRAME_OVERHEAD)
+#define CPS_FRAME_STAMP_BYTES 4u //Event frame stamp
+#define CPS_FRAME_RECORD_BYTES 4u //Event record
+#define CPS_FRAME_RECORDS_MAX ((CPS_FRAME_PAYLOAD_MAX - CPS_FRAME_STAMP_BYTES)/CPS_FRAME_RECORD_BYTES)
+#define CPS_FRAME_SAMPLES_HEADER 6u //Samples frame stamp and first sample
+#define CPS_FRAME_TOKEN_MAX 2u //Bytes of a 12 bit delta token
+//Samples a frame holds whatever the signal does
+#define CPS_FRAME_SAMPLES_MIN (1u + ((CPS_FRAME_PAYLOAD_MAX - CPS_FRAME_SAMPLES_HEADER)/CPS_FRAME_TOKEN_MAX))
+#define CPS_FRAME_BENCHMARK 0u //Time the encoder and parser once at start up (watch CPS_xFrameBench), target only
+#define CPS_FRAME_BAUDS 4u //Entries of the baud table in CPS_frame.c
+#define CPS_FRAME_BITS_PER_BYTE 11u //Start, 8 data and the 2 stop bits sciInit configures
+#define CPS_FRAME_PULSE_MS 50u //Shift pulse. The CPS and the SCT each time it, the paddle release ends nothing
+#define CPS_FRAME_KEEPALIVE_MS 20u //Period of the CPS keepalive event frame
+#define CPS_FRAME_TIMEOUT_MS (3u*CPS_FRAME_KEEPALIVE_MS) //Link silence after which the SCT drops every output
+
+/* Global Types */
+typedef enum
+{
+  eFRAME_Events, //Events of one control cycle, see above
+  eFRAME_Ack, //Payload: SEQ of the last frame received intact
+  eFRAME_Samples //ADC samples, see above
+} xCPSFrameType_t;
+
+typedef enum
+{
+  eLINK_ShiftUp, //Record types of an event frame
+  eLINK_ShiftDown,
+  eLINK_HornOn,
+  eLINK_HornOff,
+  eLINK_PaddleRelease
+} xCPSLinkEvent_t;
+
+typedef struct
+{
+  uint8_t au8Frame[CPS_FRAME_MAX];
+  uint32_t u32Stamp; //Stamp of the first record
+  uint32_t u32Records;
+} xCPSFrameBatch_t;
+
+typedef struct
+{
+  uint8_t au8Frame[CPS_FRAME_MAX];
+  uint32_t u32Index; //Payload bytes written
+  uint32_t u32Samples; //Samples in the frame, the first one included
+  uint32_t u32Run; //Repeats of u16Last not written yet
+  uint16_t u16Last; //Sample the next delta is taken from
+} xCPSFrameSamples_t;
+
+typedef struct
+{
+  uint32_t u32State;
+  uint32_t u32Index; //Payload bytes received so far
+  uint16_t u16Crc; //Running CRC of the frame in progress
+  uint16_t u16CrcRx;
+  uint8_t u8Seq; //Header of the last complete frame
+  uint8_t u8Type;
+  uint8_t u8Length;
+  uint8_t au8Payload[CPS_FRAME_PAYLOAD_MAX];
+  uint8_t u8NextSeq; //SEQ expected next
+  bool bSeqValid; //u8NextSeq holds a value, cleared by a reset
+  uint32_t u32Frames; //Frames received intact
+  uint32_t u32CrcErrors;
+  uint32_t u32LengthErrors; //LEN above CPS_FRAME_PAYLOAD_MAX
+  uint32_t u32Skipped; //Bytes dropped while hunting for SOF
+  uint32_t u32SeqGaps; //Frames lost between two intact ones, by SEQ
+} xCPSFrameParser_t;
+
+typedef struct
+{
+  uint32_t u32EncodeCycles; //PMU cycles to build a full event frame
+  uint32_t u32ParseCycles; //PMU cycles to parse it back
+  uint32_t u32FrameBytes; //Bytes of a full event frame on the line
+  uint32_t au32Baud[CPS_FRAME_BAUDS];
+  uint32_t au32FramesPerSecond[CPS_FRAME_BAUDS]; //Full event frames the line carries per second
+  uint32_t au32EventsPerSecond[CPS_FRAME_BAUDS];
+} xCPSFrameBench_t;
+
+/* Global Vars */
+#if CPS_FRAME_BENCHMARK
+extern xCPSFrameBench_t CPS_xFrameBench;
+#endif
+
+/* Global Function Prototypes */
+
+uint16_t CPS_u16FrameCrc(uint16_t u16Crc, const uint8_t *pu8Data, uint32_t u32Length);
+uint32_t CPS_u32FrameEncode(uint8_t *pu8Frame, uint8_t u8Seq, xCPSFrameType_t xType, const uint8_t *pu8Payload,
+                            uint32_t u32Length);
+void CPS_vFrameBatchStart(xCPSFrameBatch_t *pxBatch);
+bool CPS_bFrameBatchAdd(xCPSFrameBatch_t *pxBatch, xCPSLinkEvent_t xEvent, uint8_t u8Data, uint32_t u32Stamp);
+uint32_t CPS_u32FrameBatchEnd(xCPSFrameBatch_t *pxBatch, uint8_t u8Seq);
+void CPS_vFrameSamplesStart(xCPSFrameSamples_t *pxSamples, uint32_t u32Stamp, uint16_t u16Sample);
+bool CPS_bFrameSamplesAdd(xCPSFrameSamples_t *pxSamples, uint16_t u16Sample);
+uint32_t CPS_u32FrameSamplesEnd(xCPSFrameSamples_t *pxSamples, uint8_t u8Seq);
+uint32_t CPS_u32FrameSamplesDecode(const uint8_t *pu8Payload, uint32_t u32Length, uint32_t *pu32Stamp,
+                                   uint16_t *pu16Samples, uint32_t u32Max);
+uint8_t CPS_u8FrameSeq(void);
+void CPS_vFrameParserReset(xCPSFrameParser_t *pxParser);
+bool CPS_bFrameParse(xCPSFrameParser_t *pxParser, uint8_t u8Byte);
+#if CPS_FRAME_BENCHMARK
+void CPS_vFrameBenchmark(void);
+#endif
+
+#endif
@@ -0,0 +1,250 @@
+/** @file CPS_sci.c
+*   @brief Interrupt driven SCI transport for the CPS/SCT link
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Two single producer/single consumer rings with free running indexes, as in the event log. The transmit ring is
+*   filled from IRQ context (or with IRQs masked) and emptied by the SCI interrupt, the receive ring is filled by the
+*   SCI interrupt and emptied by the main loop. Each side only writes its own index, so nobody waits or masks.
+*
+*   The transmit interrupt is only enabled while the ring holds data: CPS_bSciWrite enables it after publishing the
+*   bytes and the interrupt disables it when it finds the ring empty. Both run with IRQs masked, so they cannot race.
+*   The interrupt moves one byte per event. Channel 13 is ahead of the ADC channels in the VIM, so the link can hold
+*   off the classification ISR by at most one short notification per character time (u32EventMaxCycles).
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_sci.h"
+#include "sys_core.h"
+#include "sys_pmu.h"
+#include "sys_vim.h"
+#include "system.h"
+
+/* Defines */
+#define SCI_TXMASK (CPS_SCI_TXSIZE - 1u)
+#define SCI_RXMASK (CPS_SCI_RXSIZE - 1u)
+#define SCI_CYCLES_PER_SECOND ((uint32_t)(HCLK_FREQ*1000000.0F))
+
+/* Global Vars */
+xCPSSciStats_t CPS_xSciStats;
+xCPSSciBench_t CPS_xSciBench;
+
+/* Internal Vars */
+static uint8_t au8TxRing[CPS_SCI_TXSIZE];
+static uint8_t au8RxRing[CPS_SCI_RXSIZE];
+static volatile uint32_t u32TxHead; //Free running, written by the writers only
+static volatile uint32_t u32TxTail; //Free running, written by the SCI interrupt only
+static volatile uint32_t u32RxHead; //Free running, written by the SCI interrupt only
+static volatile uint32_t u32RxTail; //Free running, written by the reader only
+static pvCPSSciRx_t pvSciRx; //Receive hook, 0 to use the receive ring
+
+/* Global Functions */
+
+/* void CPS_vSciInit(pvCPSSciRx_t pvRx)
+*   Empties the rings, clears the statistics and hands the link port interrupts to the transport. Received bytes go
+*   to pvRx from the SCI interrupt, or into the receive ring when it is 0. Call after sciInit and before IRQs are
+*   enabled.
+*
+*/
+void CPS_vSciInit(pvCPSSciRx_t pvRx)
+{
+  pvSciRx = pvRx;
+  u32TxHead = 0u;
+  u32TxTail = 0u;
+  u32RxHead = 0u;
+  u32RxTail = 0u;
+  CPS_xSciStats.u32TxBytes = 0u;
+  CPS_xSciStats.u32RxBytes = 0u;
+  CPS_xSciStats.u32TxDropped = 0u;
+  CPS_xSciStats.u32RxDropped = 0u;
+  CPS_xSciStats.u32TxMaxFill = 0u;
+  CPS_xSciStats.u32Overruns = 0u;
+  CPS_xSciStats.u32Framing = 0u;
+  CPS_xSciStats.u32Parity = 0u;
+  CPS_xSciStats.u32Events = 0u;
+  CPS_xSciStats.u32EventMaxCycles = 0u;
+  CPS_xSciStats.u32EventTotalCycles = 0u;
+  CPS_SCI_PORT->CLEARINT = (uint32_t)SCI_TX_INT;
+  CPS_SCI_PORT->CLEARINTLVL = (uint32_t)SCI_RX_INT | (uint32_t)SCI_TX_INT | CPS_SCI_ERRORS; //All on level 0
+  CPS_SCI_PORT->FLR = CPS_SCI_ERRORS;
+  CPS_SCI_PORT->SETINT = (uint32_t)SCI_RX_INT | CPS_SCI_ERRORS;
+  vimChannelMap(CPS_SCI_VIMCHANNEL, CPS_SCI_VIMCHANNEL, &linHighLevelInterrupt);
+  vimEnableInterrupt(CPS_SCI_VIMCHANNEL, SYS_IRQ);
+}
+
+/* bool CPS_bSciWrite(const uint8_t *pu8Data, uint32_t u32Length)
+*   Queues u32Length bytes for sending and returns. IRQ context, or the main loop with IRQs masked. All or nothing:
+*   when the ring cannot take every byte nothing is queued, the bytes are counted as dropped and false is returned,
+*   so a command is never sent cut short.
+*
+*/
+bool CPS_bSciWrite(const uint8_t *pu8Data, uint32_t u32Length)
+{
+  uint32_t u32HeadNow = u32TxHead;
+  uint32_t u32Fill = u32HeadNow - u32TxTail;
+  uint32_t u32Byte;
+  if((CPS_SCI_TXSIZE - u32Fill) < u32Length)
+  {
+    CPS_xSciStats.u32TxDropped += u32Length;
+    return(false);
+  }
+  for(u32Byte = 0u; u32Byte < u32Length; u32Byte++)
+  {
+    au8TxRing[(u32HeadNow + u32Byte) & SCI_TXMASK] = pu8Data[u32Byte];
+  }
+  u32TxHead = u32HeadNow + u32Length; //Publish the bytes
+  if((u32Fill + u32Length) > CPS_xSciStats.u32TxMaxFill)
+  {
+    CPS_xSciStats.u32TxMaxFill = u32Fill + u32Length;
+  }
+  CPS_SCI_PORT->SETINT = (uint32_t)SCI_TX_INT; //Interrupts as soon as TD is free, which it is on an idle line
+  return(true);
+}
+
+/* uint32_t CPS_u32SciRead(uint8_t *pu8Data, uint32_t u32Max)
+*   Reader side, main loop only. Copies up to u32Max received bytes and returns how many.
+*
+*/
+uint32_t CPS_u32SciRead(uint8_t *pu8Data, uint32_t u32Max)
+{
+  uint32_t u32TailNow = u32RxTail;
+  uint32_t u32HeadNow = u32RxHead;
+  uint32_t u32Count = 0u;
+  while((u32TailNow != u32HeadNow) && (u32Count < u32Max))
+  {
+    pu8Data[u32Count] = au8RxRing[u32TailNow & SCI_RXMASK];
+    u32Count++;
+    u32TailNow++;
+  }
+  u32RxTail = u32TailNow; //Hand the slots back to the interrupt
+  return(u32Count);
+}
+
+/* uint32_t CPS_u32SciTxPending(void)
+*   Bytes queued and not yet handed to the SCI.
+*
+*/
+uint32_t CPS_u32SciTxPending(void)
+{
+  return(u32TxHead - u32TxTail);
+}
+
+/* void CPS_vSciNotification(sciBASE_t *pxSci, uint32_t u32Flags)
+*   Called from sciNotification, SCI interrupt context. linHighLevelInterrupt passes one flag per pending vector and
+*   leaves the data registers to us.
+*
+*/
+void CPS_vSciNotification(sciBASE_t *pxSci, uint32_t u32Flags)
+{
+  uint32_t u32StartCycles = _pmuGetCycleCount_();
+  uint32_t u32Index;
+  uint32_t u32Cycles;
+  uint8_t u8Byte;
+  if(pxSci != CPS_SCI_PORT)
+  {
+    return;
+  }
+  if((u32Flags & (uint32_t)SCI_RX_INT) != 0u)
+  {
+    u8Byte = (uint8_t)pxSci->RD; //Always read, it clears RXRDY
+    if(pvSciRx != 0)
+    {
+      CPS_xSciStats.u32RxBytes++;
+      pvSciRx(u8Byte);
+    }
+    else
+    {
+      u32Index = u32RxHead;
+      if((u32Index - u32RxTail) < CPS_SCI_RXSIZE)
+      {
+        au8RxRing[u32Index & SCI_RXMASK] = u8Byte;
+        u32RxHead = u32Index + 1u;
+        CPS_xSciStats.u32RxBytes++;
+      }
+      else
+      {
+        CPS_xSciStats.u32RxDropped++;
+      }
+    }
+  }
+  if((u32Flags & (uint32_t)SCI_TX_INT) != 0u)
+  {
+    u32Index = u32TxTail;
+    if(u32Index != u32TxHead)
+    {
+      pxSci->TD = au8TxRing[u32Index & SCI_TXMASK];
+      u32TxTail = u32Index + 1u;
+      CPS_xSciStats.u32TxBytes++;
+    }
+    else
+    {
+      pxSci->CLEARINT = (uint32_t)SCI_TX_INT; //Nothing left, CPS_bSciWrite enables it again
+    }
+  }
+  if((u32Flags & CPS_SCI_ERRORS) != 0u)
+  {
+    pxSci->FLR = u32Flags & CPS_SCI_ERRORS;
+    CPS_xSciStats.u32Overruns += ((u32Flags & (uint32_t)SCI_OE_INT) != 0u) ? 1u : 0u;
+    CPS_xSciStats.u32Framing += ((u32Flags & (uint32_t)SCI_FE_INT) != 0u) ? 1u : 0u;
+    CPS_xSciStats.u32Parity += ((u32Flags & (uint32_t)SCI_PE_INT) != 0u) ? 1u : 0u;
+  }
+  u32Cycles = _pmuGetCycleCount_() - u32StartCycles;
+  CPS_xSciStats.u32Events++;
+  CPS_xSciStats.u32EventTotalCycles += u32Cycles;
+  if(u32Cycles > CPS_xSciStats.u32EventMaxCycles)
+  {
+    CPS_xSciStats.u32EventMaxCycles = u32Cycles;
+  }
+}
+
+/* bool CPS_bSciLoopback(uint32_t u32Bytes, uint32_t u32TimeoutCycles)
+*   Throughput and interrupt cost benchmark. Sends a counting pattern through the rings and the SCI in digital
+*   loopback, reads it back and fills CPS_xSciBench. Main loop only, with IRQs enabled, the PMU cycle counter running
+*   and the link otherwise idle; the port is back on its pins on return. True when every byte came back unchanged
+*   within u32TimeoutCycles.
+*
+*/
+bool CPS_bSciLoopback(uint32_t u32Bytes, uint32_t u32TimeoutCycles)
+{
+  uint32_t u32Sent = 0u;
+  uint32_t u32Received = 0u;
+  uint32_t u32Errors = 0u;
+  uint32_t u32Events = CPS_xSciStats.u32Events;
+  uint32_t u32EventCycles = CPS_xSciStats.u32EventTotalCycles;
+  uint32_t u32LineErrors = CPS_xSciStats.u32Overruns + CPS_xSciStats.u32Framing + CPS_xSciStats.u32Parity;
+  uint32_t u32StartCycles;
+  uint32_t u32Cycles;
+  uint8_t u8Byte;
+  sciEnableLoopback(CPS_SCI_PORT, Digital_Lbk);
+  u32StartCycles = _pmuGetCycleCount_();
+  do
+  {
+    if((u32Sent < u32Bytes) && (CPS_u32SciTxPending() < CPS_SCI_TXSIZE))
+    {
+      u8Byte = (uint8_t)u32Sent;
+      _disable_IRQ_interrupt_();
+      (void)CPS_bSciWrite(&u8Byte, 1u); //Cannot fail, only the interrupt frees space in between
+      _enable_interrupt_();
+      u32Sent++;
+    }
+    while(CPS_u32SciRead(&u8Byte, 1u) != 0u)
+    {
+      u32Errors += (u8Byte != (uint8_t)u32Received) ? 1u : 0u;
+      u32Received++;
+    }
+    u32Cycles = _pmuGetCycleCount_() - u32StartCycles;
+  } while((u32Received < u32Bytes) && (u32Cycles < u32TimeoutCycles));
+  sciDisableLoopback(CPS_SCI_PORT);
+  u32Events = CPS_xSciStats.u32Events - u32Events;
+  u32EventCycles = CPS_xSciStats.u32EventTotalCycles - u32EventCycles;
+  u32Errors += CPS_xSciStats.u32Overruns + CPS_xSciStats.u32Framing + CPS_xSciStats.u32Parity - u32LineErrors;
+  CPS_xSciBench.u32Bytes = u32Received;
+  CPS_xSciBench.u32Cycles = u32Cycles;
+  CPS_xSciBench.u32BytesPerSecond = (u32Cycles != 0u) ?
+                                    (uint32_t)(((uint64_t)u32Received*SCI_CYCLES_PER_SECOND)/u32Cycles) : 0u;
+  CPS_xSciBench.u32EventMeanCycles = (u32Events != 0u) ? (u32EventCycles/u32Events) : 0u;
+  CPS_xSciBench.u32Errors = u32Errors;
+  return((u32Received == u32Bytes) && (u32Errors == 0u));
+}
@@ -0,0 +1,82 @@
+/** @file CPS_sci.h
+*   @brief Interrupt driven SCI transport for the CPS/SCT link
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the ring buffered SCI transport used by both processors of the paddle shift project. Bytes
+*   are queued with CPS_bSciWrite and return straight away; the SCI interrupt moves them to the line one at a time and
+*   fills the receive ring, which is read with CPS_u32SciRead, or hands each byte straight to a receive hook in
+*   interrupt context. Nothing in here ever waits on the line, a full ring
+*   drops and counts instead. The driver's blocking sciSend/sciReceive are not used on the link port.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_SCI_H__
+#define __CPS_SCI_H__
+
+/* Include Files */
+#include "CPS_common.h"
+
+/* Defines */
+#define CPS_SCI_PORT scilinREG //Link port
+//Link rate, set by both processors after sciInit. sciSetBaudrate makes it 113636 (BRS 54), so a one event frame
+//(14 bytes of 11 bits) takes 1.36ms on the line, against 8ms at the sciInit rate (19172, BRS 325).
+#define CPS_SCI_BAUD 115200u
+#define CPS_SCI_VIMCHANNEL 13u //SCI/LIN level 0 request, phantom in the HALCoGen VIM table
+#define CPS_SCI_TXSIZE 128u //Transmit ring bytes, power of two. Holds a telemetry and an event frame together.
+#define CPS_SCI_RXSIZE 64u //Receive ring bytes, power of two
+#define CPS_SCI_ERRORS ((uint32_t)SCI_FE_INT | (uint32_t)SCI_OE_INT | (uint32_t)SCI_PE_INT)
+#define CPS_SCI_BENCHMARK 0u //Run CPS_bSciLoopback once at start up (watch CPS_xSciBench)
+#define CPS_SCI_BENCHMARK_BYTES 256u
+#define CPS_SCI_BENCHMARK_TIMEOUT 100000000u //PMU cycles, 1s at HCLK
+
+#if (CPS_SCI_TXSIZE & (CPS_SCI_TXSIZE - 1u)) != 0u
+#error "CPS_SCI_TXSIZE must be a power of two"
+#endif
+#if (CPS_SCI_RXSIZE & (CPS_SCI_RXSIZE - 1u)) != 0u
+#error "CPS_SCI_RXSIZE must be a power of two"
+#endif
+
+/* Global Types */
+typedef void (*pvCPSSciRx_t)(uint8_t u8Byte);
+
+typedef struct
+{
+  uint32_t u32TxBytes; //Bytes written to TD
+  uint32_t u32RxBytes; //Bytes read from RD into the ring or the hook
+  uint32_t u32TxDropped; //Bytes refused by CPS_bSciWrite because the ring was full
+  uint32_t u32RxDropped; //Received bytes lost because the ring was full
+  uint32_t u32TxMaxFill; //Highest number of bytes waiting to be sent
+  uint32_t u32Overruns; //RD overwritten before it was read
+  uint32_t u32Framing; //Missing stop bit
+  uint32_t u32Parity;
+  uint32_t u32Events; //Notifications handled, one per byte or error
+  uint32_t u32EventMaxCycles; //PMU cycles of the longest notification
+  uint32_t u32EventTotalCycles; //Divide by u32Events for the mean
+} xCPSSciStats_t;
+
+typedef struct
+{
+  uint32_t u32Bytes; //Bytes sent and received back in the last CPS_bSciLoopback run
+  uint32_t u32Cycles; //PMU cycles from the first byte queued to the last byte read
+  uint32_t u32BytesPerSecond;
+  uint32_t u32EventMeanCycles; //Mean notification cost during the run
+  uint32_t u32Errors; //Bytes that came back different, plus line errors
+} xCPSSciBench_t;
+
+/* Global Vars */
+extern xCPSSciStats_t CPS_xSciStats;
+extern xCPSSciBench_t CPS_xSciBench;
+
+/* Global Function Prototypes */
+
+void CPS_vSciInit(pvCPSSciRx_t pvRx);
+bool CPS_bSciWrite(const uint8_t *pu8Data, uint32_t u32Length);
+uint32_t CPS_u32SciRead(uint8_t *pu8Data, uint32_t u32Max);
+uint32_t CPS_u32SciTxPending(void);
+void CPS_vSciNotification(sciBASE_t *pxSci, uint32_t u32Flags);
+bool CPS_bSciLoopback(uint32_t u32Bytes, uint32_t u32TimeoutCycles);
+
+#endif
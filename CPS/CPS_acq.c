@@ -0,0 +1,383 @@
+/** @file CPS_acq.c
+*   @brief Steering wheel ADC acquisition
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Starts the group 1 conversions every CPS_FILTER_SAMPLE_US. In software trigger mode every conversion is started
+*   by the RTI compare0 interrupt. In hardware trigger mode group 1 is switched to the RTI compare0 trigger source, so
+*   the compare event starts the conversion directly and the only interrupt per sample is the conversion complete one.
+*
+*   Group 1 converts every channel of CPS_axAcqChannels on each trigger. The channel selection and FIFO threshold are
+*   programmed here from the channel table rather than from the HALCoGen tables. The MibADC converts the selected
+*   channels in ascending order, so with the table sorted by channel the n-th result belongs to slot n and the FIFO
+*   is drained with the fixed depth adc1Group1GetData16 read.
+*
+*   Batch mode uses group 2 instead. Each compare0 event converts the channel set once and the group only interrupts
+*   when its FIFO holds ADC1_G2_DEPTH results, so the CPU sees one interrupt per CPS_FILTER_DECIMATION conversions of
+*   every channel and the filter gets the whole block at once.
+*
+*   With CPS_ACQ_IDLEWAKE the group interrupt is switched off once every slot has classified idle for
+*   CPS_ACQ_IDLE_OUTPUTS filter outputs. The group keeps converting at the slower watch rate with FIFO overrun ignored,
+*   and the MibADC magnitude comparators check every result of each slot against the bottom of its idle band. The
+*   first result below it raises the magnitude interrupt, which restores the full sample rate and the group
+*   interrupt. A press costs at most one watch period plus one batch of extra latency.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_acq.h"
+#include "CPS_calib.h"
+#include "CPS_classify.h"
+#include "CPS_filter.h"
+#include "CPS_latency.h"
+#include "CPS_profile.h"
+#include "CPS_telemetry.h"
+#include "sys_vim.h"
+
+/* Defines */
+#define ADC_GxMODECR_HWTRIG 0x00000008u //Group is started by its hardware trigger source
+#define ADC_GxSRC_SRCMASK 0x00000007u
+#define ADC_GxMODECR_OVRIGN 0x00000010u //Overwrite the FIFO when full instead of stalling the group
+#define ADC_GxINTENA_THR 0x00000001u //Interrupt when the FIFO threshold counter reaches zero
+#define ADC_MAGINTCR_THRSHIFT 16u //MAG_THR, 12 bit compare value
+#define ADC_MAGINTCR_CHIDSHIFT 8u //MAG_CHID, input compared
+#define ADC_MAGINTCR_LT 0x00000000u //CMP_GE_LT clear: flag results below MAG_THR. CHN_THR_COMP clear: compare to MAG_THR.
+#define ADC_MAGINTMASK_ALL ADC1_RESULT_MASK //Compare every result bit
+#define ADC_MAGTHRINT_ALL 0x00000007u
+#define ADC_INPUTS 32u
+
+#if ADC1_G1_DEPTH != CPS_ACQ_CHANNELS
+#error "ADC1_G1_DEPTH in adc.h must equal CPS_ACQ_CHANNELS"
+#endif
+#if CPS_ACQ_CHANNELS > 2u
+#error "CPS_axAcqChannels only lists the horn wire and the paddle ladder, add the entries of the other ladders"
+#endif
+#if (CPS_ACQ_MODE == CPS_ACQ_BATCH) && ((ADC1_G2_DEPTH % CPS_ACQ_CHANNELS) != 0u)
+#error "A group 2 batch must hold a whole number of conversions of every channel"
+#endif
+
+#if CPS_ACQ_MODE == CPS_ACQ_BATCH
+#define ACQ_GROUP adcGROUP2
+#define ACQ_GROUP_DEPTH ADC1_G2_DEPTH
+#else
+#define ACQ_GROUP adcGROUP1
+#define ACQ_GROUP_DEPTH CPS_ACQ_CHANNELS
+#endif
+
+/* Global Vars */
+const xCPSAcqChannel_t CPS_axAcqChannels[CPS_ACQ_CHANNELS] =
+{
+#if CPS_ACQ_CHANNELS == 1u
+  {17u, &CPS_xADCLadderHorn, ADC_UPPERBOUND_SHFTUP + 1u} //Horn wire with the paddles on it, CPS_ACQ_SLOT_HORN
+#else
+  {17u, &CPS_xADCLadderHorn, ADC_UPPERBOUND_SHFTUP + 1u}, //Horn wire, CPS_ACQ_SLOT_HORN
+  {18u, &CPS_xADCLadderPaddle, ADC_UPPERBOUND_PADUP + 1u} //Paddle ladder, CPS_ACQ_SLOT_PADDLES
+#endif
+};
+
+uint16_t CPS_au16AcqFiltered[CPS_ACQ_CHANNELS];
+uint8_t CPS_au8AcqClass[CPS_ACQ_CHANNELS];
+xCPSAcqStats_t CPS_xAcqStats;
+volatile bool CPS_bAcqWatching;
+#if CPS_ACQ_BENCHMARK
+uint32_t CPS_au32AcqBenchCycles[CPS_ACQ_BENCH_CHANNELS];
+#endif
+
+/* Internal Vars */
+static uint32_t u32ChannelSelect; //GxSEL value built from the channel table
+#if CPS_ACQ_IDLEWAKE
+static uint32_t u32GroupIntEna; //GxINTENA of the acquisition group while sampling at full rate
+static uint32_t u32IdleOutputs; //Consecutive filter outputs with every slot idle
+#endif
+
+/* Local Function Prototypes */
+static void vAcqSelectGroup1(void);
+#if CPS_ACQ_IDLEWAKE
+static void vAcqMagnitudeSetup(void);
+static void vAcqWatch(void);
+#endif
+
+/* Global Functions */
+
+/* bool CPS_bAcqChannelsValid(void)
+*   Checks that the channel table is sorted by strictly ascending ADC input, which the positional slot mapping relies
+*   on, and that every channel has a ladder whose bands all sit below its idle code. Returns 1 when it does.
+*
+*/
+bool CPS_bAcqChannelsValid(void)
+{
+  const xCPSADCLadder_t *pxLadder;
+  for(uint32_t u32Slot = 0u; u32Slot < CPS_ACQ_CHANNELS; u32Slot++)
+  {
+    pxLadder = CPS_axAcqChannels[u32Slot].pxLadder;
+    if((CPS_axAcqChannels[u32Slot].u32Channel >= ADC_INPUTS) || (pxLadder == 0) || (pxLadder->u32BandCount == 0u))
+    {
+      return(0);
+    }
+    if(pxLadder->pxBands[pxLadder->u32BandCount - 1u].u16Upper >= CPS_axAcqChannels[u32Slot].u16IdleCode)
+    {
+      return(0);
+    }
+    if((u32Slot > 0u) && (CPS_axAcqChannels[u32Slot].u32Channel <= CPS_axAcqChannels[u32Slot - 1u].u32Channel))
+    {
+      return(0);
+    }
+  }
+  return(1);
+}
+
+/* void CPS_vAcqStart(void)
+*   Builds the channel selection, enables the group notification and starts sampling. adcInit and rtiInit must have
+*   been called and RTI counter 0 must be running.
+*
+*/
+void CPS_vAcqStart(void)
+{
+  u32ChannelSelect = 0u;
+  for(uint32_t u32Slot = 0u; u32Slot < CPS_ACQ_CHANNELS; u32Slot++)
+  {
+    u32ChannelSelect |= 1u << CPS_axAcqChannels[u32Slot].u32Channel;
+    CPS_au8AcqClass[u32Slot] = (uint8_t)eCMD_Null;
+  }
+  rtiREG1->CMP[0u].UDCPx = CPS_ACQ_SAMPLE_COUNTS; //Takes effect from the next compare0 match
+#if CPS_ACQ_MODE == CPS_ACQ_SWTRIGGER
+  adcEnableNotification(adcREG1, adcGROUP1); //Enable ADC ISR routine
+  adcResetFiFo(adcREG1, adcGROUP1);
+  vAcqSelectGroup1();
+  rtiEnableNotification(rtiNOTIFICATION_COMPARE0);
+#else
+  //The ADC trigger follows the compare0 flag, so the flag has to be cleared by hardware half way through each period.
+  //COMPx already holds the next match, so the first clear point is always ahead of the counter.
+  rtiREG1->COMP0CLR = rtiREG1->CMP[0u].COMPx + (rtiREG1->CMP[0u].UDCPx/2u);
+  rtiREG1->INTFLAG = rtiNOTIFICATION_COMPARE0;
+  rtiSetCompareAutoClearFlag();
+#if CPS_ACQ_MODE == CPS_ACQ_BATCH
+  vimChannelMap(CPS_ACQ_BATCH_VIMCHANNEL, CPS_ACQ_BATCH_VIMCHANNEL, &adc1Group2Interrupt);
+  vimEnableInterrupt(CPS_ACQ_BATCH_VIMCHANNEL, SYS_IRQ);
+  adcResetFiFo(adcREG1, adcGROUP2);
+  adcREG1->G2SRC = (adcREG1->G2SRC & ~ADC_GxSRC_SRCMASK) | (uint32_t)ADC1_RTI_COMP0;
+  adcREG1->GxMODECR[adcGROUP2] |= ADC_GxMODECR_HWTRIG;
+  adcREG1->GxINTFLG[adcGROUP2] = 9u;
+  adcREG1->GxINTENA[adcGROUP2] = ADC_GxINTENA_THR; //Threshold, not end of conversion
+  adcREG1->GxINTCR[adcGROUP2] = ADC1_G2_DEPTH;
+  adcREG1->GxSEL[adcGROUP2] = u32ChannelSelect; //Group now waits for the compare0 event
+#else
+  adcEnableNotification(adcREG1, adcGROUP1); //Enable ADC ISR routine
+  adcResetFiFo(adcREG1, adcGROUP1);
+  adcREG1->G1SRC = (adcREG1->G1SRC & ~ADC_GxSRC_SRCMASK) | (uint32_t)ADC1_RTI_COMP0;
+  adcREG1->GxMODECR[adcGROUP1] |= ADC_GxMODECR_HWTRIG;
+  vAcqSelectGroup1(); //Group now waits for the compare0 event
+#endif
+#if CPS_ACQ_IDLEWAKE
+  u32GroupIntEna = adcREG1->GxINTENA[ACQ_GROUP];
+  u32IdleOutputs = 0u;
+  CPS_bAcqWatching = 0;
+  vAcqMagnitudeSetup();
+#endif
+#endif
+}
+
+/* void CPS_vAcqTrigger(void)
+*   Software trigger for the next conversion. Called from the RTI compare0 ISR, does nothing in hardware mode.
+*
+*/
+void CPS_vAcqTrigger(void)
+{
+#if CPS_ACQ_MODE == CPS_ACQ_SWTRIGGER
+  adcResetFiFo(adcREG1, adcGROUP1);
+  vAcqSelectGroup1();
+#endif
+}
+
+/* bool CPS_bAcqProcess(void)
+*   Drains one group conversion (one batch in batch mode), feeds every result through the filter of its slot and
+*   classifies the slots whose filter produced an output. Returns 1 when CPS_au8AcqClass holds new values. ADC ISR
+*   context only, called on the group end or threshold interrupt so all results are in the FIFO.
+*
+*/
+bool CPS_bAcqProcess(void)
+{
+#if CPS_ACQ_MODE == CPS_ACQ_BATCH
+  uint16_t au16Raw[ADC1_G2_DEPTH];
+  uint32_t u32Results = adc1Group2GetData16(au16Raw);
+#else
+  uint16_t au16Raw[CPS_ACQ_CHANNELS];
+  uint32_t u32Results = adc1Group1GetData16(au16Raw);
+#endif
+  uint32_t u32Slot;
+  uint16_t u16Sample;
+  uint16_t u16Filtered;
+  bool bNewClass = 0;
+#if CPS_LATENCY_ENABLE
+  uint32_t u32Now = CPS_u32TimeNow32(); //Time of the last conversion, the ones before it are a sample period apart
+#endif
+  CPS_xAcqStats.u32Conversions++;
+  for(uint32_t u32Result = 0u; u32Result < u32Results; u32Result++)
+  {
+    u32Slot = u32Result % CPS_ACQ_CHANNELS; //Results repeat the channel order every CPS_ACQ_CHANNELS entries
+    u16Sample = CPS_u16CalibApply(au16Raw[u32Result]);
+#if CPS_TELEMETRY_ENABLE
+    if((u32Slot == CPS_TELEMETRY_SLOT) && (CPS_u32TelemetryRaw < CPS_TELEMETRY_RAW_MAX))
+    {
+      CPS_au16TelemetryRaw[CPS_u32TelemetryRaw] = u16Sample; //Encoded once the inputs are done, see CPS_telemetry.c
+      CPS_u32TelemetryRaw++;
+    }
+#endif
+#if CPS_LATENCY_ENABLE
+    if(u32Slot == CPS_ACQ_SLOT_HORN) //The step is the raw conversion, ahead of the filter delay
+    {
+      CPS_vLatencyInput(CPS_axAcqChannels[u32Slot].pxLadder->pu8ClassTable[u16Sample & ADC_CODEMASK],
+                        u32Now - (((u32Results - 1u - u32Result)/CPS_ACQ_CHANNELS)*CPS_ACQ_SAMPLE_COUNTS));
+    }
+#endif
+    if(CPS_bFilterPut(u32Slot, u16Sample, &u16Filtered))
+    {
+      CPS_au16AcqFiltered[u32Slot] = u16Filtered;
+      CPS_au8AcqClass[u32Slot] = CPS_axAcqChannels[u32Slot].pxLadder->pu8ClassTable[u16Filtered & ADC_CODEMASK];
+      bNewClass = 1;
+    }
+  }
+#if CPS_ACQ_IDLEWAKE
+  if(bNewClass)
+  {
+    u32IdleOutputs++;
+    for(u32Slot = 0u; u32Slot < CPS_ACQ_CHANNELS; u32Slot++)
+    {
+      if(CPS_au8AcqClass[u32Slot] != (uint8_t)eCMD_Null)
+      {
+        u32IdleOutputs = 0u;
+      }
+    }
+    if(u32IdleOutputs >= CPS_ACQ_IDLE_OUTPUTS)
+    {
+      vAcqWatch(); //This batch is still returned, the inputs see the idle sample that got us here
+    }
+  }
+#endif
+  return(bNewClass);
+}
+
+#if CPS_ACQ_IDLEWAKE
+/* void CPS_vAcqWake(void)
+*   Leaves the watch state: stops the magnitude compare, restarts the group from an empty FIFO and fresh filters at
+*   the full sample rate. Called from the magnitude compare ISR.
+*
+*/
+void CPS_vAcqWake(void)
+{
+  adcREG1->MAGTHRINTENACLR = ADC_MAGTHRINT_ALL;
+  adcREG1->MAGTHRINTFLG = ADC_MAGTHRINT_ALL;
+  if(!CPS_bAcqWatching)
+  {
+    return;
+  }
+  rtiREG1->CMP[0u].UDCPx = CPS_ACQ_SAMPLE_COUNTS;
+  adcStopConversion(adcREG1, ACQ_GROUP); //The FIFO can only be reset with the group idle
+  adcResetFiFo(adcREG1, ACQ_GROUP);
+  CPS_vFilterReset();
+  u32IdleOutputs = 0u;
+  adcREG1->GxINTFLG[ACQ_GROUP] = 9u;
+  adcREG1->GxINTCR[ACQ_GROUP] = ACQ_GROUP_DEPTH;
+  adcREG1->GxINTENA[ACQ_GROUP] = u32GroupIntEna;
+  adcREG1->GxSEL[ACQ_GROUP] = u32ChannelSelect;
+  CPS_bAcqWatching = 0;
+  CPS_xAcqStats.u32Wakes++;
+#if CPS_LATENCY_ENABLE
+  CPS_vLatencyWake();
+#endif
+}
+#endif
+
+#if CPS_ACQ_BENCHMARK
+/* void CPS_vAcqBenchmark(void)
+*   Converts the first 1..CPS_ACQ_BENCH_CHANNELS ADC inputs with a software trigger and times draining (with a
+*   run time count, so a little slower than the fixed depth read) and classifying the results of each conversion,
+*   so the ISR cost per extra ladder can be read from CPS_au32AcqBenchCycles. The filter cost per result comes on
+*   top, see CPS_axFilterBenchmark. Unconnected inputs convert just as fast as real ladders. Run with interrupts
+*   disabled and before CPS_vAcqStart.
+*
+*/
+void CPS_vAcqBenchmark(void)
+{
+  uint32_t u32Start;
+  uint32_t u32Buffer;
+  volatile uint32_t u32Class = 0u; //Keeps the table loads from being optimised away
+  const xCPSAcqChannel_t *pxChannel = &CPS_axAcqChannels[CPS_ACQ_SLOT_HORN];
+  CPS_vProfileInit();
+  for(uint32_t u32Channels = 1u; u32Channels <= CPS_ACQ_BENCH_CHANNELS; u32Channels++)
+  {
+    adcResetFiFo(adcREG1, adcGROUP1);
+    adcREG1->GxINTFLG[adcGROUP1] = 9u;
+    adcREG1->GxINTCR[adcGROUP1] = u32Channels;
+    adcREG1->GxSEL[adcGROUP1] = (1u << u32Channels) - 1u; //Inputs 0..n-1
+    while(adcIsConversionComplete(adcREG1, adcGROUP1) == 0u)
+    {
+      //Wait for the group to finish
+    }
+    u32Start = CPS_u32ProfileCycles();
+    for(uint32_t u32Result = 0u; u32Result < u32Channels; u32Result++)
+    {
+      u32Buffer = adcREG1->GxBUF[adcGROUP1].BUF0;
+      u32Class += pxChannel->pxLadder->pu8ClassTable[u32Buffer & ADC1_RESULT_MASK]; //Same work as CPS_bAcqProcess
+    }
+    CPS_au32AcqBenchCycles[u32Channels - 1u] = CPS_u32ProfileCycles() - u32Start;
+  }
+  adcREG1->GxINTFLG[adcGROUP1] = 9u;
+  adcResetFiFo(adcREG1, adcGROUP1);
+}
+#endif
+
+/* Local Functions */
+
+#if CPS_ACQ_IDLEWAKE
+/* void vAcqMagnitudeSetup(void)
+*   Points comparator n at the input of slot n with the bottom of its idle band as threshold and maps the magnitude
+*   interrupt. Lets the group FIFO overwrite itself so conversions, and with them the compares, never stall while
+*   nobody drains it. The comparators stay disabled until vAcqWatch.
+*
+*/
+static void vAcqMagnitudeSetup(void)
+{
+  volatile uint32_t *pu32MagIntCR = &adcREG1->MAGINTCR1; //CR and MASK registers alternate for comparators 1..3
+  uint32_t u32Threshold;
+  adcREG1->MAGTHRINTENACLR = ADC_MAGTHRINT_ALL;
+  adcREG1->MAGTHRINTFLG = ADC_MAGTHRINT_ALL;
+  for(uint32_t u32Slot = 0u; u32Slot < CPS_ACQ_CHANNELS; u32Slot++)
+  {
+    u32Threshold = CPS_u16CalibRawCode(CPS_axAcqChannels[u32Slot].u16IdleCode); //Compares see uncorrected results
+    pu32MagIntCR[2u*u32Slot] = (u32Threshold << ADC_MAGINTCR_THRSHIFT) |
+                               (CPS_axAcqChannels[u32Slot].u32Channel << ADC_MAGINTCR_CHIDSHIFT) | ADC_MAGINTCR_LT;
+    pu32MagIntCR[(2u*u32Slot) + 1u] = ADC_MAGINTMASK_ALL;
+  }
+  adcREG1->GxMODECR[ACQ_GROUP] |= ADC_GxMODECR_OVRIGN;
+  vimChannelMap(CPS_ACQ_MAG_VIMCHANNEL, CPS_ACQ_MAG_VIMCHANNEL, &adc1MagnitudeInterrupt);
+  vimEnableInterrupt(CPS_ACQ_MAG_VIMCHANNEL, SYS_IRQ);
+}
+
+/* void vAcqWatch(void)
+*   Enters the watch state from the group ISR: group interrupt off, watch trigger rate, comparators armed. A slot
+*   that is already below its idle code sets its flag straight away and wakes us on the next result.
+*
+*/
+static void vAcqWatch(void)
+{
+  adcREG1->GxINTENA[ACQ_GROUP] = 0u;
+  adcREG1->GxINTFLG[ACQ_GROUP] = 9u;
+  rtiREG1->CMP[0u].UDCPx = CPS_ACQ_WATCH_COUNTS;
+  CPS_bAcqWatching = 1;
+  CPS_xAcqStats.u32Watches++;
+  adcREG1->MAGTHRINTFLG = ADC_MAGTHRINT_ALL;
+  adcREG1->MAGTHRINTENASET = (1u << CPS_ACQ_CHANNELS) - 1u;
+}
+#endif
+
+/* void vAcqSelectGroup1(void)
+*   Sets the FIFO threshold to one result per channel and writes the channel selection, which arms the group.
+*
+*/
+static void vAcqSelectGroup1(void)
+{
+  adcREG1->GxINTCR[adcGROUP1] = CPS_ACQ_CHANNELS;
+  adcREG1->GxSEL[adcGROUP1] = u32ChannelSelect;
+}
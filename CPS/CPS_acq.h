@@ -0,0 +1,107 @@
+/** @file CPS_acq.h
+*   @brief Steering wheel ADC acquisition
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface used to start and pace the ADC conversions of the steering wheel resistor
+*   ladders. Every conversion samples all channels in CPS_axAcqChannels; each channel has its own ladder (band list
+*   and classifier table), filter state and result slot.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_ACQ_H__
+#define __CPS_ACQ_H__
+
+/* Include Files */
+#include "CPS_time.h"
+#include "CPS_classify.h"
+
+/* Defines */
+#define CPS_ACQ_SWTRIGGER 0u //RTI compare0 ISR resets the FIFO and starts every conversion
+#define CPS_ACQ_HWTRIGGER 1u //RTI compare0 event starts the conversion in hardware, compare0 ISR is not used
+#define CPS_ACQ_BATCH 2u //Group 2, hardware triggered, one interrupt per ADC1_G2_DEPTH results
+
+#define CPS_ACQ_MODE CPS_ACQ_BATCH
+
+#define CPS_ACQ_SAMPLE_COUNTS (CPS_FILTER_SAMPLE_US*CPS_TIME_COUNTS_PER_US) //Compare0 period, set by the filter oversampling
+#define CPS_ACQ_BATCH_VIMCHANNEL 28u //ADC1 group 2 request
+
+#ifndef CPS_TELEMETRY_ENABLE //HOST_stream builds the CPS with -DCPS_TELEMETRY_ENABLE=1
+#define CPS_TELEMETRY_ENABLE 0u //Stream the samples of CPS_TELEMETRY_SLOT to a logger on the link port, not the SCT
+#endif
+#if CPS_TELEMETRY_ENABLE
+#define CPS_ACQ_IDLEWAKE 0u //The idle waveform is streamed too, the group interrupts keep running
+#else
+#define CPS_ACQ_IDLEWAKE 1u //Stop the group interrupts while every slot is idle and let the magnitude compare wake us
+#endif
+#define CPS_ACQ_IDLE_OUTPUTS 8u //Consecutive all-idle filter outputs before the group interrupts are stopped
+#define CPS_ACQ_WATCH_US 1000u //Compare0 period while watching, bounds the extra wake up latency
+#define CPS_ACQ_WATCH_COUNTS (CPS_ACQ_WATCH_US*CPS_TIME_COUNTS_PER_US)
+#define CPS_ACQ_MAG_VIMCHANNEL 31u //ADC1 magnitude compare
+
+#ifndef CPS_ACQ_CHANNELS //HOST_acq builds the CPS with -DCPS_ACQ_CHANNELS=2u -DADC1_G1_DEPTH=2U
+#define CPS_ACQ_CHANNELS 1u //Entries in CPS_axAcqChannels, at most 16 (group 1 buffer size). Keep ADC1_G1_DEPTH equal.
+#endif
+#define CPS_ACQ_SLOT_HORN 0u //Slot of the horn wire ladder
+#if CPS_ACQ_CHANNELS > 1u
+#define CPS_ACQ_SLOT_PADDLES 1u //Newer wheels, the paddles have a ladder of their own
+#else
+#define CPS_ACQ_SLOT_PADDLES CPS_ACQ_SLOT_HORN
+#endif
+
+#ifndef CPS_ACQ_BENCHMARK
+#define CPS_ACQ_BENCHMARK 0u //Time the FIFO drain and classification for 1..CPS_ACQ_BENCH_CHANNELS channels at boot
+#endif
+#define CPS_ACQ_BENCH_CHANNELS 8u
+
+#if (CPS_ACQ_CHANNELS == 0u) || (CPS_ACQ_CHANNELS > 16u)
+#error "CPS_ACQ_CHANNELS must be between 1 and 16"
+#endif
+#if CPS_ACQ_IDLEWAKE && (CPS_ACQ_MODE == CPS_ACQ_SWTRIGGER)
+#error "Idle wake needs hardware triggered conversions, the software trigger interrupt would keep running"
+#endif
+#if CPS_ACQ_IDLEWAKE && (CPS_ACQ_CHANNELS > 3u)
+#error "Idle wake uses one of the three magnitude comparators per slot"
+#endif
+
+/* Global Types */
+typedef struct
+{
+  uint32_t u32Channel; //ADC1 input number, 0..31. The table must be sorted by ascending channel.
+  const xCPSADCLadder_t *pxLadder; //Bands and classifier table of the ladder wired to this input
+  uint16_t u16IdleCode; //Lowest raw code of the idle band. The idle band must be the top of the range for idle wake.
+} xCPSAcqChannel_t;
+
+typedef struct
+{
+  uint32_t u32Conversions; //Group conversions drained
+  uint32_t u32Watches; //Times the group interrupts were stopped for the magnitude compare
+  uint32_t u32Wakes; //Magnitude compare wake ups
+} xCPSAcqStats_t;
+
+/* Global Vars */
+extern const xCPSAcqChannel_t CPS_axAcqChannels[CPS_ACQ_CHANNELS];
+extern uint16_t CPS_au16AcqFiltered[CPS_ACQ_CHANNELS]; //Last filtered code per slot
+extern uint8_t CPS_au8AcqClass[CPS_ACQ_CHANNELS]; //Last classification per slot
+extern xCPSAcqStats_t CPS_xAcqStats;
+extern volatile bool CPS_bAcqWatching; //1 while only the magnitude compare can interrupt
+#if CPS_ACQ_BENCHMARK
+extern uint32_t CPS_au32AcqBenchCycles[CPS_ACQ_BENCH_CHANNELS]; //[n-1]: PMU cycles to drain and classify n channels
+#endif
+
+/* Global Function Prototypes */
+
+bool CPS_bAcqChannelsValid(void);
+void CPS_vAcqStart(void);
+void CPS_vAcqTrigger(void);
+bool CPS_bAcqProcess(void);
+#if CPS_ACQ_IDLEWAKE
+void CPS_vAcqWake(void);
+#endif
+#if CPS_ACQ_BENCHMARK
+void CPS_vAcqBenchmark(void);
+#endif
+
+#endif
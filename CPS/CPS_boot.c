@@ -0,0 +1,194 @@
+/** @file CPS_boot.c
+*   @brief Boot time profiler
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   The first stages of _c_int00 run before the CPU RAM has been tested and initialised. The RAM PBIST destroys
+*   whatever is in RAM and memoryInit clears it, so stamps taken before that are parked in the three PMU event
+*   counters, which are left stopped and only read and written as registers. eBOOT_RamInit then starts a fresh record
+*   and moves them over. Stamps are never taken while the RAM PBIST runs, the stack is not usable then.
+*
+*   The cycle counter is restarted by CPS_vTimeCyclesStart during vInitCPS. CPS_vBootRebase adds the count reached so
+*   far to a base that every later stamp includes, so all stamps stay on one time base (a few tens of cycles are lost
+*   per restart).
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_boot.h"
+#include "CPS_time.h"
+#include "sys_core.h"
+#include "mibspi.h"
+
+/* Defines */
+#define BOOT_SCRATCH_STAGES ((uint32_t)eBOOT_RamInit) //Stages parked in PMU event counters 0..2
+#define BOOT_RUNNING_KEY 0x52554E21u //u32BootRunning while the application is up
+#define BOOT_WDSTATUS_CLEAR 0xFFu
+
+/* Global Vars */
+__no_init xCPSBootRecord_t CPS_xBootRecord;
+
+/* Internal Vars */
+static uint32_t u32BootBase; //Cycles counted before the last restart of the cycle counter
+__no_init static uint32_t u32BootRunning; //BOOT_RUNNING_KEY once vInitCPS has completed, cleared by a warm start
+__no_init static uint32_t u32BootWarm; //1 when this boot took the warm path
+
+/* Local Function Prototypes */
+static void vBootScratchWrite(uint32_t u32Counter, uint32_t u32Value);
+static uint32_t u32BootScratchRead(uint32_t u32Counter);
+
+/* Global Functions */
+
+/* void CPS_vBootStart(void)
+*   Starts the cycle counter from 0. Called from _c_int00 as soon as the stack pointers are set up.
+*
+*/
+void CPS_vBootStart(void)
+{
+  _pmuInit_();
+  _pmuEnableCountersGlobal_();
+  _pmuResetCycleCounter_();
+  _pmuStartCounters_(pmuCYCLE_COUNTER);
+}
+
+/* void CPS_vBootStamp(xCPSBootStage_t xStage)
+*   Stamps the end of a boot stage. Each stage is stamped once per boot, later calls return straight away so it can
+*   sit in a path that runs repeatedly.
+*
+*/
+void CPS_vBootStamp(xCPSBootStage_t xStage)
+{
+  uint32_t u32Cycles = CPS_u32TimeCycles();
+  uint32_t u32Stage;
+  if((uint32_t)xStage < BOOT_SCRATCH_STAGES)
+  {
+    vBootScratchWrite((uint32_t)xStage, u32Cycles); //RAM is not usable yet, not even to read the base
+    return;
+  }
+  if(xStage == eBOOT_RamInit)
+  {
+    u32BootBase = 0u; //.bss is not cleared yet and holds the last run after a warm reset
+    CPS_xBootRecord.u32Magic = CPS_BOOT_MAGIC;
+    CPS_xBootRecord.u32Warm = u32BootWarm;
+    CPS_xBootRecord.u32Stages = 1u << eBOOT_RamInit;
+    for(u32Stage = 0u; u32Stage < (uint32_t)eBOOT_StageCount; u32Stage++)
+    {
+      CPS_xBootRecord.au32Cycles[u32Stage] = (u32Stage < BOOT_SCRATCH_STAGES) ? u32BootScratchRead(u32Stage) : 0u;
+      if(CPS_xBootRecord.au32Cycles[u32Stage] != 0u)
+      {
+        CPS_xBootRecord.u32Stages |= 1u << u32Stage; //Zero: the stage was skipped, the counters start cleared
+      }
+    }
+    CPS_xBootRecord.au32Cycles[eBOOT_RamInit] = u32Cycles;
+  }
+  else if((CPS_xBootRecord.u32Magic == CPS_BOOT_MAGIC) && ((CPS_xBootRecord.u32Stages & (1u << xStage)) == 0u))
+  {
+    u32Cycles += u32BootBase;
+    CPS_xBootRecord.au32Cycles[xStage] = u32Cycles;
+    CPS_xBootRecord.u32Stages |= 1u << xStage;
+    if(xStage == eBOOT_FirstSample)
+    {
+      CPS_xBootRecord.au32ReadyCycles[(CPS_xBootRecord.u32Warm != 0u) ? 1u : 0u] = u32Cycles;
+    }
+  }
+}
+
+/* bool CPS_bBootWarmCheck(void)
+*   Warm boot policy, called from _c_int00 after the reset cause has been decoded. A boot may go warm when it was
+*   caused by one of the CPS_BOOT_WARM_* resets, the TCRAM has not flagged any error and the RAM image was running the
+*   application when the reset hit. RAM is only read once the reset cause rules out a power on or external reset.
+*   Clears the watchdog status either way so the next reset is decoded from a clean state.
+*
+*/
+bool CPS_bBootWarmCheck(void)
+{
+  bool bWarm = false;
+  uint32_t u32Reasons = 0u;
+#if CPS_BOOT_WARM_WATCHDOG
+  u32Reasons |= WATCHDOG_STATUS;
+#endif
+#if CPS_BOOT_WARM_SOFTWARE
+  u32Reasons |= SYS_EXCEPTION & SW_RESET;
+#endif
+  if((u32Reasons != 0u) && ((tcram1REG->RAMERRSTATUS | tcram2REG->RAMERRSTATUS) == 0u))
+  {
+    bWarm = (u32BootRunning == BOOT_RUNNING_KEY);
+  }
+  WATCHDOG_STATUS = BOOT_WDSTATUS_CLEAR;
+  SYS_EXCEPTION = SW_RESET;
+  return(bWarm);
+}
+
+/* void CPS_vBootWarmStart(void)
+*   Warm path of _c_int00, run in place of everything from the ROM PBIST to the MibSPI1 parity check. RAM and the
+*   peripheral RAMs keep their contents and ECC/parity from the last run, the drivers rewrite what they use. Only the
+*   steps the rest of the start up relies on are repeated. The running key is cleared, so a reset before the
+*   application is up again boots cold.
+*
+*/
+void CPS_vBootWarmStart(void)
+{
+  _coreEnableRamEcc_();
+  u32BootRunning = 0u;
+  u32BootWarm = 1u;
+#if CPS_BOOT_PROFILE
+  CPS_vBootStamp(eBOOT_RamInit);
+#endif
+  mibspiREG1->GCR0 = 0x1U; //Same local reset release and RAM auto init as the cold path
+  while((mibspiREG1->FLG & 0x01000000U) == 0x01000000U)
+  {
+    //Wait for the MibSPI1 RAM
+  }
+}
+
+/* void CPS_vBootRunning(void)
+*   Marks the RAM image as running the application. From here on a watchdog or software reset may boot warm.
+*
+*/
+void CPS_vBootRunning(void)
+{
+  u32BootRunning = BOOT_RUNNING_KEY;
+}
+
+/* bool CPS_bBootWarm(void)
+*   True when this boot took the warm path.
+*
+*/
+bool CPS_bBootWarm(void)
+{
+  return(u32BootWarm != 0u);
+}
+
+/* void CPS_vBootRebase(void)
+*   Carries the current count into the base. Call right before the cycle counter is reset.
+*
+*/
+void CPS_vBootRebase(void)
+{
+  u32BootBase += CPS_u32TimeCycles();
+}
+
+/* Local Functions */
+
+/* void vBootScratchWrite(uint32_t u32Counter, uint32_t u32Value)
+*   Writes a PMU event counter (PMSELR, then PMXEVCNTR). The counters are never enabled, so the value holds.
+*
+*/
+static void vBootScratchWrite(uint32_t u32Counter, uint32_t u32Value)
+{
+  __asm volatile("mcr p15, #0, %0, c9, c12, #5" : : "r"(u32Counter));
+  __asm volatile("mcr p15, #0, %0, c9, c13, #2" : : "r"(u32Value));
+}
+
+/* uint32_t u32BootScratchRead(uint32_t u32Counter)
+*   Reads a PMU event counter.
+*
+*/
+static uint32_t u32BootScratchRead(uint32_t u32Counter)
+{
+  uint32_t u32Value;
+  __asm volatile("mcr p15, #0, %0, c9, c12, #5" : : "r"(u32Counter));
+  __asm volatile("mrc p15, #0, %0, c9, c13, #2" : "=r"(u32Value));
+  return(u32Value);
+}
@@ -0,0 +1,76 @@
+/** @file CPS_boot.h
+*   @brief Boot time profiler
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the boot profiler. Each stage from _c_int00 to the first classified horn sample leaves a PMU
+*   cycle stamp in CPS_xBootRecord, which sits in .noinit so it is not touched by the C start up. A debugger can read
+*   the record by symbol at any time (CPS_xBootRecord, little endian words). The only SCI port carries the SCT link,
+*   so the record is not sent out of it.
+*
+*   Stamps count CPU cycles since the cycle counter was started in _c_int00. The CPU runs from the oscillator
+*   (OSC_FREQ) until mapClocks, so eBOOT_CoreInit and eBOOT_Clocks are in oscillator cycles and everything after in
+*   HCLK cycles (CPS_TIME_CYCLES_PER_US).
+*
+*   It also holds the warm boot policy. A watchdog or software reset of a healthy running image skips the ROM and RAM
+*   PBIST, the RAM initialisation, the RAM ECC and the peripheral RAM parity tests; au32ReadyCycles keeps the time to
+*   the first classified sample of the last cold and the last warm boot for comparison.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_BOOT_H__
+#define __CPS_BOOT_H__
+
+/* Include Files */
+#include "CPS_common.h"
+#include "system.h"
+#include "reg_tcram.h"
+
+/* Defines */
+#define CPS_BOOT_PROFILE 1u //Record the boot stages in CPS_xBootRecord
+#define CPS_BOOT_MAGIC 0xB007C0DEu //CPS_xBootRecord.u32Magic once the record holds this boot
+#define CPS_BOOT_WARM 1u //1: resets selected below boot warm, 0: every reset runs the full start up self tests
+#define CPS_BOOT_WARM_WATCHDOG 1u //Digital watchdog expiry (vERROR)
+#define CPS_BOOT_WARM_SOFTWARE 1u //Software reset through SYSECR
+
+/* Global Types */
+typedef enum
+{
+  eBOOT_CoreInit, //Core registers, stacks and reset cause, just before systemInit
+  eBOOT_Clocks, //setupPLL, eFuse check, flash wait states and PLL lock (end of mapClocks)
+  eBOOT_RomPbist, //Rest of systemInit, PBIST self check and the STC/PBIST ROM tests
+  eBOOT_RamInit, //CPU RAM PBIST and memoryInit of the CPU RAM
+  eBOOT_PeriphPbist, //Dual port RAM PBIST and the RAM ECC check
+  eBOOT_PeriphInit, //Peripheral RAM auto init and parity checks
+  eBOOT_CInit, //VIM and ESM init, C start up (__cmain) up to CPS_vMain
+  eBOOT_Drivers, //CPS self checks and the HCG driver init calls in vInitCPS
+  eBOOT_Startup, //Start up time, STARTUPTIME_MS or until the horn line settles (CPS_MAIN_EARLYSTART)
+  eBOOT_FirstSample, //Up to the first classified horn sample handed to the inputs
+  eBOOT_StageCount
+} xCPSBootStage_t;
+
+typedef struct
+{
+  uint32_t u32Magic; //CPS_BOOT_MAGIC, written when the CPU RAM has been initialised
+  uint32_t u32Stages; //Bit per xCPSBootStage_t that has been stamped, stages skipped by a warm boot stay clear
+  uint32_t u32Warm; //1 when this boot took the warm path
+  uint32_t au32Cycles[eBOOT_StageCount]; //Cycles since the counter start at the end of each stage
+  uint32_t au32ReadyCycles[2]; //eBOOT_FirstSample of the last cold [0] and warm [1] boot, kept over warm resets
+} xCPSBootRecord_t;
+
+/* Global Vars */
+extern xCPSBootRecord_t CPS_xBootRecord;
+
+/* Global Function Prototypes */
+
+void CPS_vBootStart(void);
+void CPS_vBootStamp(xCPSBootStage_t xStage);
+void CPS_vBootRebase(void);
+bool CPS_bBootWarmCheck(void);
+void CPS_vBootWarmStart(void);
+void CPS_vBootRunning(void);
+bool CPS_bBootWarm(void);
+
+#endif
@@ -0,0 +1,223 @@
+/** @file CPS_calib.c
+*   @brief Persisted ADC offset and gain calibration
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Offset and gain are measured from the two bridge references of the calibration mode, which sit nominally at 3/8
+*   and 5/8 of the reference range: their mean gives the offset at mid scale and their difference the gain. The
+*   HALCoGen adcMidPointCalibration routine is not used, it converts VREFLO and VREFHI and a converter that clips at
+*   either end reports only half its offset. Measuring takes two calibration conversions, so it is done once and the
+*   result is kept in a checked record. Later boots restore the record with a single read.
+*
+*   The correction is done in software on the acquisition path, CALR is left at zero. Applying it is one multiply, one
+*   add and a shift per sample, the only division is in the one-off calibration.
+*
+*   By default the record is kept in uninitialised RAM, which memoryInit clears on every power on, so every cold boot
+*   recalibrates and warm boots keep it. With CPS_CALIB_FEE the record lives in a flash EEPROM block and only the first
+*   boot of a board calibrates. FEE block 1 is enabled in CPS.dil, but the driver and its configuration still have to
+*   be generated from it and the F021 library added to IAR/CPS.ewp before the switch can be set.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_calib.h"
+#if CPS_CALIB_FEE
+#include "ti_fee.h"
+#endif
+
+/* Defines */
+#define ADC_CALCR_CALEN 0x00000001u //Calibration mode, the converter input is the selected reference
+#define ADC_CALCR_HILO 0x00000100u
+#define ADC_CALCR_BRIDGE 0x00000200u
+#define ADC_CALCR_CALST 0x00010000u //Start, cleared by hardware when the conversion is done
+#define CALIB_BRIDGE_SPAN (((int32_t)ADC1_RESULT_MASK + 1)/4) //5/8 - 3/8 of the range
+#define CALIB_BRIDGE_SUM ((int32_t)ADC1_RESULT_MASK + 1) //5/8 + 3/8 of the range
+#define CALIB_ROUND (1 << (CPS_CALIB_FRACBITS - 1u))
+
+/* Global Vars */
+xCPSCalib_t CPS_xCalib =
+{
+  {CPS_CALIB_MAGIC, 0, CPS_CALIB_UNITY, 0u},
+  CALIB_ROUND, 0, 0
+};
+
+/* Internal Vars */
+#if !CPS_CALIB_FEE
+__no_init static xCPSCalibRecord_t xCalibStore;
+#endif
+
+/* Local Function Prototypes */
+static uint32_t u32CalibCheck(const xCPSCalibRecord_t *pxRecord);
+static bool bCalibRecordValid(const xCPSCalibRecord_t *pxRecord);
+static void vCalibUse(const xCPSCalibRecord_t *pxRecord);
+static bool bCalibLoad(xCPSCalibRecord_t *pxRecord);
+static void vCalibSave(xCPSCalibRecord_t *pxRecord);
+static uint32_t u32CalibConvert(uint32_t u32Reference);
+
+/* Global Functions */
+
+/* void CPS_vCalibInit(void)
+*   Restores the stored correction, or calibrates and stores it if there is no valid record. Falls back to raw codes
+*   when calibration fails. Call after adcInit and before the acquisition is started.
+*
+*/
+void CPS_vCalibInit(void)
+{
+  xCPSCalibRecord_t xRecord;
+  if(bCalibLoad(&xRecord) && bCalibRecordValid(&xRecord))
+  {
+    vCalibUse(&xRecord);
+    CPS_xCalib.bRestored = 1;
+    return;
+  }
+  CPS_xCalib.bRestored = 0;
+  (void)CPS_bCalibRun();
+}
+
+/* bool CPS_bCalibRun(void)
+*   Measures offset and gain, stores the record and starts using it. Returns 0 and leaves raw codes in use if the
+*   measurement is out of range. All ADC groups must be idle.
+*
+*/
+bool CPS_bCalibRun(void)
+{
+  xCPSCalibRecord_t xRecord;
+  int32_t i32High;
+  int32_t i32Low;
+  int32_t i32Offset;
+  int32_t i32Span;
+  int32_t i32Gain;
+  i32High = (int32_t)u32CalibConvert(ADC_CALCR_BRIDGE | ADC_CALCR_HILO);
+  i32Low = (int32_t)u32CalibConvert(ADC_CALCR_BRIDGE);
+  i32Offset = (CALIB_BRIDGE_SUM + 1 - (i32High + i32Low)) >> 1; //Rounded half of the distance to the ideal sum
+  i32Span = i32High - i32Low;
+  if(i32Span < 0)
+  {
+    i32Span = -i32Span; //Reference order of the bridge is not relied on
+  }
+  if(i32Span == 0)
+  {
+    i32Span = 1;
+  }
+  i32Gain = ((CALIB_BRIDGE_SPAN << CPS_CALIB_FRACBITS) + (i32Span/2))/i32Span;
+  if((i32Offset > CPS_CALIB_MAX_OFFSET) || (i32Offset < -CPS_CALIB_MAX_OFFSET) ||
+     (i32Gain < (int32_t)CPS_CALIB_MIN_GAIN) || (i32Gain > (int32_t)CPS_CALIB_MAX_GAIN))
+  {
+    xRecord.u32Magic = CPS_CALIB_MAGIC;
+    xRecord.i16Offset = 0;
+    xRecord.u16Gain = (uint16_t)CPS_CALIB_UNITY;
+    xRecord.u32Check = u32CalibCheck(&xRecord);
+    vCalibUse(&xRecord);
+    CPS_xCalib.bValid = 0;
+    return(0);
+  }
+  xRecord.u32Magic = CPS_CALIB_MAGIC;
+  xRecord.i16Offset = (int16_t)i32Offset;
+  xRecord.u16Gain = (uint16_t)i32Gain;
+  xRecord.u32Check = u32CalibCheck(&xRecord);
+  vCalibSave(&xRecord);
+  vCalibUse(&xRecord);
+  return(1);
+}
+
+/* uint16_t CPS_u16CalibRawCode(uint16_t u16Code)
+*   Inverse of CPS_u16CalibApply: the lowest raw code that corrects to u16Code or above. Used to program hardware
+*   compares that see raw results.
+*
+*/
+uint16_t CPS_u16CalibRawCode(uint16_t u16Code)
+{
+#if CPS_CALIB_ENABLE
+  int32_t i32Gain = (int32_t)CPS_xCalib.xRecord.u16Gain;
+  int32_t i32Raw = (((int32_t)u16Code << CPS_CALIB_FRACBITS) - CPS_xCalib.i32Bias + (i32Gain - 1))/i32Gain;
+  if((i32Raw < 0) || (u16Code == 0u)) //Raw codes below the corrected zero clamp to it
+  {
+    return(0u);
+  }
+  if(i32Raw > (int32_t)ADC1_RESULT_MASK)
+  {
+    return((uint16_t)ADC1_RESULT_MASK);
+  }
+  return((uint16_t)i32Raw);
+#else
+  return(u16Code);
+#endif
+}
+
+/* Local Functions */
+static uint32_t u32CalibCheck(const xCPSCalibRecord_t *pxRecord)
+{
+  return(~(pxRecord->u32Magic + (uint32_t)(uint16_t)pxRecord->i16Offset + (uint32_t)pxRecord->u16Gain));
+}
+
+static bool bCalibRecordValid(const xCPSCalibRecord_t *pxRecord)
+{
+  return((pxRecord->u32Magic == CPS_CALIB_MAGIC) && (pxRecord->u32Check == u32CalibCheck(pxRecord)) &&
+         (pxRecord->i16Offset <= CPS_CALIB_MAX_OFFSET) && (pxRecord->i16Offset >= -CPS_CALIB_MAX_OFFSET) &&
+         (pxRecord->u16Gain >= CPS_CALIB_MIN_GAIN) && (pxRecord->u16Gain <= CPS_CALIB_MAX_GAIN));
+}
+
+/* void vCalibUse(const xCPSCalibRecord_t *pxRecord)
+*   Makes the record current and folds offset, pivot and rounding into the bias term of CPS_u16CalibApply.
+*
+*/
+static void vCalibUse(const xCPSCalibRecord_t *pxRecord)
+{
+  CPS_xCalib.xRecord = *pxRecord;
+  CPS_xCalib.i32Bias = (((int32_t)pxRecord->i16Offset - (int32_t)CPS_CALIB_MIDCODE)*(int32_t)pxRecord->u16Gain) +
+                       ((int32_t)CPS_CALIB_MIDCODE << CPS_CALIB_FRACBITS) + CALIB_ROUND;
+  CPS_xCalib.bValid = 1;
+}
+
+#if CPS_CALIB_FEE
+static bool bCalibLoad(xCPSCalibRecord_t *pxRecord)
+{
+  TI_Fee_Init();
+  while(TI_Fee_GetStatus(0u) != IDLE)
+  {
+    TI_Fee_MainFunction(); //Finishes the virtual sector scan started by TI_Fee_Init
+  }
+  return(TI_Fee_ReadSync(CPS_CALIB_FEE_BLOCK, 0u, (uint8_t *)pxRecord, (uint16_t)sizeof(*pxRecord)) == E_OK);
+}
+
+static void vCalibSave(xCPSCalibRecord_t *pxRecord)
+{
+  (void)TI_Fee_WriteSync(CPS_CALIB_FEE_BLOCK, (uint8_t *)pxRecord); //On failure the next boot simply recalibrates
+}
+#else
+static bool bCalibLoad(xCPSCalibRecord_t *pxRecord)
+{
+  *pxRecord = xCalibStore;
+  return(1);
+}
+
+static void vCalibSave(xCPSCalibRecord_t *pxRecord)
+{
+  xCalibStore = *pxRecord;
+}
+#endif
+
+/* uint32_t u32CalibConvert(uint32_t u32Reference)
+*   One calibration mode conversion of the reference selected by the HILO and BRIDGE bits, same sequence as the
+*   HALCoGen calibration routines.
+*
+*/
+static uint32_t u32CalibConvert(uint32_t u32Reference)
+{
+  uint32_t u32Mode = adcREG1->OPMODECR;
+  uint32_t u32Result;
+  adcREG1->OPMODECR |= 0x80000000u; //12 bit
+  adcREG1->CALCR = u32Reference;
+  adcREG1->CALCR |= ADC_CALCR_CALEN;
+  adcREG1->CALCR |= ADC_CALCR_CALST;
+  while((adcREG1->CALCR & ADC_CALCR_CALST) != 0u)
+  {
+    //Wait for the calibration conversion
+  }
+  u32Result = adcREG1->CALR & ADC1_RESULT_MASK;
+  adcREG1->CALCR = 0u;
+  adcREG1->CALR = 0u;
+  adcREG1->OPMODECR = u32Mode;
+  return(u32Result);
+}
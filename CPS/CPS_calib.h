@@ -0,0 +1,84 @@
+/** @file CPS_calib.h
+*   @brief Persisted ADC offset and gain calibration
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface used to calibrate the MibADC once, keep the correction in non-volatile storage
+*   and apply it to every sample. The band limits in CPS_classify.h are in corrected codes.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_CALIB_H__
+#define __CPS_CALIB_H__
+
+/* Include Files */
+#include "CPS_common.h"
+
+/* Defines */
+#define CPS_CALIB_ENABLE 1u //Set to 0 to pass raw codes straight through
+
+#ifndef CPS_CALIB_FEE
+#define CPS_CALIB_FEE 0u //Keep the record in flash EEPROM. Needs the HALCoGen FEE driver and the F021 library linked.
+#endif
+#define CPS_CALIB_FEE_BLOCK 1u //FEE block number of the calibration record
+#define CPS_CALIB_MAGIC 0xCA1B0001u //Changes with the record layout
+
+#define CPS_CALIB_FRACBITS 15u
+#define CPS_CALIB_UNITY (1u << CPS_CALIB_FRACBITS) //Gain of 1.0
+#define CPS_CALIB_MIDCODE 0x7FFu //Pivot of the gain correction, where the offset is measured
+#define CPS_CALIB_MAX_OFFSET 64 //Larger measured corrections are taken as a failed calibration
+#define CPS_CALIB_MIN_GAIN 30802u //0.94
+#define CPS_CALIB_MAX_GAIN 34734u //1.06
+
+/* Global Types */
+typedef struct
+{
+  uint32_t u32Magic;
+  int16_t i16Offset; //Codes added to the raw result
+  uint16_t u16Gain; //Scale about CPS_CALIB_MIDCODE, CPS_CALIB_UNITY = 1.0
+  uint32_t u32Check; //Complement of the sum of the fields above
+} xCPSCalibRecord_t;
+
+typedef struct
+{
+  xCPSCalibRecord_t xRecord; //Correction in use
+  int32_t i32Bias; //Offset, pivot and rounding folded into one term, see CPS_u16CalibApply
+  bool bRestored; //1 when the record came from storage at boot
+  bool bValid; //0 when calibration failed and raw codes are used
+} xCPSCalib_t;
+
+/* Global Vars */
+extern xCPSCalib_t CPS_xCalib;
+
+/* Global Function Prototypes */
+
+void CPS_vCalibInit(void);
+bool CPS_bCalibRun(void);
+uint16_t CPS_u16CalibRawCode(uint16_t u16Code);
+
+/* uint16_t CPS_u16CalibApply(uint16_t u16Raw)
+*   Corrects one raw ADC code: ((raw + offset - mid)*gain >> 15) + mid, folded to one multiply-add and a shift.
+*   The result is clamped to the converter range.
+*
+*/
+static inline uint16_t CPS_u16CalibApply(uint16_t u16Raw)
+{
+#if CPS_CALIB_ENABLE
+  int32_t i32Code = (((int32_t)u16Raw*(int32_t)CPS_xCalib.xRecord.u16Gain) + CPS_xCalib.i32Bias) >> CPS_CALIB_FRACBITS;
+  if(i32Code < 0)
+  {
+    return(0u);
+  }
+  if(i32Code > (int32_t)ADC1_RESULT_MASK)
+  {
+    return((uint16_t)ADC1_RESULT_MASK);
+  }
+  return((uint16_t)i32Code);
+#else
+  return(u16Raw);
+#endif
+}
+
+#endif
@@ -0,0 +1,142 @@
+/** @file CPS_classify.c
+*   @brief ADC band classifier table
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Holds the 4096 entry classification table of every resistor ladder. The tables are generated by the preprocessor
+*   from the band limits in CPS_classify.h and live in flash. The original comparison chain is kept as the reference
+*   the boot self check holds the horn wire table against.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_classify.h"
+
+/* Defines */
+#define CLASS_HORN(c) ((uint8_t)(((c) < ADC_LOWERBOUND_HORNON) ? eCMD_Null : \
+                                 ((c) <= ADC_UPPERBOUND_HORNON) ? eCMD_HornOn : \
+                                 ((c) <= ADC_UPPERBOUND_SHFTDN) ? eCMD_ShiftDown : \
+                                 ((c) <= ADC_UPPERBOUND_SHFTUP) ? eCMD_ShiftUp : eCMD_Null))
+#define CLASS_PADDLE(c) ((uint8_t)(((c) < ADC_LOWERBOUND_PADDN) ? eCMD_Null : \
+                                   ((c) <= ADC_UPPERBOUND_PADDN) ? eCMD_ShiftDown : \
+                                   ((c) <= ADC_UPPERBOUND_PADUP) ? eCMD_ShiftUp : eCMD_Null))
+#define CLASS4(f, c) f(c), f((c) + 1u), f((c) + 2u), f((c) + 3u) //f is the band macro of the ladder
+#define CLASS16(f, c) CLASS4(f, c), CLASS4(f, (c) + 4u), CLASS4(f, (c) + 8u), CLASS4(f, (c) + 12u)
+#define CLASS64(f, c) CLASS16(f, c), CLASS16(f, (c) + 16u), CLASS16(f, (c) + 32u), CLASS16(f, (c) + 48u)
+#define CLASS256(f, c) CLASS64(f, c), CLASS64(f, (c) + 64u), CLASS64(f, (c) + 128u), CLASS64(f, (c) + 192u)
+#define CLASS1024(f, c) CLASS256(f, c), CLASS256(f, (c) + 256u), CLASS256(f, (c) + 512u), CLASS256(f, (c) + 768u)
+#define CLASS4096(f) CLASS1024(f, 0u), CLASS1024(f, 1024u), CLASS1024(f, 2048u), CLASS1024(f, 3072u)
+
+/* Global Vars */
+const xCPSADCBand_t CPS_axADCBands[] =
+{
+  {ADC_LOWERBOUND_HORNON, ADC_UPPERBOUND_HORNON, eCMD_HornOn},
+  {ADC_LOWERBOUND_SHFTDN, ADC_UPPERBOUND_SHFTDN, eCMD_ShiftDown},
+  {ADC_LOWERBOUND_SHFTUP, ADC_UPPERBOUND_SHFTUP, eCMD_ShiftUp}
+};
+const uint32_t CPS_u32ADCBandCount = sizeof(CPS_axADCBands)/sizeof(CPS_axADCBands[0]);
+
+const uint8_t CPS_au8ADCClassTable[ADC_CODES] =
+{
+  CLASS4096(CLASS_HORN)
+};
+
+const xCPSADCBand_t CPS_axADCPaddleBands[] =
+{
+  {ADC_LOWERBOUND_PADDN, ADC_UPPERBOUND_PADDN, eCMD_ShiftDown},
+  {ADC_LOWERBOUND_PADUP, ADC_UPPERBOUND_PADUP, eCMD_ShiftUp}
+};
+
+const uint8_t CPS_au8ADCPaddleTable[ADC_CODES] =
+{
+  CLASS4096(CLASS_PADDLE)
+};
+
+const xCPSADCLadder_t CPS_xADCLadderHorn = {CPS_axADCBands, sizeof(CPS_axADCBands)/sizeof(CPS_axADCBands[0]),
+                                            CPS_au8ADCClassTable};
+const xCPSADCLadder_t CPS_xADCLadderPaddle = {CPS_axADCPaddleBands,
+                                              sizeof(CPS_axADCPaddleBands)/sizeof(CPS_axADCPaddleBands[0]),
+                                              CPS_au8ADCPaddleTable};
+
+/* Local Function Prototypes */
+static xHornCommands_t ProcessADCData(uint16_t u16Data);
+
+/* Global Functions */
+
+/* bool CPS_bClassifySelfCheck(void)
+*   Walks every converter code and checks that the horn wire table matches the reference comparison chain, then
+*   checks every ladder against its band list. Returns 1 when they all match.
+*
+*/
+bool CPS_bClassifySelfCheck(void)
+{
+  for(uint32_t u32Code = 0u; u32Code < ADC_CODES; u32Code++)
+  {
+    if(CPS_xClassify(u32Code) != ProcessADCData((uint16_t)u32Code))
+    {
+      return(0);
+    }
+  }
+  return(CPS_bClassifyLadderCheck(&CPS_xADCLadderHorn) && CPS_bClassifyLadderCheck(&CPS_xADCLadderPaddle));
+}
+
+/* bool CPS_bClassifyLadderCheck(const xCPSADCLadder_t *pxLadder)
+*   Checks that the bands of a ladder are listed low to high without overlap and that its table gives the band
+*   command for every code inside a band and eCMD_Null for every other code. Returns 1 when it does.
+*
+*/
+bool CPS_bClassifyLadderCheck(const xCPSADCLadder_t *pxLadder)
+{
+  xHornCommands_t xBandCommand;
+  for(uint32_t u32Band = 1u; u32Band < pxLadder->u32BandCount; u32Band++)
+  {
+    if(pxLadder->pxBands[u32Band].u16Lower <= pxLadder->pxBands[u32Band - 1u].u16Upper)
+    {
+      return(0);
+    }
+  }
+  for(uint32_t u32Code = 0u; u32Code < ADC_CODES; u32Code++)
+  {
+    xBandCommand = eCMD_Null;
+    for(uint32_t u32Band = 0u; u32Band < pxLadder->u32BandCount; u32Band++)
+    {
+      if((u32Code >= pxLadder->pxBands[u32Band].u16Lower) && (u32Code <= pxLadder->pxBands[u32Band].u16Upper))
+      {
+        xBandCommand = pxLadder->pxBands[u32Band].xCommand;
+      }
+    }
+    if(pxLadder->pu8ClassTable[u32Code] != (uint8_t)xBandCommand)
+    {
+      return(0);
+    }
+  }
+  return(1);
+}
+
+/* Local Functions */
+static xHornCommands_t ProcessADCData(uint16_t u16Data)
+{
+  if(u16Data <= ADC_UPPERBOUND_HORNON) //Is this a horn depressed signal?
+  {
+    if(u16Data >= ADC_LOWERBOUND_HORNON)
+    {
+      return(eCMD_HornOn);
+    }
+  }
+  if(u16Data <= ADC_UPPERBOUND_SHFTUP) //Is this a shift up signal?
+  {
+    if(u16Data >= ADC_LOWERBOUND_SHFTUP)
+    {
+      return(eCMD_ShiftUp);
+    }
+  }
+  if(u16Data <= ADC_UPPERBOUND_SHFTDN) //Is this a shift down signal?
+  {
+    if(u16Data >= ADC_LOWERBOUND_SHFTDN)
+    {
+      return(eCMD_ShiftDown);
+    }
+  }
+  return (eCMD_Null); //Not an active signal
+}
@@ -0,0 +1,94 @@
+/** @file CPS_classify.h
+*   @brief ADC band definitions and sample classifier
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   The voltage bands of every resistor ladder are defined once here. Each ladder's classifier table in CPS_classify.c
+*   is expanded from them at compile time, so the ISR classifies a sample with a single indexed load. An acquisition
+*   channel points at the ladder it is wired to, see CPS_axAcqChannels.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_CLASSIFY_H__
+#define __CPS_CLASSIFY_H__
+
+/* Include Files */
+#include "CPS_main.h"
+
+/* Defines */
+#define CPS_CLASSIFY_SELFCHECK 0u //Walk every code against the reference chain at boot, HOST_classify does on the host
+
+#define ADC_CODES 4096u //12-bit converter
+#define ADC_CODEMASK (ADC_CODES - 1u)
+
+#define ADC_UPPERBOUND_SHFTUP 0x0C1Fu //These definitions set the limits for the ADC conversion to trigger a shift or horn signal.
+#define ADC_LOWERBOUND_SHFTUP 0x0747u //Bands must be listed low to high, touch each other and not overlap. Codes above the
+#define ADC_UPPERBOUND_SHFTDN 0x0746u //last band and below the first band classify as eCMD_Null.
+#define ADC_LOWERBOUND_SHFTDN 0x0251u
+#define ADC_UPPERBOUND_HORNON 0x0250u
+#define ADC_LOWERBOUND_HORNON 0x0000u
+
+#define ADC_UPPERBOUND_PADUP 0x0BFFu //Paddle ladder of the newer wheels, which leave only the horn on the horn wire.
+#define ADC_LOWERBOUND_PADUP 0x0800u //Same rules as above; codes below the shift down band are a short to ground.
+#define ADC_UPPERBOUND_PADDN 0x07FFu
+#define ADC_LOWERBOUND_PADDN 0x0100u
+
+/* Build time band checks */
+#if (ADC_LOWERBOUND_HORNON > ADC_UPPERBOUND_HORNON) || (ADC_LOWERBOUND_SHFTDN > ADC_UPPERBOUND_SHFTDN) || \
+    (ADC_LOWERBOUND_SHFTUP > ADC_UPPERBOUND_SHFTUP)
+#error "ADC band with lower bound above its upper bound"
+#endif
+#if (ADC_LOWERBOUND_SHFTDN <= ADC_UPPERBOUND_HORNON) || (ADC_LOWERBOUND_SHFTUP <= ADC_UPPERBOUND_SHFTDN)
+#error "Overlapping ADC bands"
+#endif
+#if (ADC_LOWERBOUND_SHFTDN != (ADC_UPPERBOUND_HORNON + 1u)) || (ADC_LOWERBOUND_SHFTUP != (ADC_UPPERBOUND_SHFTDN + 1u))
+#error "Gap between ADC bands"
+#endif
+#if (ADC_UPPERBOUND_SHFTUP >= ADC_CODES)
+#error "ADC band outside of the converter range"
+#endif
+#if (ADC_LOWERBOUND_PADDN > ADC_UPPERBOUND_PADDN) || (ADC_LOWERBOUND_PADUP > ADC_UPPERBOUND_PADUP)
+#error "Paddle ladder band with lower bound above its upper bound"
+#endif
+#if (ADC_LOWERBOUND_PADUP != (ADC_UPPERBOUND_PADDN + 1u)) || (ADC_UPPERBOUND_PADUP >= ADC_CODES)
+#error "Paddle ladder bands must touch and stay inside the converter range"
+#endif
+
+/* Global Types */
+typedef struct
+{
+  uint16_t u16Lower;
+  uint16_t u16Upper;
+  xHornCommands_t xCommand;
+} xCPSADCBand_t;
+
+typedef struct
+{
+  const xCPSADCBand_t *pxBands; //Low to high
+  uint32_t u32BandCount;
+  const uint8_t *pu8ClassTable; //ADC_CODES entries expanded from the same bands
+} xCPSADCLadder_t;
+
+/* Global Vars */
+extern const xCPSADCBand_t CPS_axADCBands[];
+extern const uint32_t CPS_u32ADCBandCount;
+extern const uint8_t CPS_au8ADCClassTable[ADC_CODES];
+extern const xCPSADCBand_t CPS_axADCPaddleBands[];
+extern const uint8_t CPS_au8ADCPaddleTable[ADC_CODES];
+extern const xCPSADCLadder_t CPS_xADCLadderHorn; //Horn and paddles on the horn wire, the bands above
+extern const xCPSADCLadder_t CPS_xADCLadderPaddle; //Paddle ladder of the newer wheels
+
+/* Global Function Prototypes */
+
+bool CPS_bClassifySelfCheck(void);
+bool CPS_bClassifyLadderCheck(const xCPSADCLadder_t *pxLadder);
+
+/* xHornCommands_t CPS_xClassify(uint16_t u16Data)
+*   Classifies one raw ADC code. Upper bits above the converter resolution are ignored.
+*
+*/
+#define CPS_xClassify(u16Data) ((xHornCommands_t)CPS_au8ADCClassTable[(uint32_t)(u16Data) & ADC_CODEMASK])
+
+#endif
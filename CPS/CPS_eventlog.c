@@ -0,0 +1,123 @@
+/** @file CPS_eventlog.c
+*   @brief Timestamped event log for horn and paddle decisions
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   The ring has one producer (the CPS ISRs, which do not nest) and one consumer (the main loop). The producer only
+*   writes u32Head and the consumer only writes u32Tail, so neither side ever waits or masks interrupts. A full ring
+*   drops the new record and counts it instead of overwriting data the consumer may be reading. Both sides run on the
+*   same core, so the volatile index accesses are enough to order the record stores against the index update.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_eventlog.h"
+
+/* Defines */
+#define EVENTLOG_MASK (CPS_EVENTLOG_SIZE - 1u)
+#define EVENTHISTORY_MASK (CPS_EVENTLOG_HISTORY - 1u)
+
+/* Global Vars */
+xCPSEvent_t CPS_axEventHistory[CPS_EVENTLOG_HISTORY];
+uint32_t CPS_u32EventHistoryIndex;
+xCPSEventLogStats_t CPS_xEventLogStats;
+
+/* Internal Vars */
+static xCPSEvent_t axEventRing[CPS_EVENTLOG_SIZE];
+static volatile uint32_t u32Head; //Free running, written by the producer only
+static volatile uint32_t u32Tail; //Free running, written by the consumer only
+
+/* Local Function Prototypes */
+static void vHistoryAdd(const xCPSEvent_t *pxEvent);
+
+/* Global Functions */
+
+/* void CPS_vEventLogReset(void)
+*   Empties the ring and the history. Call before the CPS interrupts are enabled.
+*
+*/
+void CPS_vEventLogReset(void)
+{
+  u32Head = 0u;
+  u32Tail = 0u;
+  CPS_u32EventHistoryIndex = 0u;
+  CPS_xEventLogStats.u32Posted = 0u;
+  CPS_xEventLogStats.u32Overflows = 0u;
+  CPS_xEventLogStats.u32MaxFill = 0u;
+}
+
+/* void CPS_vEventLogPost(xCPSEventType_t xType, uint32_t u32Data, uint32_t u32Value)
+*   Producer side, ISR context only. Stamps and queues one record, or counts an overflow when the ring is full.
+*
+*/
+void CPS_vEventLogPost(xCPSEventType_t xType, uint32_t u32Data, uint32_t u32Value)
+{
+  uint32_t u32Stamp = rtiREG1->CNT[0u].FRCx;
+  uint32_t u32HeadNow = u32Head;
+  uint32_t u32Fill = u32HeadNow - u32Tail;
+  xCPSEvent_t *pxEvent;
+  if(u32Fill >= CPS_EVENTLOG_SIZE)
+  {
+    CPS_xEventLogStats.u32Overflows++;
+    return;
+  }
+  pxEvent = &axEventRing[u32HeadNow & EVENTLOG_MASK];
+  pxEvent->u32Stamp = u32Stamp;
+  pxEvent->u8Type = (uint8_t)xType;
+  pxEvent->u8Data = (uint8_t)u32Data;
+  pxEvent->u16Value = (uint16_t)u32Value;
+  u32Head = u32HeadNow + 1u; //Publish the record
+  CPS_xEventLogStats.u32Posted++;
+  if((u32Fill + 1u) > CPS_xEventLogStats.u32MaxFill)
+  {
+    CPS_xEventLogStats.u32MaxFill = u32Fill + 1u;
+  }
+}
+
+/* void CPS_vEventLogDrain(void)
+*   Consumer side, main loop only. Moves every waiting record into the history.
+*
+*/
+void CPS_vEventLogDrain(void)
+{
+  uint32_t u32TailNow = u32Tail;
+  uint32_t u32HeadNow = u32Head;
+  while(u32TailNow != u32HeadNow)
+  {
+    vHistoryAdd(&axEventRing[u32TailNow & EVENTLOG_MASK]);
+    u32TailNow++;
+  }
+  u32Tail = u32TailNow; //Hand the slots back to the producer
+}
+
+/* void CPS_vEventLogPostMain(xCPSEventType_t xType, uint32_t u32Data, uint32_t u32Value)
+*   Records an event raised by the main loop itself. It is the consumer, so it writes the history directly. Drain the
+*   ring first so the history stays in time order.
+*
+*/
+void CPS_vEventLogPostMain(xCPSEventType_t xType, uint32_t u32Data, uint32_t u32Value)
+{
+  xCPSEvent_t xEvent;
+  xEvent.u32Stamp = rtiREG1->CNT[0u].FRCx;
+  xEvent.u8Type = (uint8_t)xType;
+  xEvent.u8Data = (uint8_t)u32Data;
+  xEvent.u16Value = (uint16_t)u32Value;
+  vHistoryAdd(&xEvent);
+}
+
+/* bool CPS_bEventLogEmpty(void)
+*   Returns 1 when the ring holds no undrained records.
+*
+*/
+bool CPS_bEventLogEmpty(void)
+{
+  return(u32Head == u32Tail);
+}
+
+/* Local Functions */
+static void vHistoryAdd(const xCPSEvent_t *pxEvent)
+{
+  CPS_axEventHistory[CPS_u32EventHistoryIndex & EVENTHISTORY_MASK] = *pxEvent;
+  CPS_u32EventHistoryIndex++;
+}
@@ -0,0 +1,73 @@
+/** @file CPS_eventlog.h
+*   @brief Timestamped event log for horn and paddle decisions
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface of the decision/output event log. The ISRs post records into a single
+*   producer/single consumer ring; the main loop drains the ring into CPS_axEventHistory, where it also records the
+*   moment each output pin actually moved. Every record carries the RTI FRC0 value (100ns per count).
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_EVENTLOG_H__
+#define __CPS_EVENTLOG_H__
+
+/* Include Files */
+#include "CPS_common.h"
+
+/* Defines */
+#define CPS_EVENTLOG_ENABLE 1u
+
+#define CPS_EVENTLOG_SIZE 256u //Ring entries, power of two
+#define CPS_EVENTLOG_HISTORY 64u //Drained records kept for the debugger, power of two
+
+#if (CPS_EVENTLOG_SIZE & (CPS_EVENTLOG_SIZE - 1u)) != 0u
+#error "CPS_EVENTLOG_SIZE must be a power of two"
+#endif
+#if (CPS_EVENTLOG_HISTORY & (CPS_EVENTLOG_HISTORY - 1u)) != 0u
+#error "CPS_EVENTLOG_HISTORY must be a power of two"
+#endif
+#if ((CPS_EVENTLOG_SIZE + CPS_EVENTLOG_HISTORY)*8u) > 0x1000u
+#error "Event log does not fit its 4kB share of the RAM region"
+#endif
+
+/* Global Types */
+typedef enum
+{
+  eEVT_Band, //Classified band changed. Data: new band, Value: filtered ADC code
+  eEVT_Decision, //A command was accepted by the hold counters. Data: command, Value: filtered ADC code
+  eEVT_Request, //Requested output image changed (vSendCommand). Value: new image
+  eEVT_Output //Output pins were written (main loop). Value: image now on the pins
+} xCPSEventType_t;
+
+typedef struct
+{
+  uint32_t u32Stamp; //RTI FRC0 at the time of the event
+  uint8_t u8Type; //xCPSEventType_t
+  uint8_t u8Data;
+  uint16_t u16Value;
+} xCPSEvent_t;
+
+typedef struct
+{
+  uint32_t u32Posted; //Records accepted into the ring
+  uint32_t u32Overflows; //Records dropped because the ring was full
+  uint32_t u32MaxFill; //Highest number of records waiting to be drained
+} xCPSEventLogStats_t;
+
+/* Global Vars */
+extern xCPSEvent_t CPS_axEventHistory[CPS_EVENTLOG_HISTORY];
+extern uint32_t CPS_u32EventHistoryIndex; //Total records written to the history, newest is at (index-1) & (size-1)
+extern xCPSEventLogStats_t CPS_xEventLogStats;
+
+/* Global Function Prototypes */
+
+void CPS_vEventLogReset(void);
+void CPS_vEventLogPost(xCPSEventType_t xType, uint32_t u32Data, uint32_t u32Value);
+void CPS_vEventLogDrain(void);
+void CPS_vEventLogPostMain(xCPSEventType_t xType, uint32_t u32Data, uint32_t u32Value);
+bool CPS_bEventLogEmpty(void);
+
+#endif
@@ -0,0 +1,243 @@
+/** @file CPS_filter.c
+*   @brief Oversampling and decimation filter for the horn wire samples
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   The ADC runs faster than the classifier needs. Each filter takes the raw conversions one at a time and produces a
+*   decimated sample at the end of every output period, so noise is removed before classification instead of being
+*   voted out by the consecutive sample counters. The boot benchmark runs every filter type over the same synthetic
+*   input and records the PMU cycles spent per conversion.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_filter.h"
+#include "CPS_profile.h"
+
+/* Defines */
+#define FILTER_BENCH_NOISE 0x3Fu //Peak to peak noise added to the synthetic input
+#define FILTER_BENCH_SPIKEEVERY 37u //One full scale spike every this many conversions
+#define FILTER_BENCH_STEPEVERY 32u //Conversions between level changes
+
+/* Internal Types */
+typedef struct
+{
+  uint32_t u32Phase; //Conversions taken in the current output period
+  uint32_t u32Sum; //Boxcar accumulator
+  uint32_t u32IIR; //IIR state with CPS_FILTER_IIR_FRACBITS fraction bits
+  uint32_t u32MedianIndex; //Next slot to overwrite in the median window
+  uint16_t au16Median[CPS_FILTER_MEDIAN_TAPS];
+  bool bPrimed; //Window and IIR state hold real samples
+} xFilterState_t;
+
+typedef bool (*xFilterFunction_t)(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered);
+
+/* Global Vars */
+#if CPS_FILTER_BENCHMARK
+xCPSFilterBenchmark_t CPS_axFilterBenchmark[CPS_FILTER_IIR + 1u];
+#endif
+
+/* Internal Vars */
+static xFilterState_t axFilterState[CPS_ACQ_CHANNELS];
+
+/* Local Function Prototypes */
+static void vFilterStateReset(xFilterState_t *pxState);
+#if CPS_FILTER_BENCHMARK || (CPS_FILTER_TYPE == CPS_FILTER_NONE)
+static bool bFilterNone(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered);
+#endif
+#if CPS_FILTER_BENCHMARK || (CPS_FILTER_TYPE == CPS_FILTER_BOXCAR)
+static bool bFilterBoxcar(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered);
+#endif
+#if CPS_FILTER_BENCHMARK || (CPS_FILTER_TYPE == CPS_FILTER_MEDIAN)
+static bool bFilterMedian(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered);
+#endif
+#if CPS_FILTER_BENCHMARK || (CPS_FILTER_TYPE == CPS_FILTER_IIR)
+static bool bFilterIIR(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered);
+#endif
+
+/* Global Functions */
+
+/* void CPS_vFilterReset(void)
+*   Drops the filter history of every slot. The next conversion primes the filters again.
+*
+*/
+void CPS_vFilterReset(void)
+{
+  for(uint32_t u32Slot = 0u; u32Slot < CPS_ACQ_CHANNELS; u32Slot++)
+  {
+    vFilterStateReset(&axFilterState[u32Slot]);
+  }
+}
+
+/* bool CPS_bFilterPut(uint32_t u32Slot, uint16_t u16Raw, uint16_t *pu16Filtered)
+*   Feeds one raw conversion of an acquisition slot into the selected filter. Returns 1 and writes *pu16Filtered when
+*   an output period has completed. Called from the ADC ISR only.
+*
+*/
+bool CPS_bFilterPut(uint32_t u32Slot, uint16_t u16Raw, uint16_t *pu16Filtered)
+{
+  xFilterState_t *pxState = &axFilterState[u32Slot];
+#if CPS_FILTER_TYPE == CPS_FILTER_BOXCAR
+  return(bFilterBoxcar(pxState, u16Raw, pu16Filtered));
+#elif CPS_FILTER_TYPE == CPS_FILTER_MEDIAN
+  return(bFilterMedian(pxState, u16Raw, pu16Filtered));
+#elif CPS_FILTER_TYPE == CPS_FILTER_IIR
+  return(bFilterIIR(pxState, u16Raw, pu16Filtered));
+#else
+  return(bFilterNone(pxState, u16Raw, pu16Filtered));
+#endif
+}
+
+#if CPS_FILTER_BENCHMARK
+/* void CPS_vFilterBenchmark(void)
+*   Runs every filter type over the same stepped, noisy input with occasional spikes and stores the mean and worst
+*   PMU cycles per conversion in CPS_axFilterBenchmark. Must run with interrupts disabled so the figures are clean.
+*
+*/
+void CPS_vFilterBenchmark(void)
+{
+  static const xFilterFunction_t axFilters[CPS_FILTER_IIR + 1u] = {bFilterNone, bFilterBoxcar, bFilterMedian, bFilterIIR};
+  static const uint16_t au16Levels[4u] = {0x0128u, 0x04CCu, 0x0980u, 0x0F00u}; //Horn, shift down, shift up, idle
+  xFilterState_t xBenchState;
+  xCPSProfile_t xProfile;
+  uint32_t u32Noise;
+  uint32_t u32Raw;
+  uint32_t u32Start;
+  uint16_t u16Filtered;
+  CPS_vProfileInit();
+  for(uint32_t u32Type = 0u; u32Type <= CPS_FILTER_IIR; u32Type++)
+  {
+    vFilterStateReset(&xBenchState);
+    CPS_vProfileReset(&xProfile);
+    u32Noise = 0x1234u; //Same input sequence for every filter
+    for(uint32_t u32Sample = 0u; u32Sample < CPS_FILTER_BENCHMARK_SAMPLES; u32Sample++)
+    {
+      u32Noise = (u32Noise*1103515245u) + 12345u;
+      u32Raw = au16Levels[(u32Sample/FILTER_BENCH_STEPEVERY) & 3u] + ((u32Noise >> 16u) & FILTER_BENCH_NOISE);
+      if((u32Sample % FILTER_BENCH_SPIKEEVERY) == 0u)
+      {
+        u32Raw = 0x0FFFu;
+      }
+      u32Start = CPS_u32ProfileCycles();
+      (void)axFilters[u32Type](&xBenchState, (uint16_t)u32Raw, &u16Filtered);
+      CPS_vProfileAdd(&xProfile, CPS_u32ProfileCycles() - u32Start);
+    }
+    CPS_axFilterBenchmark[u32Type].u32CyclesPerSample = (uint32_t)(xProfile.u64TotalCycles/xProfile.u32Count);
+    CPS_axFilterBenchmark[u32Type].u32MaxCycles = xProfile.u32MaxCycles;
+  }
+}
+#endif
+
+/* Local Functions */
+static void vFilterStateReset(xFilterState_t *pxState)
+{
+  pxState->u32Phase = 0u;
+  pxState->u32Sum = 0u;
+  pxState->u32IIR = 0u;
+  pxState->u32MedianIndex = 0u;
+  pxState->bPrimed = 0;
+}
+
+#if CPS_FILTER_BENCHMARK || (CPS_FILTER_TYPE == CPS_FILTER_NONE)
+static bool bFilterNone(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered)
+{
+  (void)pxState;
+  *pu16Filtered = u16Raw;
+  return(1);
+}
+#endif
+
+#if CPS_FILTER_BENCHMARK || (CPS_FILTER_TYPE == CPS_FILTER_BOXCAR)
+/* bool bFilterBoxcar(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered)
+*   Block average of each output period. Decimation is a power of two so the divide is a shift.
+*
+*/
+static bool bFilterBoxcar(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered)
+{
+  pxState->u32Sum += u16Raw;
+  pxState->u32Phase++;
+  if(pxState->u32Phase < CPS_FILTER_DECIMATION)
+  {
+    return(0);
+  }
+  *pu16Filtered = (uint16_t)(pxState->u32Sum/CPS_FILTER_DECIMATION);
+  pxState->u32Sum = 0u;
+  pxState->u32Phase = 0u;
+  return(1);
+}
+#endif
+
+#if CPS_FILTER_BENCHMARK || (CPS_FILTER_TYPE == CPS_FILTER_MEDIAN)
+/* bool bFilterMedian(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered)
+*   Keeps the last CPS_FILTER_MEDIAN_TAPS conversions and sorts a copy of them once per output period. In batch mode
+*   the window is the whole batch; with an even count the lower middle value is taken, never the mean of the two, so
+*   a step inside the batch gives one of the two levels and not a code between them in another band.
+*
+*/
+static bool bFilterMedian(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered)
+{
+  uint16_t au16Sorted[CPS_FILTER_MEDIAN_TAPS];
+  uint16_t u16Value;
+  uint32_t u32Slot;
+  if(!pxState->bPrimed) //Fill the whole window with the first conversion so no zeros are voted in
+  {
+    for(u32Slot = 0u; u32Slot < CPS_FILTER_MEDIAN_TAPS; u32Slot++)
+    {
+      pxState->au16Median[u32Slot] = u16Raw;
+    }
+    pxState->bPrimed = 1;
+  }
+  pxState->au16Median[pxState->u32MedianIndex] = u16Raw;
+  pxState->u32MedianIndex++;
+  if(pxState->u32MedianIndex >= CPS_FILTER_MEDIAN_TAPS)
+  {
+    pxState->u32MedianIndex = 0u;
+  }
+  pxState->u32Phase++;
+  if(pxState->u32Phase < CPS_FILTER_DECIMATION)
+  {
+    return(0);
+  }
+  pxState->u32Phase = 0u;
+  for(u32Slot = 0u; u32Slot < CPS_FILTER_MEDIAN_TAPS; u32Slot++) //Insertion sort, at most 16 entries
+  {
+    u16Value = pxState->au16Median[u32Slot];
+    uint32_t u32Insert = u32Slot;
+    while((u32Insert > 0u) && (au16Sorted[u32Insert - 1u] > u16Value))
+    {
+      au16Sorted[u32Insert] = au16Sorted[u32Insert - 1u];
+      u32Insert--;
+    }
+    au16Sorted[u32Insert] = u16Value;
+  }
+  *pu16Filtered = au16Sorted[(CPS_FILTER_MEDIAN_TAPS - 1u)/2u];
+  return(1);
+}
+#endif
+
+#if CPS_FILTER_BENCHMARK || (CPS_FILTER_TYPE == CPS_FILTER_IIR)
+/* bool bFilterIIR(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered)
+*   First order low pass on every conversion, the state is read out once per output period.
+*
+*/
+static bool bFilterIIR(xFilterState_t *pxState, uint16_t u16Raw, uint16_t *pu16Filtered)
+{
+  int32_t s32Error;
+  if(!pxState->bPrimed) //Start from the first conversion instead of ramping up from zero
+  {
+    pxState->u32IIR = (uint32_t)u16Raw << CPS_FILTER_IIR_FRACBITS;
+    pxState->bPrimed = 1;
+  }
+  s32Error = (int32_t)((uint32_t)u16Raw << CPS_FILTER_IIR_FRACBITS) - (int32_t)pxState->u32IIR;
+  pxState->u32IIR = (uint32_t)((int32_t)pxState->u32IIR + (s32Error >> CPS_FILTER_IIR_SHIFT)); //Arithmetic shift keeps the sign
+  pxState->u32Phase++;
+  if(pxState->u32Phase < CPS_FILTER_DECIMATION)
+  {
+    return(0);
+  }
+  pxState->u32Phase = 0u;
+  *pu16Filtered = (uint16_t)((pxState->u32IIR + (1u << (CPS_FILTER_IIR_FRACBITS - 1u))) >> CPS_FILTER_IIR_FRACBITS);
+  return(1);
+}
+#endif
@@ -0,0 +1,90 @@
+/** @file CPS_filter.h
+*   @brief Oversampling and decimation filter for the horn wire samples
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the filter stage that sits between the ADC and the classifier. Raw conversions arrive every
+*   CPS_FILTER_SAMPLE_US and one filtered sample is handed to the classifier every CPS_FILTER_DECIMATION conversions.
+*   Every acquisition slot has its own filter state. All filters use integer math only.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_FILTER_H__
+#define __CPS_FILTER_H__
+
+/* Include Files */
+#include "CPS_common.h"
+#include "CPS_acq.h"
+
+/* Defines */
+#define CPS_FILTER_NONE 0u //Every raw conversion goes straight to the classifier (original behaviour)
+#define CPS_FILTER_BOXCAR 1u //Mean of the CPS_FILTER_DECIMATION conversions of each output period
+#define CPS_FILTER_MEDIAN 2u //Median of the last CPS_FILTER_MEDIAN_TAPS conversions, rejects spikes
+#define CPS_FILTER_IIR 3u //First order low pass, y += (x - y)/2^CPS_FILTER_IIR_SHIFT
+
+#ifndef CPS_FILTER_TYPE
+#define CPS_FILTER_TYPE CPS_FILTER_MEDIAN
+#endif
+
+#define CPS_FILTER_IIR_SHIFT 2u
+#define CPS_FILTER_IIR_FRACBITS 4u //Fraction bits kept in the IIR state so small steps are not lost
+
+#if CPS_ACQ_MODE == CPS_ACQ_BATCH
+#define CPS_FILTER_SAMPLE_US 50u //Every slot is converted ADC1_G2_DEPTH/CPS_ACQ_CHANNELS times per batch
+#define CPS_FILTER_DECIMATION (ADC1_G2_DEPTH/CPS_ACQ_CHANNELS) //One output per batch, 800us with one channel
+#elif CPS_FILTER_TYPE == CPS_FILTER_NONE
+#define CPS_FILTER_SAMPLE_US 1000u //ADC conversion period
+#define CPS_FILTER_DECIMATION 1u
+#else
+#define CPS_FILTER_SAMPLE_US 250u
+#define CPS_FILTER_DECIMATION 2u //Power of two, the boxcar divides by shifting
+#endif
+#define CPS_FILTER_OUTPUT_US (CPS_FILTER_SAMPLE_US*CPS_FILTER_DECIMATION) //Classifier input period
+#if CPS_ACQ_MODE == CPS_ACQ_BATCH
+#define CPS_FILTER_MEDIAN_TAPS CPS_FILTER_DECIMATION //Median of the whole batch, even, the lower middle value is taken
+#else
+#define CPS_FILTER_MEDIAN_TAPS 5u //Odd, 3..7
+#endif
+
+#ifndef CPS_FILTER_BENCHMARK
+#define CPS_FILTER_BENCHMARK 0u //Time every filter type over a synthetic input at boot (watch CPS_axFilterBenchmark)
+#endif
+#define CPS_FILTER_BENCHMARK_SAMPLES 256u
+
+#if (CPS_FILTER_MEDIAN_TAPS != CPS_FILTER_DECIMATION) && \
+    (((CPS_FILTER_MEDIAN_TAPS & 1u) == 0u) || (CPS_FILTER_MEDIAN_TAPS < 3u) || (CPS_FILTER_MEDIAN_TAPS > 7u))
+#error "CPS_FILTER_MEDIAN_TAPS must be odd and between 3 and 7, or span the whole output period"
+#endif
+#if CPS_FILTER_MEDIAN_TAPS > 16u
+#error "CPS_FILTER_MEDIAN_TAPS is sorted once per output period, keep it to 16 or less"
+#endif
+#if (CPS_FILTER_DECIMATION & (CPS_FILTER_DECIMATION - 1u)) != 0u
+#error "CPS_FILTER_DECIMATION must be a power of two"
+#endif
+#if (CPS_ACQ_MODE == CPS_ACQ_BATCH) && (CPS_FILTER_TYPE == CPS_FILTER_NONE)
+#error "Batch acquisition needs a filter to reduce each batch to one sample"
+#endif
+
+/* Global Types */
+typedef struct
+{
+  uint32_t u32CyclesPerSample; //Mean PMU cycles spent per raw conversion
+  uint32_t u32MaxCycles; //Worst single conversion
+} xCPSFilterBenchmark_t;
+
+/* Global Vars */
+#if CPS_FILTER_BENCHMARK
+extern xCPSFilterBenchmark_t CPS_axFilterBenchmark[CPS_FILTER_IIR + 1u]; //Indexed by CPS_FILTER_* type
+#endif
+
+/* Global Function Prototypes */
+
+void CPS_vFilterReset(void);
+bool CPS_bFilterPut(uint32_t u32Slot, uint16_t u16Raw, uint16_t *pu16Filtered);
+#if CPS_FILTER_BENCHMARK
+void CPS_vFilterBenchmark(void);
+#endif
+
+#endif
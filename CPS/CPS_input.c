@@ -0,0 +1,143 @@
+/** @file CPS_input.c
+*   @brief Per input qualification state machine
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Each classified sample is turned into a 3 bit event per input: in band, qualified (this sample completes the
+*   count) and hold-off running. The event and the current state index a const transition table that gives the next
+*   state, how to update the sample count and which command to send. The step is the same handful of loads and
+*   stores for every input, state and sample.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_input.h"
+#include "CPS_timer.h"
+
+/* Defines */
+#define EVT_INBAND 0x1u
+#define EVT_QUALIFIED 0x2u //Only meaningful together with EVT_INBAND
+#define EVT_HOLDOFF 0x4u
+#define EVT_COUNT 8u
+
+#define CNT_CLEAR 0x00u, 0u //Count mask, count increment
+#define CNT_INC 0xFFu, 1u
+
+/* Internal Types */
+typedef enum
+{
+  eOUT_None,
+  eOUT_On,
+  eOUT_Off
+} xOutputAction_t;
+
+typedef struct
+{
+  uint8_t u8Next; //xCPSInputStates_t
+  uint8_t u8CountMask; //Count = (Count & mask) + increment
+  uint8_t u8CountInc;
+  uint8_t u8Output; //xOutputAction_t
+} xTransition_t;
+
+/* Global Vars */
+const xCPSInputConfig_t CPS_axInputConfig[eINPUT_Count] =
+{
+  {CPS_ACQ_SLOT_PADDLES, eCMD_ShiftUp, eCMD_ShiftUp, eCMD_Null, HOLDTIME_PADDLES_SAMPLES, DEBOUNCE_PADDLES_MS},
+  {CPS_ACQ_SLOT_PADDLES, eCMD_ShiftDown, eCMD_ShiftDown, eCMD_Null, HOLDTIME_PADDLES_SAMPLES, DEBOUNCE_PADDLES_MS},
+  {CPS_ACQ_SLOT_HORN, eCMD_HornOn, eCMD_HornOn, eCMD_HornOff, HOLDTIME_HORN_SAMPLES, DEBOUNCE_HORN_MS}
+};
+
+xCPSInputState_t CPS_axInputState[eINPUT_Count];
+
+/* Internal Vars */
+static const xTransition_t axTransitions[eSTATE_Count][EVT_COUNT] =
+{
+  { //eSTATE_Idle
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None}, //out of band
+    {eSTATE_Qualifying, CNT_INC, eOUT_None}, //in band
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None}, //out of band
+    {eSTATE_Active, CNT_CLEAR, eOUT_On}, //in band, qualified on the first sample
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None}, //hold-off is never running in this state, same as above
+    {eSTATE_Qualifying, CNT_INC, eOUT_None},
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None},
+    {eSTATE_Active, CNT_CLEAR, eOUT_On}
+  },
+  { //eSTATE_Qualifying
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None}, //left the band before qualifying
+    {eSTATE_Qualifying, CNT_INC, eOUT_None},
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None},
+    {eSTATE_Active, CNT_CLEAR, eOUT_On}, //count complete, accept
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None},
+    {eSTATE_Qualifying, CNT_INC, eOUT_None},
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None},
+    {eSTATE_Active, CNT_CLEAR, eOUT_On}
+  },
+  { //eSTATE_Active
+    {eSTATE_HoldOff, CNT_CLEAR, eOUT_Off}, //released, start hold-off
+    {eSTATE_Active, CNT_CLEAR, eOUT_None}, //still held, no repeat
+    {eSTATE_HoldOff, CNT_CLEAR, eOUT_Off},
+    {eSTATE_Active, CNT_CLEAR, eOUT_None},
+    {eSTATE_HoldOff, CNT_CLEAR, eOUT_Off},
+    {eSTATE_Active, CNT_CLEAR, eOUT_None},
+    {eSTATE_HoldOff, CNT_CLEAR, eOUT_Off},
+    {eSTATE_Active, CNT_CLEAR, eOUT_None}
+  },
+  { //eSTATE_HoldOff
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None}, //hold-off over, start again from this sample
+    {eSTATE_Qualifying, CNT_INC, eOUT_None},
+    {eSTATE_Idle, CNT_CLEAR, eOUT_None},
+    {eSTATE_Active, CNT_CLEAR, eOUT_On},
+    {eSTATE_HoldOff, CNT_CLEAR, eOUT_None}, //hold-off running, ignore the input
+    {eSTATE_HoldOff, CNT_CLEAR, eOUT_None},
+    {eSTATE_HoldOff, CNT_CLEAR, eOUT_None},
+    {eSTATE_HoldOff, CNT_CLEAR, eOUT_None}
+  }
+};
+
+static xCPSTimer_t axHoldOffTimer[eINPUT_Count];
+
+/* Global Functions */
+
+/* void CPS_vInputReset(void)
+*   Returns every input to idle. Call after CPS_vTimerInit and before the ADC interrupt is enabled.
+*
+*/
+void CPS_vInputReset(void)
+{
+  for(uint32_t u32Input = 0u; u32Input < eINPUT_Count; u32Input++)
+  {
+    CPS_axInputState[u32Input].u8State = eSTATE_Idle;
+    CPS_axInputState[u32Input].u8Count = 0u;
+    CPS_vTimerCancel(&axHoldOffTimer[u32Input]);
+  }
+}
+
+/* xHornCommands_t CPS_xInputStep(uint32_t u32Input, const uint8_t *pu8Class)
+*   Runs the latest classification of the input's slot (pu8Class is indexed by slot) through the state machine of one
+*   input. Returns the command to send, or eCMD_Null. ADC ISR context only.
+*
+*/
+xHornCommands_t CPS_xInputStep(uint32_t u32Input, const uint8_t *pu8Class)
+{
+  const xCPSInputConfig_t *pxConfig = &CPS_axInputConfig[u32Input];
+  xCPSInputState_t *pxState = &CPS_axInputState[u32Input];
+  const xTransition_t *pxTransition;
+  uint32_t u32Event;
+  u32Event = (uint32_t)(pu8Class[pxConfig->u8Slot] == (uint8_t)pxConfig->xBand);
+  u32Event |= (uint32_t)(((uint32_t)pxState->u8Count + 1u) >= pxConfig->u8QualifySamples) << 1u;
+  u32Event |= (uint32_t)CPS_bTimerArmed(&axHoldOffTimer[u32Input]) << 2u;
+  pxTransition = &axTransitions[pxState->u8State][u32Event];
+  pxState->u8State = pxTransition->u8Next;
+  pxState->u8Count = (uint8_t)((pxState->u8Count & pxTransition->u8CountMask) + pxTransition->u8CountInc);
+  switch(pxTransition->u8Output)
+  {
+  case eOUT_On:
+    return(pxConfig->xOnCommand);
+  case eOUT_Off:
+    CPS_vTimerArm(&axHoldOffTimer[u32Input], pxConfig->u16HoldOffMs, 0);
+    return(pxConfig->xOffCommand);
+  default:
+    return(eCMD_Null);
+  }
+}
@@ -0,0 +1,82 @@
+/** @file CPS_input.h
+*   @brief Per input qualification state machine
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface of the horn/paddle input state machine. Every input runs through idle,
+*   qualifying, active and hold-off using one shared transition table; the inputs themselves are rows of a const
+*   configuration table, so a new input needs no new code.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_INPUT_H__
+#define __CPS_INPUT_H__
+
+/* Include Files */
+#include "CPS_main.h"
+#include "CPS_filter.h"
+
+/* Defines */
+#define CPS_INPUT_TABLEDRIVEN 1u //1: state machine below, 0: original switch in CPS_vISRADCGroup1 (kept for comparison)
+#if !CPS_INPUT_TABLEDRIVEN && (CPS_ACQ_SLOT_PADDLES != CPS_ACQ_SLOT_HORN)
+#error "The original switch only reads the horn wire, a separate paddle ladder needs the state machine"
+#endif
+
+#define DEBOUNCE_PADDLES_MS 100 //Debounce time in milliseconds for the paddle shift signal (should be multiple of CPS_TIMER_TICK_MS)
+#define DEBOUNCE_HORN_MS    250 //Debounce time in milliseconds for the horn signal (off and on)
+
+#if CPS_FILTER_TYPE == CPS_FILTER_NONE
+#define HOLDTIME_PADDLES_SAMPLES 3 //Number of consecutive valid samples for an "active" signal
+#define HOLDTIME_HORN_SAMPLES 3 
+#else
+#define HOLDTIME_PADDLES_SAMPLES 2 //Filtered samples have the noise removed already, fewer are needed. Two 800us batch
+                                   //outputs take as long as three raw 1ms samples did, so no latency is saved
+#define HOLDTIME_HORN_SAMPLES 2
+#endif
+
+/* Global Types */
+typedef enum
+{
+  eINPUT_ShiftUp,
+  eINPUT_ShiftDown,
+  eINPUT_Horn,
+  eINPUT_Count
+} xCPSInputs_t;
+
+typedef enum
+{
+  eSTATE_Idle, //Not in band
+  eSTATE_Qualifying, //In band, counting consecutive samples
+  eSTATE_Active, //Accepted, on command sent
+  eSTATE_HoldOff, //Released, off command sent, ignoring the input until the hold-off timer expires
+  eSTATE_Count
+} xCPSInputStates_t;
+
+typedef struct
+{
+  uint8_t u8Slot; //Acquisition slot (resistor ladder) the input is read from
+  xHornCommands_t xBand; //Classifier band of that slot that drives this input
+  xHornCommands_t xOnCommand; //Sent when the input qualifies
+  xHornCommands_t xOffCommand; //Sent when the input leaves its band after qualifying, eCMD_Null sends nothing
+  uint8_t u8QualifySamples; //Consecutive in band samples needed, 1..255
+  uint16_t u16HoldOffMs; //Time the input is ignored after release
+} xCPSInputConfig_t;
+
+typedef struct
+{
+  uint8_t u8State; //xCPSInputStates_t
+  uint8_t u8Count; //Consecutive in band samples while qualifying
+} xCPSInputState_t;
+
+/* Global Vars */
+extern const xCPSInputConfig_t CPS_axInputConfig[eINPUT_Count];
+extern xCPSInputState_t CPS_axInputState[eINPUT_Count];
+
+/* Global Function Prototypes */
+
+void CPS_vInputReset(void);
+xHornCommands_t CPS_xInputStep(uint32_t u32Input, const uint8_t *pu8Class);
+
+#endif
@@ -0,0 +1,128 @@
+/** @file CPS_latency.c
+*   @brief Press-to-output latency measurement
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Measures the time from a voltage step on the horn wire to the output pin change it causes. The acquisition loop
+*   classifies every raw conversion of the horn slot, ahead of the filter, and the first one in a new band opens a
+*   step stamped with the RTI free running count of that conversion. When the step woke acquisition from the idle
+*   watch, the magnitude compare interrupt is the earliest sight of it and its time is used instead. The output side
+*   passes the band each pin change answers (horn or shift rising, horn falling for idle) and only closes a step of
+*   that band, stamping the counter right after the GIO write. A step replaced before any output answered it is
+*   counted as dropped. The difference is binned into a histogram that can be read with the debugger while the car is
+*   driven, so the bench scope is no longer needed to get a latency distribution.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_latency.h"
+#include "sys_core.h"
+
+/* Defines */
+#define LATENCY_NOBAND 0xFFFFFFFFu
+
+/* Global Vars */
+xCPSLatencyStats_t CPS_xLatencyStats;
+
+/* Internal Vars */
+static volatile uint32_t u32StepStamp; //FRC0 value of the conversion that started the open step, ADC ISR writes
+static volatile uint32_t u32StepBand; //Band of the open step
+static volatile bool bStepPending;
+static uint32_t u32LastBand = LATENCY_NOBAND; //Band of the last raw conversion
+static uint32_t u32WakeStamp; //FRC0 value of the last magnitude compare wake
+static bool bWakePending; //The next conversion is the first one after a wake
+
+/* Global Functions */
+
+/* void CPS_vLatencyReset(void)
+*   Clears all collected statistics.
+*
+*/
+void CPS_vLatencyReset(void)
+{
+  CPS_xLatencyStats.u32Count = 0u;
+  CPS_xLatencyStats.u32MinUs = 0xFFFFFFFFu;
+  CPS_xLatencyStats.u32MaxUs = 0u;
+  CPS_xLatencyStats.u32TotalUs = 0u;
+  CPS_xLatencyStats.u32Dropped = 0u;
+  for(uint32_t u32Bin = 0u; u32Bin < CPS_LATENCY_BINS; u32Bin++)
+  {
+    CPS_xLatencyStats.au32Histogram[u32Bin] = 0u;
+  }
+  bStepPending = 0;
+  bWakePending = 0;
+  u32LastBand = LATENCY_NOBAND;
+}
+
+/* void CPS_vLatencyInput(uint32_t u32Band, uint32_t u32Stamp)
+*   Called from the ADC ISR with the band of every raw horn wire conversion and the FRC0 value it was taken at. A
+*   change of band is taken as the voltage step.
+*
+*/
+void CPS_vLatencyInput(uint32_t u32Band, uint32_t u32Stamp)
+{
+  if(u32Band != u32LastBand)
+  {
+    if(u32LastBand != LATENCY_NOBAND)
+    {
+      if(bStepPending)
+      {
+        CPS_xLatencyStats.u32Dropped++;
+      }
+      u32StepStamp = bWakePending ? u32WakeStamp : u32Stamp;
+      u32StepBand = u32Band;
+      bStepPending = 1;
+    }
+    u32LastBand = u32Band;
+  }
+  bWakePending = 0;
+}
+
+/* void CPS_vLatencyWake(void)
+*   Called from the magnitude compare ISR. The conversion that woke acquisition is not drained, so its time stands
+*   in for the step the next conversion shows.
+*
+*/
+void CPS_vLatencyWake(void)
+{
+  u32WakeStamp = CPS_u32TimeNow32();
+  bWakePending = 1;
+}
+
+/* void CPS_vLatencyOutput(uint32_t u32Band)
+*   Called from the main loop right after an output pin has changed state, with the band that asks for the new state.
+*   Closes the open step if it is of that band.
+*
+*/
+void CPS_vLatencyOutput(uint32_t u32Band)
+{
+  uint32_t u32Now = CPS_u32TimeNow32();
+  uint32_t u32LatencyUs;
+  uint32_t u32Bin;
+  _disable_IRQ_interrupt_(); //Band, stamp and flag of the step are written together by the ADC ISR
+  if(!bStepPending || (u32StepBand != u32Band))
+  {
+    _enable_interrupt_();
+    return; //Output changed without a step of its own (e.g. the paddle pulse ending), nothing to measure
+  }
+  bStepPending = 0;
+  u32LatencyUs = (u32Now - u32StepStamp)/CPS_TIME_COUNTS_PER_US; //unsigned subtraction handles FRC wrap
+  _enable_interrupt_();
+  u32Bin = u32LatencyUs/CPS_LATENCY_BIN_US;
+  if(u32Bin >= CPS_LATENCY_BINS)
+  {
+    u32Bin = CPS_LATENCY_BINS - 1u;
+  }
+  CPS_xLatencyStats.au32Histogram[u32Bin]++;
+  CPS_xLatencyStats.u32Count++;
+  CPS_xLatencyStats.u32TotalUs += u32LatencyUs;
+  if(u32LatencyUs < CPS_xLatencyStats.u32MinUs)
+  {
+    CPS_xLatencyStats.u32MinUs = u32LatencyUs;
+  }
+  if(u32LatencyUs > CPS_xLatencyStats.u32MaxUs)
+  {
+    CPS_xLatencyStats.u32MaxUs = u32LatencyUs;
+  }
+}
@@ -0,0 +1,46 @@
+/** @file CPS_latency.h
+*   @brief Press-to-output latency measurement
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface used to measure the time from a voltage step on the horn wire to the output
+*   pin change it causes. Results are kept in RAM and are read out with the debugger (watch CPS_xLatencyStats).
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_LATENCY_H__
+#define __CPS_LATENCY_H__
+
+/* Include Files */
+#include "CPS_time.h"
+
+/* Defines */
+#define CPS_LATENCY_ENABLE 1u //Set to 0 to compile the latency hooks out of the ISR and main loop
+
+#define CPS_LATENCY_BIN_US 500u //Width of one histogram bin
+#define CPS_LATENCY_BINS 16u //Last bin also collects everything above (CPS_LATENCY_BINS-1)*CPS_LATENCY_BIN_US
+
+/* Global Types */
+typedef struct
+{
+  uint32_t u32Count; //Number of step-to-output pairs measured
+  uint32_t u32MinUs;
+  uint32_t u32MaxUs;
+  uint32_t u32TotalUs; //Sum of all measurements, divide by u32Count for the mean
+  uint32_t u32Dropped; //Steps no output answered, e.g. a paddle release (the pulse is timed) or a noise spike
+  uint32_t au32Histogram[CPS_LATENCY_BINS];
+} xCPSLatencyStats_t;
+
+/* Global Vars */
+extern xCPSLatencyStats_t CPS_xLatencyStats;
+
+/* Global Function Prototypes */
+
+void CPS_vLatencyReset(void);
+void CPS_vLatencyInput(uint32_t u32Band, uint32_t u32Stamp);
+void CPS_vLatencyWake(void);
+void CPS_vLatencyOutput(uint32_t u32Band);
+
+#endif
@@ -11,58 +11,83 @@
 
 /* Include Files */
 #include "CPS_main.h"
+#include "CPS_acq.h"
+#include "CPS_boot.h"
+#include "CPS_calib.h"
+#include "CPS_classify.h"
+#include "CPS_eventlog.h"
+#include "CPS_filter.h"
+#include "CPS_frame.h"
+#include "CPS_input.h"
+#include "CPS_latency.h"
+#include "CPS_output.h"
+#include "CPS_profile.h"
+#include "CPS_pulse.h"
+#include "CPS_sci.h"
+#include "CPS_selftest.h"
+#include "CPS_telemetry.h"
+#include "CPS_time.h"
+#include "CPS_timer.h"
 #include "sys_core.h"
 
 /* Defines */
 #define DEBUG == 1
 
-#define ADC_UPPERBOUND_SHFTUP 0x0C1Fu //These definitions set the limits for the ADC conversion to trigger a shift or horn signal.
-#define ADC_LOWERBOUND_SHFTUP 0x0747u
-#define ADC_UPPERBOUND_SHFTDN 0x0746u
-#define ADC_LOWERBOUND_SHFTDN 0x0251u
-#define ADC_UPPERBOUND_HORNON 0x0250u
-#define ADC_LOWERBOUND_HORNON 0x0000u
-#define ADC_DATABUFFERSIZE 8u
-
-#define DEBOUNCE_PADDLES_MS 100 //Debounce time in milliseconds for the paddle shift signal (should be multiple of ten)
-#define DEBOUNCE_HORN_MS    250 //Debounce time in milliseconds for the horn signal (off and on)
-
-#define ACTIVETIME_PADDLES_MS 50 //How long to hold the paddle switch for on a valid signal
-
-#define HOLDTIME_PADDLES_SAMPLES 3 //Number of consecutive valid samples for an "active" signal
-#define HOLDTIME_HORN_SAMPLES 3 
+#define ACTIVETIME_PADDLES_MS CPS_FRAME_PULSE_MS //How long to hold the paddle switch for on a valid signal
 
 #define IO_BYPASSRELAY_PORT   //idle bypass relay used to ensure horn signal works normally if module is in error state
 #define IO_BYPASSRELAY_PIN  
 #define IO_BYPASSRELAY_OPEN 1u
 #define IO_BYPASSRELAY_CLOSED 0u
-#define IO_SHIFTDOWN_PORT spiPORT2 //downshift output. Signal is active low.
+#define IO_SHIFTDOWN_PORT eOUT_Spi2 //downshift output. Signal is active low.
 #define IO_SHIFTDOWN_PIN SPI_PIN_CLK
 #define IO_SHIFTDOWN_ON 1u
 #define IO_SHIFTDOWN_OFF 0u
-#define IO_SHIFTUP_PORT spiPORT2 //upshift output. Signal is active low.
+#define IO_SHIFTUP_PORT eOUT_Spi2 //upshift output. Signal is active low.
 #define IO_SHIFTUP_PIN SPI_PIN_SIMO
 #define IO_SHIFTUP_ON 1u
 #define IO_SHIFTUP_OFF 0u
-#define IO_HORN_PORT spiPORT3 //horn output. Signal?
+#define IO_HORN_PORT eOUT_Spi3 //horn output. Signal?
 #define IO_HORN_PIN SPI_PIN_SOMI
 #define IO_HORN_ON 1u
 #define IO_HORN_OFF 0u
 
 #define STARTUPTIME_MS 3000 //CPS "start up" time in milliseconds. All ADC signals are ignored until this time has expired.
-
-#define COMPARETIMER_CONVERSIONFACTOR 2 //Timer period in milliseconds
+#define STARTUPTIME_WARM_MS 20u //Start up time after a warm boot, the horn wiring has already settled
+#define SETTLETIME_MS 20u //Early start: the horn line has to classify idle this long before the inputs are started
+
+#define RATE_PUBLISH_MS 1000u //Period of the bus write and interrupt rate counters
+
+#define CPS_PROFILE_ADCISR 1u //Time every CPS_vISRADCGroup1 run with the PMU (watch CPS_xProfileADCISR)
+
+#ifndef CPS_MAIN_LINK //HOST_stream builds the CPS with -DCPS_MAIN_LINK=0
+#define CPS_MAIN_LINK 1u //Send the horn and shift commands of each control cycle to the SCT in one link frame
+#endif
+#if CPS_TELEMETRY_ENABLE && CPS_MAIN_LINK
+#error "Telemetry takes the link port, the SCT would parse the samples frames. Set CPS_MAIN_LINK to 0."
+#endif
+#define CPS_MAIN_EVENTDRIVEN 1u //1: main loop sleeps and only writes changed pins, 0: legacy loop rewrites every pin continuously
+#define CPS_MAIN_EARLYSTART 1u //1: sample from power up, end the start up time once the horn line settles
+#if CPS_MAIN_EARLYSTART
+#define STARTUP_CALLBACK vStartUpExpired //STARTUPTIME_MS stays the upper bound
+#else
+#define STARTUP_CALLBACK 0
+#endif
+
+#define IO_DEBUGLED_A_PORT eOUT_GioA //Debug LEDs. A is lit by horn and shift up, B by horn and shift down.
+#define IO_DEBUGLED_A_PIN 2u
+#define IO_DEBUGLED_B_PORT eOUT_Het1
+#define IO_DEBUGLED_B_PIN 8u
+
+#if CPS_EVENTLOG_ENABLE
+#define LOG_EVENT(xType, u32Data, u32Value) CPS_vEventLogPost((xType), (u32Data), (u32Value)) //ISR context only
+#define LOG_EVENT_MAIN(xType, u32Data, u32Value) CPS_vEventLogPostMain((xType), (u32Data), (u32Value)) //Main loop only
+#else
+#define LOG_EVENT(xType, u32Data, u32Value)
+#define LOG_EVENT_MAIN(xType, u32Data, u32Value)
+#endif
 
 /* Variable Init. */
-typedef enum
-{
-  eCMD_ShiftUp,
-  eCMD_ShiftDown,
-  eCMD_HornOn,
-  eCMD_HornOff,
-  eCMD_Null
-} xHornCommands_t;
-
 typedef enum
 {
   eIO_Horn,
@@ -70,260 +95,578 @@ typedef enum
   eIO_ShiftDown
 } xIOSignals_t;
 
+#define OUTPUT_HORN (1u << eIO_Horn) //Bits of the requested output image
+#define OUTPUT_SHIFTUP (1u << eIO_ShiftUp)
+#define OUTPUT_SHIFTDOWN (1u << eIO_ShiftDown)
+#define OUTPUT_LEDA (1u << 3u)
+#define OUTPUT_LEDB (1u << 4u)
+#define LINK_SENT_MASK 15u //Frames whose queue time is kept for the round trip, power of two less one
+
 /* Global Vars */
+uint32_t CPS_u32BusWritesPerSecond; //Number of GIO set/clear stores issued in the last second
+uint32_t CPS_u32InterruptsPerSecond; //Number of CPS interrupts (ADC and RTI) taken in the last second
+#if CPS_PROFILE_ADCISR
+xCPSProfile_t CPS_xProfileADCISR; //PMU cycles per ADC ISR, compare CPS_INPUT_TABLEDRIVEN 1 against 0
+#endif
+uint32_t CPS_u32StartUpReadyUs; //RTI time at which the start up time ended, compare CPS_MAIN_EARLYSTART 1 against 0
+uint32_t CPS_u32FirstDecisionUs; //RTI time at which the first sample reached the inputs
+bool CPS_bStartUpSettled; //1: start up time ended by the horn line settling, 0: by STARTUPTIME_MS
+#if CPS_MAIN_LINK
+xCPSFrameParser_t CPS_xLinkParser; //Frames from the SCT and the receive error counts
+uint32_t CPS_u32LinkAcks; //Acknowledgements received
+uint8_t CPS_u8LinkAcked; //SEQ of the last frame the SCT acknowledged
+xCPSProfile_t CPS_xLinkRoundTrip; //Microseconds from a frame being queued to its acknowledgement being parsed
+#endif
 
 /* Internal Vars */
-static bool bStartUpTimeDone;
-static bool bPaddleDebounceActive;
-static bool bHornDebounceActive;
-
-static bool bHornActiveCommand;
-static bool bShiftUpHoldActive;
-static bool bShiftDownHoldActive;
-
-static adcData_t xADCData[ADC_DATABUFFERSIZE];
+static xCPSTimer_t xStartUpTimer; //Armed until the start up time has expired
+#if CPS_MAIN_EARLYSTART
+static xCPSTimer_t xSettleTimer; //Armed while the horn line classifies idle during the start up time
+#endif
+static volatile bool bStartUpDone; //Samples go to the inputs once set
+#if !CPS_INPUT_TABLEDRIVEN
+static xCPSTimer_t xPaddleDebounceTimer; //Armed while new paddle signals are ignored
+static xCPSTimer_t xHornDebounceTimer; //Armed while new horn signals are ignored
+#endif
+static xCPSTimer_t xPaddleHoldTimer; //Releases the paddle output ACTIVETIME_PADDLES_MS after a shift
+static xCPSTimer_t xRateTimer;
+#if CPS_MAIN_LINK
+static xCPSTimer_t xLinkKeepAliveTimer;
+#endif
+
+static volatile uint32_t u32OutputRequest; //Output image requested by the ISRs (OUTPUT_* bits)
+static volatile bool bOutputEventPending; //Set by the ISRs whenever u32OutputRequest changes
+static uint32_t u32OutputApplied; //Output image currently on the pins
+static volatile uint32_t u32BusWrites; //Free running, written in main context only
+static uint32_t u32BusWritesPublished; //u32BusWrites at the last vPublishRates, ISR context only
+static volatile uint32_t u32InterruptCount;
+#if CPS_MAIN_LINK
+static xCPSFrameBatch_t xLinkBatch; //Events of the current control cycle, ISR context only
+static uint32_t au32LinkSent[LINK_SENT_MASK + 1u]; //RTI count at which each recent SEQ was queued
+#endif
 
 /* Local Function Prototypes */
 static void vInitCPS(void);
-static xHornCommands_t ProcessADCData(uint16_t u16Data);
+static void vProcessConversion(void);
+static void vProcessSample(xHornCommands_t xSample, uint16_t u16Filtered);
 static void vSendCommand(xHornCommands_t xCommand);
+#if CPS_MAIN_EVENTDRIVEN
+static void vApplyOutputs(uint32_t u32Request);
+#else
 static void vSetOutput(xIOSignals_t xOutputType, uint32_t u32OutputValue);
+#endif
+#if CPS_LATENCY_ENABLE
+static void vLatencyOutputs(uint32_t u32Old, uint32_t u32New);
+#endif
 static void vERROR(void);
+static void vPaddleHoldExpired(void);
+static void vStartUpDone(bool bSettled);
+#if CPS_MAIN_EARLYSTART
+static void vStartUpExpired(void);
+static void vStartUpSettled(void);
+#endif
+static void vPublishRates(void);
+#if CPS_MAIN_LINK
+static void vLinkPost(xHornCommands_t xCommand);
+static void vLinkFlush(void);
+static void vLinkReceive(void);
+static void vLinkKeepAlive(void);
+#endif
 
 /* Global Functions */
 void CPS_vMain(void)
 {
-  bPaddleDebounceActive = 0;
-  bHornDebounceActive = 0;
+#if !CPS_MAIN_EVENTDRIVEN
+  uint32_t u32LastRequest = 0u;
+#endif
+  uint32_t u32Request;
+#if CPS_BOOT_PROFILE
+  CPS_vBootStamp(eBOOT_CInit);
+#endif
+  CPS_vLatencyReset();
+  CPS_vEventLogReset();
   vInitCPS();
   for(;;)
   {
-    if(bShiftUpHoldActive)
+#if CPS_EVENTLOG_ENABLE
+    CPS_vEventLogDrain();
+#endif
+#if CPS_MAIN_LINK
+    vLinkReceive();
+#endif
+#if CPS_MAIN_EVENTDRIVEN
+    _disable_IRQ_interrupt_(); //Close the window between checking for an event and going to sleep
+    if(bOutputEventPending)
     {
-      vSetOutput(eIO_ShiftUp, 1u); //activate shift up signal
+      bOutputEventPending = 0;
+      u32Request = u32OutputRequest;
+      _enable_interrupt_();
+#if CPS_EVENTLOG_ENABLE
+      CPS_vEventLogDrain(); //Records of the decision go into the history before the output record
+#endif
+      vApplyOutputs(u32Request);
     }
-    else
+#if CPS_EVENTLOG_ENABLE
+    else if(!CPS_bEventLogEmpty())
     {
-      vSetOutput(eIO_ShiftUp, 0u); //turn off shift up signal
+      _enable_interrupt_(); //Records arrived after the drain, go round again
     }
-    if(bShiftDownHoldActive)
+#endif
+#if CPS_SELFTEST_BACKGROUND
+    else if(CPS_bSelfTestSlice()) //IRQs stay masked for one slice
     {
-      vSetOutput(eIO_ShiftDown, 1u); //activate shift up signal
+      _enable_interrupt_(); //Let pending interrupts in before the next slice
     }
+#endif
     else
     {
-      vSetOutput(eIO_ShiftDown, 0u); //turn off shift up signal
+      _gotoCPUIdle_(); //WFI wakes on a pending IRQ even while IRQs are masked, the ISR runs once they are re-enabled
+      _enable_interrupt_();
     }
-    if(bHornActiveCommand)
-    {
-      vSetOutput(eIO_Horn, 1u); //activate horn
-    }
-    else
+#else
+    u32Request = u32OutputRequest;
+    vSetOutput(eIO_ShiftUp, ((u32Request & OUTPUT_SHIFTUP) != 0u) ? 1u : 0u); //shift up signal
+    vSetOutput(eIO_ShiftDown, ((u32Request & OUTPUT_SHIFTDOWN) != 0u) ? 1u : 0u); //shift down signal
+    vSetOutput(eIO_Horn, ((u32Request & OUTPUT_HORN) != 0u) ? 1u : 0u); //horn
+    if(u32Request != u32LastRequest)
     {
-      vSetOutput(eIO_Horn, 0u); //disable horn
+#if CPS_LATENCY_ENABLE
+      vLatencyOutputs(u32LastRequest, u32Request); //output pins have just moved
+#endif
+      LOG_EVENT_MAIN(eEVT_Output, 0u, u32Request);
+      u32LastRequest = u32Request;
     }
+#if CPS_SELFTEST_BACKGROUND
+    _disable_IRQ_interrupt_();
+    (void)CPS_bSelfTestSlice();
+    _enable_interrupt_();
+#endif
+#endif
   }
 }
 /* void CPS_vISRADCGroup1(void)
-*   Triggered on the completion of a conversion.Should interrupt every ms with a finished conversion
+*   Triggered on the completion of a group conversion of all channels. Should interrupt every CPS_FILTER_SAMPLE_US
 *
 */
 void CPS_vISRADCGroup1(void)
 {
-  uint32_t u32ADCDataTotal;
-  u32ADCDataTotal = adcGetData(adcREG1, adcGROUP1, &xADCData[0]);
-  static uint32_t u32ShiftUpSuccessiveCount;
-  static uint32_t u32ShiftDownSuccessiveCount;
-  static uint32_t u32HornSuccessiveCount;
-  for(uint32_t u32Count = 0u; u32Count < u32ADCDataTotal; u32Count++)
-  {
-    if(u32ADCDataTotal >= ADC_DATABUFFERSIZE)
-    {
-      vERROR();
-    }
-    switch(ProcessADCData(xADCData[u32Count].value))
-    {
-    case eCMD_ShiftUp:
-      u32ShiftDownSuccessiveCount = 0u; //clear other counters
-      u32HornSuccessiveCount = 0u;
-      if(!bPaddleDebounceActive) //If paddle is not currently in debounce, accept signal
-      {
-        u32ShiftUpSuccessiveCount++; //increment sample counter
-        if(u32ShiftUpSuccessiveCount >= HOLDTIME_PADDLES_SAMPLES) //if consecutive sample is valid, shifting action is considered real
-        {
-          u32ShiftUpSuccessiveCount = 0u;
-          bPaddleDebounceActive = 1;
-          vSendCommand(eCMD_ShiftUp); //Send shift up command to output handlers
-        }
-      }
-      break;
-    case eCMD_ShiftDown:
-      u32ShiftUpSuccessiveCount = 0u; //clear other counters
-      u32HornSuccessiveCount = 0u;
-      if(!bPaddleDebounceActive) //If paddle is not currently in debounce, accept signal
-      {
-        u32ShiftDownSuccessiveCount++; //increment sample counter
-        if(u32ShiftDownSuccessiveCount >= HOLDTIME_PADDLES_SAMPLES) //if consecutive sample is valid, shifting action is considered real
-        {
-          u32ShiftDownSuccessiveCount = 0u;
-          bPaddleDebounceActive = 1;
-          vSendCommand(eCMD_ShiftDown); //Send shift up command to output handlers
-        }
-      }
-      break;
-    case eCMD_HornOn:
-      u32ShiftDownSuccessiveCount = 0u; //clear other counters
-      u32ShiftUpSuccessiveCount = 0u;
-      if(!bHornDebounceActive) //If horn is not currently in debounce, accept signal
-      {
-        u32HornSuccessiveCount++; //increment sample counter
-        if(u32HornSuccessiveCount >= HOLDTIME_HORN_SAMPLES) //if consecutive sample is valid, horn is considered active
-        {
-          u32HornSuccessiveCount = 0u;
-          bHornDebounceActive = 1;
-          vSendCommand(eCMD_HornOn); //Send horn now active command to output handlers
-        }
-      }
-      break;
-    case eCMD_Null:
-      u32ShiftUpSuccessiveCount = 0u;       //clear all successive counters
-      u32ShiftDownSuccessiveCount = 0u;
-      u32HornSuccessiveCount = 0u;
-      vSendCommand(eCMD_HornOff); //If horn is not active then ensure it is off.
-      break;
-    default:
-      u32ShiftUpSuccessiveCount = 0u;
-      u32ShiftDownSuccessiveCount = 0u;
-      u32HornSuccessiveCount = 0u;
-      vSendCommand(eCMD_HornOff);
-      break;
-    }
-  }
+  vProcessConversion();
 }
 
-/* void CPS_vISRRTICompare1(void)
-*   Triggered by the RTI compare0 timer. Should be 1ms time base. This is used by system counters to trigger ADC.
+/* void CPS_vISRADCGroup2(void)
+*   Triggered when a group 2 batch of ADC1_G2_DEPTH results is ready (CPS_ACQ_BATCH mode only).
+*
+*/
+void CPS_vISRADCGroup2(void)
+{
+  vProcessConversion();
+}
+
+/* void CPS_vISRADCMagnitude(void)
+*   Triggered when a horn wire sample leaves the idle band while acquisition is watching (CPS_ACQ_IDLEWAKE only).
+*
+*/
+void CPS_vISRADCMagnitude(void)
+{
+  u32InterruptCount++;
+#if CPS_ACQ_IDLEWAKE
+  CPS_vAcqWake();
+#endif
+}
+
+/* void CPS_vISRRTICompare0(void)
+*   Triggered by the RTI compare0 timer. Runs every CPS_FILTER_SAMPLE_US. Only used to trigger the ADC in software trigger mode.
 *
 */
 void CPS_vISRRTICompare0(void)
 {
-  adcResetFiFo(adcREG1, adcGROUP1);
-  adcStartConversion(adcREG1, adcGROUP1);
+  u32InterruptCount++;
+  CPS_vAcqTrigger();
 }
 
 /* void CPS_vISRRTICompare1(void)
-*   Triggered by the RTI compare1 timer. Should be 2ms time base. This is used by system counters as a timer.
+*   Triggered by the RTI compare1 timer, at the next timer deadline (tickless) or every CPS_TIMER_TICK_MS. Drives all
+*   CPS software timers.
 *
 */
 void CPS_vISRRTICompare1(void)
 {
-  static uint32_t u32StartTimeCounter;
-  static uint32_t u32PaddleDebounceCounter;
-  static uint32_t u32HornDebounceCounter;
-  static uint32_t u32PaddleUpHoldCounter;
-  static uint32_t u32PaddleDownHoldCounter;
-  if(!bStartUpTimeDone) //Handle startup time count
-  {
-    u32StartTimeCounter++;
-    if(u32StartTimeCounter >= STARTUPTIME_MS/COMPARETIMER_CONVERSIONFACTOR)
-    {
-      bStartUpTimeDone = 1; //indicate startup time finished
-    }
-  }
-  if(bPaddleDebounceActive) //if debounce is active, start timing
-  {
-    u32PaddleDebounceCounter++;
-    if(u32PaddleDebounceCounter >= DEBOUNCE_PADDLES_MS/COMPARETIMER_CONVERSIONFACTOR)
-    {
-      u32PaddleDebounceCounter = 0u; //reset counter
-      bPaddleDebounceActive = 0; //indicate debounce finished
-    }
-  }
-  if(bHornDebounceActive)
-  {
-    u32HornDebounceCounter++;
-    if(u32HornDebounceCounter >= DEBOUNCE_HORN_MS/COMPARETIMER_CONVERSIONFACTOR)
-    {
-      u32HornDebounceCounter = 0u;
-      bHornDebounceActive = 0;
-    }
-  }
+  u32InterruptCount++;
+  CPS_vTimerTick();
 }
 
 /* Local Functions */
 static void vInitCPS(void)
 {
+#if CPS_CLASSIFY_SELFCHECK
+  if(!CPS_bClassifySelfCheck())
+  {
+    vERROR(); //Classifier table does not match the band definitions
+  }
+#endif
+  if(!CPS_bAcqChannelsValid())
+  {
+    vERROR(); //Acquisition channel table is not sorted
+  }
   gioInit();
   hetInit();
   spiInit();
+#if CPS_MAIN_LINK || CPS_SCI_BENCHMARK || CPS_TELEMETRY_ENABLE
+  sciInit();
+  sciSetBaudrate(CPS_SCI_PORT, CPS_SCI_BAUD); //The SCT sets the same rate
+  CPS_vSciInit(0); //Received frames are parsed in the main loop
+#endif
+#if CPS_TELEMETRY_ENABLE
+  CPS_vTelemetryInit();
+#endif
+#if CPS_MAIN_LINK
+  CPS_vFrameBatchStart(&xLinkBatch);
+  CPS_vFrameParserReset(&CPS_xLinkParser);
+  CPS_vProfileReset(&CPS_xLinkRoundTrip);
+#endif
+  CPS_vOutputInit(); //Shadows start from the latch state the drivers left
+#if CPS_PULSE_HET
+  CPS_vPulseInit();
+#endif
   adcInit();
   rtiInit();
-  bStartUpTimeDone = 0;
+#if CPS_CALIB_ENABLE
+  CPS_vCalibInit(); //Restores the stored ADC correction, calibrates on the first boot
+#endif
+#if CPS_PROFILE_ADCISR
+  CPS_vProfileInit();
+  CPS_vProfileReset(&CPS_xProfileADCISR);
+#endif
+#if CPS_FILTER_BENCHMARK
+  CPS_vFilterBenchmark(); //Interrupts are still off here
+#endif
+#if CPS_ACQ_BENCHMARK
+  CPS_vAcqBenchmark();
+#endif
+#if CPS_FRAME_BENCHMARK
+  CPS_vFrameBenchmark();
+#endif
+  CPS_vTimerInit();
+  CPS_vTimeInit(); //Time 0 is the counter start below
+#if CPS_SELFTEST_BACKGROUND
+  CPS_vSelfTestInit(); //Takes over the non-destructive start up parity tests
+#endif
+  CPS_vInputReset();
+#if CPS_BOOT_PROFILE
+  CPS_vBootStamp(eBOOT_Drivers);
+#endif
+#if CPS_BOOT_WARM
+  CPS_vTimerArm(&xStartUpTimer, CPS_bBootWarm() ? STARTUPTIME_WARM_MS : STARTUPTIME_MS, STARTUP_CALLBACK);
+#else
+  CPS_vTimerArm(&xStartUpTimer, STARTUPTIME_MS, STARTUP_CALLBACK);
+#endif
+  CPS_vTimerArm(&xRateTimer, RATE_PUBLISH_MS, vPublishRates);
+#if CPS_MAIN_LINK
+  CPS_vTimerArm(&xLinkKeepAliveTimer, CPS_FRAME_KEEPALIVE_MS, vLinkKeepAlive);
+#endif
   rtiResetCounter(0u);
   rtiStartCounter(0u);
   _enable_interrupt_();
-  rtiEnableNotification(rtiNOTIFICATION_COMPARE1);
-  while(!bStartUpTimeDone)
+#if CPS_SCI_BENCHMARK
+  (void)CPS_bSciLoopback(CPS_SCI_BENCHMARK_BYTES, CPS_SCI_BENCHMARK_TIMEOUT); //Runs inside the start up time
+#endif
+#if !CPS_TIMER_TICKLESS
+  rtiEnableNotification(rtiNOTIFICATION_COMPARE1); //The tickless timer enables compare1 itself when a deadline is armed
+#endif
+#if CPS_MAIN_EARLYSTART
+  CPS_vOutputSet(IO_HORN_PORT, IO_HORN_PIN, IO_HORN_OFF);
+  u32BusWrites += CPS_u32OutputCommit();
+  CPS_vFilterReset();
+  CPS_vAcqStart(); //Filters fill and the horn line is watched while the start up time runs
+  while(!bStartUpDone)
+  {
+    //Wait for the horn line to settle or the start up time to expire
+  }
+  _disable_IRQ_interrupt_();
+  CPS_vTimerCancel(&xStartUpTimer);
+  CPS_vTimerCancel(&xSettleTimer);
+  _enable_interrupt_();
+#if CPS_BOOT_PROFILE
+  CPS_vBootStamp(eBOOT_Startup);
+#endif
+#else
+  while(CPS_bTimerArmed(&xStartUpTimer))
   {
     //Wait for start up time to expire
   }
-  gioSetBit(IO_HORN_PORT, IO_HORN_PIN, IO_HORN_OFF); //
-  adcEnableNotification(adcREG1, adcGROUP1); //Enable ADC ISR routine
-  adcResetFiFo(adcREG1, adcGROUP1);
-  adcStartConversion(adcREG1, adcGROUP1);
-  rtiEnableNotification(rtiNOTIFICATION_COMPARE0);
+  vStartUpDone(0);
+#if CPS_BOOT_PROFILE
+  CPS_vBootStamp(eBOOT_Startup);
+#endif
+  CPS_vOutputSet(IO_HORN_PORT, IO_HORN_PIN, IO_HORN_OFF);
+  u32BusWrites += CPS_u32OutputCommit();
+  CPS_vFilterReset();
+  CPS_vAcqStart();
+#endif
+#if CPS_BOOT_WARM
+  CPS_vBootRunning(); //A watchdog or software reset from here on may boot warm
+#endif
 }
 
-static xHornCommands_t ProcessADCData(uint16_t u16Data)
+/* void vProcessConversion(void)
+*   Common ADC ISR body. Drains the conversion results and runs the horn slot through the inputs once the filters
+*   have produced a new sample.
+*
+*/
+static void vProcessConversion(void)
 {
-  if(u16Data <= ADC_UPPERBOUND_HORNON) //Is this a horn depressed signal?
+#if CPS_PROFILE_ADCISR
+  uint32_t u32StartCycles = CPS_u32ProfileCycles();
+#endif
+#if CPS_TELEMETRY_ENABLE
+  uint32_t u32Stamp = CPS_u32TimeNow32();
+#endif
+  static xHornCommands_t xLastSample = eCMD_Null;
+  xHornCommands_t xSample;
+  uint16_t u16Filtered;
+  u32InterruptCount++;
+  if(CPS_bAcqProcess()) //Filter output period finished, every slot has a new classification
   {
-    if(u16Data >= ADC_LOWERBOUND_HORNON)
+    xSample = (xHornCommands_t)CPS_au8AcqClass[CPS_ACQ_SLOT_HORN];
+    u16Filtered = CPS_au16AcqFiltered[CPS_ACQ_SLOT_HORN];
+    if(xSample != xLastSample)
+    {
+      xLastSample = xSample;
+      LOG_EVENT(eEVT_Band, (uint32_t)xSample, u16Filtered);
+    }
+    if(bStartUpDone)
     {
-      return(eCMD_HornOn);
+      vProcessSample(xSample, u16Filtered);
+#if CPS_MAIN_LINK
+      vLinkFlush(); //Every event of this control cycle goes out in one frame
+#endif
+      if(CPS_u32FirstDecisionUs == 0u)
+      {
+        CPS_u32FirstDecisionUs = CPS_u32TimeNow32()/CPS_TIME_COUNTS_PER_US;
+#if CPS_BOOT_PROFILE
+        CPS_vBootStamp(eBOOT_FirstSample);
+#endif
+      }
+    }
+#if CPS_MAIN_EARLYSTART
+    else if(xSample == eCMD_Null)
+    {
+      if(!CPS_bTimerArmed(&xSettleTimer))
+      {
+        CPS_vTimerArm(&xSettleTimer, SETTLETIME_MS, vStartUpSettled); //Idle from here on, start the settle time
+      }
     }
+    else
+    {
+      CPS_vTimerCancel(&xSettleTimer); //Line still moving (or a control is held), start again when it is idle
+    }
+#endif
   }
-  if(u16Data <= ADC_UPPERBOUND_SHFTUP) //Is this a shift up signal?
+#if CPS_PROFILE_ADCISR
+  CPS_vProfileAdd(&CPS_xProfileADCISR, CPS_u32ProfileCycles() - u32StartCycles);
+#endif
+#if CPS_TELEMETRY_ENABLE
+  CPS_vTelemetryPut(u32Stamp); //After the decision, timed on its own
+#endif
+}
+
+#if CPS_INPUT_TABLEDRIVEN
+/* void vProcessSample(xHornCommands_t xSample, uint16_t u16Filtered)
+*   Runs the new classifications through the state machine of every input and sends the resulting commands. Each
+*   input reads its own slot of CPS_au8AcqClass, xSample is only needed by the original switch.
+*
+*/
+static void vProcessSample(xHornCommands_t xSample, uint16_t u16Filtered)
+{
+  xHornCommands_t xCommand;
+  (void)xSample;
+  for(uint32_t u32Input = 0u; u32Input < eINPUT_Count; u32Input++)
   {
-    if(u16Data >= ADC_LOWERBOUND_SHFTUP)
+    xCommand = CPS_xInputStep(u32Input, CPS_au8AcqClass);
+    if(xCommand != eCMD_Null)
     {
-      return(eCMD_ShiftUp);
+      if((xCommand == eCMD_ShiftUp) || (xCommand == eCMD_ShiftDown))
+      {
+        CPS_vTimerArm(&xPaddleHoldTimer, ACTIVETIME_PADDLES_MS, vPaddleHoldExpired); //Paddle output is a pulse
+      }
+      LOG_EVENT(eEVT_Decision, (uint32_t)xCommand, u16Filtered);
+      vSendCommand(xCommand);
     }
   }
-  if(u16Data <= ADC_UPPERBOUND_SHFTDN) //Is this a shift down signal?
+}
+#else
+/* void vProcessSample(xHornCommands_t xSample, uint16_t u16Filtered)
+*   Original consecutive sample counters with shared paddle debounce. Kept to compare against the state machine.
+*
+*/
+static void vProcessSample(xHornCommands_t xSample, uint16_t u16Filtered)
+{
+  static uint32_t u32ShiftUpSuccessiveCount;
+  static uint32_t u32ShiftDownSuccessiveCount;
+  static uint32_t u32HornSuccessiveCount;
+  switch(xSample)
   {
-    if(u16Data >= ADC_LOWERBOUND_SHFTDN)
+  case eCMD_ShiftUp:
+    u32ShiftDownSuccessiveCount = 0u; //clear other counters
+    u32HornSuccessiveCount = 0u;
+    if(!CPS_bTimerArmed(&xPaddleDebounceTimer)) //If paddle is not currently in debounce, accept signal
+    {
+      u32ShiftUpSuccessiveCount++; //increment sample counter
+      if(u32ShiftUpSuccessiveCount >= HOLDTIME_PADDLES_SAMPLES) //if consecutive sample is valid, shifting action is considered real
+      {
+        u32ShiftUpSuccessiveCount = 0u;
+        CPS_vTimerArm(&xPaddleDebounceTimer, DEBOUNCE_PADDLES_MS, 0);
+        CPS_vTimerArm(&xPaddleHoldTimer, ACTIVETIME_PADDLES_MS, vPaddleHoldExpired);
+        LOG_EVENT(eEVT_Decision, (uint32_t)eCMD_ShiftUp, u16Filtered);
+        vSendCommand(eCMD_ShiftUp); //Send shift up command to output handlers
+      }
+    }
+    break;
+  case eCMD_ShiftDown:
+    u32ShiftUpSuccessiveCount = 0u; //clear other counters
+    u32HornSuccessiveCount = 0u;
+    if(!CPS_bTimerArmed(&xPaddleDebounceTimer)) //If paddle is not currently in debounce, accept signal
     {
-      return(eCMD_ShiftDown);
+      u32ShiftDownSuccessiveCount++; //increment sample counter
+      if(u32ShiftDownSuccessiveCount >= HOLDTIME_PADDLES_SAMPLES) //if consecutive sample is valid, shifting action is considered real
+      {
+        u32ShiftDownSuccessiveCount = 0u;
+        CPS_vTimerArm(&xPaddleDebounceTimer, DEBOUNCE_PADDLES_MS, 0);
+        CPS_vTimerArm(&xPaddleHoldTimer, ACTIVETIME_PADDLES_MS, vPaddleHoldExpired);
+        LOG_EVENT(eEVT_Decision, (uint32_t)eCMD_ShiftDown, u16Filtered);
+        vSendCommand(eCMD_ShiftDown); //Send shift up command to output handlers
+      }
     }
+    break;
+  case eCMD_HornOn:
+    u32ShiftDownSuccessiveCount = 0u; //clear other counters
+    u32ShiftUpSuccessiveCount = 0u;
+    if(!CPS_bTimerArmed(&xHornDebounceTimer)) //If horn is not currently in debounce, accept signal
+    {
+      u32HornSuccessiveCount++; //increment sample counter
+      if(u32HornSuccessiveCount >= HOLDTIME_HORN_SAMPLES) //if consecutive sample is valid, horn is considered active
+      {
+        u32HornSuccessiveCount = 0u;
+        CPS_vTimerArm(&xHornDebounceTimer, DEBOUNCE_HORN_MS, 0);
+        LOG_EVENT(eEVT_Decision, (uint32_t)eCMD_HornOn, u16Filtered);
+        vSendCommand(eCMD_HornOn); //Send horn now active command to output handlers
+      }
+    }
+    break;
+  case eCMD_Null:
+    u32ShiftUpSuccessiveCount = 0u;       //clear all successive counters
+    u32ShiftDownSuccessiveCount = 0u;
+    u32HornSuccessiveCount = 0u;
+    vSendCommand(eCMD_HornOff); //If horn is not active then ensure it is off.
+    break;
+  default:
+    u32ShiftUpSuccessiveCount = 0u;
+    u32ShiftDownSuccessiveCount = 0u;
+    u32HornSuccessiveCount = 0u;
+    vSendCommand(eCMD_HornOff);
+    break;
   }
-  return (eCMD_Null); //Not an active signal
 }
-      
+#endif
+
 static void vSendCommand(xHornCommands_t xCommand)
 {
+  uint32_t u32Request = u32OutputRequest;
   switch(xCommand)
   {
   case eCMD_ShiftUp:
-    bShiftUpHoldActive = 1;
+#if CPS_PULSE_HET
+    CPS_vPulseStart(CPS_PULSE_SHIFTUP, CPS_PULSE_LOOPS(ACTIVETIME_PADDLES_MS*1000u)); //HET times the pulse
+#endif
+    u32Request |= OUTPUT_SHIFTUP;
     break;
   case eCMD_ShiftDown:
-    bShiftDownHoldActive = 1;
+#if CPS_PULSE_HET
+    CPS_vPulseStart(CPS_PULSE_SHIFTDOWN, CPS_PULSE_LOOPS(ACTIVETIME_PADDLES_MS*1000u));
+#endif
+    u32Request |= OUTPUT_SHIFTDOWN;
     break;
   case eCMD_HornOn:
-    bHornActiveCommand = 1; //Switch on horn active signal
+    u32Request |= OUTPUT_HORN; //Switch on horn active signal
     break;
   case eCMD_HornOff:
-    bHornActiveCommand = 0; //Turn off horn
-    bShiftDownHoldActive = 0;
-    bShiftUpHoldActive = 0;
+    u32Request &= ~(OUTPUT_HORN | OUTPUT_SHIFTUP | OUTPUT_SHIFTDOWN); //Turn off horn and release the paddles
+    break;
+  case eCMD_PaddleRelease:
+    u32Request &= ~(OUTPUT_SHIFTUP | OUTPUT_SHIFTDOWN); //Paddle pulse is over
     break;
   default:
-    bHornActiveCommand = 0;
+    u32Request &= ~OUTPUT_HORN;
     break;
   }
+#if CPS_MAIN_LINK
+  if((xCommand == eCMD_ShiftUp) || (xCommand == eCMD_ShiftDown) ||
+     ((xCommand != eCMD_Null) && (u32Request != u32OutputRequest))) //Every shift, otherwise only changes
+  {
+    vLinkPost(xCommand);
+  }
+#endif
+  if(u32Request != u32OutputRequest) //Only wake the main loop when the requested outputs actually change
+  {
+    u32OutputRequest = u32Request;
+    bOutputEventPending = 1;
+    LOG_EVENT(eEVT_Request, 0u, u32Request);
+  }
 }
 
+#if CPS_MAIN_EVENTDRIVEN
+/* void vApplyOutputs(uint32_t u32Request)
+*   Stages only the pins whose state differs from what is already on the port and commits them in one pass, so the
+*   horn and its debug LEDs switch together. The debug LEDs are derived from the whole request so they can no longer
+*   be overwritten by another signal in the same pass.
+*
+*/
+static void vApplyOutputs(uint32_t u32Request)
+{
+  uint32_t u32Changed;
+  if((u32Request & (OUTPUT_HORN | OUTPUT_SHIFTUP)) != 0u)
+  {
+    u32Request |= OUTPUT_LEDA;
+  }
+  if((u32Request & (OUTPUT_HORN | OUTPUT_SHIFTDOWN)) != 0u)
+  {
+    u32Request |= OUTPUT_LEDB;
+  }
+  u32Changed = u32Request ^ u32OutputApplied;
+  if(u32Changed == 0u)
+  {
+    return;
+  }
+  if((u32Changed & OUTPUT_HORN) != 0u)
+  {
+    CPS_vOutputSet(IO_HORN_PORT, IO_HORN_PIN, ((u32Request & OUTPUT_HORN) != 0u) ? IO_HORN_ON : IO_HORN_OFF);
+  }
+#if !CPS_PULSE_HET
+  if((u32Changed & OUTPUT_SHIFTUP) != 0u)
+  {
+    CPS_vOutputSet(IO_SHIFTUP_PORT, IO_SHIFTUP_PIN, ((u32Request & OUTPUT_SHIFTUP) != 0u) ? IO_SHIFTUP_ON : IO_SHIFTUP_OFF);
+  }
+  if((u32Changed & OUTPUT_SHIFTDOWN) != 0u)
+  {
+    CPS_vOutputSet(IO_SHIFTDOWN_PORT, IO_SHIFTDOWN_PIN, ((u32Request & OUTPUT_SHIFTDOWN) != 0u) ? IO_SHIFTDOWN_ON : IO_SHIFTDOWN_OFF);
+  }
+#endif
+  if((u32Changed & OUTPUT_LEDA) != 0u)
+  {
+    CPS_vOutputSet(IO_DEBUGLED_A_PORT, IO_DEBUGLED_A_PIN, ((u32Request & OUTPUT_LEDA) != 0u) ? 1u : 0u);
+  }
+  if((u32Changed & OUTPUT_LEDB) != 0u)
+  {
+    CPS_vOutputSet(IO_DEBUGLED_B_PORT, IO_DEBUGLED_B_PIN, ((u32Request & OUTPUT_LEDB) != 0u) ? 1u : 0u);
+  }
+  u32BusWrites += CPS_u32OutputCommit();
+#if CPS_LATENCY_ENABLE
+  vLatencyOutputs(u32OutputApplied, u32Request); //output pins have just moved
+#endif
+  u32OutputApplied = u32Request;
+  LOG_EVENT_MAIN(eEVT_Output, 0u, u32Request);
+}
+#else
 static void vSetOutput(xIOSignals_t xOutputType, uint32_t u32OutputValue)
 {
   switch(xOutputType)
@@ -332,19 +675,19 @@ static void vSetOutput(xIOSignals_t xOutputType, uint32_t u32OutputValue)
     if(u32OutputValue == 1)
     {
 
-      gioSetBit(IO_HORN_PORT, IO_HORN_PIN, IO_HORN_ON);
+      CPS_vOutputSet(IO_HORN_PORT, IO_HORN_PIN, IO_HORN_ON);
 
-      gioSetBit(gioPORTA, 2u, 1u); //Debug horn both LEDs ON
-      gioSetBit(hetPORT1, 8u, 1u);
+      CPS_vOutputSet(IO_DEBUGLED_A_PORT, IO_DEBUGLED_A_PIN, 1u); //Debug horn both LEDs ON
+      CPS_vOutputSet(IO_DEBUGLED_B_PORT, IO_DEBUGLED_B_PIN, 1u);
 
     }
     else
     {
 
-      gioSetBit(IO_HORN_PORT, IO_HORN_PIN, IO_HORN_OFF);
+      CPS_vOutputSet(IO_HORN_PORT, IO_HORN_PIN, IO_HORN_OFF);
 
-      gioSetBit(gioPORTA, 2u, 0u); //Debug horn both LEDs Off
-      gioSetBit(hetPORT1, 8u, 0u);
+      CPS_vOutputSet(IO_DEBUGLED_A_PORT, IO_DEBUGLED_A_PIN, 0u); //Debug horn both LEDs Off
+      CPS_vOutputSet(IO_DEBUGLED_B_PORT, IO_DEBUGLED_B_PIN, 0u);
 
     }
     break;
@@ -352,19 +695,23 @@ static void vSetOutput(xIOSignals_t xOutputType, uint32_t u32OutputValue)
     if(u32OutputValue == 1)
     {
 
-      gioSetBit(IO_SHIFTUP_PORT, IO_SHIFTUP_PIN, IO_SHIFTUP_ON);
+#if !CPS_PULSE_HET
+      CPS_vOutputSet(IO_SHIFTUP_PORT, IO_SHIFTUP_PIN, IO_SHIFTUP_ON);
+#endif
 
-      gioSetBit(gioPORTA, 2u, 1u); //Debug horn 1 led on
-      gioSetBit(hetPORT1, 8u, 0u);
+      CPS_vOutputSet(IO_DEBUGLED_A_PORT, IO_DEBUGLED_A_PIN, 1u); //Debug horn 1 led on
+      CPS_vOutputSet(IO_DEBUGLED_B_PORT, IO_DEBUGLED_B_PIN, 0u);
 
     }
     else
     {
 
-      gioSetBit(IO_SHIFTUP_PORT, IO_SHIFTUP_PIN, IO_SHIFTUP_OFF);
+#if !CPS_PULSE_HET
+      CPS_vOutputSet(IO_SHIFTUP_PORT, IO_SHIFTUP_PIN, IO_SHIFTUP_OFF);
+#endif
 
-      gioSetBit(gioPORTA, 2u, 0u); //Debug both LEDs Off
-      gioSetBit(hetPORT1, 8u, 0u);
+      CPS_vOutputSet(IO_DEBUGLED_A_PORT, IO_DEBUGLED_A_PIN, 0u); //Debug both LEDs Off
+      CPS_vOutputSet(IO_DEBUGLED_B_PORT, IO_DEBUGLED_B_PIN, 0u);
 
       
     }
@@ -373,19 +720,23 @@ static void vSetOutput(xIOSignals_t xOutputType, uint32_t u32OutputValue)
     if(u32OutputValue == 1)
     {
 
-      gioSetBit(IO_SHIFTDOWN_PORT, IO_SHIFTDOWN_PIN, IO_SHIFTDOWN_ON);
+#if !CPS_PULSE_HET
+      CPS_vOutputSet(IO_SHIFTDOWN_PORT, IO_SHIFTDOWN_PIN, IO_SHIFTDOWN_ON);
+#endif
 
-      gioSetBit(gioPORTA, 2u, 0u); //Debug horn other led ON
-      gioSetBit(hetPORT1, 8u, 1u);
+      CPS_vOutputSet(IO_DEBUGLED_A_PORT, IO_DEBUGLED_A_PIN, 0u); //Debug horn other led ON
+      CPS_vOutputSet(IO_DEBUGLED_B_PORT, IO_DEBUGLED_B_PIN, 1u);
 
     }
     else
     {
 
-      gioSetBit(IO_SHIFTDOWN_PORT, IO_SHIFTDOWN_PIN, IO_SHIFTDOWN_OFF);
+#if !CPS_PULSE_HET
+      CPS_vOutputSet(IO_SHIFTDOWN_PORT, IO_SHIFTDOWN_PIN, IO_SHIFTDOWN_OFF);
+#endif
 
-      gioSetBit(gioPORTA, 2u, 0u); //Debug both LED Off
-      gioSetBit(hetPORT1, 8u, 0u);
+      CPS_vOutputSet(IO_DEBUGLED_A_PORT, IO_DEBUGLED_A_PIN, 0u); //Debug both LED Off
+      CPS_vOutputSet(IO_DEBUGLED_B_PORT, IO_DEBUGLED_B_PIN, 0u);
 
     }
     break;
@@ -393,6 +744,217 @@ static void vSetOutput(xIOSignals_t xOutputType, uint32_t u32OutputValue)
     //do nothing
     break;
   }
+  u32BusWrites += CPS_u32OutputCommit();
+}
+
+#endif
+
+/* void vStartUpDone(bool bSettled)
+*   Ends the start up time and records when and why. The first call wins.
+*
+*/
+static void vStartUpDone(bool bSettled)
+{
+  if(!bStartUpDone)
+  {
+    CPS_u32StartUpReadyUs = CPS_u32TimeNow32()/CPS_TIME_COUNTS_PER_US;
+    CPS_bStartUpSettled = bSettled;
+    bStartUpDone = 1;
+  }
+}
+
+#if CPS_MAIN_EARLYSTART
+/* void vStartUpExpired(void)
+*   Start up timer callback. The horn line never settled, start the inputs anyway as the original start up did.
+*
+*/
+static void vStartUpExpired(void)
+{
+  vStartUpDone(0);
+}
+
+/* void vStartUpSettled(void)
+*   Settle timer callback. The horn line has classified idle for SETTLETIME_MS.
+*
+*/
+static void vStartUpSettled(void)
+{
+  vStartUpDone(1);
+}
+#endif
+
+/* void vPaddleHoldExpired(void)
+*   Paddle hold timer callback. The only place the shift output pulse ends: it lasts ACTIVETIME_PADDLES_MS whether the
+*   paddle is let go sooner or still held, as the paddle inputs send no command on release.
+*
+*/
+static void vPaddleHoldExpired(void)
+{
+  vSendCommand(eCMD_PaddleRelease);
+#if CPS_MAIN_LINK
+  vLinkFlush();
+#endif
+}
+
+#if CPS_LATENCY_ENABLE
+/* void vLatencyOutputs(uint32_t u32Old, uint32_t u32New)
+*   Hands every output change to the latency measurement with the band that asks for it: a rising horn or shift
+*   output answers a press of that band, a falling horn answers the wire going back to idle. The end of a shift pulse
+*   is timed, no step asked for it.
+*
+*/
+static void vLatencyOutputs(uint32_t u32Old, uint32_t u32New)
+{
+  uint32_t u32Rose = u32New & ~u32Old;
+  if((u32Rose & OUTPUT_HORN) != 0u)
+  {
+    CPS_vLatencyOutput((uint32_t)eCMD_HornOn);
+  }
+  if((u32Rose & OUTPUT_SHIFTUP) != 0u)
+  {
+    CPS_vLatencyOutput((uint32_t)eCMD_ShiftUp);
+  }
+  if((u32Rose & OUTPUT_SHIFTDOWN) != 0u)
+  {
+    CPS_vLatencyOutput((uint32_t)eCMD_ShiftDown);
+  }
+  if((u32Old & ~u32New & OUTPUT_HORN) != 0u)
+  {
+    CPS_vLatencyOutput((uint32_t)eCMD_Null);
+  }
+}
+#endif
+
+#if CPS_MAIN_LINK
+/* void vLinkPost(xHornCommands_t xCommand)
+*   Adds a command to the frame of the current control cycle, ISR context. The record type is mapped case by case,
+*   so neither enum depends on the order of the other. A full batch is sent early rather than losing the event.
+*
+*/
+static void vLinkPost(xHornCommands_t xCommand)
+{
+  uint32_t u32Stamp = CPS_u32TimeNow32();
+  xCPSLinkEvent_t xEvent;
+  switch(xCommand)
+  {
+  case eCMD_ShiftUp:
+    xEvent = eLINK_ShiftUp;
+    break;
+  case eCMD_ShiftDown:
+    xEvent = eLINK_ShiftDown;
+    break;
+  case eCMD_HornOn:
+    xEvent = eLINK_HornOn;
+    break;
+  case eCMD_HornOff:
+    xEvent = eLINK_HornOff;
+    break;
+  case eCMD_PaddleRelease:
+    xEvent = eLINK_PaddleRelease;
+    break;
+  default:
+    return; //eCMD_Null has no record
+  }
+  if(!CPS_bFrameBatchAdd(&xLinkBatch, xEvent, 0u, u32Stamp))
+  {
+    vLinkFlush();
+    (void)CPS_bFrameBatchAdd(&xLinkBatch, xEvent, 0u, u32Stamp);
+  }
+}
+
+/* void vLinkFlush(void)
+*   Queues the batched events as one frame, ISR context. Nothing is sent for a cycle without events. SEQ advances
+*   even when the transmit ring is full, so the SCT sees the lost frame as a gap.
+*
+*/
+static void vLinkFlush(void)
+{
+  uint8_t u8Seq;
+  uint32_t u32Length;
+  if(xLinkBatch.u32Records != 0u)
+  {
+    u8Seq = CPS_u8FrameSeq();
+    u32Length = CPS_u32FrameBatchEnd(&xLinkBatch, u8Seq);
+    au32LinkSent[u8Seq & LINK_SENT_MASK] = CPS_u32TimeNow32();
+    (void)CPS_bSciWrite(xLinkBatch.au8Frame, u32Length);
+    CPS_vFrameBatchStart(&xLinkBatch);
+  }
+}
+
+/* void vLinkKeepAlive(void)
+*   Keepalive timer callback, sends an event frame every CPS_FRAME_KEEPALIVE_MS and re-arms itself. The SCT drops its
+*   outputs when these stop. While the horn is on the frame repeats the horn on record, so a horn the SCT dropped on
+*   a lost frame comes back on; otherwise it only carries the stamp.
+*
+*/
+static void vLinkKeepAlive(void)
+{
+  uint8_t au8Frame[CPS_FRAME_MAX];
+  uint8_t au8Stamp[CPS_FRAME_STAMP_BYTES];
+  uint32_t u32Stamp;
+  uint32_t u32Length;
+  uint8_t u8Seq;
+  CPS_vTimerArm(&xLinkKeepAliveTimer, CPS_FRAME_KEEPALIVE_MS, vLinkKeepAlive);
+  if((u32OutputRequest & OUTPUT_HORN) != 0u)
+  {
+    vLinkPost(eCMD_HornOn); //The batch is empty here, every ISR that posts flushes before it returns
+    vLinkFlush();
+    return;
+  }
+  u32Stamp = CPS_u32TimeNow32();
+  au8Stamp[0u] = (uint8_t)u32Stamp;
+  au8Stamp[1u] = (uint8_t)(u32Stamp >> 8u);
+  au8Stamp[2u] = (uint8_t)(u32Stamp >> 16u);
+  au8Stamp[3u] = (uint8_t)(u32Stamp >> 24u);
+  u8Seq = CPS_u8FrameSeq();
+  u32Length = CPS_u32FrameEncode(au8Frame, u8Seq, eFRAME_Events, au8Stamp, sizeof(au8Stamp));
+  au32LinkSent[u8Seq & LINK_SENT_MASK] = u32Stamp;
+  (void)CPS_bSciWrite(au8Frame, u32Length);
+}
+
+/* void vLinkReceive(void)
+*   Main loop. Runs whatever the SCT has sent through the parser and records its acknowledgements. The SCT acknowledges
+*   a frame after writing its pins, so the round trip bounds the command to actuation latency from above.
+*
+*/
+static void vLinkReceive(void)
+{
+  uint8_t au8Rx[16u];
+  uint32_t u32Count;
+  uint32_t u32Byte;
+  do
+  {
+    u32Count = CPS_u32SciRead(au8Rx, sizeof(au8Rx));
+    for(u32Byte = 0u; u32Byte < u32Count; u32Byte++)
+    {
+      if(CPS_bFrameParse(&CPS_xLinkParser, au8Rx[u32Byte]) && (CPS_xLinkParser.u8Type == (uint8_t)eFRAME_Ack) &&
+         (CPS_xLinkParser.u8Length != 0u))
+      {
+        CPS_u8LinkAcked = CPS_xLinkParser.au8Payload[0u];
+        CPS_u32LinkAcks++;
+        CPS_vProfileAdd(&CPS_xLinkRoundTrip,
+                        (CPS_u32TimeNow32() - au32LinkSent[CPS_u8LinkAcked & LINK_SENT_MASK])/CPS_TIME_COUNTS_PER_US);
+      }
+    }
+  } while(u32Count == sizeof(au8Rx));
+}
+#endif
+
+/* void vPublishRates(void)
+*   Rate timer callback. Publishes the bus write, interrupt and telemetry rates of the last period and re-arms itself.
+*
+*/
+static void vPublishRates(void)
+{
+  uint32_t u32BusWritesNow = u32BusWrites; //One aligned load, the main context adds can not tear it
+  CPS_u32BusWritesPerSecond = u32BusWritesNow - u32BusWritesPublished;
+  u32BusWritesPublished = u32BusWritesNow;
+  CPS_u32InterruptsPerSecond = u32InterruptCount;
+  u32InterruptCount = 0u;
+#if CPS_TELEMETRY_ENABLE
+  CPS_vTelemetryRates(RATE_PUBLISH_MS);
+#endif
+  CPS_vTimerArm(&xRateTimer, RATE_PUBLISH_MS, vPublishRates);
 }
 
 static void vERROR(void)
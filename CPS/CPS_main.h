@@ -14,15 +14,34 @@
 
 /* Include Files */
 #include "CPS_common.h"
+#include "CPS_profile.h"
 
 /* Defines */
 
 /* Global Types */
+typedef enum
+{
+  eCMD_ShiftUp,
+  eCMD_ShiftDown,
+  eCMD_HornOn,
+  eCMD_HornOff,
+  eCMD_PaddleRelease,
+  eCMD_Null
+} xHornCommands_t;
+
+/* Global Vars */
+extern uint32_t CPS_u32BusWritesPerSecond;
+extern uint32_t CPS_u32InterruptsPerSecond;
+extern xCPSProfile_t CPS_xProfileADCISR;
+extern uint32_t CPS_u32LinkAcks; //CPS_MAIN_LINK builds
+extern xCPSProfile_t CPS_xLinkRoundTrip;
 
 /* Global Function Prototypes */
 
 void CPS_vMain(void);
 void CPS_vISRADCGroup1(void);
+void CPS_vISRADCGroup2(void);
+void CPS_vISRADCMagnitude(void);
 void CPS_vISRRTICompare0(void);
 void CPS_vISRRTICompare1(void);
 
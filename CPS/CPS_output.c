@@ -0,0 +1,124 @@
+/** @file CPS_output.c
+*   @brief Shadowed output ports
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Every port CPS drives has a shadow of its output latch. CPS_vOutputSet only updates the shadow and the pending set
+*   and clear masks; pins that already hold the requested level are dropped there. CPS_u32OutputCommit then writes
+*   each port that has pending changes with at most one DCLR and one DSET store, so pins on the same port that change
+*   together move in the same bus cycle (clears first, then sets) and ports follow each other in back to back stores.
+*
+*   The shadows are loaded from DOUT by CPS_vOutputInit. From then on all writes to these ports have to go through
+*   this layer, otherwise the shadow no longer matches the pins. Main loop context only.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_output.h"
+
+/* Internal Types */
+typedef struct
+{
+  uint32_t u32Image; //Latch state after the last commit plus staged changes
+  uint32_t u32Set; //Pins to set on the next commit
+  uint32_t u32Clear; //Pins to clear on the next commit
+} xOutputShadow_t;
+
+/* Global Vars */
+#if CPS_OUTPUT_PROFILE
+xCPSProfile_t CPS_xProfileOutputCommit;
+#endif
+
+/* Internal Vars */
+static gioPORT_t * const apxOutputPorts[eOUT_PortCount] =
+{
+  gioPORTA,
+  hetPORT1,
+  spiPORT2,
+  spiPORT3
+};
+static xOutputShadow_t axOutputShadow[eOUT_PortCount];
+
+/* Global Functions */
+
+/* void CPS_vOutputInit(void)
+*   Loads the shadows from the port latches and drops anything staged. Call after the gio, het and spi drivers are
+*   initialised.
+*
+*/
+void CPS_vOutputInit(void)
+{
+  for(uint32_t u32Port = 0u; u32Port < (uint32_t)eOUT_PortCount; u32Port++)
+  {
+    axOutputShadow[u32Port].u32Image = apxOutputPorts[u32Port]->DOUT;
+    axOutputShadow[u32Port].u32Set = 0u;
+    axOutputShadow[u32Port].u32Clear = 0u;
+  }
+#if CPS_OUTPUT_PROFILE
+  CPS_vProfileReset(&CPS_xProfileOutputCommit);
+#endif
+}
+
+/* void CPS_vOutputSet(xCPSOutputPort_t xPort, uint32_t u32Pin, uint32_t u32Value)
+*   Stages a pin level for the next commit. A later call for the same pin before the commit wins.
+*
+*/
+void CPS_vOutputSet(xCPSOutputPort_t xPort, uint32_t u32Pin, uint32_t u32Value)
+{
+  xOutputShadow_t *pxShadow = &axOutputShadow[xPort];
+  uint32_t u32Mask = 1u << u32Pin;
+  uint32_t u32Latched = (pxShadow->u32Image ^ pxShadow->u32Set ^ pxShadow->u32Clear) & u32Mask; //Level on the pin now
+  pxShadow->u32Set &= ~u32Mask;
+  pxShadow->u32Clear &= ~u32Mask;
+  if(u32Value != 0u)
+  {
+    pxShadow->u32Image |= u32Mask;
+    if(u32Latched == 0u)
+    {
+      pxShadow->u32Set |= u32Mask;
+    }
+  }
+  else
+  {
+    pxShadow->u32Image &= ~u32Mask;
+    if(u32Latched != 0u)
+    {
+      pxShadow->u32Clear |= u32Mask;
+    }
+  }
+}
+
+/* uint32_t CPS_u32OutputCommit(void)
+*   Writes all staged changes out. Returns the number of port stores issued, 0 when nothing was staged.
+*
+*/
+uint32_t CPS_u32OutputCommit(void)
+{
+  uint32_t u32Writes = 0u;
+#if CPS_OUTPUT_PROFILE
+  uint32_t u32Start = CPS_u32ProfileCycles();
+#endif
+  for(uint32_t u32Port = 0u; u32Port < (uint32_t)eOUT_PortCount; u32Port++)
+  {
+    if(axOutputShadow[u32Port].u32Clear != 0u)
+    {
+      apxOutputPorts[u32Port]->DCLR = axOutputShadow[u32Port].u32Clear;
+      axOutputShadow[u32Port].u32Clear = 0u;
+      u32Writes++;
+    }
+    if(axOutputShadow[u32Port].u32Set != 0u)
+    {
+      apxOutputPorts[u32Port]->DSET = axOutputShadow[u32Port].u32Set;
+      axOutputShadow[u32Port].u32Set = 0u;
+      u32Writes++;
+    }
+  }
+#if CPS_OUTPUT_PROFILE
+  if(u32Writes != 0u)
+  {
+    CPS_vProfileAdd(&CPS_xProfileOutputCommit, CPS_u32ProfileCycles() - u32Start);
+  }
+#endif
+  return(u32Writes);
+}
@@ -0,0 +1,43 @@
+/** @file CPS_output.h
+*   @brief Shadowed output ports
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the output layer used for every CPS output pin. Pin changes are staged in a shadow image of
+*   each port and written out together by CPS_u32OutputCommit, one DCLR and one DSET store per port that changed.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_OUTPUT_H__
+#define __CPS_OUTPUT_H__
+
+/* Include Files */
+#include "CPS_profile.h"
+
+/* Defines */
+#define CPS_OUTPUT_PROFILE 1u //Time every commit with the PMU (watch CPS_xProfileOutputCommit)
+
+/* Global Types */
+typedef enum
+{
+  eOUT_GioA,
+  eOUT_Het1,
+  eOUT_Spi2,
+  eOUT_Spi3,
+  eOUT_PortCount
+} xCPSOutputPort_t;
+
+/* Global Vars */
+#if CPS_OUTPUT_PROFILE
+extern xCPSProfile_t CPS_xProfileOutputCommit; //PMU cycles per commit that wrote at least one port
+#endif
+
+/* Global Function Prototypes */
+
+void CPS_vOutputInit(void);
+void CPS_vOutputSet(xCPSOutputPort_t xPort, uint32_t u32Pin, uint32_t u32Value);
+uint32_t CPS_u32OutputCommit(void);
+
+#endif
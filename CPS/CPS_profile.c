@@ -0,0 +1,53 @@
+/** @file CPS_profile.c
+*   @brief CPU cycle profiling helpers
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Starts the PMU cycle counter and keeps min/max/total statistics for timed code sections.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_profile.h"
+
+/* Global Functions */
+
+/* void CPS_vProfileInit(void)
+*   Starts the PMU cycle counter free running at the CPU clock. Safe to call more than once.
+*
+*/
+void CPS_vProfileInit(void)
+{
+  CPS_vTimeCyclesStart();
+}
+
+/* void CPS_vProfileReset(xCPSProfile_t *pxProfile)
+*   Clears the statistics of one profiled section.
+*
+*/
+void CPS_vProfileReset(xCPSProfile_t *pxProfile)
+{
+  pxProfile->u32Count = 0u;
+  pxProfile->u32MinCycles = 0xFFFFFFFFu;
+  pxProfile->u32MaxCycles = 0u;
+  pxProfile->u64TotalCycles = 0u;
+}
+
+/* void CPS_vProfileAdd(xCPSProfile_t *pxProfile, uint32_t u32Cycles)
+*   Adds one timed run to the statistics.
+*
+*/
+void CPS_vProfileAdd(xCPSProfile_t *pxProfile, uint32_t u32Cycles)
+{
+  pxProfile->u32Count++;
+  pxProfile->u64TotalCycles += u32Cycles;
+  if(u32Cycles < pxProfile->u32MinCycles)
+  {
+    pxProfile->u32MinCycles = u32Cycles;
+  }
+  if(u32Cycles > pxProfile->u32MaxCycles)
+  {
+    pxProfile->u32MaxCycles = u32Cycles;
+  }
+}
@@ -0,0 +1,41 @@
+/** @file CPS_profile.h
+*   @brief CPU cycle profiling helpers
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface used to time code sections with the Cortex-R4 PMU cycle counter. Results are
+*   kept in RAM and are read out with the debugger.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_PROFILE_H__
+#define __CPS_PROFILE_H__
+
+/* Include Files */
+#include "CPS_common.h"
+#include "CPS_time.h"
+
+/* Global Types */
+typedef struct
+{
+  uint32_t u32Count; //Number of timed runs
+  uint32_t u32MinCycles;
+  uint32_t u32MaxCycles;
+  uint64_t u64TotalCycles; //Sum of all runs, divide by u32Count for the mean. 32 bits overflow within the hour.
+} xCPSProfile_t;
+
+/* Global Function Prototypes */
+
+void CPS_vProfileInit(void);
+void CPS_vProfileReset(xCPSProfile_t *pxProfile);
+void CPS_vProfileAdd(xCPSProfile_t *pxProfile, uint32_t u32Cycles);
+
+/* uint32_t CPS_u32ProfileCycles(void)
+*   Current value of the free running PMU cycle counter. Differences are taken with unsigned subtraction.
+*
+*/
+#define CPS_u32ProfileCycles() CPS_u32TimeCycles()
+
+#endif
@@ -0,0 +1,83 @@
+/** @file CPS_pulse.c
+*   @brief N2HET timed one-shot pulses
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   The HALCoGen PWM channels of het1PROGRAM are turned into one-shots. Each channel is a PWCNT (pin, duty count),
+*   a DJZ (period count) and two MOV64 reloads run at the end of the period. CPS_vPulseInit disables the pin action
+*   of the duty reload, loads it with 0 and sets the period to the longest the counter allows, so the period end no
+*   longer touches the pin. The PWCNT then drives the pin active for as many loop resolution periods as its count
+*   holds and inactive once it reaches 0. A pulse is started by storing its width into the PWCNT count; the HET does
+*   all the timing from there. The period counter is restarted just before, so no reload can cut a pulse short.
+*
+*   Pulse widths are exact to one loop resolution period (640ns). The rising edge follows the store by up to one loop.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_pulse.h"
+#include "het.h"
+
+/* Defines */
+#define PULSE_DUTY(u32Pwm) (((u32Pwm) << 1u) + 1u) //PWCNT, drives the pin
+#define PULSE_PERIOD(u32Pwm) (((u32Pwm) << 1u) + 2u) //DJZ period counter
+#define PULSE_DUTY_RELOAD(u32Pwm) (((u32Pwm) << 1u) + 41u) //MOV64 duty reload at the end of the period
+#define PULSE_PERIOD_RELOAD(u32Pwm) (((u32Pwm) << 1u) + 42u) //MOV64 period reload
+#define PULSE_PERIOD_DATA (CPS_PULSE_MAX_LOOPS << 7u)
+
+/* Local Function Prototypes */
+static void vPulseSetup(uint32_t u32Pwm);
+
+/* Global Functions */
+
+/* void CPS_vPulseInit(void)
+*   Turns the shift channels into idle one-shots with the pins driven inactive. Call after hetInit.
+*
+*/
+void CPS_vPulseInit(void)
+{
+  vPulseSetup(CPS_PULSE_SHIFTUP);
+  vPulseSetup(CPS_PULSE_SHIFTDOWN);
+}
+
+/* void CPS_vPulseStart(uint32_t u32Pwm, uint32_t u32Loops)
+*   Drives the channel pin active for u32Loops loop resolution periods (see CPS_PULSE_LOOPS). A pulse in progress is
+*   restarted with the new width. Any context.
+*
+*/
+void CPS_vPulseStart(uint32_t u32Pwm, uint32_t u32Loops)
+{
+  if(u32Loops > CPS_PULSE_MAX_LOOPS)
+  {
+    u32Loops = CPS_PULSE_MAX_LOOPS;
+  }
+  hetRAM1->Instruction[PULSE_PERIOD(u32Pwm)].Data = PULSE_PERIOD_DATA;
+  hetRAM1->Instruction[PULSE_DUTY(u32Pwm)].Data = u32Loops << 7u;
+}
+
+/* bool CPS_bPulseActive(uint32_t u32Pwm)
+*   True while the channel pin is being held active by the HET.
+*
+*/
+bool CPS_bPulseActive(uint32_t u32Pwm)
+{
+  return((hetRAM1->Instruction[PULSE_DUTY(u32Pwm)].Data >> 7u) != 0u);
+}
+
+/* Local Functions */
+
+/* void vPulseSetup(uint32_t u32Pwm)
+*   Configures one HALCoGen PWM channel as a one-shot.
+*
+*/
+static void vPulseSetup(uint32_t u32Pwm)
+{
+  uint32_t u32Pin = (hetRAM1->Instruction[PULSE_DUTY(u32Pwm)].Control >> 8u) & 0x1Fu;
+  pwmStop(hetRAM1, u32Pwm);
+  hetRAM1->Instruction[PULSE_DUTY_RELOAD(u32Pwm)].Data = 0u;
+  hetRAM1->Instruction[PULSE_PERIOD_RELOAD(u32Pwm)].Data = PULSE_PERIOD_DATA;
+  hetRAM1->Instruction[PULSE_PERIOD(u32Pwm)].Data = PULSE_PERIOD_DATA;
+  hetRAM1->Instruction[PULSE_DUTY(u32Pwm)].Data = 0u;
+  hetREG1->DIR |= (uint32_t)1u << u32Pin;
+}
@@ -0,0 +1,39 @@
+/** @file CPS_pulse.h
+*   @brief N2HET timed one-shot pulses
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface used to generate the paddle shift pulses in the N2HET. The CPU starts a pulse
+*   and the HET ends it after an exact number of loop resolution periods, with no CPU timing involved.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_PULSE_H__
+#define __CPS_PULSE_H__
+
+/* Include Files */
+#include "CPS_common.h"
+
+/* Defines */
+#define CPS_PULSE_HET 0u //1: shift outputs are HET one-shots. The current board has them on SPI2 pins, so this is off.
+
+#define CPS_PULSE_SHIFTUP pwm1 //HALCoGen PWM channel reused as one-shot, drives HET pin 10
+#define CPS_PULSE_SHIFTDOWN pwm2 //HET pin 12
+#define CPS_PULSE_LOOP_NS 640u //N2HET loop resolution: 2^LRPFC(6) HR clocks of VCLK2 (100MHz), see pwmSetSignal
+#define CPS_PULSE_MAX_LOOPS 0x01FFFFFFu //25 bit count field
+
+/* uint32_t CPS_PULSE_LOOPS(uint32_t u32Us)
+*   Pulse width in loop resolution periods, rounded to the nearest. Constant arguments fold at compile time.
+*
+*/
+#define CPS_PULSE_LOOPS(u32Us) ((((u32Us)*1000u) + (CPS_PULSE_LOOP_NS/2u))/CPS_PULSE_LOOP_NS)
+
+/* Global Function Prototypes */
+
+void CPS_vPulseInit(void);
+void CPS_vPulseStart(uint32_t u32Pwm, uint32_t u32Loops);
+bool CPS_bPulseActive(uint32_t u32Pwm);
+
+#endif
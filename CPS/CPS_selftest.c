@@ -0,0 +1,299 @@
+/** @file CPS_selftest.c
+*   @brief Background self test scheduler
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   A period timer starts a round; CPS_bSelfTestSlice then works through the test table from the idle loop. Each
+*   slice runs tests back to back while the worst case seen so far of the next one still fits the slice budget, and
+*   always at least one so a round cannot stall. The HALCoGen tests are atomic and take a few microseconds each.
+*
+*   The tests corrupt the parity bits of one RAM location and restore them, so they must not be interrupted: the
+*   caller keeps IRQs masked for the slice. Only the checks that leave live state alone and do not assert nERROR run
+*   here; the ESM group 1 parity channels are not routed to nERROR (esmInit EEPAPR1 = 0). checkRAMECC provokes a data
+*   abort and an ESM group 3 error, het1ParityCheck flips parity in the N2HET program RAM and vimParityCheck corrupts
+*   a live vector, so those three stay in _c_int00.
+*
+*   A round starts with the dual-port PBIST of the peripheral RAMs the CPS leaves unused, one group at a time. pbistRun
+*   only starts the controller, which then works on its own as it does next to checkRAMECC in _c_int00: a slice that
+*   finds the group still running ends at once and the idle loop comes back to poll it. A finished group is checked,
+*   the controller stopped and its RAM initialised again the way _c_int00 does, so the parity checks that follow find
+*   it as the start up left it. pbistFail is for the boot only, a failure here goes to CPS_vSelfTestFail.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_selftest.h"
+#include "CPS_time.h"
+#include "CPS_timer.h"
+#include "sys_selftest.h"
+
+/* Defines */
+#define SELFTEST_PERIOD_COUNTS (CPS_SELFTEST_PERIOD_MS*1000u*CPS_TIME_COUNTS_PER_US)
+#define SELFTEST_SLICE_CYCLES (CPS_SELFTEST_SLICE_US*CPS_TIME_CYCLES_PER_US)
+
+/* Internal Types */
+typedef void (*pvSelfTest_t)(void);
+
+typedef struct
+{
+  uint32_t u32Group; //PBIST RINFOL group
+  pvSelfTest_t pvHold; //Puts the module in the state PBIST finds it in at start up, 0: nothing to do
+  pvSelfTest_t pvRestore; //Initialises the RAM again after the test
+} xSelfTestPbist_t;
+
+/* Global Vars */
+xCPSSelfTest_t CPS_xSelfTest;
+
+/* Local Function Prototypes */
+static void vSelfTestPeriod(void);
+static void vSelfTestPbistStep(void);
+static void vSelfTestHoldMibspi1(void);
+static void vSelfTestInitHtu1(void);
+static void vSelfTestInitCan1(void);
+static void vSelfTestInitCan2(void);
+static void vSelfTestInitMibspi1(void);
+
+/* Internal Vars */
+static const xSelfTestPbist_t axSelfTestPbist[CPS_SELFTEST_PBIST_COUNT] =
+{
+  {CPS_SELFTEST_PBIST_HTU1, 0, vSelfTestInitHtu1},
+  {CPS_SELFTEST_PBIST_CAN1, 0, vSelfTestInitCan1},
+  {CPS_SELFTEST_PBIST_CAN2, 0, vSelfTestInitCan2},
+  {CPS_SELFTEST_PBIST_MIBSPI1, vSelfTestHoldMibspi1, vSelfTestInitMibspi1}
+};
+static const pvSelfTest_t apvSelfTests[CPS_SELFTEST_COUNT] =
+{
+  htu1ParityCheck,
+  adc1ParityCheck,
+  can1ParityCheck,
+  can2ParityCheck,
+  mibspi1ParityCheck
+};
+static volatile bool bSelfTestActive; //Round started by the period timer and not finished yet
+static uint32_t u32SelfTestPbist; //Next PBIST table entry of the running round, CPS_SELFTEST_PBIST_COUNT: all done
+static bool bSelfTestPbistRunning; //The controller is testing axSelfTestPbist[u32SelfTestPbist]
+static uint32_t u32SelfTestPbistStart; //RTI count the running group was started at
+static uint32_t u32SelfTestNext; //Next table entry of the running round
+static uint32_t u32SelfTestStart; //RTI count at the start of the running round
+static xCPSTimer_t xSelfTestTimer;
+
+/* Global Functions */
+
+/* void CPS_vSelfTestInit(void)
+*   Clears the statistics, starts the first round and arms the period timer. Call after CPS_vTimeInit.
+*
+*/
+void CPS_vSelfTestInit(void)
+{
+  uint32_t u32Test;
+  CPS_xSelfTest.u32Rounds = 0u;
+  CPS_xSelfTest.u32Overdue = 0u;
+  CPS_xSelfTest.u32LastRoundUs = 0u;
+  CPS_xSelfTest.u32MaxRoundUs = 0u;
+  CPS_xSelfTest.u32Slices = 0u;
+  CPS_xSelfTest.u32MaxSliceCycles = 0u;
+  CPS_xSelfTest.u32Failures = 0u;
+  CPS_xSelfTest.u32LastFailure = 0u;
+  for(u32Test = 0u; u32Test < CPS_SELFTEST_COUNT; u32Test++)
+  {
+    CPS_xSelfTest.au32TestCycles[u32Test] = 0u;
+  }
+  for(u32Test = 0u; u32Test < CPS_SELFTEST_PBIST_COUNT; u32Test++)
+  {
+    CPS_xSelfTest.au32PbistUs[u32Test] = 0u;
+  }
+  CPS_xSelfTest.bCovered = false;
+  u32SelfTestPbist = 0u;
+  bSelfTestPbistRunning = false;
+  u32SelfTestNext = 0u;
+  u32SelfTestStart = CPS_u32TimeNow32();
+  bSelfTestActive = true;
+  CPS_vTimerArm(&xSelfTestTimer, CPS_SELFTEST_PERIOD_MS, vSelfTestPeriod);
+}
+
+/* bool CPS_bSelfTestSlice(void)
+*   Runs one slice of the current round, IRQs must be masked. Returns true while the round has tests left, so the
+*   idle loop can come straight back after letting pending interrupts in; false when there is nothing to do until the
+*   next period.
+*
+*/
+bool CPS_bSelfTestSlice(void)
+{
+  uint32_t u32SliceStart;
+  uint32_t u32TestStart;
+  uint32_t u32Cycles;
+  uint32_t u32Next;
+  if(!bSelfTestActive)
+  {
+    return(false);
+  }
+  u32SliceStart = CPS_u32TimeCycles();
+  if(u32SelfTestPbist < CPS_SELFTEST_PBIST_COUNT)
+  {
+    vSelfTestPbistStep(); //Starts, polls or finishes one group, the parity tests wait for all of them
+  }
+  else
+  {
+    do
+    {
+      u32TestStart = CPS_u32TimeCycles();
+      apvSelfTests[u32SelfTestNext]();
+      u32Cycles = CPS_u32TimeCyclesSince(u32TestStart);
+      if(u32Cycles > CPS_xSelfTest.au32TestCycles[u32SelfTestNext])
+      {
+        CPS_xSelfTest.au32TestCycles[u32SelfTestNext] = u32Cycles;
+      }
+      u32SelfTestNext++;
+      u32Next = (u32SelfTestNext < CPS_SELFTEST_COUNT) ? CPS_xSelfTest.au32TestCycles[u32SelfTestNext] : 0u;
+    } while((u32SelfTestNext < CPS_SELFTEST_COUNT) &&
+            ((CPS_u32TimeCyclesSince(u32SliceStart) + u32Next) <= SELFTEST_SLICE_CYCLES));
+  }
+  u32Cycles = CPS_u32TimeCyclesSince(u32SliceStart);
+  CPS_xSelfTest.u32Slices++;
+  if(u32Cycles > CPS_xSelfTest.u32MaxSliceCycles)
+  {
+    CPS_xSelfTest.u32MaxSliceCycles = u32Cycles;
+  }
+  if(u32SelfTestNext >= CPS_SELFTEST_COUNT)
+  {
+    u32Cycles = CPS_u32TimeNow32() - u32SelfTestStart;
+    CPS_xSelfTest.u32LastRoundUs = u32Cycles/CPS_TIME_COUNTS_PER_US;
+    if(CPS_xSelfTest.u32LastRoundUs > CPS_xSelfTest.u32MaxRoundUs)
+    {
+      CPS_xSelfTest.u32MaxRoundUs = CPS_xSelfTest.u32LastRoundUs;
+    }
+    CPS_xSelfTest.bCovered = (u32Cycles <= SELFTEST_PERIOD_COUNTS);
+    CPS_xSelfTest.u32Rounds++;
+    u32SelfTestPbist = 0u;
+    u32SelfTestNext = 0u;
+    bSelfTestActive = false;
+  }
+  return(bSelfTestActive);
+}
+
+/* void CPS_vSelfTestFail(uint32_t u32Flag)
+*   Called from selftestFailNotification with the flag of the failed test. Failures of the start up tests land in .bss
+*   before the C start up and are cleared with it; only the run time tests are counted.
+*
+*/
+void CPS_vSelfTestFail(uint32_t u32Flag)
+{
+  CPS_xSelfTest.u32Failures++;
+  CPS_xSelfTest.u32LastFailure = u32Flag;
+}
+
+/* Local Functions */
+
+/* void vSelfTestPeriod(void)
+*   Period timer callback, compare1 ISR context. Starts the next round, or counts the period as missed when the
+*   current one has not finished.
+*
+*/
+static void vSelfTestPeriod(void)
+{
+  if(bSelfTestActive)
+  {
+    CPS_xSelfTest.u32Overdue++;
+    CPS_xSelfTest.bCovered = false;
+  }
+  else
+  {
+    u32SelfTestStart = CPS_u32TimeNow32();
+    bSelfTestActive = true;
+  }
+  CPS_vTimerArm(&xSelfTestTimer, CPS_SELFTEST_PERIOD_MS, vSelfTestPeriod);
+}
+
+/* void vSelfTestPbistStep(void)
+*   One slice of the PBIST part of a round: starts the next group, or checks, stops and restores the running one once
+*   the controller reports it complete.
+*
+*/
+static void vSelfTestPbistStep(void)
+{
+  const xSelfTestPbist_t *pxPbist = &axSelfTestPbist[u32SelfTestPbist];
+  uint32_t u32Us;
+  if(!bSelfTestPbistRunning)
+  {
+    if(pxPbist->pvHold != 0)
+    {
+      pxPbist->pvHold();
+    }
+    pbistRun(pxPbist->u32Group, (uint32_t)PBIST_March13N_DP);
+    u32SelfTestPbistStart = CPS_u32TimeNow32();
+    bSelfTestPbistRunning = true;
+  }
+  else if(pbistIsTestCompleted())
+  {
+    u32Us = (CPS_u32TimeNow32() - u32SelfTestPbistStart)/CPS_TIME_COUNTS_PER_US;
+    if(u32Us > CPS_xSelfTest.au32PbistUs[u32SelfTestPbist])
+    {
+      CPS_xSelfTest.au32PbistUs[u32SelfTestPbist] = u32Us;
+    }
+    if(!pbistIsTestPassed())
+    {
+      CPS_vSelfTestFail(CPS_SELFTEST_PBIST_FAIL | pxPbist->u32Group);
+    }
+    pbistStop();
+    pxPbist->pvRestore();
+    bSelfTestPbistRunning = false;
+    u32SelfTestPbist++;
+  }
+}
+
+/* void vSelfTestHoldMibspi1(void)
+*   MibSPI1 goes back into local reset, where it is when _c_int00 tests its RAM.
+*
+*/
+static void vSelfTestHoldMibspi1(void)
+{
+  mibspiREG1->GCR0 = 0x0U;
+}
+
+/* void vSelfTestInitHtu1(void)
+*   HTU1 RAM and parity initialised again, the enableParity, memoryInit, disableParity order of _c_int00.
+*
+*/
+static void vSelfTestInitHtu1(void)
+{
+  htuREG1->PCR = 0xAU;
+  memoryInit((uint32_t)1U << 4U);
+  htuREG1->PCR = 0x5U;
+}
+
+/* void vSelfTestInitCan1(void)
+*   CAN1 RAM and parity initialised again, as vSelfTestInitHtu1.
+*
+*/
+static void vSelfTestInitCan1(void)
+{
+  canREG1->CTL = ((uint32_t)0xAU << 10U) | 1U;
+  memoryInit((uint32_t)1U << 5U);
+  canREG1->CTL = ((uint32_t)0x5U << 10U) | 1U;
+}
+
+/* void vSelfTestInitCan2(void)
+*   CAN2 RAM and parity initialised again, as vSelfTestInitHtu1.
+*
+*/
+static void vSelfTestInitCan2(void)
+{
+  canREG2->CTL = ((uint32_t)0xAU << 10U) | 1U;
+  memoryInit((uint32_t)1U << 6U);
+  canREG2->CTL = ((uint32_t)0x5U << 10U) | 1U;
+}
+
+/* void vSelfTestInitMibspi1(void)
+*   Releases MibSPI1 from local reset, which initialises its RAM and parity, and waits for that as CPS_vBootWarmStart
+*   does.
+*
+*/
+static void vSelfTestInitMibspi1(void)
+{
+  mibspiREG1->GCR0 = 0x1U;
+  while((mibspiREG1->FLG & 0x01000000U) == 0x01000000U)
+  {
+    //Wait for the MibSPI1 RAM
+  }
+}
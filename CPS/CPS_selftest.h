@@ -0,0 +1,67 @@
+/** @file CPS_selftest.h
+*   @brief Background self test scheduler
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the scheduler that runs the peripheral RAM parity tests of sys_selftest.c from the idle
+*   loop instead of at start up, together with the dual-port PBIST of the peripheral RAMs the CPS leaves unused
+*   (CPS_SELFTEST_PBIST_GROUPS). Start up keeps the CPU RAM and ROM PBIST runs, the dual-port PBIST of the RAMs the
+*   application uses, the RAM initialisation, checkRAMECC and the HET1 and VIM parity checks, which either gate the
+*   application or disturb it at run time. Every CPS_SELFTEST_PERIOD_MS a new round of all tests is started and it
+*   has to complete within that period; CPS_xSelfTest reports the coverage.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_SELFTEST_H__
+#define __CPS_SELFTEST_H__
+
+/* Include Files */
+#include "CPS_common.h"
+
+/* Defines */
+#define CPS_SELFTEST_BACKGROUND 1u //1: the tests below run from the idle loop, 0: they run in _c_int00 as generated
+#define CPS_SELFTEST_PERIOD_MS 1000u //Coverage period, must be below CPS_TIMER_MAX_MS
+#define CPS_SELFTEST_SLICE_US 25u //IRQs are masked for at most this long plus one test per slice
+#define CPS_SELFTEST_COUNT 5u //Entries of the test table in CPS_selftest.c
+#define CPS_SELFTEST_PBIST_COUNT 4u //Entries of the PBIST table in CPS_selftest.c
+//PBIST RINFOL groups of the dual-port RAMs, as in the pbistRun call of _c_int00
+#define CPS_SELFTEST_PBIST_CAN1 0x00000004u
+#define CPS_SELFTEST_PBIST_CAN2 0x00000008u
+#define CPS_SELFTEST_PBIST_MIBSPI1 0x00000040u
+#define CPS_SELFTEST_PBIST_VIM 0x00000200u
+#define CPS_SELFTEST_PBIST_ADC1 0x00000400u
+#define CPS_SELFTEST_PBIST_HET1 0x00001000u
+#define CPS_SELFTEST_PBIST_HTU1 0x00002000u
+#define CPS_SELFTEST_PBIST_BOOT (CPS_SELFTEST_PBIST_VIM | CPS_SELFTEST_PBIST_ADC1 | CPS_SELFTEST_PBIST_HET1) //Used RAMs
+#define CPS_SELFTEST_PBIST_GROUPS (CPS_SELFTEST_PBIST_HTU1 | CPS_SELFTEST_PBIST_CAN1 | CPS_SELFTEST_PBIST_CAN2 | \
+                                   CPS_SELFTEST_PBIST_MIBSPI1) //Unused peripherals, tested in the background
+#define CPS_SELFTEST_PBIST_FAIL 0x80000000u //u32LastFailure of a background PBIST, ORed with its RINFOL group
+
+/* Global Types */
+typedef struct
+{
+  uint32_t u32Rounds; //Rounds completed
+  uint32_t u32Overdue; //Periods that ended with the round still running
+  uint32_t u32LastRoundUs; //Start to completion of the last round
+  uint32_t u32MaxRoundUs;
+  uint32_t u32Slices;
+  uint32_t u32MaxSliceCycles;
+  uint32_t u32Failures; //selftestFailNotification calls since CPS_vSelfTestInit
+  uint32_t u32LastFailure; //Flag of the last failure
+  uint32_t au32TestCycles[CPS_SELFTEST_COUNT]; //Worst case of each test
+  uint32_t au32PbistUs[CPS_SELFTEST_PBIST_COUNT]; //Worst case start to completion of each PBIST group
+  bool bCovered; //Last round completed within CPS_SELFTEST_PERIOD_MS and the running one is not overdue yet
+} xCPSSelfTest_t;
+
+/* Global Vars */
+extern xCPSSelfTest_t CPS_xSelfTest;
+
+/* Global Function Prototypes */
+
+void CPS_vSelfTestInit(void);
+bool CPS_bSelfTestSlice(void);
+void CPS_vSelfTestFail(uint32_t u32Flag);
+
+#endif
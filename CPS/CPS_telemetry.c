@@ -0,0 +1,159 @@
+/** @file CPS_telemetry.c
+*   @brief Raw ADC telemetry over the link port
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   The acquisition loop only copies the corrected samples of the slot into CPS_au16TelemetryRaw. They are decimated
+*   to CPS_TELEMETRY_PERIOD_US, delta coded into samples frames and queued on the link transport after the inputs
+*   have seen the new classification, so the decision of a control cycle never waits on the encoder; the encoder
+*   cost is kept apart in CPS_xTelemetryStats.u32MaxCycles. A full transmit ring drops the frame and counts it, the
+*   logger sees the SEQ gap.
+*
+*   A frame holds equally spaced samples from the stamp of its first one. Acquisition stays awake while streaming
+*   (see CPS_ACQ_IDLEWAKE), but should a sample still not land one period after the previous one, e.g. a conversion
+*   lost to an overrun, the frame is ended and the next one starts with its own stamp, so the logger rebuilds the
+*   waveform with the gap in the right place.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_telemetry.h"
+#include "CPS_frame.h"
+#include "CPS_sci.h"
+
+/* Global Vars */
+xCPSTelemetryStats_t CPS_xTelemetryStats;
+uint16_t CPS_au16TelemetryRaw[CPS_TELEMETRY_RAW_MAX];
+uint32_t CPS_u32TelemetryRaw;
+
+/* Internal Vars */
+static const uint32_t au32TelemetryBauds[CPS_TELEMETRY_BAUDS] = {9600u, 19200u, 57600u, 115200u};
+static xCPSFrameSamples_t xSamples; //Frame being filled, ADC ISR only
+static bool bOpen; //xSamples holds at least one sample
+static uint32_t u32Phase; //Raw samples since the last streamed one
+static uint32_t u32NextStamp; //RTI count the next streamed sample is due at
+static uint32_t u32RateSamples; //Counts at the last CPS_vTelemetryRates
+static uint32_t u32RateBytes;
+
+/* Local Function Prototypes */
+static void vTelemetrySend(void);
+
+/* Global Functions */
+
+/* void CPS_vTelemetryInit(void)
+*   Switches the link port to CPS_TELEMETRY_BAUD and clears the statistics. Call after CPS_vSciInit.
+*
+*/
+void CPS_vTelemetryInit(void)
+{
+  uint32_t u32Baud;
+  sciSetBaudrate(CPS_SCI_PORT, CPS_TELEMETRY_BAUD);
+  CPS_xTelemetryStats.u32Samples = 0u;
+  CPS_xTelemetryStats.u32Frames = 0u;
+  CPS_xTelemetryStats.u32Bytes = 0u;
+  CPS_xTelemetryStats.u32Dropped = 0u;
+  CPS_xTelemetryStats.u32Gaps = 0u;
+  CPS_xTelemetryStats.u32MaxCycles = 0u;
+  for(u32Baud = 0u; u32Baud < CPS_TELEMETRY_BAUDS; u32Baud++)
+  {
+    CPS_xTelemetryStats.au32Baud[u32Baud] = au32TelemetryBauds[u32Baud];
+    CPS_xTelemetryStats.au32SustainedRate[u32Baud] = 0u;
+    CPS_xTelemetryStats.au32WorstRate[u32Baud] = ((au32TelemetryBauds[u32Baud]/CPS_FRAME_BITS_PER_BYTE)*
+                                                  CPS_FRAME_SAMPLES_MIN)/CPS_FRAME_MAX;
+  }
+  CPS_u32TelemetryRaw = 0u;
+  bOpen = 0;
+  u32Phase = 0u;
+  u32RateSamples = 0u;
+  u32RateBytes = 0u;
+}
+
+/* void CPS_vTelemetryPut(uint32_t u32Stamp)
+*   ADC ISR, once per conversion. Streams every CPS_TELEMETRY_DECIMATION'th sample of CPS_au16TelemetryRaw and
+*   empties it. u32Stamp is the RTI count at the interrupt, taken as the time of the last sample.
+*
+*/
+void CPS_vTelemetryPut(uint32_t u32Stamp)
+{
+  uint32_t u32StartCycles = CPS_u32TimeCycles();
+  uint32_t u32Cycles;
+  uint32_t u32SampleStamp;
+  uint16_t u16Sample;
+  for(uint32_t u32Raw = 0u; u32Raw < CPS_u32TelemetryRaw; u32Raw++)
+  {
+    u32Phase++;
+    if(u32Phase < CPS_TELEMETRY_DECIMATION)
+    {
+      continue;
+    }
+    u32Phase = 0u;
+    u16Sample = CPS_au16TelemetryRaw[u32Raw];
+    u32SampleStamp = u32Stamp - ((CPS_u32TelemetryRaw - 1u - u32Raw)*CPS_ACQ_SAMPLE_COUNTS);
+    if(bOpen && ((u32SampleStamp - u32NextStamp + (CPS_TELEMETRY_PERIOD_COUNTS/2u)) > CPS_TELEMETRY_PERIOD_COUNTS))
+    {
+      CPS_xTelemetryStats.u32Gaps++; //Off the grid of the open frame by more than half a period
+      vTelemetrySend();
+    }
+    if(bOpen && ((xSamples.u32Samples >= CPS_TELEMETRY_FRAME_SAMPLES) || !CPS_bFrameSamplesAdd(&xSamples, u16Sample)))
+    {
+      vTelemetrySend();
+    }
+    if(!bOpen)
+    {
+      CPS_vFrameSamplesStart(&xSamples, u32SampleStamp, u16Sample);
+      bOpen = 1;
+    }
+    u32NextStamp = u32SampleStamp + CPS_TELEMETRY_PERIOD_COUNTS;
+    CPS_xTelemetryStats.u32Samples++;
+  }
+  CPS_u32TelemetryRaw = 0u;
+  u32Cycles = CPS_u32TimeCyclesSince(u32StartCycles);
+  if(u32Cycles > CPS_xTelemetryStats.u32MaxCycles)
+  {
+    CPS_xTelemetryStats.u32MaxCycles = u32Cycles;
+  }
+}
+
+/* void CPS_vTelemetryRates(uint32_t u32PeriodMs)
+*   Rate timer, every u32PeriodMs. Publishes the sample rate and line cost of the last period and the sample rate
+*   each baud of the table would sustain at that cost. au32WorstRate is the floor for a signal that never sits still.
+*
+*/
+void CPS_vTelemetryRates(uint32_t u32PeriodMs)
+{
+  uint32_t u32Samples = CPS_xTelemetryStats.u32Samples - u32RateSamples;
+  uint32_t u32Bytes = CPS_xTelemetryStats.u32Bytes - u32RateBytes;
+  uint32_t u32Baud;
+  u32RateSamples = CPS_xTelemetryStats.u32Samples;
+  u32RateBytes = CPS_xTelemetryStats.u32Bytes;
+  CPS_xTelemetryStats.u32SamplesPerSecond = (u32Samples*1000u)/u32PeriodMs;
+  CPS_xTelemetryStats.u32MilliBytesPerSample = (u32Samples != 0u) ? ((u32Bytes*1000u)/u32Samples) : 0u;
+  for(u32Baud = 0u; u32Baud < CPS_TELEMETRY_BAUDS; u32Baud++)
+  {
+    CPS_xTelemetryStats.au32SustainedRate[u32Baud] = (CPS_xTelemetryStats.u32MilliBytesPerSample != 0u) ?
+      (((au32TelemetryBauds[u32Baud]/CPS_FRAME_BITS_PER_BYTE)*1000u)/CPS_xTelemetryStats.u32MilliBytesPerSample) : 0u;
+  }
+}
+
+/* Local Functions */
+
+/* void vTelemetrySend(void)
+*   Ends the open frame and queues it on the link port.
+*
+*/
+static void vTelemetrySend(void)
+{
+  uint32_t u32Length = CPS_u32FrameSamplesEnd(&xSamples, CPS_u8FrameSeq());
+  if(CPS_bSciWrite(xSamples.au8Frame, u32Length))
+  {
+    CPS_xTelemetryStats.u32Frames++;
+    CPS_xTelemetryStats.u32Bytes += u32Length;
+  }
+  else
+  {
+    CPS_xTelemetryStats.u32Dropped++;
+  }
+  bOpen = 0;
+}
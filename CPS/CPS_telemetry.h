@@ -0,0 +1,63 @@
+/** @file CPS_telemetry.h
+*   @brief Raw ADC telemetry over the link port
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface used to stream the corrected, unfiltered ADC samples of one slot out of the
+*   link port as samples frames (see CPS_frame.h), so the band thresholds can be tuned against the real waveform.
+*   Streamed samples, frame and drop counts and the sustainable sample rate per baud are kept in RAM and are read out
+*   with the debugger (watch CPS_xTelemetryStats). HOST_telemetry rebuilds the waveform from a capture of the line.
+*
+*   CPS_TELEMETRY_ENABLE is set in CPS_acq.h: acquisition has to know, it keeps the group interrupts running while
+*   streaming instead of sleeping through idle.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_TELEMETRY_H__
+#define __CPS_TELEMETRY_H__
+
+/* Include Files */
+#include "CPS_acq.h"
+#include "CPS_filter.h"
+
+/* Defines */
+#define CPS_TELEMETRY_SLOT CPS_ACQ_SLOT_HORN
+#define CPS_TELEMETRY_BAUD 115200u //Link port baud while streaming
+#define CPS_TELEMETRY_PERIOD_US 400u //Streamed sample period, rounded down to a multiple of CPS_FILTER_SAMPLE_US
+#define CPS_TELEMETRY_DECIMATION ((CPS_FILTER_SAMPLE_US >= CPS_TELEMETRY_PERIOD_US) ? 1u : \
+                                  (CPS_TELEMETRY_PERIOD_US/CPS_FILTER_SAMPLE_US))
+#define CPS_TELEMETRY_PERIOD_COUNTS (CPS_ACQ_SAMPLE_COUNTS*CPS_TELEMETRY_DECIMATION)
+#define CPS_TELEMETRY_FRAME_SAMPLES 250u //Longest frame, bounds how late a still signal reaches the logger
+#define CPS_TELEMETRY_RAW_MAX ADC1_G2_DEPTH //Samples of one slot a single conversion can hold
+#define CPS_TELEMETRY_BAUDS 4u //Entries of the baud table in CPS_telemetry.c
+
+/* Global Types */
+typedef struct
+{
+  uint32_t u32Samples; //Samples streamed
+  uint32_t u32Frames; //Frames queued
+  uint32_t u32Bytes; //Bytes queued
+  uint32_t u32Dropped; //Frames the transmit ring had no room for
+  uint32_t u32Gaps; //Frames ended early because samples were missing, e.g. a conversion lost to an overrun
+  uint32_t u32MaxCycles; //PMU cycles of the longest CPS_vTelemetryPut
+  uint32_t u32SamplesPerSecond; //Streamed in the last rate period
+  uint32_t u32MilliBytesPerSample; //Line bytes per sample in the last rate period, 1000 = one byte
+  uint32_t au32Baud[CPS_TELEMETRY_BAUDS];
+  uint32_t au32SustainedRate[CPS_TELEMETRY_BAUDS]; //Samples per second the line carries at the measured cost
+  uint32_t au32WorstRate[CPS_TELEMETRY_BAUDS]; //Samples per second the line carries when every sample moves
+} xCPSTelemetryStats_t;
+
+/* Global Vars */
+extern xCPSTelemetryStats_t CPS_xTelemetryStats;
+extern uint16_t CPS_au16TelemetryRaw[CPS_TELEMETRY_RAW_MAX]; //Samples of the slot from the last conversion
+extern uint32_t CPS_u32TelemetryRaw; //Entries of CPS_au16TelemetryRaw in use
+
+/* Global Function Prototypes */
+
+void CPS_vTelemetryInit(void);
+void CPS_vTelemetryPut(uint32_t u32Stamp);
+void CPS_vTelemetryRates(uint32_t u32PeriodMs);
+
+#endif
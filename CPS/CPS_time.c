@@ -0,0 +1,154 @@
+/** @file CPS_time.c
+*   @brief Monotonic time and CPU cycle clock
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   RTI counter 0 is extended to 64 bits without an overflow interrupt. A software timer snapshots the counter every
+*   CPS_TIME_EPOCH_MS (at most CPS_TIMER_MAX_MS) and counts the wraps it sees between snapshots. A reader combines
+*   the last snapshot with the live counter: if the counter is below the snapshot it has wrapped once since. That
+*   holds while the snapshot is less than one wrap old, which the epoch period guarantees with a wide margin.
+*
+*   The snapshot is two words, written only from the timer ISR. Readers in main context check a sequence count
+*   around their read and retry if the ISR updated the snapshot meanwhile. ISR readers never see a partial update
+*   because the CPS ISRs do not nest. HOST_time runs both cases, the wrap and the retry, on the host simulation.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_time.h"
+#include "CPS_boot.h"
+#include "CPS_timer.h"
+
+/* Defines */
+#define TIME_COST_RUNS 8u
+
+#define TIME_EPOCH_MS ((CPS_TIME_EPOCH_MS < CPS_TIMER_MAX_MS) ? CPS_TIME_EPOCH_MS : CPS_TIMER_MAX_MS)
+
+/* Global Vars */
+xCPSTimeCost_t CPS_xTimeCost;
+
+/* Internal Vars */
+static volatile uint32_t u32BaseHigh; //Wraps of FRC0 up to the snapshot
+static volatile uint32_t u32BaseLow; //FRC0 at the snapshot
+static volatile uint32_t u32BaseSeq; //Incremented after every snapshot
+static xCPSTimer_t xEpochTimer;
+
+/* Local Function Prototypes */
+static void vTimeEpoch(void);
+static void vTimeMeasureCost(void);
+
+/* Global Functions */
+
+/* void CPS_vTimeInit(void)
+*   Starts the cycle counter, takes the first snapshot and arms the epoch timer. Time 0 is the current FRC0 value, so
+*   call it after CPS_vTimerInit and before RTI counter 0 is started.
+*
+*/
+void CPS_vTimeInit(void)
+{
+  CPS_vTimeCyclesStart();
+  u32BaseHigh = 0u;
+  u32BaseLow = CPS_u32TimeNow32();
+  u32BaseSeq = 0u;
+  CPS_vTimerArm(&xEpochTimer, TIME_EPOCH_MS, vTimeEpoch);
+  vTimeMeasureCost();
+}
+
+/* void CPS_vTimeCyclesStart(void)
+*   Starts the PMU cycle counter free running at the CPU clock. Safe to call more than once, the count restarts at 0.
+*
+*/
+void CPS_vTimeCyclesStart(void)
+{
+#if CPS_BOOT_PROFILE
+  CPS_vBootRebase(); //Boot stamps carry on across the restart
+#endif
+  _pmuInit_();
+  _pmuEnableCountersGlobal_();
+  _pmuResetCycleCounter_();
+  _pmuStartCounters_(pmuCYCLE_COUNTER);
+}
+
+/* uint64_t CPS_u64TimeNow(void)
+*   RTI counts since CPS_vTimeInit, CPS_TIME_COUNTS_PER_US per microsecond, never wraps. Callable from any context.
+*   About as cheap as four RAM loads and a peripheral load; see CPS_xTimeCost.u32NowCycles.
+*
+*/
+uint64_t CPS_u64TimeNow(void)
+{
+  uint32_t u32Seq;
+  uint32_t u32High;
+  uint32_t u32Low;
+  uint32_t u32Now;
+  do
+  {
+    u32Seq = u32BaseSeq;
+    u32High = u32BaseHigh;
+    u32Low = u32BaseLow;
+    u32Now = CPS_u32TimeNow32();
+  } while(u32Seq != u32BaseSeq);
+  if(u32Now < u32Low)
+  {
+    u32High++; //Wrapped since the snapshot
+  }
+  return(((uint64_t)u32High << 32u) | u32Now);
+}
+
+/* Local Functions */
+
+/* void vTimeEpoch(void)
+*   Epoch timer callback, compare1 ISR context. Takes a new snapshot and re-arms itself.
+*
+*/
+static void vTimeEpoch(void)
+{
+  uint32_t u32Now = CPS_u32TimeNow32();
+  if(u32Now < u32BaseLow)
+  {
+    u32BaseHigh++;
+  }
+  u32BaseLow = u32Now;
+  u32BaseSeq++;
+  CPS_vTimerArm(&xEpochTimer, TIME_EPOCH_MS, vTimeEpoch);
+}
+
+/* void vTimeMeasureCost(void)
+*   Times each clock read with the cycle counter and keeps the fastest of TIME_COST_RUNS runs, with the cost of an
+*   empty measurement taken off.
+*
+*/
+static void vTimeMeasureCost(void)
+{
+  volatile uint64_t u64Sink;
+  volatile uint32_t u32Sink;
+  uint32_t u32Start;
+  uint32_t u32Empty = 0xFFFFFFFFu;
+  uint32_t u32Now = 0xFFFFFFFFu;
+  uint32_t u32Now32 = 0xFFFFFFFFu;
+  uint32_t u32Cycles = 0xFFFFFFFFu;
+  uint32_t u32Run;
+  for(u32Run = 0u; u32Run < TIME_COST_RUNS; u32Run++)
+  {
+    u32Start = CPS_u32TimeCycles();
+    u32Start = CPS_u32TimeCyclesSince(u32Start);
+    u32Empty = (u32Start < u32Empty) ? u32Start : u32Empty;
+    u32Start = CPS_u32TimeCycles();
+    u64Sink = CPS_u64TimeNow();
+    u32Start = CPS_u32TimeCyclesSince(u32Start);
+    u32Now = (u32Start < u32Now) ? u32Start : u32Now;
+    u32Start = CPS_u32TimeCycles();
+    u32Sink = CPS_u32TimeNow32();
+    u32Start = CPS_u32TimeCyclesSince(u32Start);
+    u32Now32 = (u32Start < u32Now32) ? u32Start : u32Now32;
+    u32Start = CPS_u32TimeCycles();
+    u32Sink = CPS_u32TimeCycles();
+    u32Start = CPS_u32TimeCyclesSince(u32Start);
+    u32Cycles = (u32Start < u32Cycles) ? u32Start : u32Cycles;
+  }
+  (void)u64Sink;
+  (void)u32Sink;
+  CPS_xTimeCost.u32NowCycles = u32Now - u32Empty;
+  CPS_xTimeCost.u32Now32Cycles = u32Now32 - u32Empty;
+  CPS_xTimeCost.u32CyclesCycles = u32Cycles - u32Empty;
+}
@@ -0,0 +1,67 @@
+/** @file CPS_time.h
+*   @brief Monotonic time and CPU cycle clock
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the clocks used for all CPS time stamps. CPS_u64TimeNow extends RTI counter 0 to a 64 bit
+*   count that never wraps, CPS_u32TimeNow32 is the raw counter for short differences and the cycle functions read
+*   the Cortex-R4 PMU cycle counter for intervals of up to 42s. Measured costs per call are in CPS_xTimeCost.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_TIME_H__
+#define __CPS_TIME_H__
+
+/* Include Files */
+#include "CPS_common.h"
+#include "sys_pmu.h"
+
+/* Defines */
+#define CPS_TIME_COUNTS_PER_US 10u //RTI FRC0 runs at RTICLK/(CPUC0+1) = 10MHz
+#define CPS_TIME_CYCLES_PER_US 100u //HCLK, PLL1_FREQ in system.h
+#define CPS_TIME_EPOCH_MS 60000u //Refresh of the 64 bit base, must stay well below the 429s FRC0 wrap
+
+/* Global Types */
+typedef struct
+{
+  uint32_t u32NowCycles; //CPU cycles per CPS_u64TimeNow call
+  uint32_t u32Now32Cycles; //CPU cycles per CPS_u32TimeNow32 read
+  uint32_t u32CyclesCycles; //CPU cycles per CPS_u32TimeCycles read
+} xCPSTimeCost_t;
+
+/* Global Vars */
+extern xCPSTimeCost_t CPS_xTimeCost;
+
+/* Global Function Prototypes */
+
+void CPS_vTimeInit(void);
+void CPS_vTimeCyclesStart(void);
+uint64_t CPS_u64TimeNow(void);
+
+/* uint32_t CPS_u32TimeNow32(void)
+*   Raw RTI FRC0 value, CPS_TIME_COUNTS_PER_US per microsecond. Wraps every 429s, take differences with unsigned
+*   subtraction. One peripheral load.
+*
+*/
+#define CPS_u32TimeNow32() ((uint32_t)rtiREG1->CNT[0u].FRCx)
+
+/* uint32_t CPS_u32TimeCycles(void)
+*   Free running PMU cycle counter, CPS_TIME_CYCLES_PER_US per microsecond. Wraps every 42s, only for short
+*   intervals. One call to the PMU read routine.
+*
+*/
+#define CPS_u32TimeCycles() ((uint32_t)_pmuGetCycleCount_())
+
+/* uint32_t CPS_u32TimeCyclesSince(uint32_t u32Start)
+*   Cycles elapsed since a CPS_u32TimeCycles stamp.
+*
+*/
+#define CPS_u32TimeCyclesSince(u32Start) (CPS_u32TimeCycles() - (u32Start))
+
+/* Counter conversions. Divisions, keep them out of the hot paths. */
+#define CPS_TIME_US(u64Counts) ((u64Counts)/CPS_TIME_COUNTS_PER_US)
+#define CPS_TIME_MS(u64Counts) ((u64Counts)/(CPS_TIME_COUNTS_PER_US*1000u))
+
+#endif
@@ -0,0 +1,331 @@
+/** @file CPS_timer.c
+*   @brief Software timers driven by RTI compare1
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Tickless backend: armed timers are kept in one list sorted by deadline, in RTI FRC0 counts. Compare1 is written
+*   with the earliest deadline only and its interrupt is disabled while nothing is armed, so an idle system takes no
+*   timer interrupts and deadlines resolve to 0.1us. Deadlines are compared by signed difference to the counter,
+*   which keeps the ordering right across the FRC0 wrap. Arming walks the list, which is fine for the handful of
+*   timers CPS owns.
+*
+*   Wheel backend: two level hierarchical timer wheel on the fixed compare1 tick. Level 0 has one slot per tick for
+*   the next CPS_TIMER_WHEELSLOTS ticks, level 1 has one slot per CPS_TIMER_WHEELSLOTS ticks beyond that. Each tick
+*   only looks at the current level 0 slot; once every CPS_TIMER_WHEELSLOTS ticks the matching level 1 slot is moved
+*   down into level 0. Slots are intrusive doubly linked lists so arming and cancelling never search.
+*
+*   All functions must be called from the CPS ISRs (which do not nest) or with interrupts disabled.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_timer.h"
+
+/* Defines */
+#if CPS_TIMER_TICKLESS
+#define TIMER_NOW() CPS_u32TimeNow32()
+#else
+#define TIMER_SLOTMASK (CPS_TIMER_WHEELSLOTS - 1u)
+#endif
+
+/* Internal Vars */
+#if CPS_TIMER_TICKLESS
+static xCPSTimer_t *pxTimerHead; //Earliest deadline first
+#else
+static xCPSTimer_t *apxWheel0[CPS_TIMER_WHEELSLOTS];
+static xCPSTimer_t *apxWheel1[CPS_TIMER_WHEELSLOTS];
+static uint32_t u32TimerNow; //Ticks since CPS_vTimerInit
+#endif
+
+/* Local Function Prototypes */
+static void vTimerInsert(xCPSTimer_t *pxTimer);
+static void vTimerUnlink(xCPSTimer_t *pxTimer);
+#if CPS_TIMER_TICKLESS
+static void vTimerProgram(void);
+#endif
+
+/* Global Functions */
+
+/* void CPS_vTimerInit(void)
+*   Empties the wheel. Any timer that was armed is forgotten.
+*
+*/
+void CPS_vTimerInit(void)
+{
+#if CPS_TIMER_TICKLESS
+  pxTimerHead = 0;
+  rtiREG1->CLEARINTENA = rtiNOTIFICATION_COMPARE1;
+  rtiREG1->CMP[1u].UDCPx = 0u; //No automatic period, every deadline is written by vTimerProgram
+  rtiREG1->INTFLAG = rtiNOTIFICATION_COMPARE1;
+#else
+  for(uint32_t u32Slot = 0u; u32Slot < CPS_TIMER_WHEELSLOTS; u32Slot++)
+  {
+    apxWheel0[u32Slot] = 0;
+    apxWheel1[u32Slot] = 0;
+  }
+  u32TimerNow = 0u;
+#endif
+}
+
+/* void CPS_vTimerArm(xCPSTimer_t *pxTimer, uint32_t u32Ms, xCPSTimerCallback_t pxCallback)
+*   Starts the timer, or restarts it if it is already running. The callback runs from the compare1 ISR no earlier
+*   than u32Ms from now; pass 0 when only CPS_bTimerArmed is of interest. Delays are limited to CPS_TIMER_MAX_MS.
+*
+*/
+void CPS_vTimerArm(xCPSTimer_t *pxTimer, uint32_t u32Ms, xCPSTimerCallback_t pxCallback)
+{
+  if(u32Ms > CPS_TIMER_MAX_MS)
+  {
+    u32Ms = CPS_TIMER_MAX_MS;
+  }
+  CPS_vTimerArmUs(pxTimer, u32Ms*1000u, pxCallback);
+}
+
+/* void CPS_vTimerArmUs(xCPSTimer_t *pxTimer, uint32_t u32Us, xCPSTimerCallback_t pxCallback)
+*   Microsecond form of CPS_vTimerArm. The tickless backend resolves the delay to the RTI counter, the wheel rounds it
+*   up to whole ticks.
+*
+*/
+void CPS_vTimerArmUs(xCPSTimer_t *pxTimer, uint32_t u32Us, xCPSTimerCallback_t pxCallback)
+{
+#if CPS_TIMER_TICKLESS
+  if(u32Us > (CPS_TIMER_MAX_MS*1000u))
+  {
+    u32Us = CPS_TIMER_MAX_MS*1000u;
+  }
+  if(pxTimer->bArmed)
+  {
+    vTimerUnlink(pxTimer);
+  }
+  pxTimer->pxCallback = pxCallback;
+  pxTimer->u32Expiry = TIMER_NOW() + (u32Us*CPS_TIME_COUNTS_PER_US);
+  pxTimer->bArmed = 1;
+  vTimerInsert(pxTimer);
+  if(pxTimerHead == pxTimer)
+  {
+    vTimerProgram(); //New earliest deadline
+  }
+#else
+  uint32_t u32Ticks;
+  if(u32Us > (CPS_TIMER_MAX_MS*1000u))
+  {
+    u32Us = CPS_TIMER_MAX_MS*1000u;
+  }
+  u32Ticks = (u32Us + (CPS_TIMER_TICK_MS*1000u) - 1u)/(CPS_TIMER_TICK_MS*1000u);
+  if(u32Ticks == 0u)
+  {
+    u32Ticks = 1u; //Fire on the next tick at the earliest
+  }
+  if(u32Ticks > (CPS_TIMER_MAX_MS/CPS_TIMER_TICK_MS))
+  {
+    u32Ticks = CPS_TIMER_MAX_MS/CPS_TIMER_TICK_MS;
+  }
+  if(pxTimer->bArmed)
+  {
+    vTimerUnlink(pxTimer);
+  }
+  pxTimer->pxCallback = pxCallback;
+  pxTimer->u32Expiry = u32TimerNow + u32Ticks;
+  pxTimer->bArmed = 1;
+  vTimerInsert(pxTimer);
+#endif
+}
+
+/* void CPS_vTimerCancel(xCPSTimer_t *pxTimer)
+*   Stops the timer without calling back. Does nothing if it is not running.
+*
+*/
+void CPS_vTimerCancel(xCPSTimer_t *pxTimer)
+{
+  if(pxTimer->bArmed)
+  {
+    vTimerUnlink(pxTimer);
+    pxTimer->bArmed = 0;
+  }
+}
+
+/* void CPS_vTimerTick(void)
+*   Called from the RTI compare1 ISR. Tickless: calls back every timer whose deadline has passed and programs the next
+*   one. Wheel: advances the wheel by one tick and calls back every timer that expires on it.
+*
+*/
+#if CPS_TIMER_TICKLESS
+void CPS_vTimerTick(void)
+{
+  xCPSTimer_t *pxTimer = pxTimerHead;
+  while((pxTimer != 0) && ((int32_t)(pxTimer->u32Expiry - TIMER_NOW()) <= 0))
+  {
+    vTimerUnlink(pxTimer); //Detach first so the callback can re-arm it
+    pxTimer->bArmed = 0;
+    if(pxTimer->pxCallback != 0)
+    {
+      pxTimer->pxCallback();
+    }
+    pxTimer = pxTimerHead;
+  }
+  vTimerProgram();
+}
+#else
+void CPS_vTimerTick(void)
+{
+  xCPSTimer_t *pxTimer;
+  xCPSTimer_t *pxNext;
+  uint32_t u32Slot;
+  u32TimerNow++;
+  u32Slot = u32TimerNow & TIMER_SLOTMASK;
+  if(u32Slot == 0u) //Level 0 has wrapped, bring the next block of timers down from level 1
+  {
+    pxTimer = apxWheel1[(u32TimerNow >> CPS_TIMER_WHEELBITS) & TIMER_SLOTMASK];
+    apxWheel1[(u32TimerNow >> CPS_TIMER_WHEELBITS) & TIMER_SLOTMASK] = 0;
+    while(pxTimer != 0)
+    {
+      pxNext = pxTimer->pxNext;
+      vTimerInsert(pxTimer); //Now less than one level 0 turn away, lands in level 0
+      pxTimer = pxNext;
+    }
+  }
+  while(apxWheel0[u32Slot] != 0) //Take one timer at a time, a callback may cancel or re-arm any other timer
+  {
+    pxTimer = apxWheel0[u32Slot];
+    vTimerUnlink(pxTimer); //Re-arming lands at least one tick ahead, never back in this slot
+    pxTimer->bArmed = 0;
+    if(pxTimer->pxCallback != 0)
+    {
+      pxTimer->pxCallback();
+    }
+  }
+}
+#endif
+
+/* Local Functions */
+
+#if CPS_TIMER_TICKLESS
+/* void vTimerInsert(xCPSTimer_t *pxTimer)
+*   Puts an armed timer into the deadline list behind every timer due no later than it. Deadlines are compared as
+*   signed distances from now, so a timer that is already overdue still sorts first.
+*
+*/
+static void vTimerInsert(xCPSTimer_t *pxTimer)
+{
+  xCPSTimer_t *pxPrev = 0;
+  xCPSTimer_t *pxNext = pxTimerHead;
+  uint32_t u32Now = TIMER_NOW();
+  while((pxNext != 0) && ((int32_t)(pxNext->u32Expiry - u32Now) <= (int32_t)(pxTimer->u32Expiry - u32Now)))
+  {
+    pxPrev = pxNext;
+    pxNext = pxNext->pxNext;
+  }
+  pxTimer->pxPrev = pxPrev;
+  pxTimer->pxNext = pxNext;
+  if(pxNext != 0)
+  {
+    pxNext->pxPrev = pxTimer;
+  }
+  if(pxPrev != 0)
+  {
+    pxPrev->pxNext = pxTimer;
+  }
+  else
+  {
+    pxTimerHead = pxTimer;
+  }
+}
+
+/* void vTimerUnlink(xCPSTimer_t *pxTimer)
+*   Removes an armed timer from the deadline list. Compare1 is left alone; an early match only costs one empty pass
+*   through CPS_vTimerTick.
+*
+*/
+static void vTimerUnlink(xCPSTimer_t *pxTimer)
+{
+  if(pxTimer->pxPrev != 0)
+  {
+    pxTimer->pxPrev->pxNext = pxTimer->pxNext;
+  }
+  else
+  {
+    pxTimerHead = pxTimer->pxNext;
+  }
+  if(pxTimer->pxNext != 0)
+  {
+    pxTimer->pxNext->pxPrev = pxTimer->pxPrev;
+  }
+}
+
+/* void vTimerProgram(void)
+*   Points compare1 at the earliest deadline, or disables its interrupt when nothing is armed. Compare1 only matches
+*   when the counter equals it, so a deadline that is already due or too close to write safely is moved to
+*   CPS_TIMER_MARGIN_COUNTS from now.
+*
+*/
+static void vTimerProgram(void)
+{
+  uint32_t u32Now;
+  uint32_t u32Deadline;
+  if(pxTimerHead == 0)
+  {
+    rtiREG1->CLEARINTENA = rtiNOTIFICATION_COMPARE1;
+    return;
+  }
+  u32Now = TIMER_NOW();
+  u32Deadline = pxTimerHead->u32Expiry;
+  if((int32_t)(u32Deadline - u32Now) < (int32_t)CPS_TIMER_MARGIN_COUNTS)
+  {
+    u32Deadline = u32Now + CPS_TIMER_MARGIN_COUNTS;
+  }
+  rtiREG1->INTFLAG = rtiNOTIFICATION_COMPARE1; //Drop a match of the previous deadline before moving it
+  rtiREG1->CMP[1u].COMPx = u32Deadline;
+  rtiREG1->SETINTENA = rtiNOTIFICATION_COMPARE1;
+}
+#else
+
+/* void vTimerInsert(xCPSTimer_t *pxTimer)
+*   Puts an armed timer at the head of the slot matching its expiry. Expiry is at most 2^(2*CPS_TIMER_WHEELBITS)-1
+*   ticks ahead, so a level 1 slot is never reused before it has been cascaded.
+*
+*/
+static void vTimerInsert(xCPSTimer_t *pxTimer)
+{
+  xCPSTimer_t **ppxSlot;
+  if((pxTimer->u32Expiry - u32TimerNow) < CPS_TIMER_WHEELSLOTS)
+  {
+    ppxSlot = &apxWheel0[pxTimer->u32Expiry & TIMER_SLOTMASK];
+  }
+  else
+  {
+    ppxSlot = &apxWheel1[(pxTimer->u32Expiry >> CPS_TIMER_WHEELBITS) & TIMER_SLOTMASK];
+  }
+  pxTimer->pxPrev = 0;
+  pxTimer->pxNext = *ppxSlot;
+  if(*ppxSlot != 0)
+  {
+    (*ppxSlot)->pxPrev = pxTimer;
+  }
+  *ppxSlot = pxTimer;
+}
+
+/* void vTimerUnlink(xCPSTimer_t *pxTimer)
+*   Removes an armed timer from whichever slot holds it.
+*
+*/
+static void vTimerUnlink(xCPSTimer_t *pxTimer)
+{
+  if(pxTimer->pxPrev != 0)
+  {
+    pxTimer->pxPrev->pxNext = pxTimer->pxNext;
+  }
+  else if(apxWheel0[pxTimer->u32Expiry & TIMER_SLOTMASK] == pxTimer) //Head of its slot, find which wheel holds it
+  {
+    apxWheel0[pxTimer->u32Expiry & TIMER_SLOTMASK] = pxTimer->pxNext;
+  }
+  else
+  {
+    apxWheel1[(pxTimer->u32Expiry >> CPS_TIMER_WHEELBITS) & TIMER_SLOTMASK] = pxTimer->pxNext;
+  }
+  if(pxTimer->pxNext != 0)
+  {
+    pxTimer->pxNext->pxPrev = pxTimer->pxPrev;
+  }
+}
+#endif
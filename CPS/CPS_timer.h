@@ -0,0 +1,62 @@
+/** @file CPS_timer.h
+*   @brief Software timers driven by RTI compare1
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the timer service used for all CPS timing. Timers are owned by the caller, armed in
+*   milliseconds or microseconds and call back from the compare1 ISR when they expire. Two backends share the API: a
+*   tickless one that programs compare1 for the next deadline only, and the fixed tick timer wheel whose arming,
+*   cancelling and per-tick work are O(1) regardless of how many timers exist.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __CPS_TIMER_H__
+#define __CPS_TIMER_H__
+
+/* Include Files */
+#include "CPS_time.h"
+
+/* Defines */
+#ifndef CPS_TIMER_TICKLESS //HOST_timer_wheel builds the wheel with -DCPS_TIMER_TICKLESS=0
+#define CPS_TIMER_TICKLESS 1u //Compare1 fires only at the next deadline instead of every CPS_TIMER_TICK_MS
+#endif
+
+#if CPS_TIMER_TICKLESS
+#define CPS_TIMER_MARGIN_COUNTS 50u //Closest a deadline is programmed ahead of the counter, compare1 only matches on equal
+#define CPS_TIMER_MAX_MS 100000u //Longest delay, well inside half the 429s FRC0 wrap so ordering stays unambiguous
+#else
+#define CPS_TIMER_TICK_MS 2u //RTI compare1 period
+#define CPS_TIMER_WHEELBITS 6u //Slots per wheel level = 2^CPS_TIMER_WHEELBITS
+#define CPS_TIMER_WHEELSLOTS (1u << CPS_TIMER_WHEELBITS)
+#define CPS_TIMER_MAX_MS ((CPS_TIMER_WHEELSLOTS*CPS_TIMER_WHEELSLOTS - 1u)*CPS_TIMER_TICK_MS) //Longest delay, 8.19s
+#endif
+
+/* Global Types */
+typedef void (*xCPSTimerCallback_t)(void);
+
+typedef struct xCPSTimer
+{
+  struct xCPSTimer *pxNext; //Deadline or slot list links, only valid while armed
+  struct xCPSTimer *pxPrev;
+  uint32_t u32Expiry; //FRC0 count (tickless) or tick count (wheel) at which the timer fires
+  xCPSTimerCallback_t pxCallback;
+  volatile bool bArmed;
+} xCPSTimer_t;
+
+/* Global Function Prototypes */
+
+void CPS_vTimerInit(void);
+void CPS_vTimerArm(xCPSTimer_t *pxTimer, uint32_t u32Ms, xCPSTimerCallback_t pxCallback);
+void CPS_vTimerArmUs(xCPSTimer_t *pxTimer, uint32_t u32Us, xCPSTimerCallback_t pxCallback);
+void CPS_vTimerCancel(xCPSTimer_t *pxTimer);
+void CPS_vTimerTick(void);
+
+/* bool CPS_bTimerArmed(xCPSTimer_t *pxTimer)
+*   Returns 1 while the timer is counting down.
+*
+*/
+#define CPS_bTimerArmed(pxTimer) ((pxTimer)->bArmed)
+
+#endif
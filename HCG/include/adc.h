@@ -257,6 +257,31 @@ void adcNotification(adcBASE_t *adc, uint32 group);
 
 /**@}*/
 /* USER CODE BEGIN (3) */
+
+/* Specialized FIFO reads
+*  Resolution and FIFO depth are fixed at compile time so the read is an unrolled run of buffer loads with no mode or
+*  count lookups. The depths must match the thresholds the application programs into GxINTCR; group 1 is reprogrammed
+*  by the application to one result per acquisition channel, so ADC1_G1_DEPTH follows that and not s_adcFiFoSize.
+*/
+#define ADC1_RESOLUTION_BITS 12U /**< Set by adcInit, OPMODECR bit 31 */
+#define ADC1_RESULT_MASK ((1U << ADC1_RESOLUTION_BITS) - 1U)
+#define ADC1_G0_DEPTH 3U
+#ifndef ADC1_G1_DEPTH
+#define ADC1_G1_DEPTH 1U /**< CPS_ACQ_CHANNELS */
+#endif
+#define ADC1_G2_DEPTH 16U
+
+#if (ADC1_G0_DEPTH > 16U) || (ADC1_G1_DEPTH > 16U) || (ADC1_G2_DEPTH > 16U)
+#error "Specialized ADC reads are unrolled for at most 16 results"
+#endif
+
+uint32 adc1Group0GetData16(uint16 *data);
+uint32 adc1Group1GetData16(uint16 *data);
+uint32 adc1Group2GetData16(uint16 *data);
+
+/* Magnitude compare notification, flags holds one bit per comparator (bit 0 = MAGINTCR1) */
+void adcMagnitudeNotification(adcBASE_t *adc, uint32 flags);
+
 /* USER CODE END */
 
 
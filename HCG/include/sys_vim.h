@@ -96,6 +96,9 @@ extern void rtiCompare1Interrupt(void);
 extern void adc1Group1Interrupt(void);
 
 /* USER CODE BEGIN (3) */
+extern void adc1Group2Interrupt(void); /* Mapped at run time by the application, see vimChannelMap */
+extern void adc1MagnitudeInterrupt(void); /* Mapped at run time by the application, see vimChannelMap */
+extern void linHighLevelInterrupt(void); /* Mapped at run time by the application, see vimChannelMap */
 /* USER CODE END */
 
 #define VIM_PARFLG      (*(volatile uint32 *)0xFFFFFDECU)
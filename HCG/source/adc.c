@@ -940,4 +940,106 @@ void adc1Group1Interrupt(void)
 
 
 /* USER CODE BEGIN (44) */
+
+/** @fn static inline void adc1ReadFifo16(uint32 group, uint32 depth, uint16 *data)
+*   @brief Unrolled FIFO read of a fixed number of results
+*
+*   Enters the fall through chain at the case for depth, so results land in data[0..depth-1] in FIFO order. Called
+*   with constant arguments only, which lets the compiler drop the switch.
+*/
+#define ADC1_READ16(k) data[depth - (k)] = (uint16)(adcREG1->GxBUF[group].BUF0 & ADC1_RESULT_MASK)
+static inline void adc1ReadFifo16(uint32 group, uint32 depth, uint16 *data)
+{
+    switch(depth)
+    {
+    case 16U: ADC1_READ16(16U);
+    case 15U: ADC1_READ16(15U);
+    case 14U: ADC1_READ16(14U);
+    case 13U: ADC1_READ16(13U);
+    case 12U: ADC1_READ16(12U);
+    case 11U: ADC1_READ16(11U);
+    case 10U: ADC1_READ16(10U);
+    case 9U: ADC1_READ16(9U);
+    case 8U: ADC1_READ16(8U);
+    case 7U: ADC1_READ16(7U);
+    case 6U: ADC1_READ16(6U);
+    case 5U: ADC1_READ16(5U);
+    case 4U: ADC1_READ16(4U);
+    case 3U: ADC1_READ16(3U);
+    case 2U: ADC1_READ16(2U);
+    case 1U: ADC1_READ16(1U);
+    default:
+        break;
+    }
+}
+#undef ADC1_READ16
+
+/** @fn uint32 adc1Group0GetData16(uint16 *data)
+*   @brief Reads ADC1_G0_DEPTH event group results as packed 16 bit values
+*   @param[out] data Buffer for ADC1_G0_DEPTH values, channel IDs are dropped
+*   @return ADC1_G0_DEPTH
+*
+*   Only call once the group threshold or end flag is set, the FIFO is read without checking its fill level.
+*/
+uint32 adc1Group0GetData16(uint16 *data)
+{
+    adc1ReadFifo16(adcGROUP0, ADC1_G0_DEPTH, data);
+    return ADC1_G0_DEPTH;
+}
+
+/** @fn uint32 adc1Group1GetData16(uint16 *data)
+*   @brief Reads ADC1_G1_DEPTH group 1 results as packed 16 bit values
+*   @param[out] data Buffer for ADC1_G1_DEPTH values, channel IDs are dropped
+*   @return ADC1_G1_DEPTH
+*
+*   Only call once the group threshold or end flag is set, the FIFO is read without checking its fill level.
+*/
+uint32 adc1Group1GetData16(uint16 *data)
+{
+    adc1ReadFifo16(adcGROUP1, ADC1_G1_DEPTH, data);
+    return ADC1_G1_DEPTH;
+}
+
+/** @fn uint32 adc1Group2GetData16(uint16 *data)
+*   @brief Reads ADC1_G2_DEPTH group 2 results as packed 16 bit values
+*   @param[out] data Buffer for ADC1_G2_DEPTH values, channel IDs are dropped
+*   @return ADC1_G2_DEPTH
+*
+*   Only call once the group threshold or end flag is set, the FIFO is read without checking its fill level.
+*/
+uint32 adc1Group2GetData16(uint16 *data)
+{
+    adc1ReadFifo16(adcGROUP2, ADC1_G2_DEPTH, data);
+    return ADC1_G2_DEPTH;
+}
+
+/** @fn void adc1Group2Interrupt(void)
+*   @brief ADC1 Group 2 Interrupt Handler
+*
+*   Not in the HALCoGen VIM table, the application maps it to VIM channel 28 with vimChannelMap when it uses group 2.
+*/
+IRQ
+void adc1Group2Interrupt(void)
+{
+    adcREG1->GxINTFLG[2U] = 9U;
+
+    adcNotification(adcREG1, adcGROUP2);
+}
+
+/** @fn void adc1MagnitudeInterrupt(void)
+*   @brief ADC1 Magnitude Compare Interrupt Handler
+*
+*   Not in the HALCoGen VIM table, the application maps it to VIM channel 31 with vimChannelMap when it uses the
+*   magnitude compares. Clears the flags it reports, the notification gets one bit per comparator.
+*/
+IRQ
+void adc1MagnitudeInterrupt(void)
+{
+    uint32 flags = adcREG1->MAGTHRINTFLG & 7U;
+
+    adcREG1->MAGTHRINTFLG = flags;
+
+    adcMagnitudeNotification(adcREG1, flags);
+}
+
 /* USER CODE END */
@@ -60,7 +60,12 @@
 #include "rti.h"
 
 /* USER CODE BEGIN (0) */
+#if !BUILD_FOR_SCT
 #include "CPS_main.h"
+#else
+#include "SCT_main.h"
+#endif
+#include "CPS_sci.h"
 /* USER CODE END */
 void esmGroup1Notification(uint32 channel)
 {
@@ -102,6 +107,7 @@ void rtiNotification(uint32 notification)
 {
 /*  enter user code between the USER CODE BEGIN and USER CODE END. */
 /* USER CODE BEGIN (9) */
+#if !BUILD_FOR_SCT
   if(notification == rtiNOTIFICATION_COMPARE0)
   {
     CPS_vISRRTICompare0();
@@ -110,6 +116,12 @@ void rtiNotification(uint32 notification)
   {
     CPS_vISRRTICompare1();
   }
+#else
+  if(notification == rtiNOTIFICATION_COMPARE0)
+  {
+    SCT_vISRRTICompare0();
+  }
+#endif
 /* USER CODE END */
 }
 
@@ -119,14 +131,29 @@ void adcNotification(adcBASE_t *adc, uint32 group)
 {
 /*  enter user code between the USER CODE BEGIN and USER CODE END. */
 /* USER CODE BEGIN (11) */
-  if(adc == adcREG1)
+#if !BUILD_FOR_SCT
+  if((adc == adcREG1) && (group == adcGROUP1))
   {
     CPS_vISRADCGroup1();
   }
+  if((adc == adcREG1) && (group == adcGROUP2))
+  {
+    CPS_vISRADCGroup2();
+  }
+#endif
 /* USER CODE END */
 }
 
 /* USER CODE BEGIN (12) */
+void adcMagnitudeNotification(adcBASE_t *adc, uint32 flags)
+{
+#if !BUILD_FOR_SCT
+  if(adc == adcREG1)
+  {
+    CPS_vISRADCMagnitude();
+  }
+#endif
+}
 /* USER CODE END */
 void canErrorNotification(canBASE_t *node, uint32 notification)
 {
@@ -182,6 +209,7 @@ void sciNotification(sciBASE_t *sci, uint32 flags)
 {
 /*  enter user code between the USER CODE BEGIN and USER CODE END. */
 /* USER CODE BEGIN (29) */
+  CPS_vSciNotification(sci, flags);
 /* USER CODE END */
 }
 
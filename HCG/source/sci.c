@@ -633,5 +633,52 @@ void scilinGetConfigValue(sci_config_reg_t *config_reg, config_value_type_t type
 }
 
 /* USER CODE BEGIN (31) */
+/** @fn void linHighLevelInterrupt(void)
+*   @brief Level 0 Interrupt for SCILIN
+*
+*   Not in the HALCoGen VIM table, the application maps it to VIM channel 13 with vimChannelMap. Unlike the generated
+*   handler it does not run the sciSend/sciReceive transfers: sciNotification is called once per pending vector with
+*   its flag and reads RD or writes TD itself. Loops until no vector is pending.
+*/
+IRQ
+void linHighLevelInterrupt(void)
+{
+    uint32 vec = scilinREG->INTVECT0;
+    uint32 flags;
+
+    while (vec != 0U)
+    {
+        switch (vec)
+        {
+        case 1U:
+            flags = (uint32)SCI_WAKE_INT;
+            break;
+        case 3U:
+            flags = (uint32)SCI_PE_INT;
+            break;
+        case 6U:
+            flags = (uint32)SCI_FE_INT;
+            break;
+        case 7U:
+            flags = (uint32)SCI_BREAK_INT;
+            break;
+        case 9U:
+            flags = (uint32)SCI_OE_INT;
+            break;
+        case 11U:
+            flags = (uint32)SCI_RX_INT;
+            break;
+        case 12U:
+            flags = (uint32)SCI_TX_INT;
+            break;
+        default:
+            /* phantom interrupt, clear flags and return */
+            scilinREG->FLR = scilinREG->SETINTLVL & 0x07000303U;
+            return;
+        }
+        sciNotification(scilinREG, flags);
+        vec = scilinREG->INTVECT0;
+    }
+}
 /* USER CODE END */
 
@@ -43,7 +43,9 @@
 
 
 /* USER CODE BEGIN (0) */
-#define BUILD_FOR_SCT 1
+#ifndef BUILD_FOR_SCT
+#define BUILD_FOR_SCT 0 //The CPS_SCT project defines it as 1 for all files
+#endif
 /* USER CODE END */
 
 /* Include Files */
@@ -51,7 +53,11 @@
 #include "sys_common.h"
 
 /* USER CODE BEGIN (1) */
+#if BUILD_FOR_SCT
+#include "SCT_main.h"
+#else
 #include "CPS_main.h"
+#endif
 /* USER CODE END */
 
 /** @fn void main(void)
@@ -68,7 +74,11 @@
 void main(void)
 {
 /* USER CODE BEGIN (3) */
+#if BUILD_FOR_SCT
+SCT_vMain();
+#else
 CPS_vMain();
+#endif
 /* USER CODE END */
 }
 
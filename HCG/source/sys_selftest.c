@@ -43,6 +43,9 @@
 
 
 /* USER CODE BEGIN (0) */
+#if !BUILD_FOR_SCT
+#include "CPS_selftest.h"
+#endif
 /* USER CODE END */
 
 #include "sys_selftest.h"
@@ -58,6 +61,9 @@ void selftestFailNotification(uint32 flag)
 {
 
 /* USER CODE BEGIN (1) */
+#if CPS_SELFTEST_BACKGROUND
+    CPS_vSelfTestFail(flag);
+#endif
 /* USER CODE END */
 
 }
@@ -63,6 +63,10 @@
 #include "mibspi.h"
 
 /* USER CODE BEGIN (1) */
+#if !BUILD_FOR_SCT /* The SCT has no boot profiler or self test scheduler, the CPS_* switches below read as 0 */
+#include "CPS_boot.h"
+#include "CPS_selftest.h"
+#endif
 /* USER CODE END */
 
 
@@ -106,6 +110,9 @@ void _c_int00(void)
     _coreInitStackPointer_();
 
 /* USER CODE BEGIN (7) */
+#if CPS_BOOT_PROFILE
+    CPS_vBootStart();
+#endif
 /* USER CODE END */
 
 
@@ -238,6 +245,19 @@ void _c_int00(void)
     }
 
 /* USER CODE BEGIN (26) */
+#if CPS_BOOT_PROFILE
+    CPS_vBootStamp(eBOOT_CoreInit);
+#endif
+#if CPS_BOOT_WARM
+    /* Warm boot: everything from here to USER CODE (72) is replaced by CPS_vBootWarmStart */
+    if(CPS_bBootWarmCheck() == true)
+    {
+        systemInit();
+        CPS_vBootWarmStart();
+    }
+    else
+    {
+#endif
 /* USER CODE END */
     /* Initialize System - Clock, Flash settings with Efuse self check */
     systemInit();
@@ -301,6 +321,9 @@ void _c_int00(void)
 /* USER CODE END */
 
 /* USER CODE BEGIN (31) */
+#if CPS_BOOT_PROFILE
+    CPS_vBootStamp(eBOOT_RomPbist);
+#endif
 /* USER CODE END */
 
     /* Disable RAM ECC before doing PBIST for Main RAM */
@@ -362,6 +385,9 @@ void _c_int00(void)
     memoryInit(0x1U);
 
 /* USER CODE BEGIN (38) */
+#if CPS_BOOT_PROFILE
+    CPS_vBootStamp(eBOOT_RamInit);
+#endif
 /* USER CODE END */
     
     /* Enable ECC checking for TCRAM accesses.
@@ -370,6 +396,10 @@ void _c_int00(void)
     _coreEnableRamEcc_();
 
 /* USER CODE BEGIN (39) */
+#if CPS_SELFTEST_BACKGROUND
+    /* Only the dual-port RAMs the application uses, CPS_selftest.c tests the others in the background */
+    pbistRun(CPS_SELFTEST_PBIST_BOOT, (uint32)PBIST_March13N_DP);
+#else
 /* USER CODE END */
 
 
@@ -399,6 +429,7 @@ void _c_int00(void)
              ,(uint32) PBIST_March13N_DP);
 
 /* USER CODE BEGIN (40) */
+#endif
 /* USER CODE END */
 
 
@@ -449,6 +480,9 @@ void _c_int00(void)
     }
 
 /* USER CODE BEGIN (48) */
+#if CPS_BOOT_PROFILE
+    CPS_vBootStamp(eBOOT_PeriphPbist);
+#endif
 /* USER CODE END */
 
     /* Disable PBIST clocks and disable memory self-test mode */
@@ -506,6 +540,7 @@ void _c_int00(void)
     het1ParityCheck();
     
 /* USER CODE BEGIN (58) */
+#if !CPS_SELFTEST_BACKGROUND
 /* USER CODE END */
 
     htu1ParityCheck();
@@ -526,12 +561,16 @@ void _c_int00(void)
     can2ParityCheck();
     
 /* USER CODE BEGIN (66) */
+#endif
 /* USER CODE END */
 
     vimParityCheck();
     
 
 /* USER CODE BEGIN (68) */
+#if CPS_BOOT_PROFILE
+    CPS_vBootStamp(eBOOT_PeriphInit);
+#endif
 /* USER CODE END */
 
 /*SAFETYMCUSW 28 D MR:NA <APPROVED> "Hardware status bit read check" */
@@ -541,12 +580,17 @@ void _c_int00(void)
     /* wait for MibSPI1 RAM to complete initialization */
 
 /* USER CODE BEGIN (69) */
+#if !CPS_SELFTEST_BACKGROUND
 /* USER CODE END */
 
     mibspi1ParityCheck();
     
 
 /* USER CODE BEGIN (72) */
+#endif
+#if CPS_BOOT_WARM
+    }
+#endif
 /* USER CODE END */
     
     /* Enable IRQ offset via Vic controller */
@@ -56,6 +56,9 @@
 #include "pinmux.h"
 
 /* USER CODE BEGIN (1) */
+#if !BUILD_FOR_SCT
+#include "CPS_boot.h"
+#endif
 /* USER CODE END */
 
 /** @fn void systemInit(void)
@@ -383,6 +386,9 @@ void systemInit(void)
 	mapClocks();
 
 /* USER CODE BEGIN (24) */
+#if CPS_BOOT_PROFILE
+	CPS_vBootStamp(eBOOT_Clocks);
+#endif
 /* USER CODE END */
 
 	/** - set ECLK pins functional mode */
@@ -0,0 +1,217 @@
+/** @file HOST_acq.c
+*   @brief Two ladder acquisition of the CPS on the host simulation
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Runs a CPS image built with CPS_ACQ_CHANNELS 2, the newer wheels with the horn alone on the horn wire and the
+*   paddles on a ladder of their own, and drives both inputs through a fixed script. After every step each slot's
+*   classification must match its own ladder's table for its filtered code, and the output pins must have pulsed
+*   exactly as the inputs reading that slot ask for. One step puts the same code on both inputs: it is a shift up on
+*   the horn wire ladder and a shift down on the paddle ladder, and only the shift down may reach the pins. The idle
+*   gaps between steps let acquisition stop its interrupts and watch both inputs with the magnitude compare.
+*
+*   Usage: HOST_acq
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include "HOST_sim.h"
+#include "CPS_acq.h"
+#include "CPS_boot.h"
+#include "CPS_main.h"
+#include "spi.h"
+
+/* Defines */
+#define ACQ_CHANNEL_HORN 17u //CPS_axAcqChannels
+#define ACQ_CHANNEL_PADDLE 18u
+#define ACQ_IDLE_HORN 0x0E00u
+#define ACQ_IDLE_PADDLE 0x0E00u
+#define ACQ_NOISE 8u //Peak noise in codes
+#define ACQ_WARMUP_MS 4000u
+#define ACQ_HOLD_MS 300u //Long enough for every input to qualify
+#define ACQ_GAP_MS 1000u //Idle between steps, long enough to start watching
+#define ACQ_STEPS 6u
+
+/* Internal Types */
+typedef enum
+{
+  eACQ_Horn,
+  eACQ_ShiftUp,
+  eACQ_ShiftDown,
+  eACQ_OutputCount
+} xAcqOutput_t;
+
+typedef struct
+{
+  const char *pcName;
+  uint16_t u16Horn; //Code held on the horn wire
+  uint16_t u16Paddle; //Code held on the paddle ladder
+  xHornCommands_t axClass[CPS_ACQ_CHANNELS]; //Expected class of each slot while held
+  uint32_t au32Rises[eACQ_OutputCount]; //Expected output pulses
+} xAcqStep_t;
+
+/* Internal Vars */
+static const xAcqStep_t axAcqSteps[ACQ_STEPS] =
+{
+  {"both idle", ACQ_IDLE_HORN, ACQ_IDLE_PADDLE, {eCMD_Null, eCMD_Null}, {0u, 0u, 0u}},
+  {"paddle ladder shift up", ACQ_IDLE_HORN, 0x0A00u, {eCMD_Null, eCMD_ShiftUp}, {0u, 1u, 0u}},
+  {"paddle ladder shift down", ACQ_IDLE_HORN, 0x0400u, {eCMD_Null, eCMD_ShiftDown}, {0u, 0u, 1u}},
+  {"horn wire horn", 0x0128u, ACQ_IDLE_PADDLE, {eCMD_HornOn, eCMD_Null}, {1u, 0u, 0u}},
+  {"0x7A0 on both, horn wire shift up is not read", 0x07A0u, 0x07A0u, {eCMD_ShiftUp, eCMD_ShiftDown}, {0u, 0u, 1u}},
+  {"horn and paddle shift up together", 0x0128u, 0x0A00u, {eCMD_HornOn, eCMD_ShiftUp}, {1u, 1u, 0u}}
+};
+static const xHostPort_t axOutputPort[eACQ_OutputCount] = {eHOST_PortSpi3, eHOST_PortSpi2, eHOST_PortSpi2};
+static const uint32_t au32OutputPin[eACQ_OutputCount] = {SPI_PIN_SOMI, SPI_PIN_SIMO, SPI_PIN_CLK};
+static const char *const apcOutputName[eACQ_OutputCount] = {"horn", "shift up", "shift down"};
+
+static uint16_t u16Horn = ACQ_IDLE_HORN;
+static uint16_t u16Paddle = ACQ_IDLE_PADDLE;
+static uint32_t u32Random = 0x1B873593u;
+static uint32_t au32Rises[eACQ_OutputCount];
+static uint32_t u32Failures;
+
+/* Local Function Prototypes */
+static uint16_t u16AcqInput(uint32_t u32Channel, uint64_t u64Cycles);
+static void vAcqPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles);
+static void vAcqFirmware(void);
+static void vAcqCheck(bool bPass, const char *pcWhat);
+static void vAcqStep(const xAcqStep_t *pxStep);
+
+/* Global Functions */
+int main(void)
+{
+  xHostSimConfig_t xConfig = {u16AcqInput, vAcqPin, 0, 0, HOST_SIM_ADC_GAIN_UNITY};
+  char acWhat[96];
+  HOST_vSimInit(&xConfig);
+  HOST_vSimStart(vAcqFirmware);
+  HOST_vSimRun((uint64_t)ACQ_WARMUP_MS*HOST_SIM_CYCLES_PER_MS);
+  printf("CPS acquisition, %u channels: horn wire on input %u, paddle ladder on input %u\n", CPS_ACQ_CHANNELS,
+         CPS_axAcqChannels[CPS_ACQ_SLOT_HORN].u32Channel, CPS_axAcqChannels[CPS_ACQ_SLOT_PADDLES].u32Channel);
+  vAcqCheck((CPS_axAcqChannels[CPS_ACQ_SLOT_HORN].u32Channel == ACQ_CHANNEL_HORN) &&
+            (CPS_axAcqChannels[CPS_ACQ_SLOT_PADDLES].u32Channel == ACQ_CHANNEL_PADDLE), "channel table as driven");
+  vAcqCheck(CPS_axAcqChannels[CPS_ACQ_SLOT_PADDLES].pxLadder == &CPS_xADCLadderPaddle, "paddle slot uses its ladder");
+  for(uint32_t u32Step = 0u; u32Step < ACQ_STEPS; u32Step++)
+  {
+    vAcqStep(&axAcqSteps[u32Step]);
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "acquisition watched the idle inputs %u times and woke %u times",
+                 CPS_xAcqStats.u32Watches, CPS_xAcqStats.u32Wakes);
+  vAcqCheck((CPS_xAcqStats.u32Watches >= (ACQ_STEPS - 1u)) && (CPS_xAcqStats.u32Wakes >= (ACQ_STEPS - 2u)), acWhat);
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* uint16_t u16AcqInput(uint32_t u32Channel, uint64_t u64Cycles)
+*   Ideal code of each input, the held level plus a few codes of noise.
+*
+*/
+static uint16_t u16AcqInput(uint32_t u32Channel, uint64_t u64Cycles)
+{
+  int32_t i32Code;
+  (void)u64Cycles;
+  u32Random = (u32Random*1103515245u) + 12345u;
+  i32Code = (int32_t)((u32Random >> 16u) % ((2u*ACQ_NOISE) + 1u)) - (int32_t)ACQ_NOISE;
+  if(u32Channel == ACQ_CHANNEL_HORN)
+  {
+    i32Code += u16Horn;
+  }
+  else if(u32Channel == ACQ_CHANNEL_PADDLE)
+  {
+    i32Code += u16Paddle;
+  }
+  else
+  {
+    HOST_vSimFault("conversion of an input that is not in the channel table");
+  }
+  return((uint16_t)((i32Code < 0) ? 0 : ((i32Code > (int32_t)ADC_CODEMASK) ? (int32_t)ADC_CODEMASK : i32Code)));
+}
+
+/* void vAcqPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+*   Counts the rising edges of the horn and shift outputs.
+*
+*/
+static void vAcqPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+{
+  (void)u64Cycles;
+  for(uint32_t u32Output = 0u; u32Output < (uint32_t)eACQ_OutputCount; u32Output++)
+  {
+    if((xPort == axOutputPort[u32Output]) && ((u32New & ~u32Old & (1u << au32OutputPin[u32Output])) != 0u))
+    {
+      au32Rises[u32Output]++;
+    }
+  }
+}
+
+/* void vAcqFirmware(void)
+*   The CPS image, from reset.
+*
+*/
+static void vAcqFirmware(void)
+{
+  CPS_vBootStart();
+  CPS_vMain();
+}
+
+/* void vAcqCheck(bool bPass, const char *pcWhat)
+*   Prints and counts one check.
+*
+*/
+static void vAcqCheck(bool bPass, const char *pcWhat)
+{
+  printf("  %-90s %s\n", pcWhat, bPass ? "ok" : "FAILED");
+  u32Failures += bPass ? 0u : 1u;
+}
+
+/* void vAcqStep(const xAcqStep_t *pxStep)
+*   Holds the codes of one step, checks the class of every slot against its ladder and the script, releases both
+*   inputs and checks the output pulses the step caused.
+*
+*/
+static void vAcqStep(const xAcqStep_t *pxStep)
+{
+  char acWhat[128];
+  bool bClass = true;
+  bool bOutputs = true;
+  uint32_t u32Code;
+  uint32_t au32Before[eACQ_OutputCount];
+  for(uint32_t u32Output = 0u; u32Output < (uint32_t)eACQ_OutputCount; u32Output++)
+  {
+    au32Before[u32Output] = au32Rises[u32Output];
+  }
+  printf("%s: horn wire 0x%03X, paddle ladder 0x%03X\n", pxStep->pcName, pxStep->u16Horn, pxStep->u16Paddle);
+  u16Horn = pxStep->u16Horn;
+  u16Paddle = pxStep->u16Paddle;
+  HOST_vSimRun(HOST_u64SimCycles() + ((uint64_t)ACQ_HOLD_MS*HOST_SIM_CYCLES_PER_MS));
+  for(uint32_t u32Slot = 0u; u32Slot < CPS_ACQ_CHANNELS; u32Slot++)
+  {
+    u32Code = CPS_au16AcqFiltered[u32Slot] & ADC_CODEMASK;
+    bClass = bClass && (CPS_au8AcqClass[u32Slot] == CPS_axAcqChannels[u32Slot].pxLadder->pu8ClassTable[u32Code]) &&
+             (CPS_au8AcqClass[u32Slot] == (uint8_t)pxStep->axClass[u32Slot]);
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "slots classify through their own ladders, horn wire %u, paddle ladder %u",
+                 CPS_au8AcqClass[CPS_ACQ_SLOT_HORN], CPS_au8AcqClass[CPS_ACQ_SLOT_PADDLES]);
+  vAcqCheck(bClass, acWhat);
+  u16Horn = ACQ_IDLE_HORN;
+  u16Paddle = ACQ_IDLE_PADDLE;
+  HOST_vSimRun(HOST_u64SimCycles() + ((uint64_t)ACQ_GAP_MS*HOST_SIM_CYCLES_PER_MS));
+  for(uint32_t u32Output = 0u; u32Output < (uint32_t)eACQ_OutputCount; u32Output++)
+  {
+    au32Before[u32Output] = au32Rises[u32Output] - au32Before[u32Output];
+    bOutputs = bOutputs && (au32Before[u32Output] == pxStep->au32Rises[u32Output]);
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "outputs pulsed: %s %u, %s %u, %s %u", apcOutputName[eACQ_Horn],
+                 au32Before[eACQ_Horn], apcOutputName[eACQ_ShiftUp], au32Before[eACQ_ShiftUp],
+                 apcOutputName[eACQ_ShiftDown], au32Before[eACQ_ShiftDown]);
+  vAcqCheck(bOutputs, acWhat);
+}
@@ -0,0 +1,103 @@
+/** @file HOST_boot.c
+*   @brief Boot time profiler of the host build
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Stands in for CPS_boot.c, whose early stages park their stamps in PMU event counters with coprocessor
+*   instructions. On the host the C start up has already run when the firmware starts, so every boot is cold and the
+*   record opens at eBOOT_RamInit; the later stamps and the rebase follow CPS_boot.c.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "CPS_boot.h"
+#include "CPS_time.h"
+#include "sys_pmu.h"
+
+/* Global Vars */
+xCPSBootRecord_t CPS_xBootRecord;
+
+/* Internal Vars */
+static uint32_t u32BootBase; //Cycles counted before the last restart of the cycle counter
+
+/* Global Functions */
+
+/* void CPS_vBootStart(void)
+*   Starts the cycle counter and opens a cold boot record. Called by the harness before CPS_vMain.
+*
+*/
+void CPS_vBootStart(void)
+{
+  _pmuInit_();
+  _pmuEnableCountersGlobal_();
+  _pmuResetCycleCounter_();
+  _pmuStartCounters_(pmuCYCLE_COUNTER);
+  u32BootBase = 0u;
+  CPS_xBootRecord.u32Magic = CPS_BOOT_MAGIC;
+  CPS_xBootRecord.u32Warm = 0u;
+  CPS_xBootRecord.u32Stages = 0u;
+  CPS_vBootStamp(eBOOT_RamInit);
+}
+
+/* void CPS_vBootStamp(xCPSBootStage_t xStage)
+*   Stamps the end of a boot stage once per boot.
+*
+*/
+void CPS_vBootStamp(xCPSBootStage_t xStage)
+{
+  uint32_t u32Cycles = CPS_u32TimeCycles() + u32BootBase;
+  if((CPS_xBootRecord.u32Magic == CPS_BOOT_MAGIC) && ((CPS_xBootRecord.u32Stages & (1u << xStage)) == 0u))
+  {
+    CPS_xBootRecord.au32Cycles[xStage] = u32Cycles;
+    CPS_xBootRecord.u32Stages |= 1u << xStage;
+    if(xStage == eBOOT_FirstSample)
+    {
+      CPS_xBootRecord.au32ReadyCycles[0] = u32Cycles;
+    }
+  }
+}
+
+/* bool CPS_bBootWarmCheck(void)
+*   There is no reset to survive on the host.
+*
+*/
+bool CPS_bBootWarmCheck(void)
+{
+  return(false);
+}
+
+/* void CPS_vBootWarmStart(void)
+*   Never taken, see CPS_bBootWarmCheck.
+*
+*/
+void CPS_vBootWarmStart(void)
+{
+}
+
+/* void CPS_vBootRunning(void)
+*   Nothing to keep over a reset on the host.
+*
+*/
+void CPS_vBootRunning(void)
+{
+}
+
+/* bool CPS_bBootWarm(void)
+*   Every host boot is cold.
+*
+*/
+bool CPS_bBootWarm(void)
+{
+  return(false);
+}
+
+/* void CPS_vBootRebase(void)
+*   Carries the current count into the base. Call right before the cycle counter is reset.
+*
+*/
+void CPS_vBootRebase(void)
+{
+  u32BootBase += CPS_u32TimeCycles();
+}
@@ -0,0 +1,206 @@
+/** @file HOST_calib.c
+*   @brief Host test of the ADC offset and gain calibration
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Runs CPS_bCalibRun on the simulated converter for a set of offset and gain errors, then checks the correction
+*   math over every code:
+*
+*   - CPS_u16CalibApply against ((raw + offset - mid)*gain >> 15) + mid worked out in floating point, rounded and
+*     clamped
+*   - CPS_u16CalibRawCode returns the lowest raw code that corrects to the code asked for
+*   - every input the simulated converter does not clip reads back within CALIB_TOLERANCE codes once corrected
+*   - CPS_vCalibInit restores the stored record instead of measuring again
+*
+*   Errors outside the accepted range must fail the calibration and leave raw codes in use, with a unity record whose
+*   check is filled in.
+*
+*   Usage: HOST_calib
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "HOST_sim.h"
+#include "CPS_calib.h"
+#include "adc.h"
+
+/* Defines */
+#define CALIB_CODES 4096u
+#define CALIB_MIDCODE 2047 //Pivot of the simulated gain error
+#define CALIB_TOLERANCE 2 //Codes between a corrected reading and the ideal code
+#define CALIB_GAIN(x) ((uint32_t)(((x)*(double)HOST_SIM_ADC_GAIN_UNITY) + 0.5))
+
+/* Internal Types */
+typedef struct
+{
+  int32_t i32Offset; //Converter errors given to the simulation
+  uint32_t u32Gain;
+  bool bAccept; //Calibration expected to pass
+} xCalibCase_t;
+
+/* Internal Vars */
+static const xCalibCase_t axCases[] =
+{
+  {0, CALIB_GAIN(1.0), true},
+  {6, CALIB_GAIN(1.0), true},
+  {-9, CALIB_GAIN(1.0), true},
+  {4, CALIB_GAIN(0.99), true},
+  {-3, CALIB_GAIN(0.985), true},
+  {2, CALIB_GAIN(1.004), true},
+  {100, CALIB_GAIN(1.0), false},
+  {0, CALIB_GAIN(0.9), false}
+};
+static uint32_t u32Failures;
+
+/* Local Function Prototypes */
+static void vCalibCase(const xCalibCase_t *pxCase);
+static int32_t i32CalibWorst(const xCalibCase_t *pxCase);
+static uint32_t u32CalibMath(void);
+static uint32_t u32CalibConverter(const xCalibCase_t *pxCase, uint32_t u32Ideal);
+static void vCalibCheck(bool bPass, const char *pcWhat);
+
+/* Global Functions */
+int main(void)
+{
+  printf("CPS ADC calibration on the simulated converter\n");
+  for(uint32_t u32Case = 0u; u32Case < (sizeof(axCases)/sizeof(axCases[0])); u32Case++)
+  {
+    vCalibCase(&axCases[u32Case]);
+  }
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* void vCalibCase(const xCalibCase_t *pxCase)
+*   Calibrates against one set of converter errors and checks the result.
+*
+*/
+static void vCalibCase(const xCalibCase_t *pxCase)
+{
+  xHostSimConfig_t xConfig = {0, 0, 0, pxCase->i32Offset, pxCase->u32Gain};
+  xCPSCalibRecord_t xMeasured;
+  uint32_t u32Wrong;
+  int32_t i32Worst;
+  bool bPassed;
+  char acWhat[96];
+  HOST_vSimInit(&xConfig);
+  adcInit();
+  bPassed = CPS_bCalibRun();
+  printf("  converter offset %+d, gain %.4f: measured offset %+d, gain %.4f, %s\n", pxCase->i32Offset,
+         (double)pxCase->u32Gain/HOST_SIM_ADC_GAIN_UNITY, CPS_xCalib.xRecord.i16Offset,
+         (double)CPS_xCalib.xRecord.u16Gain/CPS_CALIB_UNITY, bPassed ? "accepted" : "rejected");
+  vCalibCheck(bPassed == pxCase->bAccept, pxCase->bAccept ? "calibration accepted" : "calibration rejected");
+  vCalibCheck(CPS_xCalib.bValid == bPassed, "correction in use only when accepted");
+  u32Wrong = u32CalibMath();
+  (void)snprintf(acWhat, sizeof(acWhat), "apply and raw code match the reference for every code, %u wrong", u32Wrong);
+  vCalibCheck(u32Wrong == 0u, acWhat);
+  if(!pxCase->bAccept)
+  {
+    u32Wrong = 0u;
+    for(uint32_t u32Raw = 0u; u32Raw < CALIB_CODES; u32Raw++)
+    {
+      u32Wrong += (CPS_u16CalibApply((uint16_t)u32Raw) != u32Raw) ? 1u : 0u;
+    }
+    vCalibCheck(u32Wrong == 0u, "raw codes passed through");
+    vCalibCheck(CPS_xCalib.xRecord.u32Check == ~(CPS_xCalib.xRecord.u32Magic + (uint32_t)CPS_CALIB_UNITY),
+                "unity record in use carries its check");
+    return;
+  }
+  i32Worst = i32CalibWorst(pxCase);
+  (void)snprintf(acWhat, sizeof(acWhat), "corrected readings within %d codes, worst %d", CALIB_TOLERANCE, i32Worst);
+  vCalibCheck(i32Worst <= CALIB_TOLERANCE, acWhat);
+  xMeasured = CPS_xCalib.xRecord;
+  CPS_vCalibInit();
+  vCalibCheck(CPS_xCalib.bRestored && (CPS_xCalib.xRecord.i16Offset == xMeasured.i16Offset) &&
+              (CPS_xCalib.xRecord.u16Gain == xMeasured.u16Gain), "record restored by CPS_vCalibInit");
+}
+
+/* int32_t i32CalibWorst(const xCalibCase_t *pxCase)
+*   Largest distance between an ideal code and its corrected reading, over the inputs the converter does not clip.
+*
+*/
+static int32_t i32CalibWorst(const xCalibCase_t *pxCase)
+{
+  int32_t i32Worst = 0;
+  int32_t i32Error;
+  uint32_t u32Raw;
+  for(uint32_t u32Ideal = 0u; u32Ideal < CALIB_CODES; u32Ideal++)
+  {
+    u32Raw = u32CalibConverter(pxCase, u32Ideal);
+    if((u32Raw == 0u) || (u32Raw == (CALIB_CODES - 1u)))
+    {
+      continue;
+    }
+    i32Error = abs((int32_t)CPS_u16CalibApply((uint16_t)u32Raw) - (int32_t)u32Ideal);
+    i32Worst = (i32Error > i32Worst) ? i32Error : i32Worst;
+  }
+  return(i32Worst);
+}
+
+/* uint32_t u32CalibMath(void)
+*   Checks the fixed point correction in use against the floating point formula, and its inverse by search. Returns
+*   the number of codes that differ.
+*
+*/
+static uint32_t u32CalibMath(void)
+{
+  double dOffset = (double)CPS_xCalib.xRecord.i16Offset;
+  double dGain = (double)CPS_xCalib.xRecord.u16Gain/CPS_CALIB_UNITY;
+  double dCode;
+  uint32_t u32Wrong = 0u;
+  uint32_t u32Lowest = 0u;
+  for(uint32_t u32Raw = 0u; u32Raw < CALIB_CODES; u32Raw++)
+  {
+    dCode = floor((((double)u32Raw + dOffset - CPS_CALIB_MIDCODE)*dGain) + CPS_CALIB_MIDCODE + 0.5);
+    dCode = (dCode < 0.0) ? 0.0 : ((dCode > (CALIB_CODES - 1u)) ? (double)(CALIB_CODES - 1u) : dCode);
+    u32Wrong += (CPS_u16CalibApply((uint16_t)u32Raw) != (uint16_t)dCode) ? 1u : 0u;
+  }
+  if(!CPS_xCalib.bValid)
+  {
+    return(u32Wrong); //CPS_u16CalibRawCode follows the record, not bValid
+  }
+  for(uint32_t u32Code = 0u; u32Code < CALIB_CODES; u32Code++)
+  {
+    while((u32Lowest < (CALIB_CODES - 1u)) && (CPS_u16CalibApply((uint16_t)u32Lowest) < u32Code))
+    {
+      u32Lowest++;
+    }
+    u32Wrong += (CPS_u16CalibRawCode((uint16_t)u32Code) != u32Lowest) ? 1u : 0u;
+  }
+  return(u32Wrong);
+}
+
+/* uint32_t u32CalibConverter(const xCalibCase_t *pxCase, uint32_t u32Ideal)
+*   Raw code the simulated converter gives for an ideal code, same rounding as HOST_periph.c.
+*
+*/
+static uint32_t u32CalibConverter(const xCalibCase_t *pxCase, uint32_t u32Ideal)
+{
+  double dCode = floor(((((double)u32Ideal - CALIB_MIDCODE)*pxCase->u32Gain)/HOST_SIM_ADC_GAIN_UNITY) + 0.5);
+  int64_t i64Code = (int64_t)dCode + CALIB_MIDCODE + pxCase->i32Offset;
+  i64Code = (i64Code < 0) ? 0 : i64Code;
+  i64Code = (i64Code > (CALIB_CODES - 1u)) ? (CALIB_CODES - 1u) : i64Code;
+  return((uint32_t)i64Code);
+}
+
+/* void vCalibCheck(bool bPass, const char *pcWhat)
+*   Prints and counts one check.
+*
+*/
+static void vCalibCheck(bool bPass, const char *pcWhat)
+{
+  printf("    %-70s %s\n", pcWhat, bPass ? "ok" : "FAILED");
+  u32Failures += bPass ? 0u : 1u;
+}
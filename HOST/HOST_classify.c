@@ -0,0 +1,112 @@
+/** @file HOST_classify.c
+*   @brief Host test of the ADC classifier table
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Checks the compile time classifier table of CPS_classify.c against ProcessADCData as it stood in CPS_main.c before
+*   the table replaced it, for every converter code. Codes with bits set above the converter resolution must classify
+*   as their low 12 bits, and the boot self check must pass. The paddle ladder table is checked against its band list.
+*   Needs no simulation, CPS_classify.c is built natively.
+*
+*   Usage: HOST_classify
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include "CPS_classify.h"
+
+/* Defines */
+#define CLASSIFY_REPORT_MAX 10u //Mismatches printed, the rest are only counted
+
+/* Local Function Prototypes */
+static xHornCommands_t ProcessADCData(uint16_t u16Data);
+
+/* Global Functions */
+int main(void)
+{
+  uint32_t au32Band[eCMD_Null + 1] = {0u};
+  uint32_t u32Mismatches = 0u;
+  xHornCommands_t xExpected;
+  xHornCommands_t xTable;
+  xHornCommands_t xHigh;
+  bool bSelfCheck;
+  bool bPaddle;
+  uint32_t au32Paddle[eCMD_Null + 1] = {0u};
+  printf("CPS classifier table against the reference comparison chain\n");
+  for(uint32_t u32Code = 0u; u32Code < ADC_CODES; u32Code++)
+  {
+    xExpected = ProcessADCData((uint16_t)u32Code);
+    xTable = CPS_xClassify(u32Code);
+    xHigh = CPS_xClassify(u32Code | 0xF000u);
+    if((xTable != xExpected) || (xHigh != xExpected))
+    {
+      if(u32Mismatches < CLASSIFY_REPORT_MAX)
+      {
+        printf("  code 0x%03X: reference %d, table %d, table with the upper bits set %d\n", u32Code, (int)xExpected,
+               (int)xTable, (int)xHigh);
+      }
+      u32Mismatches++;
+    }
+    if((uint32_t)xTable <= (uint32_t)eCMD_Null)
+    {
+      au32Band[xTable]++;
+    }
+  }
+  for(uint32_t u32Code = 0u; u32Code < ADC_CODES; u32Code++)
+  {
+    if(CPS_au8ADCPaddleTable[u32Code] <= (uint8_t)eCMD_Null)
+    {
+      au32Paddle[CPS_au8ADCPaddleTable[u32Code]]++;
+    }
+  }
+  bPaddle = CPS_bClassifyLadderCheck(&CPS_xADCLadderPaddle);
+  bSelfCheck = CPS_bClassifySelfCheck();
+  printf("  %u codes, %u mismatches, boot self check %s\n", ADC_CODES, u32Mismatches, bSelfCheck ? "passed" : "failed");
+  printf("  horn on %u codes, shift down %u, shift up %u, none %u\n", au32Band[eCMD_HornOn], au32Band[eCMD_ShiftDown],
+         au32Band[eCMD_ShiftUp], au32Band[eCMD_Null]);
+  printf("  paddle ladder against its bands %s, shift down %u codes, shift up %u, none %u\n",
+         bPaddle ? "passed" : "failed", au32Paddle[eCMD_ShiftDown], au32Paddle[eCMD_ShiftUp], au32Paddle[eCMD_Null]);
+  if((u32Mismatches != 0u) || !bSelfCheck || !bPaddle)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* xHornCommands_t ProcessADCData(uint16_t u16Data)
+*   The comparison chain the table replaced, unchanged from CPS_main.c.
+*
+*/
+static xHornCommands_t ProcessADCData(uint16_t u16Data)
+{
+  if(u16Data <= ADC_UPPERBOUND_HORNON) //Is this a horn depressed signal?
+  {
+    if(u16Data >= ADC_LOWERBOUND_HORNON)
+    {
+      return(eCMD_HornOn);
+    }
+  }
+  if(u16Data <= ADC_UPPERBOUND_SHFTUP) //Is this a shift up signal?
+  {
+    if(u16Data >= ADC_LOWERBOUND_SHFTUP)
+    {
+      return(eCMD_ShiftUp);
+    }
+  }
+  if(u16Data <= ADC_UPPERBOUND_SHFTDN) //Is this a shift down signal?
+  {
+    if(u16Data >= ADC_LOWERBOUND_SHFTDN)
+    {
+      return(eCMD_ShiftDown);
+    }
+  }
+  return (eCMD_Null); //Not an active signal
+}
@@ -0,0 +1,305 @@
+/** @file HOST_filter.c
+*   @brief Host benchmark and test of the sample filter stage
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Builds CPS_filter.c natively and runs its own CPS_vFilterBenchmark, with the PMU cycle counter stood in for by the
+*   time stamp counter of the host CPU. The benchmark is repeated FILTER_RUNS times and the best run of every filter
+*   type is printed, in host cycles per conversion with and without the cost of reading the counter twice. The figures
+*   rank the filters against each other; the target numbers are in CPS_axFilterBenchmark after boot.
+*
+*   The configured filter (CPS_FILTER_TYPE) is then checked through CPS_bFilterPut: one output per
+*   CPS_FILTER_DECIMATION conversions, a flat input passed unchanged and a step settled within FILTER_SETTLE_OUTPUTS
+*   outputs. The output values are checked per type: the boxcar gives the mean of each output period of a ramp, the
+*   IIR stays within FILTER_IIR_CODES of a floating point low pass over a noisy input, and the median rejects a spike
+*   per window and, for a step between any two band levels at every point of the output period, gives one of the
+*   two levels. ctest also builds this file with the boxcar and the IIR selected, as host_filter_boxcar and
+*   host_filter_iir; the benchmark runs only in host_filter (CPS_FILTER_BENCHMARK).
+*
+*   Usage: HOST_filter
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "CPS_filter.h"
+#include "CPS_profile.h"
+#include "sys_pmu.h"
+
+/* Defines */
+#define FILTER_RUNS 2000u //Benchmark repeats, the best run of each filter is kept
+#define FILTER_OUTPUTS 64u //Outputs taken per functional check
+#define FILTER_LEVEL 0x0800u
+#define FILTER_STEP 0x0C00u
+#define FILTER_SETTLE_OUTPUTS 16u //Outputs a step may take to get within FILTER_SETTLE_CODES
+#define FILTER_SETTLE_CODES 2u
+#define FILTER_IIR_CODES 1u //Allowed difference to the floating point low pass
+#define FILTER_LEVELS 4u
+
+/* Internal Vars */
+static const char *const apcFilterName[CPS_FILTER_IIR + 1u] = {"none", "boxcar", "median", "IIR"};
+static const uint16_t au16FilterLevels[FILTER_LEVELS] = {0x0128u, 0x04CCu, 0x0980u, 0x0F00u}; //Horn, down, up, idle
+static uint32_t u32Failures;
+
+/* Local Function Prototypes */
+static uint32_t u32FilterCycles(void);
+static void vFilterCheck(bool bPass, const char *pcWhat);
+#if CPS_FILTER_BENCHMARK
+static void vFilterBenchmark(void);
+#endif
+static void vFilterFunction(void);
+static void vFilterValues(void);
+
+/* Global Functions */
+int main(void)
+{
+#if CPS_FILTER_BENCHMARK
+  vFilterBenchmark();
+#endif
+  vFilterFunction();
+  vFilterValues();
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Stand ins for the sys_pmu assembler routines and CPS_time.c, the profiler only needs a free running counter */
+
+void CPS_vTimeCyclesStart(void)
+{
+}
+
+void _pmuInit_(void)
+{
+}
+
+void _pmuEnableCountersGlobal_(void)
+{
+}
+
+void _pmuResetCycleCounter_(void)
+{
+}
+
+void _pmuStartCounters_(uint32 counters)
+{
+  (void)counters;
+}
+
+uint32 _pmuGetCycleCount_(void)
+{
+  return(u32FilterCycles());
+}
+
+/* Local Functions */
+
+/* uint32_t u32FilterCycles(void)
+*   Host cycle counter, nanoseconds where the CPU has no time stamp counter.
+*
+*/
+static uint32_t u32FilterCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return((uint32_t)__rdtsc());
+#else
+  struct timespec xNow;
+  (void)clock_gettime(CLOCK_MONOTONIC, &xNow);
+  return((uint32_t)(((uint64_t)xNow.tv_sec*1000000000u) + (uint64_t)xNow.tv_nsec));
+#endif
+}
+
+/* void vFilterCheck(bool bPass, const char *pcWhat)
+*   Prints and counts one functional check.
+*
+*/
+static void vFilterCheck(bool bPass, const char *pcWhat)
+{
+  printf("  %-60s %s\n", pcWhat, bPass ? "ok" : "FAILED");
+  u32Failures += bPass ? 0u : 1u;
+}
+
+#if CPS_FILTER_BENCHMARK
+/* void vFilterBenchmark(void)
+*   Best of FILTER_RUNS runs of CPS_vFilterBenchmark per filter type, next to the cost of an empty measurement.
+*
+*/
+static void vFilterBenchmark(void)
+{
+  xCPSFilterBenchmark_t axBest[CPS_FILTER_IIR + 1u];
+  uint32_t u32Empty = 0xFFFFFFFFu;
+  uint32_t u32Start;
+  uint32_t u32Net;
+  for(uint32_t u32Type = 0u; u32Type <= CPS_FILTER_IIR; u32Type++)
+  {
+    axBest[u32Type].u32CyclesPerSample = 0xFFFFFFFFu;
+    axBest[u32Type].u32MaxCycles = 0u;
+  }
+  for(uint32_t u32Run = 0u; u32Run < FILTER_RUNS; u32Run++)
+  {
+    u32Start = CPS_u32ProfileCycles();
+    u32Start = CPS_u32ProfileCycles() - u32Start;
+    u32Empty = (u32Start < u32Empty) ? u32Start : u32Empty;
+    CPS_vFilterBenchmark();
+    for(uint32_t u32Type = 0u; u32Type <= CPS_FILTER_IIR; u32Type++)
+    {
+      if(CPS_axFilterBenchmark[u32Type].u32CyclesPerSample < axBest[u32Type].u32CyclesPerSample)
+      {
+        axBest[u32Type] = CPS_axFilterBenchmark[u32Type];
+      }
+    }
+  }
+  printf("CPS filter stage, CPS_vFilterBenchmark best of %u runs of %u conversions\n", FILTER_RUNS,
+         CPS_FILTER_BENCHMARK_SAMPLES);
+  printf("  host cycles per conversion, %u of them are the two counter reads\n", u32Empty);
+  for(uint32_t u32Type = 0u; u32Type <= CPS_FILTER_IIR; u32Type++)
+  {
+    u32Net = (axBest[u32Type].u32CyclesPerSample > u32Empty) ? (axBest[u32Type].u32CyclesPerSample - u32Empty) : 0u;
+    printf("  %-7s mean %5u net %5u worst %6u%s\n", apcFilterName[u32Type], axBest[u32Type].u32CyclesPerSample,
+           u32Net, axBest[u32Type].u32MaxCycles, (u32Type == CPS_FILTER_TYPE) ? "  (configured)" : "");
+  }
+}
+#endif
+
+/* void vFilterFunction(void)
+*   Runs the configured filter through CPS_bFilterPut on slot 0.
+*
+*/
+static void vFilterFunction(void)
+{
+  uint32_t u32Outputs = 0u;
+  uint32_t u32Wrong = 0u;
+  uint32_t u32Settle = 0u;
+  uint16_t u16Filtered;
+  char acWhat[96];
+  printf("CPS_bFilterPut, %s filter, decimation %u, median taps %u\n", apcFilterName[CPS_FILTER_TYPE],
+         CPS_FILTER_DECIMATION, CPS_FILTER_MEDIAN_TAPS);
+  CPS_vFilterReset();
+  for(uint32_t u32Conversion = 0u; u32Conversion < (FILTER_OUTPUTS*CPS_FILTER_DECIMATION); u32Conversion++)
+  {
+    if(CPS_bFilterPut(0u, FILTER_LEVEL, &u16Filtered))
+    {
+      u32Outputs++;
+      u32Wrong += (u16Filtered != FILTER_LEVEL) ? 1u : 0u;
+    }
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "%u outputs from %u conversions", u32Outputs,
+                 FILTER_OUTPUTS*CPS_FILTER_DECIMATION);
+  vFilterCheck(u32Outputs == FILTER_OUTPUTS, acWhat);
+  vFilterCheck(u32Wrong == 0u, "flat input passed unchanged");
+
+  u32Outputs = 0u;
+  while((u32Outputs < FILTER_OUTPUTS) && (u32Settle == 0u))
+  {
+    if(CPS_bFilterPut(0u, FILTER_STEP, &u16Filtered))
+    {
+      u32Outputs++;
+      u32Settle = ((u16Filtered + FILTER_SETTLE_CODES) >= FILTER_STEP) ? u32Outputs : 0u;
+    }
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "step 0x%03X to 0x%03X, outputs to settle %u", FILTER_LEVEL, FILTER_STEP,
+                 u32Settle);
+  vFilterCheck((u32Settle != 0u) && (u32Settle <= FILTER_SETTLE_OUTPUTS), acWhat);
+}
+
+/* void vFilterValues(void)
+*   Checks the output values of the configured filter type on slot 0.
+*
+*/
+static void vFilterValues(void)
+{
+  char acWhat[96];
+  uint32_t u32Outputs = 0u;
+  uint32_t u32Wrong = 0u;
+  uint32_t u32Raw;
+  uint16_t u16Filtered;
+#if CPS_FILTER_TYPE == CPS_FILTER_BOXCAR
+  CPS_vFilterReset();
+  for(uint32_t u32Conversion = 0u; u32Conversion < (FILTER_OUTPUTS*CPS_FILTER_DECIMATION); u32Conversion++)
+  {
+    u32Raw = FILTER_LEVEL + (u32Conversion % CPS_FILTER_DECIMATION);
+    if(CPS_bFilterPut(0u, (uint16_t)u32Raw, &u16Filtered))
+    {
+      u32Outputs++;
+      u32Wrong += (u16Filtered != (FILTER_LEVEL + ((CPS_FILTER_DECIMATION - 1u)/2u))) ? 1u : 0u;
+    }
+  }
+  vFilterCheck((u32Outputs == FILTER_OUTPUTS) && (u32Wrong == 0u), "ramp gives the mean of every output period");
+#elif CPS_FILTER_TYPE == CPS_FILTER_IIR
+  double dReference = 0.0;
+  double dError;
+  uint32_t u32Noise = 0x1234u;
+  CPS_vFilterReset();
+  for(uint32_t u32Conversion = 0u; u32Conversion < (FILTER_OUTPUTS*CPS_FILTER_DECIMATION); u32Conversion++)
+  {
+    u32Noise = (u32Noise*1103515245u) + 12345u;
+    u32Raw = au16FilterLevels[(u32Conversion/(4u*CPS_FILTER_DECIMATION)) % FILTER_LEVELS] + ((u32Noise >> 16u) & 0x3Fu);
+    dReference = (u32Conversion == 0u) ? (double)u32Raw :
+                 (dReference + (((double)u32Raw - dReference)/(double)(1u << CPS_FILTER_IIR_SHIFT)));
+    if(CPS_bFilterPut(0u, (uint16_t)u32Raw, &u16Filtered))
+    {
+      u32Outputs++;
+      dError = (double)u16Filtered - dReference;
+      u32Wrong += ((dError > (double)FILTER_IIR_CODES) || (dError < -(double)FILTER_IIR_CODES)) ? 1u : 0u;
+    }
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "noisy steps track a floating point low pass, %u of %u off", u32Wrong,
+                 u32Outputs);
+  vFilterCheck((u32Outputs == FILTER_OUTPUTS) && (u32Wrong == 0u), acWhat);
+#elif CPS_FILTER_TYPE == CPS_FILTER_MEDIAN
+  CPS_vFilterReset();
+  for(uint32_t u32Conversion = 0u; u32Conversion < (FILTER_OUTPUTS*CPS_FILTER_DECIMATION); u32Conversion++)
+  {
+    u32Raw = ((u32Conversion % CPS_FILTER_MEDIAN_TAPS) == 1u) ? 0x0FFFu : FILTER_LEVEL;
+    if(CPS_bFilterPut(0u, (uint16_t)u32Raw, &u16Filtered))
+    {
+      u32Outputs++;
+      u32Wrong += (u16Filtered != FILTER_LEVEL) ? 1u : 0u;
+    }
+  }
+  vFilterCheck(u32Wrong == 0u, "one full scale spike per median window rejected");
+
+  u32Outputs = 0u;
+  u32Wrong = 0u;
+  for(uint32_t u32From = 0u; u32From < FILTER_LEVELS; u32From++) //Step inside an output period, at every conversion
+  {
+    for(uint32_t u32To = 0u; u32To < FILTER_LEVELS; u32To++)
+    {
+      for(uint32_t u32Split = 1u; (u32From != u32To) && (u32Split < CPS_FILTER_DECIMATION); u32Split++)
+      {
+        CPS_vFilterReset();
+        for(uint32_t u32Conversion = 0u; u32Conversion < (4u*CPS_FILTER_DECIMATION); u32Conversion++)
+        {
+          u32Raw = (u32Conversion < (CPS_FILTER_DECIMATION + u32Split)) ? au16FilterLevels[u32From] :
+                   au16FilterLevels[u32To];
+          if(CPS_bFilterPut(0u, (uint16_t)u32Raw, &u16Filtered))
+          {
+            u32Outputs++;
+            u32Wrong += ((u16Filtered != au16FilterLevels[u32From]) && (u16Filtered != au16FilterLevels[u32To])) ?
+                        1u : 0u;
+          }
+        }
+      }
+    }
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "step inside a period gives one of its two levels, %u of %u off",
+                 u32Wrong, u32Outputs);
+  vFilterCheck(u32Wrong == 0u, acWhat);
+#endif
+  (void)au16FilterLevels;
+  (void)acWhat;
+  (void)u32Outputs;
+  (void)u32Wrong;
+  (void)u32Raw;
+  (void)u16Filtered;
+}
@@ -0,0 +1,311 @@
+/** @file HOST_frame.c
+*   @brief Host test of the CPS/SCT link frames
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Builds CPS_frame.c natively and checks the protocol both processors share:
+*
+*   - the CRC-16/CCITT-FALSE check value of "123456789" is 0x29B1
+*   - event frames of every length from one record to a full batch parse back to the same SEQ, stamp and records
+*   - every single bit error and every dropped byte of a frame is caught, and the parser is back in step within
+*     FRAME_RECOVER_FRAMES frames. A corrupted LEN can make it swallow the frame that follows, it prints how many
+*     were lost at worst
+*   - a lost frame shows as a SEQ gap
+*   - samples frames of a random walk with flat stretches decode back to the same samples
+*
+*   It also prints the time a one event frame spends on the line at CPS_SCI_BAUD.
+*
+*   Usage: HOST_frame
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CPS_frame.h"
+#include "CPS_sci.h"
+
+/* Defines */
+#define FRAME_CHECK_VALUE 0x29B1u
+#define FRAME_SAMPLE_FRAMES 1000u
+#define FRAME_SAMPLES_MAX 64u //Decode room, more than a frame can hold
+#define FRAME_RECOVER_FRAMES 4u //One event frames sent after a corrupted one, the last must parse
+
+/* Internal Vars */
+static uint32_t u32Random = 0x2545F491u;
+static uint32_t u32Failures;
+
+/* Local Function Prototypes */
+static void vFrameCrc(void);
+static void vFrameEvents(void);
+static void vFrameErrors(void);
+static void vFrameSamples(void);
+static uint32_t u32FrameBuild(xCPSFrameBatch_t *pxBatch, uint32_t u32Records, uint8_t u8Seq, uint32_t u32Stamp);
+static uint32_t u32FrameFeed(xCPSFrameParser_t *pxParser, const uint8_t *pu8Data, uint32_t u32Length);
+static uint32_t u32FrameRecover(xCPSFrameParser_t *pxParser);
+static uint32_t u32FrameRandom(void);
+static void vFrameCheck(bool bPass, const char *pcWhat);
+
+/* Global Functions */
+int main(void)
+{
+  printf("CPS link frames\n");
+  vFrameCrc();
+  vFrameEvents();
+  vFrameErrors();
+  vFrameSamples();
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* void vFrameCrc(void)
+*   Check value of the CRC, in one go and continued a byte at a time.
+*
+*/
+static void vFrameCrc(void)
+{
+  static const uint8_t au8Check[9u] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  uint16_t u16Whole = CPS_u16FrameCrc(0xFFFFu, au8Check, sizeof(au8Check));
+  uint16_t u16Bytes = 0xFFFFu;
+  char acWhat[96];
+  for(uint32_t u32Byte = 0u; u32Byte < sizeof(au8Check); u32Byte++)
+  {
+    u16Bytes = CPS_u16FrameCrc(u16Bytes, &au8Check[u32Byte], 1u);
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "CRC of \"123456789\" 0x%04X, continued 0x%04X, expected 0x%04X", u16Whole,
+                 u16Bytes, FRAME_CHECK_VALUE);
+  vFrameCheck((u16Whole == FRAME_CHECK_VALUE) && (u16Bytes == FRAME_CHECK_VALUE), acWhat);
+}
+
+/* void vFrameEvents(void)
+*   Round trip of event frames from one record to a full batch, and the line time of the shortest.
+*
+*/
+static void vFrameEvents(void)
+{
+  xCPSFrameBatch_t xBatch;
+  xCPSFrameParser_t xParser;
+  uint32_t u32Length;
+  uint32_t u32Wrong = 0u;
+  uint32_t u32Stamp;
+  const uint8_t *pu8Record;
+  char acWhat[96];
+  CPS_vFrameParserReset(&xParser);
+  for(uint32_t u32Records = 1u; u32Records <= CPS_FRAME_RECORDS_MAX; u32Records++)
+  {
+    u32Stamp = u32FrameRandom();
+    u32Length = u32FrameBuild(&xBatch, u32Records, (uint8_t)u32Records, u32Stamp);
+    if(u32Records == 1u)
+    {
+      printf("  one event frame: %u bytes, %u us on the line at %u baud\n", u32Length,
+             (u32Length*CPS_FRAME_BITS_PER_BYTE*1000000u)/CPS_SCI_BAUD, CPS_SCI_BAUD);
+    }
+    if((u32FrameFeed(&xParser, xBatch.au8Frame, u32Length) != 1u) || (xParser.u8Seq != (uint8_t)u32Records) ||
+       (xParser.u8Type != (uint8_t)eFRAME_Events) ||
+       (xParser.u8Length != (CPS_FRAME_STAMP_BYTES + (u32Records*CPS_FRAME_RECORD_BYTES))))
+    {
+      u32Wrong++;
+      continue;
+    }
+    u32Wrong += (((uint32_t)xParser.au8Payload[0u] | ((uint32_t)xParser.au8Payload[1u] << 8u) |
+                  ((uint32_t)xParser.au8Payload[2u] << 16u) | ((uint32_t)xParser.au8Payload[3u] << 24u)) != u32Stamp) ?
+                1u : 0u;
+    for(uint32_t u32Record = 0u; u32Record < u32Records; u32Record++)
+    {
+      pu8Record = &xParser.au8Payload[CPS_FRAME_STAMP_BYTES + (u32Record*CPS_FRAME_RECORD_BYTES)];
+      u32Wrong += ((pu8Record[0u] != (uint8_t)(u32Record % ((uint32_t)eLINK_PaddleRelease + 1u))) ||
+                   (pu8Record[1u] != (uint8_t)u32Record) ||
+                   (((uint32_t)pu8Record[2u] | ((uint32_t)pu8Record[3u] << 8u)) != (u32Record*100u))) ? 1u : 0u;
+    }
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "event frames of 1 to %u records parse back unchanged, %u wrong",
+                 CPS_FRAME_RECORDS_MAX, u32Wrong);
+  vFrameCheck((u32Wrong == 0u) && (xParser.u32SeqGaps == 0u), acWhat);
+}
+
+/* void vFrameErrors(void)
+*   Every single bit error and every dropped byte of a full frame, each followed by an intact frame.
+*
+*/
+static void vFrameErrors(void)
+{
+  xCPSFrameBatch_t xBatch;
+  xCPSFrameParser_t xParser;
+  uint8_t au8Bad[CPS_FRAME_MAX];
+  uint32_t u32Length = u32FrameBuild(&xBatch, CPS_FRAME_RECORDS_MAX, 10u, 0x12345678u);
+  uint32_t u32Accepted = 0u;
+  uint32_t u32Lost;
+  uint32_t u32WorstLost = 0u;
+  uint32_t u32Unrecovered = 0u;
+  uint32_t u32Cases = 0u;
+  char acWhat[96];
+  for(uint32_t u32Bit = 0u; u32Bit < (u32Length*8u); u32Bit++)
+  {
+    memcpy(au8Bad, xBatch.au8Frame, u32Length);
+    au8Bad[u32Bit/8u] ^= (uint8_t)(1u << (u32Bit%8u));
+    CPS_vFrameParserReset(&xParser);
+    u32Accepted += u32FrameFeed(&xParser, au8Bad, u32Length);
+    u32Lost = u32FrameRecover(&xParser);
+    u32WorstLost = (u32Lost > u32WorstLost) ? u32Lost : u32WorstLost;
+    u32Unrecovered += (u32Lost >= FRAME_RECOVER_FRAMES) ? 1u : 0u;
+    u32Cases++;
+  }
+  for(uint32_t u32Drop = 0u; u32Drop < u32Length; u32Drop++)
+  {
+    memcpy(au8Bad, xBatch.au8Frame, u32Drop);
+    memcpy(&au8Bad[u32Drop], &xBatch.au8Frame[u32Drop + 1u], u32Length - u32Drop - 1u);
+    CPS_vFrameParserReset(&xParser);
+    u32Accepted += u32FrameFeed(&xParser, au8Bad, u32Length - 1u);
+    u32Lost = u32FrameRecover(&xParser);
+    u32WorstLost = (u32Lost > u32WorstLost) ? u32Lost : u32WorstLost;
+    u32Unrecovered += (u32Lost >= FRAME_RECOVER_FRAMES) ? 1u : 0u;
+    u32Cases++;
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "%u corrupted frames, %u accepted", u32Cases, u32Accepted);
+  vFrameCheck(u32Accepted == 0u, acWhat);
+  (void)snprintf(acWhat, sizeof(acWhat), "parser back in step within %u frames, worst %u intact frames lost",
+                 FRAME_RECOVER_FRAMES, u32WorstLost);
+  vFrameCheck(u32Unrecovered == 0u, acWhat);
+
+  CPS_vFrameParserReset(&xParser);
+  (void)u32FrameFeed(&xParser, xBatch.au8Frame, u32Length); //SEQ 10
+  u32Length = u32FrameBuild(&xBatch, 1u, 13u, 0u);
+  (void)u32FrameFeed(&xParser, xBatch.au8Frame, u32Length); //SEQ 11 and 12 lost
+  (void)snprintf(acWhat, sizeof(acWhat), "two lost frames counted as %u SEQ gaps", xParser.u32SeqGaps);
+  vFrameCheck(xParser.u32SeqGaps == 2u, acWhat);
+}
+
+/* void vFrameSamples(void)
+*   Random walk with flat stretches through samples frames, each parsed and decoded back.
+*
+*/
+static void vFrameSamples(void)
+{
+  xCPSFrameSamples_t xSamples;
+  xCPSFrameParser_t xParser;
+  uint16_t au16Sent[FRAME_SAMPLES_MAX];
+  uint16_t au16Back[FRAME_SAMPLES_MAX];
+  uint32_t u32Stamp;
+  uint32_t u32Count;
+  uint32_t u32Length;
+  uint32_t u32Wrong = 0u;
+  uint32_t u32Samples = 0u;
+  uint32_t u32Bytes = 0u;
+  int32_t i32Sample = 0x800;
+  char acWhat[96];
+  CPS_vFrameParserReset(&xParser);
+  for(uint32_t u32Frame = 0u; u32Frame < FRAME_SAMPLE_FRAMES; u32Frame++)
+  {
+    u32Count = 1u;
+    au16Sent[0u] = (uint16_t)i32Sample;
+    CPS_vFrameSamplesStart(&xSamples, u32Frame*1000u, au16Sent[0u]);
+    for(;;)
+    {
+      if((u32FrameRandom() % 4u) != 0u) //A quarter of the samples move, by up to a full scale step
+      {
+        i32Sample += (int32_t)(u32FrameRandom() % 4095u) - 2047;
+        i32Sample = (i32Sample < 0) ? 0 : ((i32Sample > 0xFFF) ? 0xFFF : i32Sample);
+      }
+      if((u32Count >= FRAME_SAMPLES_MAX) || !CPS_bFrameSamplesAdd(&xSamples, (uint16_t)i32Sample))
+      {
+        break;
+      }
+      au16Sent[u32Count] = (uint16_t)i32Sample;
+      u32Count++;
+    }
+    u32Length = CPS_u32FrameSamplesEnd(&xSamples, (uint8_t)u32Frame);
+    u32Samples += u32Count;
+    u32Bytes += u32Length;
+    if((u32FrameFeed(&xParser, xSamples.au8Frame, u32Length) != 1u) ||
+       (CPS_u32FrameSamplesDecode(xParser.au8Payload, xParser.u8Length, &u32Stamp, au16Back, FRAME_SAMPLES_MAX) !=
+        u32Count) || (u32Stamp != (u32Frame*1000u)) || (memcmp(au16Sent, au16Back, u32Count*sizeof(uint16_t)) != 0))
+    {
+      u32Wrong++;
+    }
+  }
+  (void)snprintf(acWhat, sizeof(acWhat), "%u samples frames, %u samples, %u bytes on the line, %u wrong",
+                 FRAME_SAMPLE_FRAMES, u32Samples, u32Bytes, u32Wrong);
+  vFrameCheck((u32Wrong == 0u) && (u32Count >= CPS_FRAME_SAMPLES_MIN), acWhat);
+}
+
+/* uint32_t u32FrameBuild(xCPSFrameBatch_t *pxBatch, uint32_t u32Records, uint8_t u8Seq, uint32_t u32Stamp)
+*   Event frame of u32Records records: every link event in turn, the record index as data, 100 counts apart.
+*
+*/
+static uint32_t u32FrameBuild(xCPSFrameBatch_t *pxBatch, uint32_t u32Records, uint8_t u8Seq, uint32_t u32Stamp)
+{
+  CPS_vFrameBatchStart(pxBatch);
+  for(uint32_t u32Record = 0u; u32Record < u32Records; u32Record++)
+  {
+    (void)CPS_bFrameBatchAdd(pxBatch, (xCPSLinkEvent_t)(u32Record % ((uint32_t)eLINK_PaddleRelease + 1u)),
+                             (uint8_t)u32Record, u32Stamp + (u32Record*100u));
+  }
+  return(CPS_u32FrameBatchEnd(pxBatch, u8Seq));
+}
+
+/* uint32_t u32FrameFeed(xCPSFrameParser_t *pxParser, const uint8_t *pu8Data, uint32_t u32Length)
+*   Feeds bytes to the parser and returns the number of intact frames they completed. The last one stays in the
+*   parser.
+*
+*/
+static uint32_t u32FrameFeed(xCPSFrameParser_t *pxParser, const uint8_t *pu8Data, uint32_t u32Length)
+{
+  uint32_t u32Frames = 0u;
+  for(uint32_t u32Byte = 0u; u32Byte < u32Length; u32Byte++)
+  {
+    u32Frames += CPS_bFrameParse(pxParser, pu8Data[u32Byte]) ? 1u : 0u;
+  }
+  return(u32Frames);
+}
+
+/* uint32_t u32FrameRecover(xCPSFrameParser_t *pxParser)
+*   Sends FRAME_RECOVER_FRAMES one event frames and returns how many did not parse. The last one must, or the
+*   parser is out of step for good.
+*
+*/
+static uint32_t u32FrameRecover(xCPSFrameParser_t *pxParser)
+{
+  xCPSFrameBatch_t xNext;
+  uint32_t u32Length;
+  uint32_t u32Lost = 0u;
+  bool bParsed = false;
+  for(uint32_t u32Frame = 0u; u32Frame < FRAME_RECOVER_FRAMES; u32Frame++)
+  {
+    u32Length = u32FrameBuild(&xNext, 1u, (uint8_t)(11u + u32Frame), u32Frame);
+    bParsed = (u32FrameFeed(pxParser, xNext.au8Frame, u32Length) == 1u);
+    u32Lost += bParsed ? 0u : 1u;
+  }
+  return(bParsed ? u32Lost : FRAME_RECOVER_FRAMES);
+}
+
+/* uint32_t u32FrameRandom(void)
+*   Xorshift, the same sequence on every run.
+*
+*/
+static uint32_t u32FrameRandom(void)
+{
+  u32Random ^= u32Random << 13u;
+  u32Random ^= u32Random >> 17u;
+  u32Random ^= u32Random << 5u;
+  return(u32Random);
+}
+
+/* void vFrameCheck(bool bPass, const char *pcWhat)
+*   Prints and counts one check.
+*
+*/
+static void vFrameCheck(bool bPass, const char *pcWhat)
+{
+  printf("  %-90s %s\n", pcWhat, bPass ? "ok" : "FAILED");
+  u32Failures += bPass ? 0u : 1u;
+}
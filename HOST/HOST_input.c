@@ -0,0 +1,245 @@
+/** @file HOST_input.c
+*   @brief Exhaustive host test of the input state machine
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Feeds CPS_xInputStep every sequence of INPUT_SEQUENCE_LENGTH steps, where a step is one classified sample (horn,
+*   shift up, shift down or none) or a wait as long as the paddle or the horn hold-off. After every step each input's
+*   command, state and sample count are compared with a reference model written from the rules in CPS_input.h
+*   rather than from the transition table, the hold-off timer through the state the next sample leaves behind:
+*
+*   - idle, or hold-off once its timer has run out: an in band sample starts qualifying, or is accepted straight away
+*     when one sample qualifies
+*   - qualifying: in band samples count up and the one that completes the count is accepted with the on command; any
+*     other sample goes back to idle
+*   - active: in band samples change nothing; the first other sample sends the off command and starts the hold-off
+*   - hold-off while its timer runs: every sample is ignored
+*
+*   CPS_input.c is built natively with the wheel timer backend, which the harness ticks itself.
+*
+*   Usage: HOST_input
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include "CPS_input.h"
+#include "CPS_timer.h"
+
+/* Defines */
+#define INPUT_SEQUENCE_LENGTH 7u
+#define INPUT_SYMBOLS 6u //Four sample classes and two waits
+#define INPUT_SYMBOL_WAITPADDLE 4u
+#define INPUT_SYMBOL_WAITHORN 5u
+#define INPUT_REPORT_MAX 10u
+
+#if CPS_TIMER_TICKLESS
+#error "HOST_input ticks the wheel backend itself, build it with CPS_TIMER_TICKLESS=0"
+#endif
+
+/* Internal Types */
+typedef struct
+{
+  xCPSInputStates_t xState;
+  uint32_t u32Count;
+  uint32_t u32HoldOffEnd; //Tick at which the hold-off runs out
+} xInputModel_t;
+
+/* Internal Vars */
+static const xHornCommands_t axSymbolClass[4u] = {eCMD_HornOn, eCMD_ShiftUp, eCMD_ShiftDown, eCMD_Null};
+static const char *const apcSymbolName[INPUT_SYMBOLS] = {"horn", "up", "down", "none", "wait paddle", "wait horn"};
+static xInputModel_t axModel[eINPUT_Count];
+static uint32_t u32Ticks; //Wheel ticks given since the sequence started
+static uint32_t u32Failures;
+
+/* Local Function Prototypes */
+static void vInputRunSequence(const uint32_t *pu32Symbols, uint32_t *pu32Transitions);
+static xHornCommands_t xInputModelStep(uint32_t u32Input, xHornCommands_t xClass);
+static bool bInputModelHoldOff(uint32_t u32Input);
+static void vInputWait(uint32_t u32Ms);
+static void vInputFail(const uint32_t *pu32Symbols, uint32_t u32Step, uint32_t u32Input, const char *pcWhat);
+
+/* Global Functions */
+int main(void)
+{
+  uint32_t au32Symbols[INPUT_SEQUENCE_LENGTH] = {0u};
+  uint32_t au32Transitions[eSTATE_Count] = {0u};
+  uint32_t u32Sequences = 0u;
+  uint32_t u32Digit;
+  printf("CPS input state machine against the reference model, every sequence of %u steps\n", INPUT_SEQUENCE_LENGTH);
+  for(;;)
+  {
+    vInputRunSequence(au32Symbols, au32Transitions);
+    u32Sequences++;
+    for(u32Digit = 0u; u32Digit < INPUT_SEQUENCE_LENGTH; u32Digit++) //Next sequence, counting in base INPUT_SYMBOLS
+    {
+      au32Symbols[u32Digit]++;
+      if(au32Symbols[u32Digit] < INPUT_SYMBOLS)
+      {
+        break;
+      }
+      au32Symbols[u32Digit] = 0u;
+    }
+    if(u32Digit == INPUT_SEQUENCE_LENGTH)
+    {
+      break;
+    }
+  }
+  printf("  %u sequences, %u mismatches\n", u32Sequences, u32Failures);
+  printf("  samples taken in idle %u, qualifying %u, active %u, hold-off %u\n", au32Transitions[eSTATE_Idle],
+         au32Transitions[eSTATE_Qualifying], au32Transitions[eSTATE_Active], au32Transitions[eSTATE_HoldOff]);
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* void vInputRunSequence(const uint32_t *pu32Symbols, uint32_t *pu32Transitions)
+*   Runs one sequence from a reset and checks every input after every step. Counts the samples seen per state.
+*
+*/
+static void vInputRunSequence(const uint32_t *pu32Symbols, uint32_t *pu32Transitions)
+{
+  uint8_t au8Class[CPS_ACQ_CHANNELS];
+  xHornCommands_t xExpected;
+  xHornCommands_t xCommand;
+  CPS_vTimerInit();
+  CPS_vInputReset();
+  u32Ticks = 0u;
+  for(uint32_t u32Input = 0u; u32Input < eINPUT_Count; u32Input++)
+  {
+    axModel[u32Input].xState = eSTATE_Idle;
+    axModel[u32Input].u32Count = 0u;
+    axModel[u32Input].u32HoldOffEnd = 0u;
+  }
+  for(uint32_t u32Step = 0u; u32Step < INPUT_SEQUENCE_LENGTH; u32Step++)
+  {
+    if(pu32Symbols[u32Step] == INPUT_SYMBOL_WAITPADDLE)
+    {
+      vInputWait(DEBOUNCE_PADDLES_MS);
+    }
+    else if(pu32Symbols[u32Step] == INPUT_SYMBOL_WAITHORN)
+    {
+      vInputWait(DEBOUNCE_HORN_MS);
+    }
+    for(uint32_t u32Input = 0u; u32Input < eINPUT_Count; u32Input++)
+    {
+      if(pu32Symbols[u32Step] < INPUT_SYMBOL_WAITPADDLE)
+      {
+        for(uint32_t u32Slot = 0u; u32Slot < CPS_ACQ_CHANNELS; u32Slot++)
+        {
+          au8Class[u32Slot] = (uint8_t)eCMD_Null;
+        }
+        au8Class[CPS_axInputConfig[u32Input].u8Slot] = (uint8_t)axSymbolClass[pu32Symbols[u32Step]];
+        pu32Transitions[CPS_axInputState[u32Input].u8State]++;
+        xCommand = CPS_xInputStep(u32Input, au8Class);
+        xExpected = xInputModelStep(u32Input, axSymbolClass[pu32Symbols[u32Step]]);
+        if(xCommand != xExpected)
+        {
+          vInputFail(pu32Symbols, u32Step, u32Input, "command");
+        }
+      }
+      if(CPS_axInputState[u32Input].u8State != (uint8_t)axModel[u32Input].xState)
+      {
+        vInputFail(pu32Symbols, u32Step, u32Input, "state");
+      }
+      else if(CPS_axInputState[u32Input].u8Count != axModel[u32Input].u32Count)
+      {
+        vInputFail(pu32Symbols, u32Step, u32Input, "sample count");
+      }
+    }
+  }
+}
+
+/* xHornCommands_t xInputModelStep(uint32_t u32Input, xHornCommands_t xClass)
+*   Reference model of one sample, see the file header.
+*
+*/
+static xHornCommands_t xInputModelStep(uint32_t u32Input, xHornCommands_t xClass)
+{
+  const xCPSInputConfig_t *pxConfig = &CPS_axInputConfig[u32Input];
+  xInputModel_t *pxModel = &axModel[u32Input];
+  bool bInBand = (xClass == pxConfig->xBand);
+  if((pxModel->xState == eSTATE_HoldOff) && !bInputModelHoldOff(u32Input))
+  {
+    pxModel->xState = eSTATE_Idle;
+  }
+  switch(pxModel->xState)
+  {
+  case eSTATE_Idle:
+  case eSTATE_Qualifying:
+    if(!bInBand)
+    {
+      pxModel->xState = eSTATE_Idle;
+      pxModel->u32Count = 0u;
+      return(eCMD_Null);
+    }
+    if((pxModel->u32Count + 1u) >= pxConfig->u8QualifySamples)
+    {
+      pxModel->xState = eSTATE_Active;
+      pxModel->u32Count = 0u;
+      return(pxConfig->xOnCommand);
+    }
+    pxModel->xState = eSTATE_Qualifying;
+    pxModel->u32Count++;
+    return(eCMD_Null);
+  case eSTATE_Active:
+    if(bInBand)
+    {
+      return(eCMD_Null);
+    }
+    pxModel->xState = eSTATE_HoldOff;
+    pxModel->u32HoldOffEnd = u32Ticks + ((pxConfig->u16HoldOffMs + CPS_TIMER_TICK_MS - 1u)/CPS_TIMER_TICK_MS);
+    return(pxConfig->xOffCommand);
+  default:
+    return(eCMD_Null); //Hold-off running
+  }
+}
+
+/* bool bInputModelHoldOff(uint32_t u32Input)
+*   Hold-off of the model still running, the firmware timer fires on the tick it rounds up to.
+*
+*/
+static bool bInputModelHoldOff(uint32_t u32Input)
+{
+  return(u32Ticks < axModel[u32Input].u32HoldOffEnd);
+}
+
+/* void vInputWait(uint32_t u32Ms)
+*   Ticks the wheel for u32Ms without any sample.
+*
+*/
+static void vInputWait(uint32_t u32Ms)
+{
+  for(uint32_t u32Tick = 0u; u32Tick < (u32Ms/CPS_TIMER_TICK_MS); u32Tick++)
+  {
+    u32Ticks++;
+    CPS_vTimerTick();
+  }
+}
+
+/* void vInputFail(const uint32_t *pu32Symbols, uint32_t u32Step, uint32_t u32Input, const char *pcWhat)
+*   Reports a mismatch with the sequence that led to it.
+*
+*/
+static void vInputFail(const uint32_t *pu32Symbols, uint32_t u32Step, uint32_t u32Input, const char *pcWhat)
+{
+  if(u32Failures < INPUT_REPORT_MAX)
+  {
+    printf("  input %u, %s differs after step %u of:", u32Input, pcWhat, u32Step);
+    for(uint32_t u32Symbol = 0u; u32Symbol <= u32Step; u32Symbol++)
+    {
+      printf(" %s", apcSymbolName[pu32Symbols[u32Symbol]]);
+    }
+    printf("\n");
+  }
+  u32Failures++;
+}
@@ -0,0 +1,411 @@
+/** @file HOST_latency.c
+*   @brief Press to output latency of the CPS over simulated drive time
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Runs the unchanged CPS firmware on the host simulation and drives the horn wire the way a driver would: idle for
+*   0.3 to 5 s, then a horn press of 0.1 to 2 s or a paddle press of 20 to 400 ms, with a few codes of noise on every
+*   conversion. For each press the time from the voltage step to the matching output pin rising is taken from the
+*   virtual clock, and for the horn also the time from the release to the horn pin dropping. The distribution is
+*   printed at the end together with the firmware's own CPS_xLatencyStats. Every shift pulse has to last
+*   CPS_FRAME_PULSE_MS however long the paddle was held, the shortest presses end well before the pulse would.
+*   The background self tests, PBIST groups included, have to keep up their coverage throughout.
+*
+*   The firmware can only see a step from the first conversion after it, which while acquisition watches the idle
+*   line is up to CPS_ACQ_WATCH_US later. The time from that conversion to the output is taken as well, and the
+*   firmware's histogram has to hold the same steps with a mean and maximum within LATENCY_AGREE_US of it.
+*
+*   Usage: HOST_latency [minutes of drive time, default 60] [seed]
+*   Exits with a failure when a press did not produce its output, an output moved that no press asked for, the
+*   worst latency is above LATENCY_LIMIT_US, a shift pulse was not CPS_FRAME_PULSE_MS long, a self test round was
+*   overdue or failed, or the firmware's own measurement does not agree.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "HOST_sim.h"
+#include "CPS_boot.h"
+#include "CPS_frame.h"
+#include "CPS_latency.h"
+#include "CPS_main.h"
+#include "CPS_selftest.h"
+#include "spi.h"
+
+/* Defines */
+#define LATENCY_CHANNEL 17u //Horn wire, CPS_axAcqChannels
+#define LATENCY_LEVEL_IDLE 0x0E00u
+#define LATENCY_LEVEL_UP 0x09B3u //Band centres
+#define LATENCY_LEVEL_DOWN 0x04CBu
+#define LATENCY_LEVEL_HORN 0x0128u
+#define LATENCY_NOISE 8u //Peak noise in codes
+#define LATENCY_WARMUP_MS 4000u //Start up time and then some, presses start after it
+#define LATENCY_LIMIT_US 10000u
+#define LATENCY_AGREE_US 25u //Firmware stamps at the ISR, the simulation at the end of the conversion
+#define LATENCY_BIN_US 250u
+#define LATENCY_BINS 40u //Last bin also collects everything above
+#define LATENCY_PRESSES_MAX 100000u
+#define LATENCY_PULSE_SLACK_US 1000u //Shift pulse width either side of CPS_FRAME_PULSE_MS, the hold timer's resolution
+
+/* Internal Types */
+typedef enum
+{
+  eLAT_Horn,
+  eLAT_ShiftUp,
+  eLAT_ShiftDown,
+  eLAT_KindCount
+} xLatencyKind_t;
+
+typedef struct
+{
+  uint32_t au32Cycles[LATENCY_PRESSES_MAX];
+  uint32_t u32Count;
+} xLatencySet_t;
+
+/* Internal Vars */
+static const uint16_t au16KindLevel[eLAT_KindCount] = {LATENCY_LEVEL_HORN, LATENCY_LEVEL_UP, LATENCY_LEVEL_DOWN};
+static const xHostPort_t axKindPort[eLAT_KindCount] = {eHOST_PortSpi3, eHOST_PortSpi2, eHOST_PortSpi2};
+static const uint32_t au32KindPin[eLAT_KindCount] = {SPI_PIN_SOMI, SPI_PIN_SIMO, SPI_PIN_CLK};
+
+static uint32_t u32Random = 0x2545F491u;
+static uint16_t u16Level = LATENCY_LEVEL_IDLE;
+static bool bMeasuring; //Presses have started, every output change is accounted for
+static bool bPressPending; //Waiting for the output of xPressKind to rise
+static bool bReleasePending; //Waiting for the horn output to drop
+static bool bSeenPending; //Waiting for the first conversion after the last step
+static xLatencyKind_t xPressKind;
+static uint64_t u64StepCycles;
+static uint64_t u64SeenCycles; //End of the first conversion after the last step
+static uint32_t u32Presses;
+static uint32_t u32Missed;
+static uint32_t u32Spurious;
+static uint64_t au64RoseCycles[eLAT_KindCount]; //Last rising edge of each output
+static uint32_t u32Pulses; //Shift pulses
+static uint32_t u32BadPulses; //Of those, not CPS_FRAME_PULSE_MS long
+static uint64_t u64PulseMinCycles = HOST_SIM_NEVER;
+static uint64_t u64PulseMaxCycles;
+static xLatencySet_t xPress;
+static xLatencySet_t xRelease;
+static xLatencySet_t xSeen; //First conversion to output, presses and releases
+
+/* Local Function Prototypes */
+static uint32_t u32LatencyRandom(uint32_t u32Min, uint32_t u32Max);
+static uint16_t u16LatencyInput(uint32_t u32Channel, uint64_t u64Cycles);
+static void vLatencyPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles);
+static void vLatencyPulse(uint64_t u64Cycles);
+static void vLatencyFirmware(void);
+static void vLatencyRecord(xLatencySet_t *pxSet, uint64_t u64Cycles);
+static int iLatencyCompare(const void *pvA, const void *pvB);
+static uint32_t u32LatencyReport(const char *pcName, xLatencySet_t *pxSet);
+
+/* Global Functions */
+int main(int argc, char **argv)
+{
+  xHostSimConfig_t xConfig = {u16LatencyInput, vLatencyPin, 0, 0, HOST_SIM_ADC_GAIN_UNITY};
+  uint64_t u64DriveMinutes = (argc > 1) ? strtoull(argv[1], 0, 0) : 60u;
+  uint64_t u64End;
+  uint64_t u64Now;
+  uint32_t u32WorstUs;
+  uint32_t u32WorstReleaseUs;
+  uint32_t u32SeenMaxUs;
+  uint32_t u32SeenMeanUs;
+  uint32_t u32FirmwareMeanUs;
+  uint64_t u64SeenTotal = 0u;
+  bool bAgree;
+  bool bSelfTest;
+  struct timespec xStart;
+  struct timespec xStop;
+  double dHostSeconds;
+  double dSimSeconds;
+  if(argc > 2)
+  {
+    u32Random = ((uint32_t)strtoul(argv[2], 0, 0)*0x9E3779B9u) ^ 0x2545F491u; //Spread the seed over the state
+  }
+  (void)clock_gettime(CLOCK_MONOTONIC, &xStart);
+  HOST_vSimInit(&xConfig);
+  HOST_vSimStart(vLatencyFirmware);
+  HOST_vSimRun((uint64_t)LATENCY_WARMUP_MS*HOST_SIM_CYCLES_PER_MS);
+  bMeasuring = true;
+  u64End = HOST_u64SimCycles() + (u64DriveMinutes*60000u*HOST_SIM_CYCLES_PER_MS);
+  while(HOST_u64SimCycles() < u64End)
+  {
+    u64Now = HOST_u64SimCycles();
+    HOST_vSimRun(u64Now + ((uint64_t)u32LatencyRandom(300u, 5000u)*HOST_SIM_CYCLES_PER_MS));
+    if(bPressPending)
+    {
+      u32Missed++;
+      bPressPending = false;
+    }
+    xPressKind = (xLatencyKind_t)u32LatencyRandom(0u, (uint32_t)eLAT_KindCount - 1u);
+    u16Level = au16KindLevel[xPressKind];
+    u64StepCycles = HOST_u64SimCycles();
+    bPressPending = true;
+    bSeenPending = true;
+    u32Presses++;
+    if(xPressKind == eLAT_Horn)
+    {
+      HOST_vSimRun(u64StepCycles + ((uint64_t)u32LatencyRandom(100u, 2000u)*HOST_SIM_CYCLES_PER_MS));
+    }
+    else
+    {
+      HOST_vSimRun(u64StepCycles + ((uint64_t)u32LatencyRandom(20u, 400u)*HOST_SIM_CYCLES_PER_MS));
+    }
+    u16Level = LATENCY_LEVEL_IDLE;
+    bSeenPending = true;
+    if(bPressPending)
+    {
+      u32Missed++;
+      bPressPending = false;
+    }
+    else if(xPressKind == eLAT_Horn)
+    {
+      u64StepCycles = HOST_u64SimCycles();
+      bReleasePending = true;
+    }
+  }
+  HOST_vSimRun(HOST_u64SimCycles() + (500u*HOST_SIM_CYCLES_PER_MS)); //Let the last release through
+  u32Missed += bReleasePending ? 1u : 0u;
+  (void)clock_gettime(CLOCK_MONOTONIC, &xStop);
+  dHostSeconds = (double)(xStop.tv_sec - xStart.tv_sec) + ((double)(xStop.tv_nsec - xStart.tv_nsec)/1e9);
+  dSimSeconds = (double)HOST_u64SimCycles()/(double)(HOST_SIM_CYCLES_PER_MS*1000u);
+
+  printf("CPS press to output latency, %llu min of drive time\n", (unsigned long long)u64DriveMinutes);
+  printf("  %.1f s simulated in %.2f s of host time (%.0fx real time)\n", dSimSeconds, dHostSeconds,
+         dSimSeconds/dHostSeconds);
+  printf("  %u presses, %u missed, %u outputs nobody asked for\n", u32Presses, u32Missed, u32Spurious);
+  printf("  %u shift pulses, %u not %u ms long, %.3f to %.3f ms\n", u32Pulses, u32BadPulses, CPS_FRAME_PULSE_MS,
+         (double)((u32Pulses != 0u) ? u64PulseMinCycles : 0u)/(double)HOST_SIM_CYCLES_PER_MS,
+         (double)u64PulseMaxCycles/(double)HOST_SIM_CYCLES_PER_MS);
+  u32WorstUs = u32LatencyReport("step to output", &xPress);
+  u32WorstReleaseUs = u32LatencyReport("horn release to horn off", &xRelease);
+  u32SeenMaxUs = u32LatencyReport("first conversion after the step to output", &xSeen);
+  for(uint32_t u32Sample = 0u; u32Sample < xSeen.u32Count; u32Sample++)
+  {
+    u64SeenTotal += xSeen.au32Cycles[u32Sample];
+  }
+  u32SeenMeanUs = (xSeen.u32Count != 0u) ? (uint32_t)((u64SeenTotal/xSeen.u32Count)/HOST_SIM_CYCLES_PER_US) : 0u;
+  u32FirmwareMeanUs = (CPS_xLatencyStats.u32Count != 0u) ?
+                      (CPS_xLatencyStats.u32TotalUs/CPS_xLatencyStats.u32Count) : 0u;
+  printf("  firmware CPS_xLatencyStats: %u measured, %u dropped, min %u us, mean %u us, max %u us\n",
+         CPS_xLatencyStats.u32Count, CPS_xLatencyStats.u32Dropped,
+         (CPS_xLatencyStats.u32Count != 0u) ? CPS_xLatencyStats.u32MinUs : 0u, u32FirmwareMeanUs,
+         CPS_xLatencyStats.u32MaxUs);
+  bAgree = (CPS_xLatencyStats.u32Count == xSeen.u32Count) &&
+           ((u32FirmwareMeanUs + LATENCY_AGREE_US) >= u32SeenMeanUs) &&
+           (u32FirmwareMeanUs <= (u32SeenMeanUs + LATENCY_AGREE_US)) &&
+           ((CPS_xLatencyStats.u32MaxUs + LATENCY_AGREE_US) >= u32SeenMaxUs) &&
+           (CPS_xLatencyStats.u32MaxUs <= (u32SeenMaxUs + LATENCY_AGREE_US));
+  printf("  firmware and simulation agree on %u steps within %u us: %s\n", xSeen.u32Count, LATENCY_AGREE_US,
+         bAgree ? "yes" : "NO");
+  printf("  %llu ISRs (%.2f%% of the CPU), %.2f%% idle, %llu ADC conversions, %llu register accesses\n",
+         (unsigned long long)HOST_xSimStats.u64Irqs,
+         (100.0*(double)HOST_xSimStats.u64IrqCycles)/(double)HOST_u64SimCycles(),
+         (100.0*(double)HOST_xSimStats.u64IdleCycles)/(double)HOST_u64SimCycles(),
+         (unsigned long long)HOST_xSimStats.u64AdcConversions, (unsigned long long)HOST_xSimStats.u64PeriphAccesses);
+  bSelfTest = (CPS_xSelfTest.u32Rounds != 0u) && (CPS_xSelfTest.u32Overdue == 0u) &&
+              (CPS_xSelfTest.u32Failures == 0u) && CPS_xSelfTest.bCovered;
+  printf("  self tests: %u rounds, %u overdue, %u failures, round at most %u us, PBIST groups at most",
+         CPS_xSelfTest.u32Rounds, CPS_xSelfTest.u32Overdue, CPS_xSelfTest.u32Failures, CPS_xSelfTest.u32MaxRoundUs);
+  for(uint32_t u32Group = 0u; u32Group < CPS_SELFTEST_PBIST_COUNT; u32Group++)
+  {
+    printf("%s %u us", (u32Group == 0u) ? "" : ",", CPS_xSelfTest.au32PbistUs[u32Group]);
+  }
+  printf("\n");
+  if((u32Missed != 0u) || (u32Spurious != 0u) || (xPress.u32Count == 0u) || (u32WorstUs > LATENCY_LIMIT_US) ||
+     (u32WorstReleaseUs > LATENCY_LIMIT_US) || (u32Pulses == 0u) || (u32BadPulses != 0u) || !bSelfTest || !bAgree)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* uint32_t u32LatencyRandom(uint32_t u32Min, uint32_t u32Max)
+*   Uniform in u32Min..u32Max from a xorshift generator, so every run with the same seed is the same drive.
+*
+*/
+static uint32_t u32LatencyRandom(uint32_t u32Min, uint32_t u32Max)
+{
+  u32Random ^= u32Random << 13;
+  u32Random ^= u32Random >> 17;
+  u32Random ^= u32Random << 5;
+  return(u32Min + (u32Random % (u32Max - u32Min + 1u)));
+}
+
+/* uint16_t u16LatencyInput(uint32_t u32Channel, uint64_t u64Cycles)
+*   Horn wire level plus noise, notes the end of the first conversion after a step. Inputs without a ladder read idle.
+*
+*/
+static uint16_t u16LatencyInput(uint32_t u32Channel, uint64_t u64Cycles)
+{
+  if(u32Channel != LATENCY_CHANNEL)
+  {
+    return(LATENCY_LEVEL_IDLE);
+  }
+  if(bSeenPending)
+  {
+    bSeenPending = false;
+    u64SeenCycles = u64Cycles;
+  }
+  return((uint16_t)((u16Level + u32LatencyRandom(0u, 2u*LATENCY_NOISE)) - LATENCY_NOISE));
+}
+
+/* void vLatencyPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+*   Output latch change: closes the pending press or release and times the shift pulses, anything else on an output
+*   pin is spurious.
+*
+*/
+static void vLatencyPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+{
+  uint32_t u32Mask;
+  uint32_t u32Rose;
+  uint32_t u32Fell;
+  if(!bMeasuring)
+  {
+    return;
+  }
+  for(uint32_t u32Kind = 0u; u32Kind < (uint32_t)eLAT_KindCount; u32Kind++)
+  {
+    if(axKindPort[u32Kind] != xPort)
+    {
+      continue;
+    }
+    u32Mask = 1u << au32KindPin[u32Kind];
+    u32Rose = u32New & ~u32Old & u32Mask;
+    u32Fell = u32Old & ~u32New & u32Mask;
+    if(u32Rose != 0u)
+    {
+      au64RoseCycles[u32Kind] = u64Cycles;
+      if(bPressPending && (u32Kind == (uint32_t)xPressKind))
+      {
+        bPressPending = false;
+        vLatencyRecord(&xPress, u64Cycles - u64StepCycles);
+        vLatencyRecord(&xSeen, u64Cycles - u64SeenCycles);
+      }
+      else
+      {
+        u32Spurious++;
+      }
+    }
+    if((u32Fell != 0u) && (u32Kind == (uint32_t)eLAT_Horn))
+    {
+      if(bReleasePending)
+      {
+        bReleasePending = false;
+        vLatencyRecord(&xRelease, u64Cycles - u64StepCycles);
+        vLatencyRecord(&xSeen, u64Cycles - u64SeenCycles);
+      }
+      else if(!bPressPending && (xPressKind == eLAT_Horn))
+      {
+        u32Spurious++; //Horn dropped while still pressed
+      }
+    }
+    if((u32Fell != 0u) && (u32Kind != (uint32_t)eLAT_Horn))
+    {
+      vLatencyPulse(u64Cycles - au64RoseCycles[u32Kind]);
+    }
+  }
+}
+
+/* void vLatencyPulse(uint64_t u64Cycles)
+*   Width of one shift pulse, anything more than LATENCY_PULSE_SLACK_US off CPS_FRAME_PULSE_MS is counted bad.
+*
+*/
+static void vLatencyPulse(uint64_t u64Cycles)
+{
+  const uint64_t u64Nominal = (uint64_t)CPS_FRAME_PULSE_MS*HOST_SIM_CYCLES_PER_MS;
+  const uint64_t u64Slack = (uint64_t)LATENCY_PULSE_SLACK_US*HOST_SIM_CYCLES_PER_US;
+  u32Pulses++;
+  u64PulseMinCycles = (u64Cycles < u64PulseMinCycles) ? u64Cycles : u64PulseMinCycles;
+  u64PulseMaxCycles = (u64Cycles > u64PulseMaxCycles) ? u64Cycles : u64PulseMaxCycles;
+  if(((u64Cycles + u64Slack) < u64Nominal) || (u64Cycles > (u64Nominal + u64Slack)))
+  {
+    u32BadPulses++;
+  }
+}
+
+/* void vLatencyFirmware(void)
+*   Firmware entry, what _c_int00 does before main on the target.
+*
+*/
+static void vLatencyFirmware(void)
+{
+  CPS_vBootStart();
+  CPS_vMain();
+}
+
+/* void vLatencyRecord(xLatencySet_t *pxSet, uint64_t u64Cycles)
+*   Keeps one latency, the set stops growing at LATENCY_PRESSES_MAX.
+*
+*/
+static void vLatencyRecord(xLatencySet_t *pxSet, uint64_t u64Cycles)
+{
+  if(pxSet->u32Count < LATENCY_PRESSES_MAX)
+  {
+    pxSet->au32Cycles[pxSet->u32Count] = (uint32_t)u64Cycles;
+    pxSet->u32Count++;
+  }
+}
+
+/* int iLatencyCompare(const void *pvA, const void *pvB)
+*   qsort order, ascending.
+*
+*/
+static int iLatencyCompare(const void *pvA, const void *pvB)
+{
+  uint32_t u32A = *(const uint32_t *)pvA;
+  uint32_t u32B = *(const uint32_t *)pvB;
+  return((u32A > u32B) - (u32A < u32B));
+}
+
+/* uint32_t u32LatencyReport(const char *pcName, xLatencySet_t *pxSet)
+*   Prints min, mean, percentiles, max and a histogram. Returns the maximum in microseconds.
+*
+*/
+static uint32_t u32LatencyReport(const char *pcName, xLatencySet_t *pxSet)
+{
+  static const uint32_t au32Permille[] = {500u, 900u, 990u, 999u};
+  uint32_t au32Bins[LATENCY_BINS] = {0u};
+  uint64_t u64Total = 0u;
+  uint32_t u32Count = pxSet->u32Count;
+  uint32_t u32Bin;
+  uint32_t u32Last = 0u;
+  if(u32Count == 0u)
+  {
+    printf("  %s: no samples\n", pcName);
+    return(0u);
+  }
+  qsort(pxSet->au32Cycles, u32Count, sizeof(pxSet->au32Cycles[0]), iLatencyCompare);
+  for(uint32_t u32Sample = 0u; u32Sample < u32Count; u32Sample++)
+  {
+    u64Total += pxSet->au32Cycles[u32Sample];
+    u32Bin = (pxSet->au32Cycles[u32Sample]/HOST_SIM_CYCLES_PER_US)/LATENCY_BIN_US;
+    u32Bin = (u32Bin >= LATENCY_BINS) ? (LATENCY_BINS - 1u) : u32Bin;
+    au32Bins[u32Bin]++;
+    u32Last = (u32Bin > u32Last) ? u32Bin : u32Last;
+  }
+  printf("  %s, %u samples (us): min %.1f mean %.1f", pcName, u32Count,
+         (double)pxSet->au32Cycles[0]/HOST_SIM_CYCLES_PER_US,
+         ((double)u64Total/u32Count)/HOST_SIM_CYCLES_PER_US);
+  for(uint32_t u32Point = 0u; u32Point < (sizeof(au32Permille)/sizeof(au32Permille[0])); u32Point++)
+  {
+    printf(" p%.1f %.1f", (double)au32Permille[u32Point]/10.0,
+           (double)pxSet->au32Cycles[((uint64_t)(u32Count - 1u)*au32Permille[u32Point])/1000u]/HOST_SIM_CYCLES_PER_US);
+  }
+  printf(" max %.1f\n", (double)pxSet->au32Cycles[u32Count - 1u]/HOST_SIM_CYCLES_PER_US);
+  for(u32Bin = 0u; u32Bin <= u32Last; u32Bin++)
+  {
+    if(au32Bins[u32Bin] != 0u)
+    {
+      printf("    %5u..%5u us %6u\n", u32Bin*LATENCY_BIN_US, ((u32Bin + 1u)*LATENCY_BIN_US) - 1u, au32Bins[u32Bin]);
+    }
+  }
+  return(pxSet->au32Cycles[u32Count - 1u]/HOST_SIM_CYCLES_PER_US);
+}
@@ -0,0 +1,617 @@
+/** @file HOST_link.c
+*   @brief End to end simulation of the CPS and the SCT connected by a virtual UART
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Runs the unchanged CPS firmware here and the unchanged SCT firmware in HOST_sct, the SCI of one wired to the SCI
+*   of the other as described in HOST_link.h. The horn wire is driven as in HOST_latency: idle for 0.3 to 5 s, then a
+*   horn press of 0.1 to 2 s or a paddle press of 50 to 400 ms, with noise on every conversion. For each press it
+*   takes from the virtual clocks
+*
+*   - the command to actuation latency, from the voltage step to the SCT actuator pin rising
+*   - the link share of it, from the CPS output pin to the SCT actuator pin
+*   - for the horn, the release to the SCT horn pin dropping
+*   - the width of every SCT shift pulse, which the SCT times alone and ends with its pulse timer
+*
+*   Then the SCT fail-safe is checked with faults on the CPS to SCT direction:
+*
+*   - link cut with the horn held: the SCT drops the horn within CPS_FRAME_TIMEOUT_MS and the keepalive puts it back
+*     once the link returns
+*   - the horn off frame lost: the next keepalive shows the SEQ gap and the SCT drops the horn
+*   - the paddle release lost: the SCT ends the shift pulse after CPS_FRAME_PULSE_MS all the same
+*
+*   Usage: HOST_link <path of HOST_sct> [minutes of drive time, default 2] [seed]
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "HOST_link.h"
+#include "CPS_boot.h"
+#include "CPS_frame.h"
+#include "CPS_main.h"
+#include "spi.h"
+
+/* Defines */
+#define LINK_CHANNEL 17u //Horn wire, CPS_axAcqChannels
+#define LINK_LEVEL_IDLE 0x0E00u
+#define LINK_LEVEL_UP 0x09B3u //Band centres
+#define LINK_LEVEL_DOWN 0x04CBu
+#define LINK_LEVEL_HORN 0x0128u
+#define LINK_NOISE 8u //Peak noise in codes
+#define LINK_WARMUP_MS 4000u //Start up time and then some, presses start after it
+#define LINK_LIMIT_US 12000u //HOST_latency's limit and a frame on the line
+#define LINK_SLACK_MS 2u //SCT tick and a frame time on top of the fail-safe times
+#define LINK_CUT_MS 300u //Link cut with the horn held
+#define LINK_LOSS_MS 15u //Characters dropped after a horn release, the horn off frame goes out inside it
+#define LINK_PRESSES_MAX 100000u
+#define LINK_SCT_HORN (1u << 4u) //SCT actuator pins on GIOA
+#define LINK_SCT_SHIFTUP (1u << 6u)
+#define LINK_SCT_SHIFTDOWN (1u << 7u)
+#define LINK_MS(u64Cycles) ((double)(u64Cycles)/(double)HOST_SIM_CYCLES_PER_MS)
+
+/* Internal Types */
+typedef enum
+{
+  eKIND_Horn,
+  eKIND_ShiftUp,
+  eKIND_ShiftDown,
+  eKIND_Count
+} xLinkKind_t;
+
+typedef struct
+{
+  uint32_t au32Cycles[LINK_PRESSES_MAX];
+  uint32_t u32Count;
+} xLinkSet_t;
+
+/* Internal Vars */
+static const uint16_t au16KindLevel[eKIND_Count] = {LINK_LEVEL_HORN, LINK_LEVEL_UP, LINK_LEVEL_DOWN};
+static const xHostPort_t axKindPort[eKIND_Count] = {eHOST_PortSpi3, eHOST_PortSpi2, eHOST_PortSpi2};
+static const uint32_t au32KindPin[eKIND_Count] = {SPI_PIN_SOMI, SPI_PIN_SIMO, SPI_PIN_CLK};
+static const uint32_t au32KindSct[eKIND_Count] = {LINK_SCT_HORN, LINK_SCT_SHIFTUP, LINK_SCT_SHIFTDOWN};
+
+static int iToSct; //Pipe ends to and from HOST_sct
+static int iFromSct;
+static xHostLinkByte_t axCpsTx[HOST_LINK_BYTES_MAX]; //CPS characters of the current slice
+static uint32_t u32CpsTx;
+static uint64_t u64DropStart; //CPS characters ending in u64DropStart..u64DropEnd - 1 never reach the SCT
+static uint64_t u64DropEnd;
+static uint32_t u32Dropped;
+
+static uint32_t u32Random = 0x2545F491u;
+static uint16_t u16Level = LINK_LEVEL_IDLE;
+static bool bMeasuring; //Presses are running, every SCT output change is accounted for
+static bool bSctPending; //Waiting for the SCT output of xPressKind to rise
+static bool bCpsRose; //The CPS output of the pending press rose at u64CpsRise
+static bool bReleasePending; //Waiting for the SCT horn to drop
+static xLinkKind_t xPressKind;
+static uint64_t u64StepCycles;
+static uint64_t u64CpsRise;
+static uint64_t au64SctRise[eKIND_Count]; //Last edges of the SCT outputs
+static uint64_t au64SctFall[eKIND_Count];
+static uint32_t u32SctOutputs; //SCT GIOA latch
+static uint32_t u32Presses;
+static uint32_t u32Missed;
+static uint32_t u32Spurious;
+static uint32_t u32Pulses;
+static uint32_t u32BadPulses; //SCT shift pulses outside CPS_FRAME_PULSE_MS - 1 ms .. + LINK_SLACK_MS
+static uint32_t u32Failures;
+static xLinkSet_t xStep;
+static xLinkSet_t xWire;
+static xLinkSet_t xRelease;
+
+/* Local Function Prototypes */
+static void vLinkStart(const char *pcSct);
+static void vLinkRun(uint64_t u64Until);
+static void vLinkDrive(uint64_t u64Minutes);
+static void vLinkFaults(void);
+static void vLinkStats(xHostLinkStats_t *pxStats);
+static void vLinkCpsTx(uint8_t u8Byte, uint64_t u64Cycles);
+static void vLinkCpsPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles);
+static void vLinkSctPin(uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles);
+static uint16_t u16LinkInput(uint32_t u32Channel, uint64_t u64Cycles);
+static void vLinkFirmware(void);
+static uint32_t u32LinkRandom(uint32_t u32Min, uint32_t u32Max);
+static void vLinkRecord(xLinkSet_t *pxSet, uint64_t u64Cycles);
+static int iLinkCompare(const void *pvA, const void *pvB);
+static uint32_t u32LinkReport(const char *pcName, xLinkSet_t *pxSet);
+static void vLinkRead(void *pvData, size_t xLength);
+static void vLinkWrite(const void *pvData, size_t xLength);
+static void vLinkCheck(bool bPass, const char *pcWhat);
+
+/* Global Functions */
+int main(int argc, char **argv)
+{
+  xHostSimConfig_t xConfig = {u16LinkInput, vLinkCpsPin, vLinkCpsTx, 0, HOST_SIM_ADC_GAIN_UNITY};
+  xHostLinkStats_t xStats;
+  uint64_t u64DriveMinutes = (argc > 2) ? strtoull(argv[2], 0, 0) : 2u;
+  uint32_t u32WorstUs;
+  uint32_t u32WorstReleaseUs;
+  char acWhat[96];
+  int iStatus;
+  if(argc < 2)
+  {
+    fprintf(stderr, "usage: HOST_link <path of HOST_sct> [minutes] [seed]\n");
+    return(EXIT_FAILURE);
+  }
+  if(argc > 3)
+  {
+    u32Random = ((uint32_t)strtoul(argv[3], 0, 0)*0x9E3779B9u) ^ 0x2545F491u; //Spread the seed over the state
+  }
+  vLinkStart(argv[1]);
+  HOST_vSimInit(&xConfig);
+  HOST_vSimStart(vLinkFirmware);
+  vLinkRun((uint64_t)LINK_WARMUP_MS*HOST_SIM_CYCLES_PER_MS);
+
+  printf("CPS and SCT over the virtual UART, %llu min of drive time\n", (unsigned long long)u64DriveMinutes);
+  vLinkDrive(u64DriveMinutes);
+  printf("  %u presses, %u missed, %u SCT outputs nobody asked for, %u shift pulses\n", u32Presses, u32Missed,
+         u32Spurious, u32Pulses);
+  u32WorstUs = u32LinkReport("step to SCT actuator", &xStep);
+  (void)u32LinkReport("CPS output to SCT actuator", &xWire);
+  u32WorstReleaseUs = u32LinkReport("horn release to SCT horn off", &xRelease);
+  vLinkStats(&xStats);
+  printf("  SCT: %u frames, %u commands, %u CRC errors, %u SEQ gaps, dispatch at most %u cycles, interrupts %.2f%% of "
+         "the CPU\n", xStats.u32Frames, xStats.u32Commands, xStats.u32CrcErrors, xStats.u32SeqGaps,
+         xStats.u32MaxDispatchCycles, (100.0*(double)xStats.u64IrqCycles)/(double)xStats.u64Cycles);
+  printf("  CPS: %u acks, round trip min %u us, mean %u us, max %u us (acks reach the CPS %u us late here)\n",
+         CPS_u32LinkAcks, CPS_xLinkRoundTrip.u32MinCycles,
+         (CPS_xLinkRoundTrip.u32Count != 0u) ?
+         (uint32_t)(CPS_xLinkRoundTrip.u64TotalCycles/CPS_xLinkRoundTrip.u32Count) : 0u,
+         CPS_xLinkRoundTrip.u32MaxCycles, HOST_LINK_SLICE_CYCLES/HOST_SIM_CYCLES_PER_US);
+  vLinkCheck((u32Missed == 0u) && (u32Spurious == 0u) && (xStep.u32Count != 0u), "every press actuated, nothing else");
+  (void)snprintf(acWhat, sizeof(acWhat), "command to actuation and release under %u us", LINK_LIMIT_US);
+  vLinkCheck((u32WorstUs <= LINK_LIMIT_US) && (u32WorstReleaseUs <= LINK_LIMIT_US), acWhat);
+  vLinkCheck((xStats.u32CrcErrors == 0u) && (xStats.u32SeqGaps == 0u) && (xStats.u32GapDrops == 0u) &&
+             (xStats.u32Timeouts == 0u), "clean link, no fail-safe action");
+  (void)snprintf(acWhat, sizeof(acWhat), "%u of %u SCT shift pulses ended by the SCT pulse timer", xStats.u32PulseEnds,
+                 u32Pulses);
+  vLinkCheck(xStats.u32PulseEnds == u32Pulses, acWhat);
+  vLinkFaults();
+  (void)snprintf(acWhat, sizeof(acWhat), "%u SCT shift pulses of %u ms, %u outside", u32Pulses, CPS_FRAME_PULSE_MS,
+                 u32BadPulses);
+  vLinkCheck((u32Pulses != 0u) && (u32BadPulses == 0u), acWhat);
+
+  (void)close(iToSct); //HOST_sct ends on the closed pipe
+  (void)close(iFromSct);
+  if((wait(&iStatus) < 0) || !WIFEXITED(iStatus) || (WEXITSTATUS(iStatus) != EXIT_SUCCESS))
+  {
+    vLinkCheck(false, "HOST_sct ended cleanly");
+  }
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* void vLinkStart(const char *pcSct)
+*   Starts HOST_sct with a pipe on its stdin and one on its stdout.
+*
+*/
+static void vLinkStart(const char *pcSct)
+{
+  int aiToSct[2];
+  int aiFromSct[2];
+  pid_t xPid;
+  if((pipe(aiToSct) != 0) || (pipe(aiFromSct) != 0))
+  {
+    HOST_vSimFault("no pipes for HOST_sct");
+  }
+  (void)signal(SIGPIPE, SIG_IGN); //A dead HOST_sct shows as a failed write
+  fflush(stdout);
+  xPid = fork();
+  if(xPid < 0)
+  {
+    HOST_vSimFault("cannot start HOST_sct");
+  }
+  if(xPid == 0)
+  {
+    (void)dup2(aiToSct[0], STDIN_FILENO);
+    (void)dup2(aiFromSct[1], STDOUT_FILENO);
+    (void)close(aiToSct[0]);
+    (void)close(aiToSct[1]);
+    (void)close(aiFromSct[0]);
+    (void)close(aiFromSct[1]);
+    (void)execl(pcSct, pcSct, (char *)0);
+    perror(pcSct);
+    _exit(EXIT_FAILURE);
+  }
+  (void)close(aiToSct[0]);
+  (void)close(aiFromSct[1]);
+  iToSct = aiToSct[1];
+  iFromSct = aiFromSct[0];
+}
+
+/* void vLinkRun(uint64_t u64Until)
+*   Runs both processors to u64Until, a slice at a time. See HOST_link.h.
+*
+*/
+static void vLinkRun(uint64_t u64Until)
+{
+  xHostLinkRequest_t xRequest;
+  xHostLinkReply_t xReply;
+  xHostLinkByte_t xByte;
+  xHostLinkPin_t xPin;
+  uint64_t u64Slice;
+  while(HOST_u64SimCycles() < u64Until)
+  {
+    u64Slice = HOST_u64SimCycles() + HOST_LINK_SLICE_CYCLES;
+    u64Slice = (u64Slice < u64Until) ? u64Slice : u64Until;
+    u32CpsTx = 0u;
+    HOST_vSimRun(u64Slice);
+    xRequest.u32Command = (uint32_t)eHOSTLINK_Run;
+    xRequest.u32Bytes = u32CpsTx;
+    xRequest.u64Until = u64Slice;
+    vLinkWrite(&xRequest, sizeof(xRequest));
+    vLinkWrite(axCpsTx, u32CpsTx*sizeof(axCpsTx[0]));
+    vLinkRead(&xReply, sizeof(xReply));
+    for(uint32_t u32Byte = 0u; u32Byte < xReply.u32Bytes; u32Byte++)
+    {
+      vLinkRead(&xByte, sizeof(xByte));
+      HOST_vSimSciReceive((uint8_t)xByte.u32Byte, xByte.u64At + HOST_LINK_SLICE_CYCLES); //Keeps the spacing
+    }
+    for(uint32_t u32Pin = 0u; u32Pin < xReply.u32Pins; u32Pin++)
+    {
+      vLinkRead(&xPin, sizeof(xPin));
+      vLinkSctPin(xPin.u32Old, xPin.u32New, xPin.u64At);
+    }
+  }
+}
+
+/* void vLinkDrive(uint64_t u64Minutes)
+*   Random presses for u64Minutes of drive time, every SCT output change accounted for.
+*
+*/
+static void vLinkDrive(uint64_t u64Minutes)
+{
+  uint64_t u64End = HOST_u64SimCycles() + (u64Minutes*60000u*HOST_SIM_CYCLES_PER_MS);
+  bMeasuring = true;
+  while(HOST_u64SimCycles() < u64End)
+  {
+    vLinkRun(HOST_u64SimCycles() + ((uint64_t)u32LinkRandom(300u, 5000u)*HOST_SIM_CYCLES_PER_MS));
+    xPressKind = (xLinkKind_t)u32LinkRandom(0u, (uint32_t)eKIND_Count - 1u);
+    u16Level = au16KindLevel[xPressKind];
+    u64StepCycles = HOST_u64SimCycles();
+    bSctPending = true;
+    bCpsRose = false;
+    u32Presses++;
+    if(xPressKind == eKIND_Horn)
+    {
+      vLinkRun(u64StepCycles + ((uint64_t)u32LinkRandom(100u, 2000u)*HOST_SIM_CYCLES_PER_MS));
+    }
+    else
+    {
+      vLinkRun(u64StepCycles + ((uint64_t)u32LinkRandom(50u, 400u)*HOST_SIM_CYCLES_PER_MS));
+    }
+    u16Level = LINK_LEVEL_IDLE;
+    if(bSctPending)
+    {
+      u32Missed++;
+      bSctPending = false;
+    }
+    else if(xPressKind == eKIND_Horn)
+    {
+      u64StepCycles = HOST_u64SimCycles();
+      bReleasePending = true;
+    }
+  }
+  vLinkRun(HOST_u64SimCycles() + (500u*HOST_SIM_CYCLES_PER_MS)); //Let the last release through
+  u32Missed += bReleasePending ? 1u : 0u;
+  bReleasePending = false;
+  bMeasuring = false;
+}
+
+/* void vLinkFaults(void)
+*   Runs the three fault cases of the file header and checks what the SCT did from its output edges and counts.
+*
+*/
+static void vLinkFaults(void)
+{
+  xHostLinkStats_t xBefore;
+  xHostLinkStats_t xAfter;
+  uint64_t u64Start;
+  uint64_t u64Fall;
+  char acWhat[96];
+
+  u16Level = LINK_LEVEL_HORN; //Link cut with the horn held
+  vLinkRun(HOST_u64SimCycles() + (300u*HOST_SIM_CYCLES_PER_MS));
+  vLinkStats(&xBefore);
+  u64DropStart = HOST_u64SimCycles();
+  u64DropEnd = u64DropStart + ((uint64_t)LINK_CUT_MS*HOST_SIM_CYCLES_PER_MS);
+  vLinkRun(u64DropEnd);
+  vLinkStats(&xAfter);
+  u64Fall = au64SctFall[eKIND_Horn] - u64DropStart;
+  (void)snprintf(acWhat, sizeof(acWhat), "link cut, horn held: SCT horn off after %.1f ms, limit %u ms",
+                 LINK_MS(u64Fall), CPS_FRAME_TIMEOUT_MS + LINK_SLACK_MS);
+  vLinkCheck((au64SctFall[eKIND_Horn] > u64DropStart) && (u64Fall <= ((uint64_t)(CPS_FRAME_TIMEOUT_MS +
+             LINK_SLACK_MS)*HOST_SIM_CYCLES_PER_MS)) && ((xAfter.u32Timeouts - xBefore.u32Timeouts) == 1u), acWhat);
+  vLinkRun(u64DropEnd + ((uint64_t)(CPS_FRAME_KEEPALIVE_MS + LINK_SLACK_MS)*HOST_SIM_CYCLES_PER_MS));
+  (void)snprintf(acWhat, sizeof(acWhat), "link back: SCT horn on again after %.1f ms, limit %u ms",
+                 LINK_MS(au64SctRise[eKIND_Horn] - u64DropEnd), CPS_FRAME_KEEPALIVE_MS + LINK_SLACK_MS);
+  vLinkCheck(((u32SctOutputs & LINK_SCT_HORN) != 0u) && (au64SctRise[eKIND_Horn] >= u64DropEnd), acWhat);
+  u16Level = LINK_LEVEL_IDLE;
+  vLinkRun(HOST_u64SimCycles() + (500u*HOST_SIM_CYCLES_PER_MS));
+
+  u16Level = LINK_LEVEL_HORN; //Horn off frame lost
+  vLinkRun(HOST_u64SimCycles() + (300u*HOST_SIM_CYCLES_PER_MS));
+  vLinkStats(&xBefore);
+  u16Level = LINK_LEVEL_IDLE;
+  u64DropStart = HOST_u64SimCycles();
+  u64DropEnd = u64DropStart + ((uint64_t)LINK_LOSS_MS*HOST_SIM_CYCLES_PER_MS);
+  vLinkRun(HOST_u64SimCycles() + (500u*HOST_SIM_CYCLES_PER_MS));
+  vLinkStats(&xAfter);
+  u64Fall = au64SctFall[eKIND_Horn] - u64DropStart;
+  (void)snprintf(acWhat, sizeof(acWhat), "horn off frame lost: SCT horn off after %.1f ms, limit %u ms",
+                 LINK_MS(u64Fall), LINK_LOSS_MS + CPS_FRAME_KEEPALIVE_MS + LINK_SLACK_MS);
+  vLinkCheck((au64SctFall[eKIND_Horn] > u64DropStart) && (u64Fall <= ((uint64_t)(LINK_LOSS_MS + CPS_FRAME_KEEPALIVE_MS +
+             LINK_SLACK_MS)*HOST_SIM_CYCLES_PER_MS)) && ((xAfter.u32GapDrops - xBefore.u32GapDrops) == 1u), acWhat);
+
+  u16Level = LINK_LEVEL_UP; //Paddle release lost
+  u64Start = HOST_u64SimCycles();
+  while(((u32SctOutputs & LINK_SCT_SHIFTUP) == 0u) && ((HOST_u64SimCycles() - u64Start) < (20u*HOST_SIM_CYCLES_PER_MS)))
+  {
+    vLinkRun(HOST_u64SimCycles() + HOST_LINK_SLICE_CYCLES);
+  }
+  vLinkStats(&xBefore);
+  u64DropStart = HOST_u64SimCycles();
+  u64DropEnd = u64DropStart + (200u*HOST_SIM_CYCLES_PER_MS);
+  vLinkRun(HOST_u64SimCycles() + (100u*HOST_SIM_CYCLES_PER_MS));
+  u16Level = LINK_LEVEL_IDLE;
+  vLinkRun(u64DropEnd + (100u*HOST_SIM_CYCLES_PER_MS));
+  vLinkStats(&xAfter);
+  (void)snprintf(acWhat, sizeof(acWhat), "paddle release lost: SCT shift pulse %.1f ms, ended by the pulse timer",
+                 LINK_MS(au64SctFall[eKIND_ShiftUp] - au64SctRise[eKIND_ShiftUp]));
+  vLinkCheck((au64SctRise[eKIND_ShiftUp] >= u64Start) && (au64SctFall[eKIND_ShiftUp] > au64SctRise[eKIND_ShiftUp]) &&
+             ((xAfter.u32PulseEnds - xBefore.u32PulseEnds) == 1u), acWhat);
+  u64DropStart = 0u;
+  u64DropEnd = 0u;
+  printf("  %u CPS characters dropped by the faults\n", u32Dropped);
+}
+
+/* void vLinkStats(xHostLinkStats_t *pxStats)
+*   Asks HOST_sct for the SCT's counts.
+*
+*/
+static void vLinkStats(xHostLinkStats_t *pxStats)
+{
+  xHostLinkRequest_t xRequest = {(uint32_t)eHOSTLINK_Stats, 0u, 0u};
+  vLinkWrite(&xRequest, sizeof(xRequest));
+  vLinkRead(pxStats, sizeof(*pxStats));
+}
+
+/* void vLinkCpsTx(uint8_t u8Byte, uint64_t u64Cycles)
+*   A character the CPS finished sending, goes to the SCT at the end of the slice unless a fault drops it.
+*
+*/
+static void vLinkCpsTx(uint8_t u8Byte, uint64_t u64Cycles)
+{
+  if((u64Cycles >= u64DropStart) && (u64Cycles < u64DropEnd))
+  {
+    u32Dropped++;
+    return;
+  }
+  if(u32CpsTx >= HOST_LINK_BYTES_MAX)
+  {
+    HOST_vSimFault("more CPS characters in a slice than the line carries");
+  }
+  axCpsTx[u32CpsTx].u64At = u64Cycles;
+  axCpsTx[u32CpsTx].u32Byte = u8Byte;
+  u32CpsTx++;
+}
+
+/* void vLinkCpsPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+*   CPS output latch change: notes when the output of the pending press rose.
+*
+*/
+static void vLinkCpsPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+{
+  uint32_t u32Mask;
+  if(!bSctPending || (axKindPort[xPressKind] != xPort) || bCpsRose)
+  {
+    return;
+  }
+  u32Mask = 1u << au32KindPin[xPressKind];
+  if((u32New & ~u32Old & u32Mask) != 0u)
+  {
+    bCpsRose = true;
+    u64CpsRise = u64Cycles;
+  }
+}
+
+/* void vLinkSctPin(uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+*   SCT actuator change: keeps the edges, closes the pending press or release and times the shift pulses.
+*
+*/
+static void vLinkSctPin(uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+{
+  uint64_t u64Width;
+  u32SctOutputs = u32New;
+  for(uint32_t u32Kind = 0u; u32Kind < (uint32_t)eKIND_Count; u32Kind++)
+  {
+    if((u32New & ~u32Old & au32KindSct[u32Kind]) != 0u)
+    {
+      au64SctRise[u32Kind] = u64Cycles;
+      if(bMeasuring && bSctPending && (u32Kind == (uint32_t)xPressKind))
+      {
+        bSctPending = false;
+        vLinkRecord(&xStep, u64Cycles - u64StepCycles);
+        if(bCpsRose)
+        {
+          vLinkRecord(&xWire, u64Cycles - u64CpsRise);
+        }
+      }
+      else if(bMeasuring)
+      {
+        u32Spurious++;
+      }
+    }
+    if((u32Old & ~u32New & au32KindSct[u32Kind]) == 0u)
+    {
+      continue;
+    }
+    au64SctFall[u32Kind] = u64Cycles;
+    if(u32Kind != (uint32_t)eKIND_Horn)
+    {
+      u64Width = u64Cycles - au64SctRise[u32Kind];
+      u32Pulses++;
+      u32BadPulses += ((u64Width < ((uint64_t)(CPS_FRAME_PULSE_MS - 1u)*HOST_SIM_CYCLES_PER_MS)) ||
+                       (u64Width > ((uint64_t)(CPS_FRAME_PULSE_MS + LINK_SLACK_MS)*HOST_SIM_CYCLES_PER_MS))) ? 1u : 0u;
+    }
+    else if(bMeasuring && bReleasePending)
+    {
+      bReleasePending = false;
+      vLinkRecord(&xRelease, u64Cycles - u64StepCycles);
+    }
+    else if(bMeasuring && !bSctPending && (xPressKind == eKIND_Horn))
+    {
+      u32Spurious++; //Horn dropped while still pressed
+    }
+  }
+}
+
+/* uint16_t u16LinkInput(uint32_t u32Channel, uint64_t u64Cycles)
+*   Horn wire level plus noise. Inputs without a ladder read idle.
+*
+*/
+static uint16_t u16LinkInput(uint32_t u32Channel, uint64_t u64Cycles)
+{
+  (void)u64Cycles;
+  if(u32Channel != LINK_CHANNEL)
+  {
+    return(LINK_LEVEL_IDLE);
+  }
+  return((uint16_t)((u16Level + u32LinkRandom(0u, 2u*LINK_NOISE)) - LINK_NOISE));
+}
+
+/* void vLinkFirmware(void)
+*   CPS firmware entry, what _c_int00 does before main on the target.
+*
+*/
+static void vLinkFirmware(void)
+{
+  CPS_vBootStart();
+  CPS_vMain();
+}
+
+/* uint32_t u32LinkRandom(uint32_t u32Min, uint32_t u32Max)
+*   Uniform in u32Min..u32Max from a xorshift generator, so every run with the same seed is the same drive.
+*
+*/
+static uint32_t u32LinkRandom(uint32_t u32Min, uint32_t u32Max)
+{
+  u32Random ^= u32Random << 13;
+  u32Random ^= u32Random >> 17;
+  u32Random ^= u32Random << 5;
+  return(u32Min + (u32Random % (u32Max - u32Min + 1u)));
+}
+
+/* void vLinkRecord(xLinkSet_t *pxSet, uint64_t u64Cycles)
+*   Keeps one latency, the set stops growing at LINK_PRESSES_MAX.
+*
+*/
+static void vLinkRecord(xLinkSet_t *pxSet, uint64_t u64Cycles)
+{
+  if(pxSet->u32Count < LINK_PRESSES_MAX)
+  {
+    pxSet->au32Cycles[pxSet->u32Count] = (uint32_t)u64Cycles;
+    pxSet->u32Count++;
+  }
+}
+
+/* int iLinkCompare(const void *pvA, const void *pvB)
+*   qsort order, ascending.
+*
+*/
+static int iLinkCompare(const void *pvA, const void *pvB)
+{
+  uint32_t u32A = *(const uint32_t *)pvA;
+  uint32_t u32B = *(const uint32_t *)pvB;
+  return((u32A > u32B) - (u32A < u32B));
+}
+
+/* uint32_t u32LinkReport(const char *pcName, xLinkSet_t *pxSet)
+*   Prints min, mean, p99 and max. Returns the maximum in microseconds.
+*
+*/
+static uint32_t u32LinkReport(const char *pcName, xLinkSet_t *pxSet)
+{
+  uint64_t u64Total = 0u;
+  uint32_t u32Count = pxSet->u32Count;
+  if(u32Count == 0u)
+  {
+    printf("  %s: no samples\n", pcName);
+    return(0u);
+  }
+  qsort(pxSet->au32Cycles, u32Count, sizeof(pxSet->au32Cycles[0]), iLinkCompare);
+  for(uint32_t u32Sample = 0u; u32Sample < u32Count; u32Sample++)
+  {
+    u64Total += pxSet->au32Cycles[u32Sample];
+  }
+  printf("  %s, %u samples (us): min %.1f mean %.1f p99 %.1f max %.1f\n", pcName, u32Count,
+         (double)pxSet->au32Cycles[0]/HOST_SIM_CYCLES_PER_US, ((double)u64Total/u32Count)/HOST_SIM_CYCLES_PER_US,
+         (double)pxSet->au32Cycles[((uint64_t)(u32Count - 1u)*99u)/100u]/HOST_SIM_CYCLES_PER_US,
+         (double)pxSet->au32Cycles[u32Count - 1u]/HOST_SIM_CYCLES_PER_US);
+  return(pxSet->au32Cycles[u32Count - 1u]/HOST_SIM_CYCLES_PER_US);
+}
+
+/* void vLinkRead(void *pvData, size_t xLength)
+*   Reads exactly xLength bytes from HOST_sct.
+*
+*/
+static void vLinkRead(void *pvData, size_t xLength)
+{
+  uint8_t *pu8Data = (uint8_t *)pvData;
+  size_t xDone = 0u;
+  ssize_t xCount;
+  while(xDone < xLength)
+  {
+    xCount = read(iFromSct, &pu8Data[xDone], xLength - xDone);
+    if(xCount <= 0)
+    {
+      HOST_vSimFault("link pipe from HOST_sct broken");
+    }
+    xDone += (size_t)xCount;
+  }
+}
+
+/* void vLinkWrite(const void *pvData, size_t xLength)
+*   Writes exactly xLength bytes to HOST_sct.
+*
+*/
+static void vLinkWrite(const void *pvData, size_t xLength)
+{
+  const uint8_t *pu8Data = (const uint8_t *)pvData;
+  size_t xDone = 0u;
+  ssize_t xCount;
+  while(xDone < xLength)
+  {
+    xCount = write(iToSct, &pu8Data[xDone], xLength - xDone);
+    if(xCount <= 0)
+    {
+      HOST_vSimFault("link pipe to HOST_sct broken");
+    }
+    xDone += (size_t)xCount;
+  }
+}
+
+/* void vLinkCheck(bool bPass, const char *pcWhat)
+*   Prints and counts one check.
+*
+*/
+static void vLinkCheck(bool bPass, const char *pcWhat)
+{
+  printf("  %-90s %s\n", pcWhat, bPass ? "ok" : "FAILED");
+  u32Failures += bPass ? 0u : 1u;
+}
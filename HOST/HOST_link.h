@@ -0,0 +1,78 @@
+/** @file HOST_link.h
+*   @brief Messages between the two processes of the CPS/SCT link simulation
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Only one firmware image can run in a process (see HOST_sim.c), so HOST_link runs the CPS and starts HOST_sct for
+*   the SCT with a pipe on its stdin and one on its stdout. The two virtual clocks move in slices of
+*   HOST_LINK_SLICE_CYCLES with the CPS one slice ahead: HOST_link runs the CPS to the end of a slice, sends the SCT
+*   the characters the CPS finished sending in it, stamped with the cycle their stop bit ended, and has the SCT run to
+*   the same time. Every character therefore reaches the SCT exactly when it would on the wire. The SCT's own
+*   characters, the acknowledgements, reach the CPS exactly one slice late: the CPS has already run past the time
+*   they were sent, and delaying them all by the same amount keeps them a character time apart.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __HOST_LINK_H__
+#define __HOST_LINK_H__
+
+/* Include Files */
+#include "HOST_sim.h"
+
+/* Defines */
+#define HOST_LINK_SLICE_CYCLES (100u*HOST_SIM_CYCLES_PER_US) //About one character time at 115200
+#define HOST_LINK_BYTES_MAX 64u //Characters one side can finish in a slice, with room to spare
+#define HOST_LINK_PINS_MAX 64u //SCT output changes in a slice
+
+/* Global Types */
+typedef enum
+{
+  eHOSTLINK_Run, //Deliver the characters, run to u64Until and reply with xHostLinkReply_t
+  eHOSTLINK_Stats //Reply with xHostLinkStats_t
+} xHostLinkCommand_t;
+
+typedef struct
+{
+  uint64_t u64At; //Cycle the stop bit ended
+  uint32_t u32Byte;
+} xHostLinkByte_t;
+
+typedef struct
+{
+  uint64_t u64At;
+  uint32_t u32Old; //GIOA output latch
+  uint32_t u32New;
+} xHostLinkPin_t;
+
+typedef struct
+{
+  uint32_t u32Command; //xHostLinkCommand_t
+  uint32_t u32Bytes; //xHostLinkByte_t that follow, CPS to SCT
+  uint64_t u64Until;
+} xHostLinkRequest_t;
+
+typedef struct
+{
+  uint32_t u32Bytes; //xHostLinkByte_t that follow, SCT to CPS
+  uint32_t u32Pins; //xHostLinkPin_t that follow the bytes
+} xHostLinkReply_t;
+
+typedef struct
+{
+  uint32_t u32Frames; //SCT_xStats and SCT_xLinkParser
+  uint32_t u32Commands;
+  uint32_t u32PulseEnds;
+  uint32_t u32GapDrops;
+  uint32_t u32Timeouts;
+  uint32_t u32AckDropped;
+  uint32_t u32MaxDispatchCycles;
+  uint32_t u32CrcErrors;
+  uint32_t u32LengthErrors;
+  uint32_t u32SeqGaps;
+  uint64_t u64IrqCycles; //HOST_xSimStats of the SCT
+  uint64_t u64Cycles;
+} xHostLinkStats_t;
+
+#endif
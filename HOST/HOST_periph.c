@@ -0,0 +1,1300 @@
+/** @file HOST_periph.c
+*   @brief Register models of the host simulation
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This file models the parts of the RTI, ADC, SCI, VIM, ESM and the GIO style ports (GIO A, N2HET1, SPI2, SPI3)
+*   that the CPS and SCT use, plus the parity RAMs the background self tests corrupt and the completion flags of the
+*   PBIST and memory initialisation runs they start. Everything else in the window reads back what was written.
+*
+*   Time only moves forward through HOST_vPeriphEvents, which the access hooks call before every register access and
+*   while the core idles. Each model keeps the cycle of its next event (RTI match, end of a conversion, end of a
+*   character) and HOST_u64PeriphNext holds the earliest of them, so a hook only has to compare two numbers.
+*
+*   RTI: counter 0 with its prescaler, compares 0 and 1 with the update compare, and the compare 0 auto clear that
+*   the hardware triggered acquisition relies on. Counter 1, captures and the watchdog are not modelled.
+*   ADC: one converter shared by the three groups in priority order, FIFOs with the threshold counter and overrun
+*   handling, the compare 0 hardware trigger, calibration conversions and the magnitude compares. Offset and gain
+*   errors are applied to every conversion, so CPS_calib has something to measure.
+*   SCI: the transmit buffer and shift register, the receive buffer with overrun, loopback and the level 0 vector.
+*   PBIST and memory initialisation: MSTDONE and MINIDONE set a fixed time after the start, the RAMs always pass.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <string.h>
+#include "HOST_periph.h"
+#include "reg_adc.h"
+#include "reg_can.h"
+#include "reg_esm.h"
+#include "reg_gio.h"
+#include "reg_het.h"
+#include "reg_mibspi.h"
+#include "rti.h"
+#include "reg_sci.h"
+#include "reg_spi.h"
+#include "reg_vim.h"
+#include "htu.h"
+#include "sys_selftest.h"
+#include "system.h"
+
+/* Defines */
+#define RTI_COMPARES 2u //Compares 0 and 1, both on counter 0
+#define RTI_GCTRL_CNT0EN 0x00000001u
+#define RTI_COMPCTRL_SEL1 0x00000001u //COMPSELn, shifted by 4n: compare n follows counter 1
+#define RTI_INTCLRENABLE_MASK 0x0000000Fu
+#define RTI_INTCLRENABLE_COMP0 0x00000005u //Auto clear of the compare 0 flag enabled
+
+#define ADC_GROUPS 3u
+#define ADC_FIFO_MAX 32u
+#define ADC_CODE_MAX 4095
+#define ADC_MIDCODE 2047
+#define ADC_CHID_SHIFT 16u
+#define ADC_BUF_EMPTY 0x80000000u //EV_EMP/G1_EMP/G2_EMP of a result read from an empty FIFO
+#define ADC_FLG_THR 0x00000001u
+#define ADC_FLG_OVR 0x00000002u
+#define ADC_FLG_EMPTY 0x00000004u
+#define ADC_FLG_END 0x00000008u
+#define ADC_FLG_W1C (ADC_FLG_THR | ADC_FLG_OVR | ADC_FLG_END)
+#define ADC_MODECR_CONT 0x00000002u
+#define ADC_MODECR_HWTRIG 0x00000008u
+#define ADC_MODECR_OVRIGN 0x00000010u
+#define ADC_SRC_MASK 0x00000007u
+#define ADC_SRC_RTI_COMP0 3u
+#define ADC_INTCR_MASK 0x000001FFu
+#define ADC_CALCR_HILO 0x00000100u
+#define ADC_CALCR_BRIDGE 0x00000200u
+#define ADC_CALCR_CALST 0x00010000u
+#define ADC_MAG_COMPARES 3u
+#define ADC_MAGINTCR_GE 0x00000002u //CMP_GE_LT: flag results at or above the threshold
+#define ADC_MAGINTCR_THRSHIFT 16u
+#define ADC_MAGINTCR_CHIDSHIFT 8u
+
+#define SCI_FLR_TXRDY 0x00000100u
+#define SCI_FLR_RXRDY 0x00000200u
+#define SCI_FLR_TXEMPTY 0x00000800u
+#define SCI_FLR_PE 0x01000000u
+#define SCI_FLR_OE 0x02000000u
+#define SCI_FLR_FE 0x04000000u
+#define SCI_FLR_ERRORS (SCI_FLR_PE | SCI_FLR_OE | SCI_FLR_FE)
+#define SCI_GCR0_RESET 0x00000001u
+#define SCI_GCR1_SWNRST 0x00000080u
+#define SCI_GCR1_STOP 0x00000010u
+#define SCI_GCR1_PARITY 0x00000004u
+#define SCI_GCR1_ASYNC 0x00000002u
+#define SCI_LOOPBACK_MASK 0x00000F00u
+#define SCI_LOOPBACK_ON 0x00000A00u
+#define SCI_RXQUEUE 1024u //Characters the harness may have in flight towards the SCI
+
+#define VIM_RTI_COMP0 2u
+#define VIM_RTI_COMP1 3u
+#define VIM_SCI_LEVEL0 13u
+#define VIM_ADC_GROUP1 15u
+#define VIM_ADC_GROUP2 28u
+#define VIM_ADC_MAGNITUDE 31u
+
+#define SYS_MSTCGSTAT_MSTDONE 0x00000001u
+#define SYS_MSTCGSTAT_MINIDONE 0x00000100u
+#define SYS_MINITGCR_ENABLE 0x0000000Au
+#define SYS_PBIST_DLR_START 0x00000014u //ROM algorithms on the RINFOx groups, as pbistRun writes it
+#define SYS_PBIST_CYCLES 30000u //Per run, a round figure for March13N on a few kB of dual-port RAM
+#define SYS_MINIT_CYCLES 500u
+
+#define PORT_DIR 0u //gioPORT_t register offsets
+#define PORT_DIN 4u
+#define PORT_DOUT 8u
+#define PORT_DSET 12u
+#define PORT_DCLR 16u
+
+/* Global Vars */
+uint64_t HOST_u64PeriphNext;
+
+/* Internal Types */
+typedef struct
+{
+  bool bRunning;
+  uint64_t u64Start; //Cycle at which counter 0 held u32Base
+  uint32_t u32Base;
+  uint32_t u32Div; //Cycles per count, CPUC0 + 1
+  uint32_t u32IntEna;
+  uint32_t u32Flags;
+  uint32_t au32Comp[RTI_COMPARES];
+  uint32_t u32Comp0Clr;
+  uint64_t au64Match[RTI_COMPARES];
+  uint64_t u64ClrMatch;
+} xHostRti_t;
+
+typedef struct
+{
+  uint32_t u32Pending; //Channels left to convert in the current pass
+  uint32_t au32Fifo[ADC_FIFO_MAX];
+  uint32_t u32Head;
+  uint32_t u32Count;
+  int32_t i32Threshold;
+  uint32_t u32Flags;
+} xHostAdcGroup_t;
+
+typedef struct
+{
+  xHostAdcGroup_t axGroup[ADC_GROUPS];
+  bool bBusy;
+  uint32_t u32Group; //Group and channel of the conversion in progress
+  uint32_t u32Channel;
+  uint64_t u64Done;
+  bool bCalBusy;
+  uint32_t u32CalCr;
+  uint64_t u64CalDone;
+  uint32_t u32MagEna;
+  uint32_t u32MagFlags;
+} xHostAdc_t;
+
+typedef struct
+{
+  uint8_t u8Byte;
+  uint64_t u64At;
+} xHostSciRx_t;
+
+typedef struct
+{
+  uint32_t u32IntEna;
+  uint32_t u32IntLvl;
+  uint32_t u32Flags; //RXRDY and the error flags, TX readiness comes from the buffers
+  bool bTdFull;
+  uint8_t u8Td;
+  bool bShiftBusy;
+  uint8_t u8Shift;
+  uint64_t u64ShiftDone;
+  uint8_t u8Rd;
+  xHostSciRx_t axRx[SCI_RXQUEUE];
+  uint32_t u32RxHead;
+  uint32_t u32RxCount;
+} xHostSci_t;
+
+typedef struct
+{
+  uint32_t u32Par; //Parity RAM location the self test flips
+  uint32_t u32Ram; //Data RAM location it then reads
+  uint32_t u32Esm; //ESM group 1 flag of the module
+} xHostParity_t;
+
+/* Internal Vars */
+static const uint32_t au32AdcFifoSize[ADC_GROUPS] = {16u, 16u, 32u}; //BNDCR and BNDEND as written by adcInit
+static const uint32_t au32PortBase[eHOST_PortCount] =
+{
+  (uint32_t)(uintptr_t)gioPORTA, (uint32_t)(uintptr_t)hetPORT1, (uint32_t)(uintptr_t)spiPORT2,
+  (uint32_t)(uintptr_t)spiPORT3
+};
+static const xHostParity_t axParity[] =
+{
+  {HOST_PERIPH_ADDR(HTU1PARLOC), HOST_PERIPH_ADDR(HTU1RAMLOC), 0x00000100u},
+  {HOST_PERIPH_ADDR(adcPARRAM1), HOST_PERIPH_ADDR(adcRAM1), 0x00080000u},
+  {HOST_PERIPH_ADDR(canPARRAM1), HOST_PERIPH_ADDR(canRAM1), 0x00200000u},
+  {HOST_PERIPH_ADDR(canPARRAM2), HOST_PERIPH_ADDR(canRAM2), 0x00800000u},
+  {HOST_PERIPH_ADDR(mibspiPARRAM1), HOST_PERIPH_ADDR(MIBSPI1RAMLOC), 0x00020000u}
+};
+
+static xHostSimConfig_t xConfig;
+static xHostRti_t xRti;
+static xHostAdc_t xAdc;
+static xHostSci_t xSci;
+static uint32_t au32Port[eHOST_PortCount];
+static uint32_t au32VimMask[2];
+static uint32_t u32EsmFlags;
+static uint32_t u32MstcgStat; //System MSTCGSTAT
+static uint64_t u64PbistDone; //HOST_SIM_NEVER: no PBIST run going
+static uint64_t u64MinitDone; //HOST_SIM_NEVER: no memory initialisation going
+
+/* Local Function Prototypes */
+static void vPeriphSchedule(void);
+static bool bRtiRead(uint32_t u32Addr, uint64_t u64Now);
+static bool bRtiWrite(uint32_t u32Addr, uint64_t u64Now);
+static uint32_t u32RtiCount(uint64_t u64Now);
+static uint64_t u64RtiWhen(uint32_t u32Value, uint64_t u64From);
+static void vRtiRebase(uint64_t u64Now);
+static void vRtiArm(uint64_t u64Now);
+static void vRtiMatch(uint32_t u32Compare, uint64_t u64Now);
+static bool bAdcRead(uint32_t u32Addr);
+static bool bAdcWrite(uint32_t u32Addr, uint64_t u64Now);
+static void vAdcReset(void);
+static void vAdcTrigger(uint64_t u64Now);
+static void vAdcSchedule(uint64_t u64Now);
+static uint32_t u32AdcConvert(uint32_t u32Ideal);
+static void vAdcComplete(uint64_t u64Now);
+static void vAdcCalComplete(void);
+static bool bSciRead(uint32_t u32Addr);
+static bool bSciWrite(uint32_t u32Addr, uint64_t u64Now);
+static void vSciReset(void);
+static uint32_t u32SciFlags(void);
+static uint32_t u32SciVector(void);
+static void vSciShiftStart(uint64_t u64Now);
+static void vSciShiftDone(uint64_t u64Now);
+static void vSciArrive(uint8_t u8Byte);
+static bool bPortRead(uint32_t u32Addr);
+static bool bPortWrite(uint32_t u32Addr, uint64_t u64Now);
+static bool bSystemRead(uint32_t u32Addr);
+static bool bSystemWrite(uint32_t u32Addr, uint64_t u64Now);
+
+/* Global Functions */
+
+/* void HOST_vPeriphInit(const xHostSimConfig_t *pxConfig)
+*   Power on reset of every model. The register window itself is cleared by the caller.
+*
+*/
+void HOST_vPeriphInit(const xHostSimConfig_t *pxConfig)
+{
+  xConfig = *pxConfig;
+  if(xConfig.u32AdcGain == 0u)
+  {
+    xConfig.u32AdcGain = HOST_SIM_ADC_GAIN_UNITY;
+  }
+  memset(&xRti, 0, sizeof(xRti));
+  xRti.u32Div = 1u;
+  xRti.au64Match[0] = HOST_SIM_NEVER;
+  xRti.au64Match[1] = HOST_SIM_NEVER;
+  xRti.u64ClrMatch = HOST_SIM_NEVER;
+  vAdcReset();
+  vSciReset();
+  xSci.u32RxHead = 0u;
+  xSci.u32RxCount = 0u;
+  memset(au32Port, 0, sizeof(au32Port));
+  au32VimMask[0] = 0u;
+  au32VimMask[1] = 0u;
+  u32EsmFlags = 0u;
+  u32MstcgStat = 0u;
+  u64PbistDone = HOST_SIM_NEVER;
+  u64MinitDone = HOST_SIM_NEVER;
+  vPeriphSchedule();
+}
+
+/* void HOST_vPeriphRead(uint32_t u32Addr, uint64_t u64Now)
+*   Puts the value a read of u32Addr returns at u64Now into the window, just before the firmware loads it.
+*
+*/
+void HOST_vPeriphRead(uint32_t u32Addr, uint64_t u64Now)
+{
+  u32Addr &= ~3u;
+  if(!bRtiRead(u32Addr, u64Now) && !bAdcRead(u32Addr) && !bSciRead(u32Addr) && !bPortRead(u32Addr))
+  {
+    (void)bSystemRead(u32Addr);
+  }
+}
+
+/* void HOST_vPeriphWrite(uint32_t u32Addr, uint64_t u64Now)
+*   Acts on a value the firmware has just stored at u32Addr. Events that fell due between the store and its commit
+*   run first, a compare match passed in that gap would otherwise be rescheduled a full counter wrap away.
+*
+*/
+void HOST_vPeriphWrite(uint32_t u32Addr, uint64_t u64Now)
+{
+  HOST_vPeriphEvents(u64Now);
+  u32Addr &= ~3u;
+  if(!bRtiWrite(u32Addr, u64Now) && !bAdcWrite(u32Addr, u64Now) && !bSciWrite(u32Addr, u64Now) &&
+     !bPortWrite(u32Addr, u64Now))
+  {
+    (void)bSystemWrite(u32Addr, u64Now);
+  }
+  vPeriphSchedule();
+}
+
+/* bool HOST_bPeriphFreeRunning(uint32_t u32Addr)
+*   True for registers that change on their own between reads without any event, so a loop reading them is not
+*   a busy wait that can be skipped.
+*
+*/
+bool HOST_bPeriphFreeRunning(uint32_t u32Addr)
+{
+  u32Addr &= ~3u;
+  return((u32Addr == HOST_PERIPH_ADDR(rtiREG1->CNT[0u].FRCx)) || (u32Addr == HOST_PERIPH_ADDR(rtiREG1->CNT[0u].UCx)));
+}
+
+/* void HOST_vPeriphEvents(uint64_t u64Until)
+*   Runs every event due at or before u64Until in time order.
+*
+*/
+void HOST_vPeriphEvents(uint64_t u64Until)
+{
+  uint64_t u64Now;
+  while(HOST_u64PeriphNext <= u64Until)
+  {
+    u64Now = HOST_u64PeriphNext;
+    if(xRti.au64Match[0] == u64Now)
+    {
+      vRtiMatch(0u, u64Now);
+    }
+    else if(xRti.au64Match[1] == u64Now)
+    {
+      vRtiMatch(1u, u64Now);
+    }
+    else if(xRti.u64ClrMatch == u64Now)
+    {
+      xRti.u32Flags &= ~rtiNOTIFICATION_COMPARE0;
+      xRti.u32Comp0Clr += HOST_PERIPH_REG(HOST_PERIPH_ADDR(rtiREG1->CMP[0u].UDCPx));
+      xRti.u64ClrMatch = u64RtiWhen(xRti.u32Comp0Clr, u64Now + 1u);
+    }
+    else if(xAdc.bBusy && (xAdc.u64Done == u64Now))
+    {
+      vAdcComplete(u64Now);
+    }
+    else if(xAdc.bCalBusy && (xAdc.u64CalDone == u64Now))
+    {
+      vAdcCalComplete();
+      vAdcSchedule(u64Now);
+    }
+    else if(xSci.bShiftBusy && (xSci.u64ShiftDone == u64Now))
+    {
+      vSciShiftDone(u64Now);
+    }
+    else if(u64PbistDone == u64Now)
+    {
+      u32MstcgStat |= SYS_MSTCGSTAT_MSTDONE;
+      u64PbistDone = HOST_SIM_NEVER;
+    }
+    else if(u64MinitDone == u64Now)
+    {
+      u32MstcgStat |= SYS_MSTCGSTAT_MINIDONE;
+      u64MinitDone = HOST_SIM_NEVER;
+    }
+    else
+    {
+      vSciArrive(xSci.axRx[xSci.u32RxHead].u8Byte);
+      xSci.u32RxHead = (xSci.u32RxHead + 1u) % SCI_RXQUEUE;
+      xSci.u32RxCount--;
+    }
+    vPeriphSchedule();
+  }
+}
+
+/* uint32_t HOST_u32PeriphIrq(void)
+*   Lowest numbered VIM channel that requests an IRQ and is enabled, HOST_SIM_VIM_NONE if there is none.
+*
+*/
+uint32_t HOST_u32PeriphIrq(void)
+{
+  uint64_t u64Lines = 0u;
+  uint64_t u64Mask = ((uint64_t)au32VimMask[1] << 32) | au32VimMask[0];
+  uint32_t u32Sci = u32SciVector();
+  u64Lines |= ((xRti.u32Flags & xRti.u32IntEna & rtiNOTIFICATION_COMPARE0) != 0u) ? (1ull << VIM_RTI_COMP0) : 0u;
+  u64Lines |= ((xRti.u32Flags & xRti.u32IntEna & rtiNOTIFICATION_COMPARE1) != 0u) ? (1ull << VIM_RTI_COMP1) : 0u;
+  u64Lines |= (u32Sci != 0u) ? (1ull << VIM_SCI_LEVEL0) : 0u;
+  u64Lines |= ((xAdc.axGroup[1].u32Flags & HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->GxINTENA[1u])) &
+                ADC_FLG_W1C) != 0u) ? (1ull << VIM_ADC_GROUP1) : 0u;
+  u64Lines |= ((xAdc.axGroup[2].u32Flags & HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->GxINTENA[2u])) &
+                ADC_FLG_W1C) != 0u) ? (1ull << VIM_ADC_GROUP2) : 0u;
+  u64Lines |= ((xAdc.u32MagFlags & xAdc.u32MagEna) != 0u) ? (1ull << VIM_ADC_MAGNITUDE) : 0u;
+  u64Lines &= u64Mask;
+  if(u64Lines == 0u)
+  {
+    return(HOST_SIM_VIM_NONE);
+  }
+  return((uint32_t)__builtin_ctzll(u64Lines));
+}
+
+/* uint32_t HOST_u32PeriphPort(xHostPort_t xPort)
+*   Output latch of a port.
+*
+*/
+uint32_t HOST_u32PeriphPort(xHostPort_t xPort)
+{
+  return(au32Port[xPort]);
+}
+
+/* void HOST_vPeriphSciReceive(uint8_t u8Byte, uint64_t u64At)
+*   Queues a character whose stop bit arrives at u64At. Characters must be queued in time order.
+*
+*/
+void HOST_vPeriphSciReceive(uint8_t u8Byte, uint64_t u64At)
+{
+  uint32_t u32Tail;
+  if(xSci.u32RxCount >= SCI_RXQUEUE)
+  {
+    HOST_vSimFault("SCI receive queue full");
+  }
+  u32Tail = (xSci.u32RxHead + xSci.u32RxCount) % SCI_RXQUEUE;
+  xSci.axRx[u32Tail].u8Byte = u8Byte;
+  xSci.axRx[u32Tail].u64At = u64At;
+  xSci.u32RxCount++;
+  vPeriphSchedule();
+}
+
+/* uint64_t HOST_u64PeriphSciCharCycles(void)
+*   Length of one character at the current format and baud rate.
+*
+*/
+uint64_t HOST_u64PeriphSciCharCycles(void)
+{
+  uint32_t u32Gcr1 = HOST_PERIPH_REG(HOST_PERIPH_ADDR(scilinREG->GCR1));
+  uint64_t u64Bits = 1u + (HOST_PERIPH_REG(HOST_PERIPH_ADDR(scilinREG->FORMAT)) & 7u) + 1u;
+  uint64_t u64BitCycles = (uint64_t)(HOST_PERIPH_REG(HOST_PERIPH_ADDR(scilinREG->BRS)) & 0x00FFFFFFu) + 1u;
+  u64Bits += ((u32Gcr1 & SCI_GCR1_PARITY) != 0u) ? 1u : 0u;
+  u64Bits += ((u32Gcr1 & SCI_GCR1_STOP) != 0u) ? 2u : 1u;
+  if((u32Gcr1 & SCI_GCR1_ASYNC) != 0u)
+  {
+    u64BitCycles *= 16u;
+  }
+  return(u64Bits*u64BitCycles);
+}
+
+/* Local Functions */
+
+/* void vPeriphSchedule(void)
+*   Recomputes HOST_u64PeriphNext from the pending events of every model.
+*
+*/
+static void vPeriphSchedule(void)
+{
+  uint64_t u64Next = xRti.au64Match[0];
+  u64Next = (xRti.au64Match[1] < u64Next) ? xRti.au64Match[1] : u64Next;
+  u64Next = (xRti.u64ClrMatch < u64Next) ? xRti.u64ClrMatch : u64Next;
+  u64Next = (xAdc.bBusy && (xAdc.u64Done < u64Next)) ? xAdc.u64Done : u64Next;
+  u64Next = (xAdc.bCalBusy && (xAdc.u64CalDone < u64Next)) ? xAdc.u64CalDone : u64Next;
+  u64Next = (xSci.bShiftBusy && (xSci.u64ShiftDone < u64Next)) ? xSci.u64ShiftDone : u64Next;
+  u64Next = (u64PbistDone < u64Next) ? u64PbistDone : u64Next;
+  u64Next = (u64MinitDone < u64Next) ? u64MinitDone : u64Next;
+  if((xSci.u32RxCount > 0u) && (xSci.axRx[xSci.u32RxHead].u64At < u64Next))
+  {
+    u64Next = xSci.axRx[xSci.u32RxHead].u64At;
+  }
+  HOST_u64PeriphNext = u64Next;
+}
+
+/* RTI */
+
+static bool bRtiRead(uint32_t u32Addr, uint64_t u64Now)
+{
+  uint32_t u32Value;
+  if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->CNT[0u].FRCx))
+  {
+    u32Value = u32RtiCount(u64Now);
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->CNT[0u].UCx))
+  {
+    u32Value = xRti.bRunning ? (uint32_t)((u64Now - xRti.u64Start) % xRti.u32Div) : 0u;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->CMP[0u].COMPx))
+  {
+    u32Value = xRti.au32Comp[0];
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->CMP[1u].COMPx))
+  {
+    u32Value = xRti.au32Comp[1];
+  }
+  else if((u32Addr == HOST_PERIPH_ADDR(rtiREG1->SETINTENA)) || (u32Addr == HOST_PERIPH_ADDR(rtiREG1->CLEARINTENA)))
+  {
+    u32Value = xRti.u32IntEna;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->INTFLAG))
+  {
+    u32Value = xRti.u32Flags;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->COMP0CLR))
+  {
+    u32Value = xRti.u32Comp0Clr;
+  }
+  else
+  {
+    return(false);
+  }
+  HOST_PERIPH_REG(u32Addr) = u32Value;
+  return(true);
+}
+
+static bool bRtiWrite(uint32_t u32Addr, uint64_t u64Now)
+{
+  uint32_t u32Value = HOST_PERIPH_REG(u32Addr);
+  if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->GCTRL))
+  {
+    if(((u32Value & RTI_GCTRL_CNT0EN) != 0u) && !xRti.bRunning)
+    {
+      xRti.bRunning = true;
+      xRti.u64Start = u64Now;
+    }
+    else if(((u32Value & RTI_GCTRL_CNT0EN) == 0u) && xRti.bRunning)
+    {
+      vRtiRebase(u64Now);
+      xRti.bRunning = false;
+    }
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->CNT[0u].FRCx))
+  {
+    vRtiRebase(u64Now);
+    xRti.u32Base = u32Value;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->CNT[0u].CPUCx))
+  {
+    vRtiRebase(u64Now);
+    xRti.u32Div = u32Value + 1u;
+    xRti.u32Div = (xRti.u32Div == 0u) ? 0xFFFFFFFFu : xRti.u32Div;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->CMP[0u].COMPx))
+  {
+    xRti.au32Comp[0] = u32Value;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->CMP[1u].COMPx))
+  {
+    xRti.au32Comp[1] = u32Value;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->SETINTENA))
+  {
+    xRti.u32IntEna |= u32Value;
+    u32Value = xRti.u32IntEna;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->CLEARINTENA))
+  {
+    xRti.u32IntEna &= ~u32Value;
+    u32Value = xRti.u32IntEna;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->INTFLAG))
+  {
+    xRti.u32Flags &= ~u32Value;
+    u32Value = xRti.u32Flags;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(rtiREG1->COMP0CLR))
+  {
+    xRti.u32Comp0Clr = u32Value;
+  }
+  else if((u32Addr == HOST_PERIPH_ADDR(rtiREG1->DWDCTRL)) && (u32Value != 0u))
+  {
+    HOST_vSimFault("digital watchdog enabled, the firmware has stopped in vERROR");
+  }
+  else if((u32Addr != HOST_PERIPH_ADDR(rtiREG1->COMPCTRL)) && (u32Addr != HOST_PERIPH_ADDR(rtiREG1->INTCLRENABLE)))
+  {
+    return(false);
+  }
+  HOST_PERIPH_REG(u32Addr) = u32Value;
+  vRtiArm(u64Now);
+  return(true);
+}
+
+/* uint32_t u32RtiCount(uint64_t u64Now)
+*   Counter 0 at u64Now.
+*
+*/
+static uint32_t u32RtiCount(uint64_t u64Now)
+{
+  if(!xRti.bRunning)
+  {
+    return(xRti.u32Base);
+  }
+  return(xRti.u32Base + (uint32_t)((u64Now - xRti.u64Start)/xRti.u32Div));
+}
+
+/* uint64_t u64RtiWhen(uint32_t u32Value, uint64_t u64From)
+*   First cycle at or after u64From at which counter 0 changes to u32Value. A match handled at cycle n asks from n + 1,
+*   any other caller from now, so a compare due this very cycle is not pushed a full wrap away.
+*
+*/
+static uint64_t u64RtiWhen(uint32_t u32Value, uint64_t u64From)
+{
+  uint64_t u64Ticks;
+  uint64_t u64Delta;
+  if(!xRti.bRunning)
+  {
+    return(HOST_SIM_NEVER);
+  }
+  u64Ticks = (u64From - xRti.u64Start + xRti.u32Div - 1u)/xRti.u32Div; //First count boundary at or after u64From
+  u64Delta = (uint64_t)(uint32_t)(u32Value - (xRti.u32Base + (uint32_t)u64Ticks));
+  return(xRti.u64Start + ((u64Ticks + u64Delta)*xRti.u32Div));
+}
+
+/* void vRtiRebase(uint64_t u64Now)
+*   Moves the reference point to the last count boundary, keeping the prescaler phase.
+*
+*/
+static void vRtiRebase(uint64_t u64Now)
+{
+  uint64_t u64Ticks;
+  if(xRti.bRunning)
+  {
+    u64Ticks = (u64Now - xRti.u64Start)/xRti.u32Div;
+    xRti.u32Base += (uint32_t)u64Ticks;
+    xRti.u64Start += u64Ticks*xRti.u32Div;
+  }
+}
+
+/* void vRtiArm(uint64_t u64Now)
+*   Recomputes the match times after a change to the counter or a compare.
+*
+*/
+static void vRtiArm(uint64_t u64Now)
+{
+  uint32_t u32CompCtrl = HOST_PERIPH_REG(HOST_PERIPH_ADDR(rtiREG1->COMPCTRL));
+  uint32_t u32ClrEnable = HOST_PERIPH_REG(HOST_PERIPH_ADDR(rtiREG1->INTCLRENABLE)) & RTI_INTCLRENABLE_MASK;
+  for(uint32_t u32Compare = 0u; u32Compare < RTI_COMPARES; u32Compare++)
+  {
+    if((u32CompCtrl & (RTI_COMPCTRL_SEL1 << (4u*u32Compare))) != 0u)
+    {
+      xRti.au64Match[u32Compare] = HOST_SIM_NEVER; //Counter 1 is not modelled
+    }
+    else
+    {
+      xRti.au64Match[u32Compare] = u64RtiWhen(xRti.au32Comp[u32Compare], u64Now);
+    }
+  }
+  if(((u32CompCtrl & RTI_COMPCTRL_SEL1) == 0u) && (u32ClrEnable == RTI_INTCLRENABLE_COMP0))
+  {
+    xRti.u64ClrMatch = u64RtiWhen(xRti.u32Comp0Clr, u64Now);
+  }
+  else
+  {
+    xRti.u64ClrMatch = HOST_SIM_NEVER;
+  }
+}
+
+/* void vRtiMatch(uint32_t u32Compare, uint64_t u64Now)
+*   Compare match: sets the flag, moves the compare on by its update value and raises the ADC trigger on a rising
+*   compare 0 flag.
+*
+*/
+static void vRtiMatch(uint32_t u32Compare, uint64_t u64Now)
+{
+  uint32_t u32Flag = 1u << u32Compare;
+  if((u32Compare == 0u) && ((xRti.u32Flags & u32Flag) == 0u))
+  {
+    xRti.u32Flags |= u32Flag;
+    vAdcTrigger(u64Now);
+  }
+  xRti.u32Flags |= u32Flag;
+  xRti.au32Comp[u32Compare] += HOST_PERIPH_REG(HOST_PERIPH_ADDR(rtiREG1->CMP[u32Compare].UDCPx));
+  xRti.au64Match[u32Compare] = u64RtiWhen(xRti.au32Comp[u32Compare], u64Now + 1u); //The others keep their match
+}
+
+/* ADC */
+
+static bool bAdcRead(uint32_t u32Addr)
+{
+  xHostAdcGroup_t *pxGroup;
+  uint32_t u32Value;
+  uint32_t u32Group;
+  uint32_t u32Base = HOST_PERIPH_ADDR(adcREG1->GxBUF[0u].BUF0);
+  uint32_t u32Stride = HOST_PERIPH_ADDR(adcREG1->GxBUF[1u].BUF0) - u32Base;
+  if((u32Addr >= u32Base) && (u32Addr < (u32Base + (ADC_GROUPS*u32Stride))))
+  {
+    pxGroup = &xAdc.axGroup[(u32Addr - u32Base)/u32Stride]; //BUF0..BUF7 all pop the same FIFO
+    if(pxGroup->u32Count == 0u)
+    {
+      u32Value = ADC_BUF_EMPTY;
+    }
+    else
+    {
+      u32Value = pxGroup->au32Fifo[pxGroup->u32Head];
+      pxGroup->u32Head = (pxGroup->u32Head + 1u) % ADC_FIFO_MAX;
+      pxGroup->u32Count--;
+      pxGroup->i32Threshold++;
+    }
+    HOST_PERIPH_REG(u32Addr) = u32Value;
+    return(true);
+  }
+  for(u32Group = 0u; u32Group < ADC_GROUPS; u32Group++)
+  {
+    pxGroup = &xAdc.axGroup[u32Group];
+    if(u32Addr == HOST_PERIPH_ADDR(adcREG1->GxINTFLG[u32Group]))
+    {
+      HOST_PERIPH_REG(u32Addr) = pxGroup->u32Flags | ((pxGroup->u32Count == 0u) ? ADC_FLG_EMPTY : 0u);
+      return(true);
+    }
+    if(u32Addr == HOST_PERIPH_ADDR(adcREG1->GxINTCR[u32Group]))
+    {
+      HOST_PERIPH_REG(u32Addr) = (uint32_t)pxGroup->i32Threshold & ADC_INTCR_MASK;
+      return(true);
+    }
+  }
+  if(u32Addr == HOST_PERIPH_ADDR(adcREG1->CALCR))
+  {
+    HOST_PERIPH_REG(u32Addr) = xAdc.u32CalCr;
+  }
+  else if((u32Addr == HOST_PERIPH_ADDR(adcREG1->MAGTHRINTENASET)) ||
+          (u32Addr == HOST_PERIPH_ADDR(adcREG1->MAGTHRINTENACLR)))
+  {
+    HOST_PERIPH_REG(u32Addr) = xAdc.u32MagEna;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(adcREG1->MAGTHRINTFLG))
+  {
+    HOST_PERIPH_REG(u32Addr) = xAdc.u32MagFlags;
+  }
+  else
+  {
+    return(false);
+  }
+  return(true);
+}
+
+static bool bAdcWrite(uint32_t u32Addr, uint64_t u64Now)
+{
+  xHostAdcGroup_t *pxGroup;
+  uint32_t u32Value = HOST_PERIPH_REG(u32Addr);
+  for(uint32_t u32Group = 0u; u32Group < ADC_GROUPS; u32Group++)
+  {
+    pxGroup = &xAdc.axGroup[u32Group];
+    if(u32Addr == HOST_PERIPH_ADDR(adcREG1->GxSEL[u32Group]))
+    {
+      pxGroup->u32Pending = 0u;
+      if(xAdc.bBusy && (xAdc.u32Group == u32Group))
+      {
+        xAdc.bBusy = false; //Conversion in progress is abandoned
+      }
+      if((u32Value != 0u) && ((HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->GxMODECR[u32Group])) &
+                               ADC_MODECR_HWTRIG) == 0u))
+      {
+        pxGroup->u32Pending = u32Value; //Software trigger, otherwise armed for the trigger source
+      }
+      vAdcSchedule(u64Now);
+      return(true);
+    }
+    if(u32Addr == HOST_PERIPH_ADDR(adcREG1->GxINTFLG[u32Group]))
+    {
+      pxGroup->u32Flags &= ~(u32Value & ADC_FLG_W1C);
+      HOST_PERIPH_REG(u32Addr) = pxGroup->u32Flags | ((pxGroup->u32Count == 0u) ? ADC_FLG_EMPTY : 0u);
+      return(true);
+    }
+    if(u32Addr == HOST_PERIPH_ADDR(adcREG1->GxINTCR[u32Group]))
+    {
+      pxGroup->i32Threshold = (int32_t)(u32Value & ADC_INTCR_MASK);
+      return(true);
+    }
+    if(u32Addr == HOST_PERIPH_ADDR(adcREG1->GxFIFORESETCR[u32Group]))
+    {
+      if((u32Value & 1u) != 0u)
+      {
+        pxGroup->u32Head = 0u;
+        pxGroup->u32Count = 0u;
+      }
+      HOST_PERIPH_REG(u32Addr) = 0u;
+      return(true);
+    }
+  }
+  if(u32Addr == HOST_PERIPH_ADDR(adcREG1->RSTCR))
+  {
+    if((u32Value & 1u) != 0u)
+    {
+      vAdcReset();
+    }
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(adcREG1->CALCR))
+  {
+    if(((u32Value & ADC_CALCR_CALST) != 0u) && !xAdc.bCalBusy)
+    {
+      xAdc.bCalBusy = true;
+      xAdc.u64CalDone = (xAdc.bBusy ? xAdc.u64Done : u64Now) + HOST_SIM_ADC_CONVERSION_CYCLES;
+    }
+    xAdc.u32CalCr = u32Value | (xAdc.bCalBusy ? ADC_CALCR_CALST : 0u);
+    HOST_PERIPH_REG(u32Addr) = xAdc.u32CalCr;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(adcREG1->MAGTHRINTENASET))
+  {
+    xAdc.u32MagEna |= u32Value & ((1u << ADC_MAG_COMPARES) - 1u);
+    HOST_PERIPH_REG(u32Addr) = xAdc.u32MagEna;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(adcREG1->MAGTHRINTENACLR))
+  {
+    xAdc.u32MagEna &= ~u32Value;
+    HOST_PERIPH_REG(u32Addr) = xAdc.u32MagEna;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(adcREG1->MAGTHRINTFLG))
+  {
+    xAdc.u32MagFlags &= ~u32Value;
+    HOST_PERIPH_REG(u32Addr) = xAdc.u32MagFlags;
+  }
+  else
+  {
+    return(false);
+  }
+  return(true);
+}
+
+/* void vAdcReset(void)
+*   Module reset: groups idle, FIFOs empty, flags clear.
+*
+*/
+static void vAdcReset(void)
+{
+  memset(&xAdc, 0, sizeof(xAdc));
+  for(uint32_t u32Group = 0u; u32Group < ADC_GROUPS; u32Group++)
+  {
+    HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->GxSEL[u32Group])) = 0u;
+  }
+}
+
+/* void vAdcTrigger(uint64_t u64Now)
+*   RTI compare 0 event: starts a pass of every armed group whose trigger source it is. A group still busy with the
+*   previous pass ignores it.
+*
+*/
+static void vAdcTrigger(uint64_t u64Now)
+{
+  uint32_t au32Src[ADC_GROUPS];
+  uint32_t u32Select;
+  au32Src[0] = HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->EVSRC));
+  au32Src[1] = HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->G1SRC));
+  au32Src[2] = HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->G2SRC));
+  for(uint32_t u32Group = 0u; u32Group < ADC_GROUPS; u32Group++)
+  {
+    u32Select = HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->GxSEL[u32Group]));
+    if(((HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->GxMODECR[u32Group])) & ADC_MODECR_HWTRIG) != 0u) &&
+       ((au32Src[u32Group] & ADC_SRC_MASK) == ADC_SRC_RTI_COMP0) && (u32Select != 0u) &&
+       (xAdc.axGroup[u32Group].u32Pending == 0u))
+    {
+      xAdc.axGroup[u32Group].u32Pending = u32Select;
+    }
+  }
+  vAdcSchedule(u64Now);
+}
+
+/* void vAdcSchedule(uint64_t u64Now)
+*   Starts the next conversion when the converter is free: lowest group first, lowest channel first.
+*
+*/
+static void vAdcSchedule(uint64_t u64Now)
+{
+  uint32_t u32Pending;
+  if(xAdc.bBusy || xAdc.bCalBusy)
+  {
+    return;
+  }
+  for(uint32_t u32Group = 0u; u32Group < ADC_GROUPS; u32Group++)
+  {
+    u32Pending = xAdc.axGroup[u32Group].u32Pending;
+    if(u32Pending != 0u)
+    {
+      xAdc.bBusy = true;
+      xAdc.u32Group = u32Group;
+      xAdc.u32Channel = (uint32_t)__builtin_ctz(u32Pending);
+      xAdc.u64Done = u64Now + HOST_SIM_ADC_CONVERSION_CYCLES;
+      return;
+    }
+  }
+}
+
+/* uint32_t u32AdcConvert(uint32_t u32Ideal)
+*   Applies the configured gain and offset error to an ideal code.
+*
+*/
+static uint32_t u32AdcConvert(uint32_t u32Ideal)
+{
+  int64_t i64Code = ((int64_t)u32Ideal - ADC_MIDCODE)*(int64_t)xConfig.u32AdcGain;
+  i64Code = (i64Code + (HOST_SIM_ADC_GAIN_UNITY/2u)) >> 15; //Unity is 1 << 15, rounds half up on both sides
+  i64Code += ADC_MIDCODE + xConfig.i32AdcOffset;
+  i64Code = (i64Code < 0) ? 0 : i64Code;
+  i64Code = (i64Code > ADC_CODE_MAX) ? ADC_CODE_MAX : i64Code;
+  return((uint32_t)i64Code);
+}
+
+/* void vAdcComplete(uint64_t u64Now)
+*   End of a conversion: writes the FIFO, counts the threshold down, runs the magnitude compares and ends the pass
+*   when it was the last channel.
+*
+*/
+static void vAdcComplete(uint64_t u64Now)
+{
+  xHostAdcGroup_t *pxGroup = &xAdc.axGroup[xAdc.u32Group];
+  volatile uint32_t *pu32MagIntCR = &adcREG1->MAGINTCR1;
+  uint32_t u32Ideal = (xConfig.pu16AdcInput != 0) ? xConfig.pu16AdcInput(xAdc.u32Channel, u64Now) : ADC_MIDCODE;
+  uint32_t u32Code = u32AdcConvert(u32Ideal);
+  uint32_t u32Size = au32AdcFifoSize[xAdc.u32Group];
+  uint32_t u32Control;
+  uint32_t u32Masked;
+  uint32_t u32Threshold;
+  bool bGreaterEqual;
+  xAdc.bBusy = false;
+  HOST_xSimStats.u64AdcConversions++;
+  if(pxGroup->u32Count < u32Size)
+  {
+    pxGroup->au32Fifo[(pxGroup->u32Head + pxGroup->u32Count) % ADC_FIFO_MAX] = u32Code |
+                                                                              (xAdc.u32Channel << ADC_CHID_SHIFT);
+    pxGroup->u32Count++;
+    pxGroup->i32Threshold--;
+  }
+  else if((HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->GxMODECR[xAdc.u32Group])) & ADC_MODECR_OVRIGN) != 0u)
+  {
+    pxGroup->au32Fifo[(pxGroup->u32Head + u32Size - 1u) % ADC_FIFO_MAX] = u32Code |
+                                                                         (xAdc.u32Channel << ADC_CHID_SHIFT);
+    pxGroup->i32Threshold--;
+  }
+  else
+  {
+    pxGroup->u32Flags |= ADC_FLG_OVR;
+  }
+  if(pxGroup->i32Threshold == 0)
+  {
+    pxGroup->u32Flags |= ADC_FLG_THR;
+  }
+  for(uint32_t u32Compare = 0u; u32Compare < ADC_MAG_COMPARES; u32Compare++)
+  {
+    u32Control = pu32MagIntCR[2u*u32Compare];
+    if(((u32Control >> ADC_MAGINTCR_CHIDSHIFT) & 0x1Fu) == xAdc.u32Channel)
+    {
+      u32Masked = u32Code & pu32MagIntCR[(2u*u32Compare) + 1u];
+      u32Threshold = (u32Control >> ADC_MAGINTCR_THRSHIFT) & (uint32_t)ADC_CODE_MAX;
+      bGreaterEqual = (u32Control & ADC_MAGINTCR_GE) != 0u;
+      if(bGreaterEqual ? (u32Masked >= u32Threshold) : (u32Masked < u32Threshold))
+      {
+        xAdc.u32MagFlags |= 1u << u32Compare;
+      }
+    }
+  }
+  pxGroup->u32Pending &= ~(1u << xAdc.u32Channel);
+  if(pxGroup->u32Pending == 0u)
+  {
+    pxGroup->u32Flags |= ADC_FLG_END;
+    if((HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->GxMODECR[xAdc.u32Group])) &
+        (ADC_MODECR_CONT | ADC_MODECR_HWTRIG)) == ADC_MODECR_CONT)
+    {
+      pxGroup->u32Pending = HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->GxSEL[xAdc.u32Group]));
+    }
+  }
+  vAdcSchedule(u64Now);
+}
+
+/* void vAdcCalComplete(void)
+*   End of a calibration conversion of the reference selected in CALCR.
+*
+*/
+static void vAdcCalComplete(void)
+{
+  uint32_t u32Ideal;
+  if((xAdc.u32CalCr & ADC_CALCR_BRIDGE) != 0u)
+  {
+    u32Ideal = ((xAdc.u32CalCr & ADC_CALCR_HILO) != 0u) ? (5u*4096u)/8u : (3u*4096u)/8u;
+  }
+  else
+  {
+    u32Ideal = ((xAdc.u32CalCr & ADC_CALCR_HILO) != 0u) ? (uint32_t)ADC_CODE_MAX : 0u;
+  }
+  HOST_PERIPH_REG(HOST_PERIPH_ADDR(adcREG1->CALR)) = u32AdcConvert(u32Ideal);
+  xAdc.bCalBusy = false;
+  xAdc.u32CalCr &= ~ADC_CALCR_CALST;
+  HOST_xSimStats.u64AdcConversions++;
+}
+
+/* SCI */
+
+static bool bSciRead(uint32_t u32Addr)
+{
+  if(u32Addr == HOST_PERIPH_ADDR(scilinREG->FLR))
+  {
+    HOST_PERIPH_REG(u32Addr) = u32SciFlags();
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(scilinREG->INTVECT0))
+  {
+    HOST_PERIPH_REG(u32Addr) = u32SciVector();
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(scilinREG->RD))
+  {
+    HOST_PERIPH_REG(u32Addr) = xSci.u8Rd;
+    xSci.u32Flags &= ~SCI_FLR_RXRDY;
+  }
+  else if((u32Addr == HOST_PERIPH_ADDR(scilinREG->SETINT)) || (u32Addr == HOST_PERIPH_ADDR(scilinREG->CLEARINT)))
+  {
+    HOST_PERIPH_REG(u32Addr) = xSci.u32IntEna;
+  }
+  else if((u32Addr == HOST_PERIPH_ADDR(scilinREG->SETINTLVL)) ||
+          (u32Addr == HOST_PERIPH_ADDR(scilinREG->CLEARINTLVL)))
+  {
+    HOST_PERIPH_REG(u32Addr) = xSci.u32IntLvl;
+  }
+  else
+  {
+    return(false);
+  }
+  return(true);
+}
+
+static bool bSciWrite(uint32_t u32Addr, uint64_t u64Now)
+{
+  uint32_t u32Value = HOST_PERIPH_REG(u32Addr);
+  if(u32Addr == HOST_PERIPH_ADDR(scilinREG->GCR0))
+  {
+    if((u32Value & SCI_GCR0_RESET) == 0u)
+    {
+      vSciReset();
+    }
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(scilinREG->SETINT))
+  {
+    xSci.u32IntEna |= u32Value;
+    HOST_PERIPH_REG(u32Addr) = xSci.u32IntEna;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(scilinREG->CLEARINT))
+  {
+    xSci.u32IntEna &= ~u32Value;
+    HOST_PERIPH_REG(u32Addr) = xSci.u32IntEna;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(scilinREG->SETINTLVL))
+  {
+    xSci.u32IntLvl |= u32Value;
+    HOST_PERIPH_REG(u32Addr) = xSci.u32IntLvl;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(scilinREG->CLEARINTLVL))
+  {
+    xSci.u32IntLvl &= ~u32Value;
+    HOST_PERIPH_REG(u32Addr) = xSci.u32IntLvl;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(scilinREG->FLR))
+  {
+    xSci.u32Flags &= ~u32Value;
+    HOST_PERIPH_REG(u32Addr) = u32SciFlags();
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(scilinREG->TD))
+  {
+    if(!xSci.bTdFull)
+    {
+      xSci.u8Td = (uint8_t)u32Value;
+      xSci.bTdFull = true;
+      vSciShiftStart(u64Now);
+    }
+  }
+  else
+  {
+    return(false);
+  }
+  return(true);
+}
+
+/* void vSciReset(void)
+*   GCR0 reset: both buffers empty, flags and enables clear. Characters still on their way in stay queued.
+*
+*/
+static void vSciReset(void)
+{
+  xSci.u32IntEna = 0u;
+  xSci.u32IntLvl = 0u;
+  xSci.u32Flags = 0u;
+  xSci.bTdFull = false;
+  xSci.bShiftBusy = false;
+  xSci.u8Rd = 0u;
+}
+
+/* uint32_t u32SciFlags(void)
+*   FLR as the firmware sees it.
+*
+*/
+static uint32_t u32SciFlags(void)
+{
+  uint32_t u32Flags = xSci.u32Flags;
+  u32Flags |= !xSci.bTdFull ? SCI_FLR_TXRDY : 0u;
+  u32Flags |= (!xSci.bTdFull && !xSci.bShiftBusy) ? SCI_FLR_TXEMPTY : 0u;
+  return(u32Flags);
+}
+
+/* uint32_t u32SciVector(void)
+*   INTVECT0: offset of the highest priority enabled level 0 interrupt, 0 when none is pending or the SCI is held in
+*   reset.
+*
+*/
+static uint32_t u32SciVector(void)
+{
+  uint32_t u32Pending = u32SciFlags() & xSci.u32IntEna & ~xSci.u32IntLvl;
+  if(((HOST_PERIPH_REG(HOST_PERIPH_ADDR(scilinREG->GCR0)) & SCI_GCR0_RESET) == 0u) ||
+     ((HOST_PERIPH_REG(HOST_PERIPH_ADDR(scilinREG->GCR1)) & SCI_GCR1_SWNRST) == 0u))
+  {
+    return(0u);
+  }
+  if((u32Pending & SCI_FLR_PE) != 0u)
+  {
+    return(3u);
+  }
+  if((u32Pending & SCI_FLR_FE) != 0u)
+  {
+    return(6u);
+  }
+  if((u32Pending & SCI_FLR_OE) != 0u)
+  {
+    return(9u);
+  }
+  if((u32Pending & SCI_FLR_RXRDY) != 0u)
+  {
+    return(11u);
+  }
+  if((u32Pending & SCI_FLR_TXRDY) != 0u)
+  {
+    return(12u);
+  }
+  return(0u);
+}
+
+/* void vSciShiftStart(uint64_t u64Now)
+*   Moves TD into an idle shift register and starts sending it.
+*
+*/
+static void vSciShiftStart(uint64_t u64Now)
+{
+  if(xSci.bShiftBusy || !xSci.bTdFull)
+  {
+    return;
+  }
+  xSci.u8Shift = xSci.u8Td;
+  xSci.bTdFull = false;
+  xSci.bShiftBusy = true;
+  xSci.u64ShiftDone = u64Now + HOST_u64PeriphSciCharCycles();
+}
+
+/* void vSciShiftDone(uint64_t u64Now)
+*   Stop bit sent: the character goes back into the receiver in loopback, out on the link otherwise.
+*
+*/
+static void vSciShiftDone(uint64_t u64Now)
+{
+  xSci.bShiftBusy = false;
+  HOST_xSimStats.u64SciTxBytes++;
+  if((HOST_PERIPH_REG(HOST_PERIPH_ADDR(scilinREG->IODFTCTRL)) & SCI_LOOPBACK_MASK) == SCI_LOOPBACK_ON)
+  {
+    vSciArrive(xSci.u8Shift);
+  }
+  else if(xConfig.pvSciTx != 0)
+  {
+    xConfig.pvSciTx(xSci.u8Shift, u64Now);
+  }
+  vSciShiftStart(u64Now);
+}
+
+/* void vSciArrive(uint8_t u8Byte)
+*   A received character lands in RD. If the previous one was not read yet it is lost and OE is set.
+*
+*/
+static void vSciArrive(uint8_t u8Byte)
+{
+  HOST_xSimStats.u64SciRxBytes++;
+  if((xSci.u32Flags & SCI_FLR_RXRDY) != 0u)
+  {
+    xSci.u32Flags |= SCI_FLR_OE;
+  }
+  xSci.u8Rd = u8Byte;
+  xSci.u32Flags |= SCI_FLR_RXRDY;
+}
+
+/* Ports */
+
+static bool bPortRead(uint32_t u32Addr)
+{
+  uint32_t u32Offset;
+  for(uint32_t u32Port = 0u; u32Port < (uint32_t)eHOST_PortCount; u32Port++)
+  {
+    u32Offset = u32Addr - au32PortBase[u32Port];
+    if((u32Offset >= PORT_DIN) && (u32Offset <= PORT_DCLR))
+    {
+      HOST_PERIPH_REG(u32Addr) = au32Port[u32Port]; //Input buffers see the driven level
+      return(true);
+    }
+  }
+  return(false);
+}
+
+static bool bPortWrite(uint32_t u32Addr, uint64_t u64Now)
+{
+  uint32_t u32Value = HOST_PERIPH_REG(u32Addr);
+  uint32_t u32Offset;
+  uint32_t u32Old;
+  for(uint32_t u32Port = 0u; u32Port < (uint32_t)eHOST_PortCount; u32Port++)
+  {
+    u32Offset = u32Addr - au32PortBase[u32Port];
+    if((u32Offset < PORT_DOUT) || (u32Offset > PORT_DCLR))
+    {
+      continue;
+    }
+    u32Old = au32Port[u32Port];
+    if(u32Offset == PORT_DOUT)
+    {
+      au32Port[u32Port] = u32Value;
+    }
+    else if(u32Offset == PORT_DSET)
+    {
+      au32Port[u32Port] |= u32Value;
+    }
+    else
+    {
+      au32Port[u32Port] &= ~u32Value;
+    }
+    HOST_PERIPH_REG(u32Addr) = au32Port[u32Port];
+    if(au32Port[u32Port] != u32Old)
+    {
+      HOST_xSimStats.u64PinChanges++;
+      if(xConfig.pvPinChange != 0)
+      {
+        xConfig.pvPinChange((xHostPort_t)u32Port, u32Old, au32Port[u32Port], u64Now);
+      }
+    }
+    return(true);
+  }
+  return(false);
+}
+
+/* VIM, ESM, the parity RAMs, PBIST and memory initialisation */
+
+static bool bSystemRead(uint32_t u32Addr)
+{
+  if(u32Addr == HOST_PERIPH_ADDR(esmREG->SR1[0u]))
+  {
+    HOST_PERIPH_REG(u32Addr) = u32EsmFlags;
+    return(true);
+  }
+  if(u32Addr == HOST_PERIPH_ADDR(systemREG1->MSTCGSTAT))
+  {
+    HOST_PERIPH_REG(u32Addr) = u32MstcgStat;
+    return(true);
+  }
+  for(uint32_t u32Entry = 0u; u32Entry < (sizeof(axParity)/sizeof(axParity[0])); u32Entry++)
+  {
+    if((u32Addr == axParity[u32Entry].u32Ram) && (HOST_PERIPH_REG(axParity[u32Entry].u32Par) != 0u))
+    {
+      u32EsmFlags |= axParity[u32Entry].u32Esm; //Parity bits start out all correct, any flip is an error
+      return(true);
+    }
+  }
+  return(false);
+}
+
+static bool bSystemWrite(uint32_t u32Addr, uint64_t u64Now)
+{
+  uint32_t u32Value = HOST_PERIPH_REG(u32Addr);
+  if((u32Addr == HOST_PERIPH_ADDR(pbistREG->DLR)) && (u32Value == SYS_PBIST_DLR_START))
+  {
+    u32MstcgStat &= ~SYS_MSTCGSTAT_MSTDONE;
+    u64PbistDone = u64Now + SYS_PBIST_CYCLES;
+    return(true);
+  }
+  if((u32Addr == HOST_PERIPH_ADDR(systemREG1->MSINENA)) &&
+     (HOST_PERIPH_REG(HOST_PERIPH_ADDR(systemREG1->MINITGCR)) == SYS_MINITGCR_ENABLE))
+  {
+    u32MstcgStat &= ~SYS_MSTCGSTAT_MINIDONE;
+    u64MinitDone = u64Now + SYS_MINIT_CYCLES;
+    return(true);
+  }
+  if(u32Addr == HOST_PERIPH_ADDR(systemREG1->MSTCGSTAT))
+  {
+    u32MstcgStat &= ~u32Value; //Write one to clear
+    HOST_PERIPH_REG(u32Addr) = u32MstcgStat;
+    return(true);
+  }
+  if(u32Addr == HOST_PERIPH_ADDR(vimREG->REQMASKSET0))
+  {
+    au32VimMask[0] |= u32Value;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(vimREG->REQMASKSET1))
+  {
+    au32VimMask[1] |= u32Value;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(vimREG->REQMASKCLR0))
+  {
+    au32VimMask[0] &= ~u32Value;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(vimREG->REQMASKCLR1))
+  {
+    au32VimMask[1] &= ~u32Value;
+  }
+  else if(u32Addr == HOST_PERIPH_ADDR(esmREG->SR1[0u]))
+  {
+    u32EsmFlags &= ~u32Value;
+    HOST_PERIPH_REG(u32Addr) = u32EsmFlags;
+    return(true);
+  }
+  else
+  {
+    return(false);
+  }
+  HOST_PERIPH_REG(HOST_PERIPH_ADDR(vimREG->REQMASKSET0)) = au32VimMask[0];
+  HOST_PERIPH_REG(HOST_PERIPH_ADDR(vimREG->REQMASKCLR0)) = au32VimMask[0];
+  HOST_PERIPH_REG(HOST_PERIPH_ADDR(vimREG->REQMASKSET1)) = au32VimMask[1];
+  HOST_PERIPH_REG(HOST_PERIPH_ADDR(vimREG->REQMASKCLR1)) = au32VimMask[1];
+  return(true);
+}
@@ -0,0 +1,44 @@
+/** @file HOST_periph.h
+*   @brief Register models of the host simulation
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface between the access hooks in HOST_sim.c and the peripheral models in
+*   HOST_periph.c. The firmware's registers live in a plain memory window at their real addresses. A read is prepared
+*   by the model just before the firmware loads it (a FIFO pops, a counter shows the current time); a write is handed
+*   to the model once the store has landed, which then puts its read view back (write one to clear flags, set and
+*   clear register pairs). Registers without a model behave as memory.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __HOST_PERIPH_H__
+#define __HOST_PERIPH_H__
+
+/* Include Files */
+#include "HOST_sim.h"
+
+/* Defines */
+#define HOST_PERIPH_BASE 0xFF000000u //Peripheral RAMs, peripheral frames and system registers
+#define HOST_PERIPH_SIZE 0x01000000u
+
+#define HOST_PERIPH_REG(u32Addr) (*(volatile uint32_t *)(uintptr_t)(u32Addr))
+#define HOST_PERIPH_ADDR(xRegister) ((uint32_t)(uintptr_t)&(xRegister))
+
+/* Global Vars */
+extern uint64_t HOST_u64PeriphNext; //Cycle of the earliest pending peripheral event, HOST_SIM_NEVER when none
+
+/* Global Function Prototypes */
+
+void HOST_vPeriphInit(const xHostSimConfig_t *pxConfig);
+void HOST_vPeriphRead(uint32_t u32Addr, uint64_t u64Now);
+void HOST_vPeriphWrite(uint32_t u32Addr, uint64_t u64Now);
+bool HOST_bPeriphFreeRunning(uint32_t u32Addr);
+void HOST_vPeriphEvents(uint64_t u64Until);
+uint32_t HOST_u32PeriphIrq(void);
+uint32_t HOST_u32PeriphPort(xHostPort_t xPort);
+void HOST_vPeriphSciReceive(uint8_t u8Byte, uint64_t u64At);
+uint64_t HOST_u64PeriphSciCharCycles(void);
+
+#endif
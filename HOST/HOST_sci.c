@@ -0,0 +1,143 @@
+/** @file HOST_sci.c
+*   @brief Host benchmark and test of the SCI link transport
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Runs the firmware's own CPS_bSciLoopback on the host simulation, the SCI in digital loopback, at the sciInit rate
+*   and at SCI_FAST_BAUD. For each rate it prints the throughput against the line rate, the notification cost the
+*   transport measured with the PMU and the share of the CPU the interrupts took, next to the whole transfer time a
+*   polled send used to hold the CPU for. The driver's sciSend cannot be timed here, the transport owns the port.
+*
+*   Checks: every byte comes back unchanged, the transport keeps the line at least SCI_MIN_LINE_PERCENT busy, its
+*   interrupts take less than SCI_MAX_CPU_PERCENT of the CPU, and CPS_bSciWrite queues all or nothing when the ring
+*   is full.
+*
+*   Usage: HOST_sci
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include "HOST_sim.h"
+#include "CPS_sci.h"
+#include "sci.h"
+#include "sys_core.h"
+#include "sys_vim.h"
+
+/* Defines */
+#define SCI_FAST_BAUD 115200u
+#define SCI_MIN_LINE_PERCENT 95u
+#define SCI_MAX_CPU_PERCENT 5u
+
+/* Internal Vars */
+static uint8_t au8Pattern[CPS_SCI_BENCHMARK_BYTES];
+static uint32_t u32Failures;
+
+/* Local Function Prototypes */
+static void vSciRate(uint32_t u32Baud);
+static void vSciRingFull(uint64_t u64CharCycles);
+static void vSciCheck(bool bPass, const char *pcWhat);
+
+/* Global Functions */
+int main(void)
+{
+  for(uint32_t u32Byte = 0u; u32Byte < CPS_SCI_BENCHMARK_BYTES; u32Byte++)
+  {
+    au8Pattern[u32Byte] = (uint8_t)u32Byte;
+  }
+  printf("CPS SCI transport in digital loopback, %u bytes\n", CPS_SCI_BENCHMARK_BYTES);
+  vSciRate(0u);
+  vSciRate(SCI_FAST_BAUD);
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* void vSciRate(uint32_t u32Baud)
+*   Benchmarks one rate from a fresh simulation, u32Baud 0 keeps the sciInit setting.
+*
+*/
+static void vSciRate(uint32_t u32Baud)
+{
+  xHostSimConfig_t xConfig = {0, 0, 0, 0, HOST_SIM_ADC_GAIN_UNITY};
+  uint64_t u64CharCycles;
+  uint64_t u64IrqCycles;
+  uint32_t u32LineRate;
+  uint32_t u32LinePercent;
+  uint32_t u32CpuPercent;
+  bool bPassed;
+  char acWhat[96];
+  HOST_vSimInit(&xConfig);
+  vimInit();
+  sciInit();
+  if(u32Baud != 0u)
+  {
+    sciSetBaudrate(CPS_SCI_PORT, u32Baud);
+  }
+  CPS_vSciInit(0);
+  u64CharCycles = HOST_u64SimSciCharCycles();
+  u32LineRate = (uint32_t)(((uint64_t)HOST_SIM_CYCLES_PER_MS*1000u)/u64CharCycles);
+  printf("  BRS %u, %llu cycles per character, line rate %u bytes/s\n", (uint32_t)CPS_SCI_PORT->BRS,
+         (unsigned long long)u64CharCycles, u32LineRate);
+
+  u64IrqCycles = HOST_xSimStats.u64IrqCycles;
+  _enable_interrupt_();
+  bPassed = CPS_bSciLoopback(CPS_SCI_BENCHMARK_BYTES, CPS_SCI_BENCHMARK_TIMEOUT);
+  _disable_interrupt_();
+  u64IrqCycles = HOST_xSimStats.u64IrqCycles - u64IrqCycles;
+  u32LinePercent = (uint32_t)(((uint64_t)CPS_xSciBench.u32BytesPerSecond*100u)/u32LineRate);
+  u32CpuPercent = (CPS_xSciBench.u32Cycles != 0u) ? (uint32_t)((u64IrqCycles*100u)/CPS_xSciBench.u32Cycles) : 100u;
+  printf("    transport: %u bytes/s (%u%% of the line), notification mean %u cycles, worst %u, interrupts %llu cycles"
+         " (%u%% of the CPU)\n", CPS_xSciBench.u32BytesPerSecond, u32LinePercent, CPS_xSciBench.u32EventMeanCycles,
+         CPS_xSciStats.u32EventMaxCycles, (unsigned long long)u64IrqCycles, u32CpuPercent);
+  printf("    a polled send would hold the CPU %llu cycles for the same bytes\n",
+         (unsigned long long)(u64CharCycles*CPS_SCI_BENCHMARK_BYTES));
+  (void)snprintf(acWhat, sizeof(acWhat), "%u of %u bytes back unchanged, %u errors", CPS_xSciBench.u32Bytes,
+                 CPS_SCI_BENCHMARK_BYTES, CPS_xSciBench.u32Errors);
+  vSciCheck(bPassed, acWhat);
+  (void)snprintf(acWhat, sizeof(acWhat), "line kept at least %u%% busy", SCI_MIN_LINE_PERCENT);
+  vSciCheck(u32LinePercent >= SCI_MIN_LINE_PERCENT, acWhat);
+  (void)snprintf(acWhat, sizeof(acWhat), "interrupts under %u%% of the CPU", SCI_MAX_CPU_PERCENT);
+  vSciCheck(u32CpuPercent < SCI_MAX_CPU_PERCENT, acWhat);
+  vSciRingFull(u64CharCycles);
+}
+
+/* void vSciRingFull(uint64_t u64CharCycles)
+*   A write the ring cannot take whole is refused and counted, one that fits exactly goes out in full.
+*
+*/
+static void vSciRingFull(uint64_t u64CharCycles)
+{
+  uint32_t u32Dropped = CPS_xSciStats.u32TxDropped;
+  uint32_t u32Sent = CPS_xSciStats.u32TxBytes;
+  bool bRefused;
+  bool bQueued;
+  bRefused = !CPS_bSciWrite(au8Pattern, CPS_SCI_TXSIZE + 1u);
+  vSciCheck(bRefused && (CPS_u32SciTxPending() == 0u) &&
+            ((CPS_xSciStats.u32TxDropped - u32Dropped) == (CPS_SCI_TXSIZE + 1u)), "oversized write refused whole");
+  bQueued = CPS_bSciWrite(au8Pattern, CPS_SCI_TXSIZE);
+  _enable_interrupt_();
+  HOST_vSimAdvance((CPS_SCI_TXSIZE + 2u)*u64CharCycles);
+  _disable_interrupt_();
+  vSciCheck(bQueued && (CPS_u32SciTxPending() == 0u) && ((CPS_xSciStats.u32TxBytes - u32Sent) == CPS_SCI_TXSIZE),
+            "full ring queued and sent");
+}
+
+/* void vSciCheck(bool bPass, const char *pcWhat)
+*   Prints and counts one check.
+*
+*/
+static void vSciCheck(bool bPass, const char *pcWhat)
+{
+  printf("    %-70s %s\n", pcWhat, bPass ? "ok" : "FAILED");
+  u32Failures += bPass ? 0u : 1u;
+}
@@ -0,0 +1,171 @@
+/** @file HOST_sct.c
+*   @brief SCT side of the CPS/SCT link simulation
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Runs the unchanged SCT firmware on the host simulation for HOST_link, which starts this program with pipes on
+*   stdin and stdout (see HOST_link.h). Each request delivers the characters the CPS sent to the SCI receiver at their
+*   own time and runs the SCT to the end of the slice; the reply carries what the SCT sent back and every change of
+*   the actuator pins. Faults go to stderr.
+*
+*   Usage: started by HOST_link
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "HOST_link.h"
+#include "SCT_main.h"
+
+/* Internal Vars */
+static xHostLinkByte_t axTx[HOST_LINK_BYTES_MAX];
+static xHostLinkPin_t axPins[HOST_LINK_PINS_MAX];
+static xHostLinkReply_t xReply;
+
+/* Local Function Prototypes */
+static void vSctTx(uint8_t u8Byte, uint64_t u64Cycles);
+static void vSctPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles);
+static void vSctStats(void);
+static bool bSctRead(void *pvData, size_t xLength);
+static void vSctWrite(const void *pvData, size_t xLength);
+
+/* Global Functions */
+int main(void)
+{
+  xHostSimConfig_t xConfig = {0, vSctPin, vSctTx, 0, HOST_SIM_ADC_GAIN_UNITY};
+  xHostLinkRequest_t xRequest;
+  xHostLinkByte_t xByte;
+  HOST_vSimInit(&xConfig);
+  HOST_vSimStart(SCT_vMain);
+  while(bSctRead(&xRequest, sizeof(xRequest))) //HOST_link closing the pipe ends the run
+  {
+    for(uint32_t u32Byte = 0u; u32Byte < xRequest.u32Bytes; u32Byte++)
+    {
+      if(!bSctRead(&xByte, sizeof(xByte)))
+      {
+        HOST_vSimFault("link request cut short");
+      }
+      HOST_vSimSciReceive((uint8_t)xByte.u32Byte, xByte.u64At);
+    }
+    if(xRequest.u32Command == (uint32_t)eHOSTLINK_Stats)
+    {
+      vSctStats();
+      continue;
+    }
+    xReply.u32Bytes = 0u;
+    xReply.u32Pins = 0u;
+    HOST_vSimRun(xRequest.u64Until);
+    vSctWrite(&xReply, sizeof(xReply));
+    vSctWrite(axTx, xReply.u32Bytes*sizeof(axTx[0]));
+    vSctWrite(axPins, xReply.u32Pins*sizeof(axPins[0]));
+  }
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* void vSctTx(uint8_t u8Byte, uint64_t u64Cycles)
+*   A character the SCT finished sending, goes to the CPS with the reply.
+*
+*/
+static void vSctTx(uint8_t u8Byte, uint64_t u64Cycles)
+{
+  if(xReply.u32Bytes >= HOST_LINK_BYTES_MAX)
+  {
+    HOST_vSimFault("more SCT characters in a slice than the line carries");
+  }
+  axTx[xReply.u32Bytes].u64At = u64Cycles;
+  axTx[xReply.u32Bytes].u32Byte = u8Byte;
+  xReply.u32Bytes++;
+}
+
+/* void vSctPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+*   Output latch change. Only GIOA carries actuators on the SCT.
+*
+*/
+static void vSctPin(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles)
+{
+  if(xPort != eHOST_PortGioA)
+  {
+    return;
+  }
+  if(xReply.u32Pins >= HOST_LINK_PINS_MAX)
+  {
+    HOST_vSimFault("SCT pins changing faster than the link commands them");
+  }
+  axPins[xReply.u32Pins].u64At = u64Cycles;
+  axPins[xReply.u32Pins].u32Old = u32Old;
+  axPins[xReply.u32Pins].u32New = u32New;
+  xReply.u32Pins++;
+}
+
+/* void vSctStats(void)
+*   Replies with the SCT's own counts.
+*
+*/
+static void vSctStats(void)
+{
+  xHostLinkStats_t xStats;
+  xStats.u32Frames = SCT_xStats.u32Frames;
+  xStats.u32Commands = SCT_xStats.u32Commands;
+  xStats.u32PulseEnds = SCT_xStats.u32PulseEnds;
+  xStats.u32GapDrops = SCT_xStats.u32GapDrops;
+  xStats.u32Timeouts = SCT_xStats.u32Timeouts;
+  xStats.u32AckDropped = SCT_xStats.u32AckDropped;
+  xStats.u32MaxDispatchCycles = SCT_xStats.u32MaxDispatchCycles;
+  xStats.u32CrcErrors = SCT_xLinkParser.u32CrcErrors;
+  xStats.u32LengthErrors = SCT_xLinkParser.u32LengthErrors;
+  xStats.u32SeqGaps = SCT_xLinkParser.u32SeqGaps;
+  xStats.u64IrqCycles = HOST_xSimStats.u64IrqCycles;
+  xStats.u64Cycles = HOST_u64SimCycles();
+  vSctWrite(&xStats, sizeof(xStats));
+}
+
+/* bool bSctRead(void *pvData, size_t xLength)
+*   Reads exactly xLength bytes from HOST_link. Returns false when the pipe closed before the first byte.
+*
+*/
+static bool bSctRead(void *pvData, size_t xLength)
+{
+  uint8_t *pu8Data = (uint8_t *)pvData;
+  size_t xDone = 0u;
+  ssize_t xCount;
+  while(xDone < xLength)
+  {
+    xCount = read(STDIN_FILENO, &pu8Data[xDone], xLength - xDone);
+    if((xCount == 0) && (xDone == 0u))
+    {
+      return(false);
+    }
+    if(xCount <= 0)
+    {
+      HOST_vSimFault("link pipe from HOST_link broken");
+    }
+    xDone += (size_t)xCount;
+  }
+  return(true);
+}
+
+/* void vSctWrite(const void *pvData, size_t xLength)
+*   Writes exactly xLength bytes to HOST_link.
+*
+*/
+static void vSctWrite(const void *pvData, size_t xLength)
+{
+  const uint8_t *pu8Data = (const uint8_t *)pvData;
+  size_t xDone = 0u;
+  ssize_t xCount;
+  while(xDone < xLength)
+  {
+    xCount = write(STDOUT_FILENO, &pu8Data[xDone], xLength - xDone);
+    if(xCount <= 0)
+    {
+      HOST_vSimFault("link pipe to HOST_link broken");
+    }
+    xDone += (size_t)xCount;
+  }
+}
@@ -0,0 +1,566 @@
+/** @file HOST_sim.c
+*   @brief Virtual CPU of the host simulation
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   The firmware objects are built with -fsanitize=thread but linked without the sanitizer run time, so every load
+*   and store they make calls one of the __tsan_* hooks below. A hook charges the access to the virtual clock and,
+*   once the clock reaches u64SimNextStop (the next peripheral event or the run horizon), drops into vSimSync to run
+*   the due events, take interrupts and hand control back to the harness. Register reads are prepared by the models
+*   before the load; register writes are committed by the next hook, when the store has landed.
+*
+*   A firmware loop that keeps reading the same location without writing anything is a busy wait: after
+*   SIM_SPIN_READS reads the clock jumps straight to the next event. The same happens in _gotoCPUIdle_, which sleeps
+*   until any enabled interrupt line is up (with the I bit set too, as WFI does).
+*
+*   Only one firmware image can run in a process, its registers sit at fixed addresses.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include "HOST_periph.h"
+#include "sys_core.h"
+#include "sys_pmu.h"
+#include "sys_vim.h"
+#include "esm.h"
+
+/* Defines */
+#define SIM_STACK_BYTES (1024u*1024u) //Firmware stack, the target has far less
+#define SIM_SPIN_READS 32u //Reads of one location without a write in between that make a busy wait
+#define SIM_IRQ_STORM 100000u //ISRs back to back without the interrupted code getting a cycle
+#define SIM_VIM_RAM 0xFFF82000u //vimRAM, entry n + 1 is the handler of channel n
+
+/* Global Vars */
+xHostSimStats_t HOST_xSimStats;
+
+/* Internal Vars */
+static uint64_t u64SimCycles;
+static uint64_t u64SimNextStop; //Hooks call vSimSync once u64SimCycles reaches this
+static uint64_t u64SimHorizon; //End of the current HOST_vSimRun
+static uint64_t u64SimPmuBase; //Clock at the last reset of the PMU cycle counter
+static bool bSimInFirmware; //Running on the firmware coroutine inside HOST_vSimRun
+static bool bSimStarted;
+static bool bSimDone; //Firmware main returned
+static bool bSimIrqMasked; //CPSR I bit
+static bool bSimInIsr;
+static bool bSimWritePending;
+static uint32_t u32SimWriteAddr;
+static uint32_t u32SimSpinAddr;
+static uint32_t u32SimSpinReads;
+static void (*pvSimMain)(void);
+static ucontext_t xSimHostContext;
+static ucontext_t xSimFirmwareContext;
+static uint8_t *pu8SimStack;
+static bool bSimWindowMapped;
+
+/* Local Function Prototypes */
+static void vSimSync(void);
+static void vSimUpdateStop(void);
+static void vSimCommit(void);
+static void vSimDispatch(void);
+static void vSimYield(void);
+static void vSimSkip(void);
+static void vSimTrampoline(void);
+static inline void vSimAccess(const void *pvAddr, uint32_t u32Cost, bool bWrite, bool bVolatile);
+static void vSimPeriphAccess(uint32_t u32Addr, bool bWrite, bool bVolatile);
+
+/* Global Functions */
+
+/* void HOST_vSimInit(const xHostSimConfig_t *pxConfig)
+*   Maps (or clears) the register window and resets the clock and every model. Firmware RAM is not touched, so a
+*   process runs one firmware life.
+*
+*/
+void HOST_vSimInit(const xHostSimConfig_t *pxConfig)
+{
+  void *pvWindow;
+  if(!bSimWindowMapped)
+  {
+    pvWindow = mmap((void *)(uintptr_t)HOST_PERIPH_BASE, HOST_PERIPH_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if(pvWindow != (void *)(uintptr_t)HOST_PERIPH_BASE)
+    {
+      HOST_vSimFault("cannot map the register window at 0xFF000000");
+    }
+    bSimWindowMapped = true;
+  }
+  memset((void *)(uintptr_t)HOST_PERIPH_BASE, 0, HOST_PERIPH_SIZE);
+  memset(&HOST_xSimStats, 0, sizeof(HOST_xSimStats));
+  u64SimCycles = 0u;
+  u64SimHorizon = 0u;
+  u64SimPmuBase = 0u;
+  bSimIrqMasked = true; //As out of reset
+  bSimInIsr = false;
+  bSimWritePending = false;
+  u32SimSpinReads = 0u;
+  HOST_vPeriphInit(pxConfig);
+  vSimUpdateStop();
+}
+
+/* void HOST_vSimStart(void (*pvMain)(void))
+*   Sets up the firmware coroutine. pvMain runs on the first HOST_vSimRun, after vimInit and esmInit as in
+*   _c_int00.
+*
+*/
+void HOST_vSimStart(void (*pvMain)(void))
+{
+  if(bSimStarted)
+  {
+    HOST_vSimFault("firmware already started");
+  }
+  pu8SimStack = malloc(SIM_STACK_BYTES);
+  if(pu8SimStack == 0)
+  {
+    HOST_vSimFault("no memory for the firmware stack");
+  }
+  pvSimMain = pvMain;
+  (void)getcontext(&xSimFirmwareContext);
+  xSimFirmwareContext.uc_stack.ss_sp = pu8SimStack;
+  xSimFirmwareContext.uc_stack.ss_size = SIM_STACK_BYTES;
+  xSimFirmwareContext.uc_link = &xSimHostContext;
+  makecontext(&xSimFirmwareContext, vSimTrampoline, 0);
+  bSimStarted = true;
+}
+
+/* void HOST_vSimRun(uint64_t u64Until)
+*   Runs the firmware until the virtual clock reaches u64Until.
+*
+*/
+void HOST_vSimRun(uint64_t u64Until)
+{
+  if(!bSimStarted || bSimDone)
+  {
+    HOST_vSimFault("no firmware to run");
+  }
+  u64SimHorizon = u64Until;
+  while(u64SimCycles < u64SimHorizon)
+  {
+    bSimInFirmware = true;
+    vSimUpdateStop();
+    (void)swapcontext(&xSimHostContext, &xSimFirmwareContext);
+    bSimInFirmware = false;
+    if(bSimDone)
+    {
+      HOST_vSimFault("firmware main returned");
+    }
+  }
+  vSimUpdateStop();
+}
+
+/* uint64_t HOST_u64SimCycles(void)
+*   Virtual clock, CPU cycles since HOST_vSimInit.
+*
+*/
+uint64_t HOST_u64SimCycles(void)
+{
+  return(u64SimCycles);
+}
+
+/* void HOST_vSimAdvance(uint64_t u64Cycles)
+*   Moves the clock on by u64Cycles outside the coroutine, running events and taking interrupts as they come. For
+*   tests that call firmware functions straight from the harness.
+*
+*/
+void HOST_vSimAdvance(uint64_t u64Cycles)
+{
+  uint64_t u64Until = u64SimCycles + u64Cycles;
+  vSimCommit();
+  while(u64SimCycles < u64Until)
+  {
+    u64SimCycles = (HOST_u64PeriphNext < u64Until) ? HOST_u64PeriphNext : u64Until;
+    vSimSync();
+  }
+}
+
+/* uint32_t HOST_u32SimPort(xHostPort_t xPort)
+*   Output latch of a port.
+*
+*/
+uint32_t HOST_u32SimPort(xHostPort_t xPort)
+{
+  return(HOST_u32PeriphPort(xPort));
+}
+
+/* void HOST_vSimSciReceive(uint8_t u8Byte, uint64_t u64At)
+*   Delivers a character to the SCI receiver at u64At, or now if that has passed.
+*
+*/
+void HOST_vSimSciReceive(uint8_t u8Byte, uint64_t u64At)
+{
+  HOST_vPeriphSciReceive(u8Byte, (u64At < u64SimCycles) ? u64SimCycles : u64At);
+  vSimUpdateStop();
+}
+
+/* uint64_t HOST_u64SimSciCharCycles(void)
+*   Cycles per character at the SCI format and baud rate the firmware has set.
+*
+*/
+uint64_t HOST_u64SimSciCharCycles(void)
+{
+  return(HOST_u64PeriphSciCharCycles());
+}
+
+/* void HOST_vSimFault(const char *pcReason)
+*   The simulation cannot go on: reports where and exits with a failure.
+*
+*/
+void HOST_vSimFault(const char *pcReason)
+{
+  fprintf(stderr, "host sim fault at cycle %llu (%.3f ms): %s\n", (unsigned long long)u64SimCycles,
+          (double)u64SimCycles/(double)HOST_SIM_CYCLES_PER_MS, pcReason);
+  fflush(stdout);
+  exit(EXIT_FAILURE);
+}
+
+/* Access hooks, see the -fsanitize=thread flags of the firmware objects in CMakeLists.txt */
+
+void __tsan_init(void)
+{
+}
+
+void __tsan_read1(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, false, false); }
+void __tsan_read2(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, false, false); }
+void __tsan_read4(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, false, false); }
+void __tsan_read8(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, false, false); }
+void __tsan_read16(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, false, false); }
+void __tsan_write1(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, true, false); }
+void __tsan_write2(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, true, false); }
+void __tsan_write4(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, true, false); }
+void __tsan_write8(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, true, false); }
+void __tsan_write16(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, true, false); }
+void __tsan_unaligned_read2(const void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, false, false); }
+void __tsan_unaligned_read4(const void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, false, false); }
+void __tsan_unaligned_read8(const void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, false, false); }
+void __tsan_unaligned_write2(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, true, false); }
+void __tsan_unaligned_write4(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, true, false); }
+void __tsan_unaligned_write8(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_ACCESS, true, false); }
+void __tsan_volatile_read1(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_VOLATILE, false, true); }
+void __tsan_volatile_read2(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_VOLATILE, false, true); }
+void __tsan_volatile_read4(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_VOLATILE, false, true); }
+void __tsan_volatile_read8(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_VOLATILE, false, true); }
+void __tsan_volatile_write1(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_VOLATILE, true, true); }
+void __tsan_volatile_write2(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_VOLATILE, true, true); }
+void __tsan_volatile_write4(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_VOLATILE, true, true); }
+void __tsan_volatile_write8(void *pvAddr) { vSimAccess(pvAddr, HOST_SIM_COST_VOLATILE, true, true); }
+
+void __tsan_read_range(void *pvAddr, unsigned long ulSize)
+{
+  vSimAccess(pvAddr, HOST_SIM_COST_ACCESS*(uint32_t)((ulSize + 3u)/4u), false, false);
+}
+
+void __tsan_write_range(void *pvAddr, unsigned long ulSize)
+{
+  vSimAccess(pvAddr, HOST_SIM_COST_ACCESS*(uint32_t)((ulSize + 3u)/4u), true, false);
+}
+
+/* Stand ins for the sys_core and sys_pmu assembler routines */
+
+void _enable_interrupt_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+  bSimIrqMasked = false;
+  vSimSync();
+}
+
+void _disable_interrupt_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+  bSimIrqMasked = true;
+}
+
+void _disable_IRQ_interrupt_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+  bSimIrqMasked = true;
+}
+
+/* void _gotoCPUIdle_(void)
+*   WFI: the clock runs on event by event until an enabled VIM channel is requesting, then the interrupt is taken
+*   if the I bit allows it.
+*
+*/
+void _gotoCPUIdle_(void)
+{
+  uint64_t u64Start;
+  u64SimCycles += HOST_SIM_COST_CALL;
+  vSimCommit();
+  HOST_vPeriphEvents(u64SimCycles);
+  while(HOST_u32PeriphIrq() == HOST_SIM_VIM_NONE)
+  {
+    if(bSimInFirmware && (HOST_u64PeriphNext >= u64SimHorizon))
+    {
+      HOST_xSimStats.u64IdleCycles += (u64SimHorizon > u64SimCycles) ? (u64SimHorizon - u64SimCycles) : 0u;
+      u64SimCycles = (u64SimHorizon > u64SimCycles) ? u64SimHorizon : u64SimCycles;
+      vSimYield();
+      continue;
+    }
+    if(HOST_u64PeriphNext == HOST_SIM_NEVER)
+    {
+      HOST_vSimFault("WFI with no interrupt that can ever wake the core");
+    }
+    u64Start = u64SimCycles;
+    u64SimCycles = (HOST_u64PeriphNext > u64SimCycles) ? HOST_u64PeriphNext : u64SimCycles;
+    HOST_xSimStats.u64IdleCycles += u64SimCycles - u64Start;
+    HOST_vPeriphEvents(u64SimCycles);
+  }
+  vSimSync();
+}
+
+void _coreEnableRamEcc_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+}
+
+void _coreDisableRamEcc_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+}
+
+void _pmuInit_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+}
+
+void _pmuEnableCountersGlobal_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+}
+
+void _pmuDisableCountersGlobal_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+}
+
+void _pmuResetCycleCounter_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+  u64SimPmuBase = u64SimCycles;
+}
+
+void _pmuResetCounters_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+  u64SimPmuBase = u64SimCycles;
+}
+
+void _pmuStartCounters_(uint32 counters)
+{
+  (void)counters;
+  u64SimCycles += HOST_SIM_COST_CALL;
+}
+
+void _pmuStopCounters_(uint32 counters)
+{
+  (void)counters;
+  u64SimCycles += HOST_SIM_COST_CALL;
+}
+
+uint32 _pmuGetCycleCount_(void)
+{
+  u64SimCycles += HOST_SIM_COST_CALL;
+  return((uint32)(u64SimCycles - u64SimPmuBase));
+}
+
+/* Local Functions */
+
+/* void vSimAccess(const void *pvAddr, uint32_t u32Cost, bool bWrite, bool bVolatile)
+*   Hook body: charges the access and leaves the fast path only for registers, busy waits and due events.
+*
+*/
+static inline void vSimAccess(const void *pvAddr, uint32_t u32Cost, bool bWrite, bool bVolatile)
+{
+  uint32_t u32Addr = (uint32_t)(uintptr_t)pvAddr;
+  u64SimCycles += u32Cost;
+  HOST_xSimStats.u64Accesses++;
+  if(((uintptr_t)pvAddr - HOST_PERIPH_BASE) < HOST_PERIPH_SIZE)
+  {
+    vSimPeriphAccess(u32Addr, bWrite, bVolatile);
+    return;
+  }
+  if(bWrite)
+  {
+    u32SimSpinReads = 0u;
+  }
+  else if(bVolatile)
+  {
+    u32SimSpinReads = (u32Addr == u32SimSpinAddr) ? (u32SimSpinReads + 1u) : 0u;
+    u32SimSpinAddr = u32Addr;
+    if(u32SimSpinReads >= SIM_SPIN_READS)
+    {
+      vSimSkip();
+    }
+  }
+  if(u64SimCycles >= u64SimNextStop)
+  {
+    vSimSync();
+  }
+}
+
+/* void vSimPeriphAccess(uint32_t u32Addr, bool bWrite, bool bVolatile)
+*   Register access: events up to now run first, then a read is prepared or a write is queued for commit.
+*
+*/
+static void vSimPeriphAccess(uint32_t u32Addr, bool bWrite, bool bVolatile)
+{
+  (void)bVolatile;
+  HOST_xSimStats.u64PeriphAccesses++;
+  u64SimCycles += bWrite ? HOST_SIM_COST_PERIPH_WRITE : HOST_SIM_COST_PERIPH_READ;
+  vSimSync();
+  if(bWrite)
+  {
+    u32SimSpinReads = 0u;
+    bSimWritePending = true;
+    u32SimWriteAddr = u32Addr;
+    u64SimNextStop = 0u; //The next hook commits it, the store lands in between
+    return;
+  }
+  u32SimSpinReads = (u32Addr == u32SimSpinAddr) ? (u32SimSpinReads + 1u) : 0u;
+  u32SimSpinAddr = u32Addr;
+  if((u32SimSpinReads >= SIM_SPIN_READS) && !HOST_bPeriphFreeRunning(u32Addr))
+  {
+    vSimSkip();
+  }
+  HOST_vPeriphRead(u32Addr, u64SimCycles);
+}
+
+/* void vSimSync(void)
+*   Slow path: commits a register write, runs due events, takes pending interrupts and yields at the horizon.
+*
+*/
+static void vSimSync(void)
+{
+  vSimCommit();
+  HOST_vPeriphEvents(u64SimCycles);
+  if(!bSimIrqMasked && !bSimInIsr)
+  {
+    vSimDispatch();
+  }
+  if(bSimInFirmware && (u64SimCycles >= u64SimHorizon))
+  {
+    vSimYield();
+  }
+  vSimUpdateStop();
+}
+
+/* void vSimUpdateStop(void)
+*   Next cycle at which a hook has to leave the fast path.
+*
+*/
+static void vSimUpdateStop(void)
+{
+  u64SimNextStop = HOST_u64PeriphNext;
+  if(bSimInFirmware && (u64SimHorizon < u64SimNextStop))
+  {
+    u64SimNextStop = u64SimHorizon;
+  }
+  if(bSimWritePending)
+  {
+    u64SimNextStop = 0u;
+  }
+}
+
+/* void vSimCommit(void)
+*   Hands a register write whose store has landed to the models.
+*
+*/
+static void vSimCommit(void)
+{
+  if(bSimWritePending)
+  {
+    bSimWritePending = false;
+    HOST_vPeriphWrite(u32SimWriteAddr, u64SimCycles);
+  }
+}
+
+/* void vSimDispatch(void)
+*   Runs the ISR of the lowest requesting VIM channel until none is left. ISRs do not nest.
+*
+*/
+static void vSimDispatch(void)
+{
+  uint32_t u32Channel;
+  uint32_t u32Storm = 0u;
+  uint64_t u64Start;
+  t_isrFuncPTR pvIsr;
+  while((u32Channel = HOST_u32PeriphIrq()) != HOST_SIM_VIM_NONE)
+  {
+    pvIsr = ((t_isrFuncPTR volatile *)(uintptr_t)SIM_VIM_RAM)[u32Channel + 1u];
+    if(pvIsr == 0)
+    {
+      HOST_vSimFault("interrupt on a VIM channel without a handler");
+    }
+    u64Start = u64SimCycles;
+    bSimInIsr = true;
+    bSimIrqMasked = true;
+    u64SimCycles += HOST_SIM_COST_IRQ_ENTRY;
+    u32SimSpinReads = 0u;
+    pvIsr();
+    u64SimCycles += HOST_SIM_COST_IRQ_EXIT;
+    vSimCommit();
+    HOST_vPeriphEvents(u64SimCycles);
+    bSimInIsr = false;
+    bSimIrqMasked = false;
+    HOST_xSimStats.u64Irqs++;
+    HOST_xSimStats.u64IrqCycles += u64SimCycles - u64Start;
+    u32Storm++;
+    if(u32Storm > SIM_IRQ_STORM)
+    {
+      HOST_vSimFault("interrupt storm, a line stays up after its ISR");
+    }
+  }
+}
+
+/* void vSimYield(void)
+*   Back to the harness at the horizon. Returns when the next HOST_vSimRun resumes the firmware.
+*
+*/
+static void vSimYield(void)
+{
+  vSimCommit();
+  (void)swapcontext(&xSimFirmwareContext, &xSimHostContext);
+}
+
+/* void vSimSkip(void)
+*   Busy wait found: the clock jumps to the next event (or the horizon) since nothing can change before it.
+*
+*/
+static void vSimSkip(void)
+{
+  uint64_t u64Target = HOST_u64PeriphNext;
+  vSimCommit();
+  if(bSimInFirmware && (u64SimHorizon < u64Target))
+  {
+    u64Target = u64SimHorizon;
+  }
+  if(u64Target == HOST_SIM_NEVER)
+  {
+    HOST_vSimFault("busy wait on a location nothing will change");
+  }
+  if(u64Target > u64SimCycles)
+  {
+    HOST_xSimStats.u64IdleCycles += u64Target - u64SimCycles;
+    u64SimCycles = u64Target;
+  }
+  u32SimSpinReads = 0u;
+  vSimSync();
+}
+
+/* void vSimTrampoline(void)
+*   Entry of the firmware coroutine, the part of _c_int00 the firmware relies on and then its main.
+*
+*/
+static void vSimTrampoline(void)
+{
+  vimInit();
+  esmInit();
+  pvSimMain();
+  bSimDone = true;
+}
@@ -0,0 +1,101 @@
+/** @file HOST_sim.h
+*   @brief Linux host simulation of the RM42 peripherals used by the CPS and SCT
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the interface of the host target. The firmware and the HALCoGen drivers are compiled
+*   unchanged for Linux with GCC's thread sanitizer instrumentation, which calls a hook before every memory access.
+*   The hooks are implemented here instead of by the sanitizer run time: they keep a virtual CPU clock, and accesses
+*   to the peripheral window (mapped at its real address, 0xFF000000 up) go to register models of the RTI, ADC, GIO
+*   style ports, SCI, VIM and ESM. Time only moves with the accesses the firmware makes, so a run is deterministic and
+*   idle time (WFI, busy waits on a flag) costs nothing on the host.
+*
+*   The firmware runs as a coroutine. HOST_vSimRun resumes it until the virtual clock reaches the given time; the
+*   harness then changes the analog inputs or feeds the link and runs it on. Interrupts are taken between accesses
+*   while the I bit is clear and do not nest, as on the target.
+*
+*   The cycle counts are a cost model, not a cycle accurate core: every load or store costs HOST_SIM_COST_ACCESS,
+*   peripheral reads and writes the bus costs below. Timing that comes from the peripherals (RTI, conversion times,
+*   character times) is exact to the cycle.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __HOST_SIM_H__
+#define __HOST_SIM_H__
+
+/* Include Files */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines */
+#define HOST_SIM_CYCLES_PER_US 100u //HCLK and VCLK, 100MHz
+#define HOST_SIM_CYCLES_PER_MS (HOST_SIM_CYCLES_PER_US*1000u)
+#define HOST_SIM_NEVER 0xFFFFFFFFFFFFFFFFull
+
+#define HOST_SIM_COST_ACCESS 2u //Plain load or store, stands in for the instructions around it
+#define HOST_SIM_COST_VOLATILE 2u //Volatile RAM access
+#define HOST_SIM_COST_PERIPH_READ 12u //Peripheral read over the VBUSP bridge
+#define HOST_SIM_COST_PERIPH_WRITE 4u //Posted peripheral write
+#define HOST_SIM_COST_IRQ_ENTRY 30u //Exception entry, VIM vector fetch and the ISR prologue
+#define HOST_SIM_COST_IRQ_EXIT 15u
+#define HOST_SIM_COST_CALL 10u //Call into one of the assembler routines of sys_core/sys_pmu
+
+#define HOST_SIM_ADC_CONVERSION_CYCLES 120u //One 12 bit conversion, sample window and SAR at ADCLK 10MHz
+#define HOST_SIM_ADC_GAIN_UNITY 32768u
+
+#define HOST_SIM_VIM_NONE 0xFFFFFFFFu
+
+/* Global Types */
+typedef enum
+{
+  eHOST_PortGioA,
+  eHOST_PortHet1,
+  eHOST_PortSpi2,
+  eHOST_PortSpi3,
+  eHOST_PortCount
+} xHostPort_t;
+
+typedef uint16_t (*pu16HostAdcInput_t)(uint32_t u32Channel, uint64_t u64Cycles); //Ideal code of an input, 0..4095
+typedef void (*pvHostPinChange_t)(xHostPort_t xPort, uint32_t u32Old, uint32_t u32New, uint64_t u64Cycles);
+typedef void (*pvHostSciTx_t)(uint8_t u8Byte, uint64_t u64Cycles); //Stop bit of a character has left the pin
+
+typedef struct
+{
+  pu16HostAdcInput_t pu16AdcInput; //0: every input converts mid scale
+  pvHostPinChange_t pvPinChange; //0: output changes are only counted
+  pvHostSciTx_t pvSciTx; //0: characters sent on the link pins are dropped
+  int32_t i32AdcOffset; //Converter offset error in codes
+  uint32_t u32AdcGain; //Converter gain about mid scale, HOST_SIM_ADC_GAIN_UNITY = 1.0
+} xHostSimConfig_t;
+
+typedef struct
+{
+  uint64_t u64Accesses; //Instrumented loads and stores
+  uint64_t u64PeriphAccesses; //Of those, to the peripheral window
+  uint64_t u64Irqs; //ISRs run
+  uint64_t u64IrqCycles; //Cycles spent in ISRs, entry and exit included
+  uint64_t u64IdleCycles; //Cycles skipped in WFI or a busy wait on an unchanging location
+  uint64_t u64AdcConversions;
+  uint64_t u64SciTxBytes;
+  uint64_t u64SciRxBytes;
+  uint64_t u64PinChanges;
+} xHostSimStats_t;
+
+/* Global Vars */
+extern xHostSimStats_t HOST_xSimStats;
+
+/* Global Function Prototypes */
+
+void HOST_vSimInit(const xHostSimConfig_t *pxConfig);
+void HOST_vSimStart(void (*pvMain)(void));
+void HOST_vSimRun(uint64_t u64Until);
+uint64_t HOST_u64SimCycles(void);
+void HOST_vSimAdvance(uint64_t u64Cycles);
+uint32_t HOST_u32SimPort(xHostPort_t xPort);
+void HOST_vSimSciReceive(uint8_t u8Byte, uint64_t u64At);
+uint64_t HOST_u64SimSciCharCycles(void);
+void HOST_vSimFault(const char *pcReason);
+
+#endif
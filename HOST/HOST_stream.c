@@ -0,0 +1,321 @@
+/** @file HOST_stream.c
+*   @brief End to end test of the CPS raw ADC telemetry and its host decoder
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Runs the CPS firmware built with CPS_TELEMETRY_ENABLE on the host simulation and drives the horn wire as in
+*   HOST_link: idle for 0.3 to 3 s, then a horn or paddle press of 50 ms to 2 s, with noise on every conversion.
+*   Everything the link port sends is captured to <prefix>.bin and HOST_telemetry rebuilds the waveform from it into
+*   <prefix>.csv, which is read back and held against the conversions the harness fed the ADC.
+*
+*   Checks: the decoder runs cleanly, every streamed sample that was sent comes back, none was dropped and the
+*   waveform has no gap, idle included (acquisition stays awake while streaming), every sample is the code of the
+*   conversion at its time, and the line keeps up with at least STREAM_MIN_RATE samples per second. It prints the
+*   sample rate each baud of the firmware's table sustains at the measured cost.
+*
+*   Usage: HOST_stream <path of HOST_telemetry> <output prefix>
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "HOST_sim.h"
+#include "CPS_boot.h"
+#include "CPS_main.h"
+#include "CPS_telemetry.h"
+
+/* Defines */
+#define STREAM_CHANNEL 17u //Horn wire, CPS_axAcqChannels
+#define STREAM_LEVEL_IDLE 0x0E00u
+#define STREAM_LEVEL_UP 0x09B3u //Band centres
+#define STREAM_LEVEL_DOWN 0x04CBu
+#define STREAM_LEVEL_HORN 0x0128u
+#define STREAM_NOISE 8u //Peak noise in codes
+#define STREAM_DRIVE_MS 20000u
+#define STREAM_SPAN_MS 19500u //Waveform the decoder has to rebuild at least, boot and the open frame are missing
+#define STREAM_MIN_RATE 1000u //Samples per second
+#define STREAM_ALIGN_SAMPLES 64u //Decoded samples that have to match to place the waveform on the conversions
+#define STREAM_CONVERSIONS_MAX (((STREAM_DRIVE_MS + 6000u)*1000u)/CPS_FILTER_SAMPLE_US) //Last idle and press run over
+#define STREAM_CAPTURE_MAX (1u << 20u)
+#define STREAM_PATH_MAX 512u
+
+/* Internal Vars */
+static const uint16_t au16StreamLevel[3u] = {STREAM_LEVEL_HORN, STREAM_LEVEL_UP, STREAM_LEVEL_DOWN};
+
+static uint32_t u32Random = 0x2545F491u;
+static uint16_t u16Level = STREAM_LEVEL_IDLE;
+static uint16_t au16Conversions[STREAM_CONVERSIONS_MAX]; //Horn wire codes the ADC was fed, in order
+static uint32_t u32Conversions;
+static uint8_t au8Capture[STREAM_CAPTURE_MAX]; //Link port output
+static uint32_t u32Capture;
+static uint16_t au16Decoded[STREAM_CONVERSIONS_MAX]; //Waveform read back from the decoder
+static uint32_t au32DecodedAt[STREAM_CONVERSIONS_MAX]; //Its time, in conversions from the first sample
+static uint32_t u32Decoded;
+static uint32_t u32Breaks; //Empty lines the decoder put at gaps
+static uint32_t u32Failures;
+
+/* Local Function Prototypes */
+static bool bStreamDecode(const char *pcDecoder, const char *pcPrefix);
+static bool bStreamRead(const char *pcWaveform);
+static uint32_t u32StreamMismatches(void);
+static uint16_t u16StreamInput(uint32_t u32Channel, uint64_t u64Cycles);
+static void vStreamTx(uint8_t u8Byte, uint64_t u64Cycles);
+static void vStreamFirmware(void);
+static uint32_t u32StreamRandom(uint32_t u32Min, uint32_t u32Max);
+static void vStreamCheck(bool bPass, const char *pcWhat);
+
+/* Global Functions */
+int main(int argc, char **argv)
+{
+  xHostSimConfig_t xConfig = {u16StreamInput, 0, vStreamTx, 0, HOST_SIM_ADC_GAIN_UNITY};
+  uint64_t u64End = (uint64_t)STREAM_DRIVE_MS*HOST_SIM_CYCLES_PER_MS;
+  uint32_t u32Sent;
+  uint32_t u32SpanMs;
+  uint32_t u32Mismatches;
+  bool bDecoded;
+  char acWhat[96];
+  if(argc != 3)
+  {
+    fprintf(stderr, "usage: HOST_stream <path of HOST_telemetry> <output prefix>\n");
+    return(EXIT_FAILURE);
+  }
+  HOST_vSimInit(&xConfig);
+  HOST_vSimStart(vStreamFirmware);
+  while(HOST_u64SimCycles() < u64End)
+  {
+    HOST_vSimRun(HOST_u64SimCycles() + ((uint64_t)u32StreamRandom(300u, 3000u)*HOST_SIM_CYCLES_PER_MS));
+    u16Level = au16StreamLevel[u32StreamRandom(0u, 2u)];
+    HOST_vSimRun(HOST_u64SimCycles() + ((uint64_t)u32StreamRandom(50u, 2000u)*HOST_SIM_CYCLES_PER_MS));
+    u16Level = STREAM_LEVEL_IDLE;
+  }
+
+  printf("CPS telemetry of slot %u, one sample every %u us, %u s of drive time\n", CPS_TELEMETRY_SLOT,
+         CPS_TELEMETRY_PERIOD_COUNTS/CPS_TIME_COUNTS_PER_US, STREAM_DRIVE_MS/1000u);
+  printf("  firmware: %u samples, %u frames, %u bytes, %u dropped, %u gaps, encoder at most %u cycles\n",
+         CPS_xTelemetryStats.u32Samples, CPS_xTelemetryStats.u32Frames, CPS_xTelemetryStats.u32Bytes,
+         CPS_xTelemetryStats.u32Dropped, CPS_xTelemetryStats.u32Gaps, CPS_xTelemetryStats.u32MaxCycles);
+  printf("  firmware: %u samples/s at %u.%03u bytes per sample, sustained at", CPS_xTelemetryStats.u32SamplesPerSecond,
+         CPS_xTelemetryStats.u32MilliBytesPerSample/1000u, CPS_xTelemetryStats.u32MilliBytesPerSample%1000u);
+  for(uint32_t u32Baud = 0u; u32Baud < CPS_TELEMETRY_BAUDS; u32Baud++)
+  {
+    printf("%s %u baud %u samples/s (%u at worst)", (u32Baud == 0u) ? "" : ",", CPS_xTelemetryStats.au32Baud[u32Baud],
+           CPS_xTelemetryStats.au32SustainedRate[u32Baud], CPS_xTelemetryStats.au32WorstRate[u32Baud]);
+  }
+  printf("\n");
+
+  bDecoded = bStreamDecode(argv[1], argv[2]);
+  vStreamCheck(bDecoded, "HOST_telemetry rebuilt the waveform from the capture");
+  u32Sent = CPS_xTelemetryStats.u32Samples; //The open frame has not gone out yet
+  (void)snprintf(acWhat, sizeof(acWhat), "%u of %u streamed samples decoded, the rest in the open frame", u32Decoded,
+                 u32Sent);
+  vStreamCheck(bDecoded && (u32Decoded <= u32Sent) && ((u32Sent - u32Decoded) <= CPS_TELEMETRY_FRAME_SAMPLES), acWhat);
+  vStreamCheck((CPS_xTelemetryStats.u32Dropped == 0u) && (CPS_xTelemetryStats.u32Gaps == 0u) && (u32Breaks == 0u),
+               "no frame dropped, no gap in the waveform");
+  u32SpanMs = (u32Decoded != 0u) ? ((au32DecodedAt[u32Decoded - 1u]*CPS_FILTER_SAMPLE_US)/1000u) : 0u;
+  (void)snprintf(acWhat, sizeof(acWhat), "%u ms of waveform, idle included, at least %u", u32SpanMs, STREAM_SPAN_MS);
+  vStreamCheck(u32SpanMs >= STREAM_SPAN_MS, acWhat);
+  u32Mismatches = u32StreamMismatches();
+  (void)snprintf(acWhat, sizeof(acWhat), "every sample is the conversion at its time, %u differ", u32Mismatches);
+  vStreamCheck(bDecoded && (u32Mismatches == 0u), acWhat);
+  (void)snprintf(acWhat, sizeof(acWhat), "%u samples/s, at least %u, and %u baud carries them",
+                 CPS_xTelemetryStats.u32SamplesPerSecond, STREAM_MIN_RATE, CPS_TELEMETRY_BAUD);
+  vStreamCheck((CPS_xTelemetryStats.u32SamplesPerSecond >= STREAM_MIN_RATE) &&
+               (CPS_xTelemetryStats.au32SustainedRate[CPS_TELEMETRY_BAUDS - 1u] >=
+                CPS_xTelemetryStats.u32SamplesPerSecond), acWhat);
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* bool bStreamDecode(const char *pcDecoder, const char *pcPrefix)
+*   Writes the capture, runs HOST_telemetry on it and reads its waveform back.
+*
+*/
+static bool bStreamDecode(const char *pcDecoder, const char *pcPrefix)
+{
+  char acCapture[STREAM_PATH_MAX];
+  char acWaveform[STREAM_PATH_MAX];
+  FILE *pxCapture;
+  pid_t xPid;
+  int iStatus;
+  (void)snprintf(acCapture, sizeof(acCapture), "%s.bin", pcPrefix);
+  (void)snprintf(acWaveform, sizeof(acWaveform), "%s.csv", pcPrefix);
+  pxCapture = fopen(acCapture, "wb");
+  if((pxCapture == 0) || (fwrite(au8Capture, 1u, u32Capture, pxCapture) != u32Capture) || (fclose(pxCapture) != 0))
+  {
+    perror(acCapture);
+    return(false);
+  }
+  printf("  %u bytes captured to %s\n", u32Capture, acCapture);
+  fflush(stdout);
+  xPid = fork();
+  if(xPid < 0)
+  {
+    return(false);
+  }
+  if(xPid == 0)
+  {
+    (void)execl(pcDecoder, pcDecoder, acCapture, acWaveform, (char *)0);
+    perror(pcDecoder);
+    _exit(EXIT_FAILURE);
+  }
+  if((waitpid(xPid, &iStatus, 0) < 0) || !WIFEXITED(iStatus) || (WEXITSTATUS(iStatus) != EXIT_SUCCESS))
+  {
+    return(false);
+  }
+  return(bStreamRead(acWaveform));
+}
+
+/* bool bStreamRead(const char *pcWaveform)
+*   Reads the decoder's "time_us,code" lines, each time as a number of conversions from the first sample.
+*
+*/
+static bool bStreamRead(const char *pcWaveform)
+{
+  FILE *pxWaveform = fopen(pcWaveform, "r");
+  char acLine[128];
+  double dFirstUs = 0.0;
+  double dUs;
+  unsigned int uCode;
+  if(pxWaveform == 0)
+  {
+    perror(pcWaveform);
+    return(false);
+  }
+  while(fgets(acLine, sizeof(acLine), pxWaveform) != 0)
+  {
+    if(acLine[0] == '\n')
+    {
+      u32Breaks++;
+      continue;
+    }
+    if((sscanf(acLine, "%lf,%u", &dUs, &uCode) != 2) || (u32Decoded >= STREAM_CONVERSIONS_MAX))
+    {
+      continue; //Comment and column names
+    }
+    dFirstUs = (u32Decoded == 0u) ? dUs : dFirstUs;
+    au16Decoded[u32Decoded] = (uint16_t)uCode;
+    au32DecodedAt[u32Decoded] = (uint32_t)(((dUs - dFirstUs)/(double)CPS_FILTER_SAMPLE_US) + 0.5);
+    u32Decoded++;
+  }
+  (void)fclose(pxWaveform);
+  return(u32Decoded != 0u);
+}
+
+/* uint32_t u32StreamMismatches(void)
+*   Places the decoded waveform on the fed conversions where its first STREAM_ALIGN_SAMPLES match, the noise makes
+*   that place unique, and counts the samples that differ from the conversion at their time.
+*
+*/
+static uint32_t u32StreamMismatches(void)
+{
+  uint32_t u32First;
+  uint32_t u32Sample;
+  uint32_t u32Mismatches = 0u;
+  if(u32Decoded < STREAM_ALIGN_SAMPLES)
+  {
+    return(u32Decoded);
+  }
+  for(u32First = 0u; (u32First + au32DecodedAt[STREAM_ALIGN_SAMPLES - 1u]) < u32Conversions; u32First++)
+  {
+    for(u32Sample = 0u; u32Sample < STREAM_ALIGN_SAMPLES; u32Sample++)
+    {
+      if(au16Conversions[u32First + au32DecodedAt[u32Sample]] != au16Decoded[u32Sample])
+      {
+        break;
+      }
+    }
+    if(u32Sample == STREAM_ALIGN_SAMPLES)
+    {
+      break;
+    }
+  }
+  for(u32Sample = 0u; u32Sample < u32Decoded; u32Sample++)
+  {
+    if(((u32First + au32DecodedAt[u32Sample]) >= u32Conversions) ||
+       (au16Conversions[u32First + au32DecodedAt[u32Sample]] != au16Decoded[u32Sample]))
+    {
+      u32Mismatches++;
+    }
+  }
+  return(u32Mismatches);
+}
+
+/* uint16_t u16StreamInput(uint32_t u32Channel, uint64_t u64Cycles)
+*   Horn wire level plus noise, every code kept. Inputs without a ladder read idle.
+*
+*/
+static uint16_t u16StreamInput(uint32_t u32Channel, uint64_t u64Cycles)
+{
+  uint16_t u16Code;
+  (void)u64Cycles;
+  if(u32Channel != STREAM_CHANNEL)
+  {
+    return(STREAM_LEVEL_IDLE);
+  }
+  u16Code = (uint16_t)((u16Level + u32StreamRandom(0u, 2u*STREAM_NOISE)) - STREAM_NOISE);
+  if(u32Conversions < STREAM_CONVERSIONS_MAX)
+  {
+    au16Conversions[u32Conversions] = u16Code;
+    u32Conversions++;
+  }
+  return(u16Code);
+}
+
+/* void vStreamTx(uint8_t u8Byte, uint64_t u64Cycles)
+*   A character the link port finished sending, the logger's capture.
+*
+*/
+static void vStreamTx(uint8_t u8Byte, uint64_t u64Cycles)
+{
+  (void)u64Cycles;
+  if(u32Capture >= STREAM_CAPTURE_MAX)
+  {
+    HOST_vSimFault("capture full");
+  }
+  au8Capture[u32Capture] = u8Byte;
+  u32Capture++;
+}
+
+/* void vStreamFirmware(void)
+*   CPS firmware entry, what _c_int00 does before main on the target.
+*
+*/
+static void vStreamFirmware(void)
+{
+  CPS_vBootStart();
+  CPS_vMain();
+}
+
+/* uint32_t u32StreamRandom(uint32_t u32Min, uint32_t u32Max)
+*   Uniform in u32Min..u32Max from a xorshift generator, so every run is the same drive.
+*
+*/
+static uint32_t u32StreamRandom(uint32_t u32Min, uint32_t u32Max)
+{
+  u32Random ^= u32Random << 13;
+  u32Random ^= u32Random >> 17;
+  u32Random ^= u32Random << 5;
+  return(u32Min + (u32Random % (u32Max - u32Min + 1u)));
+}
+
+/* void vStreamCheck(bool bPass, const char *pcWhat)
+*   Prints and counts one check.
+*
+*/
+static void vStreamCheck(bool bPass, const char *pcWhat)
+{
+  printf("  %-90s %s\n", pcWhat, bPass ? "ok" : "FAILED");
+  u32Failures += bPass ? 0u : 1u;
+}
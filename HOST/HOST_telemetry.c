@@ -0,0 +1,159 @@
+/** @file HOST_telemetry.c
+*   @brief Host decoder of the CPS raw ADC telemetry
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Rebuilds the waveform the CPS streams with CPS_TELEMETRY_ENABLE (see CPS_telemetry.h) from a capture of the link
+*   port, the bytes exactly as a logger on the line received them. Samples frames are parsed with the firmware's own
+*   CPS_bFrameParse and CPS_u32FrameSamplesDecode, built natively. The waveform file has one "time_us,code" line per
+*   sample, time from the first sample; a frame that does not start one period after the previous one ends is
+*   preceded by an empty line, so plotting tools break the trace at the gap.
+*
+*   Prints the frames, the CRC and length errors and SEQ gaps of the capture, the time gaps in the waveform, the
+*   sample rate and the line bytes per sample, and from those the sample rate each baud sustains.
+*
+*   Usage: HOST_telemetry <capture> <waveform file>
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include "CPS_frame.h"
+#include "CPS_telemetry.h"
+
+/* Defines */
+#define TELEMETRY_BAUDS 4u
+
+/* Internal Vars */
+static const uint32_t au32TelemetryBauds[TELEMETRY_BAUDS] = {9600u, 19200u, 57600u, 115200u};
+static xCPSFrameParser_t xParser;
+static uint16_t au16Samples[CPS_TELEMETRY_FRAME_SAMPLES + 1u]; //Room for one more shows a frame that holds too many
+static uint64_t u64Bytes; //Capture bytes
+static uint64_t u64FrameBytes; //Line bytes of the samples frames
+static uint32_t u32Frames; //Samples frames decoded
+static uint32_t u32Others; //Intact frames of another type
+static uint32_t u32Rejected; //Intact samples frames that did not decode
+static uint64_t u64Samples;
+static uint32_t u32Gaps;
+static bool bStarted; //A sample has been written
+static uint32_t u32LastStamp; //Stamp of the last frame
+static int64_t i64LastCounts; //Its time from the first sample, in RTI counts
+static int64_t i64NextCounts; //Time the next sample is due at
+
+/* Local Function Prototypes */
+static void vTelemetryFrame(FILE *pxWaveform);
+
+/* Global Functions */
+int main(int argc, char **argv)
+{
+  FILE *pxCapture;
+  FILE *pxWaveform;
+  double dSpanUs;
+  double dBytesPerSample;
+  int iByte;
+  if(argc != 3)
+  {
+    fprintf(stderr, "usage: HOST_telemetry <capture> <waveform file>\n");
+    return(EXIT_FAILURE);
+  }
+  pxCapture = fopen(argv[1], "rb");
+  if(pxCapture == 0)
+  {
+    perror(argv[1]);
+    return(EXIT_FAILURE);
+  }
+  pxWaveform = fopen(argv[2], "w");
+  if(pxWaveform == 0)
+  {
+    perror(argv[2]);
+    (void)fclose(pxCapture);
+    return(EXIT_FAILURE);
+  }
+  fprintf(pxWaveform, "# CPS telemetry, slot %u, one sample every %u us\n", CPS_TELEMETRY_SLOT,
+          CPS_TELEMETRY_PERIOD_COUNTS/CPS_TIME_COUNTS_PER_US);
+  fprintf(pxWaveform, "time_us,code\n");
+  CPS_vFrameParserReset(&xParser);
+  while((iByte = fgetc(pxCapture)) != EOF)
+  {
+    u64Bytes++;
+    if(CPS_bFrameParse(&xParser, (uint8_t)iByte))
+    {
+      vTelemetryFrame(pxWaveform);
+    }
+  }
+  (void)fclose(pxCapture);
+  if(fclose(pxWaveform) != 0)
+  {
+    perror(argv[2]);
+    return(EXIT_FAILURE);
+  }
+
+  printf("capture: %llu bytes, %u samples frames, %u other frames, %u CRC errors, %u length errors, %u SEQ gaps, "
+         "%u samples frames rejected\n", (unsigned long long)u64Bytes, u32Frames, u32Others, xParser.u32CrcErrors,
+         xParser.u32LengthErrors, xParser.u32SeqGaps, u32Rejected);
+  if(u64Samples == 0u)
+  {
+    printf("no samples\n");
+    return(EXIT_FAILURE);
+  }
+  dSpanUs = (double)(i64NextCounts - CPS_TELEMETRY_PERIOD_COUNTS)/(double)CPS_TIME_COUNTS_PER_US;
+  dBytesPerSample = (double)u64FrameBytes/(double)u64Samples;
+  printf("waveform: %llu samples over %.1f ms, %u gaps, %.0f samples/s\n", (unsigned long long)u64Samples,
+         dSpanUs/1000.0, u32Gaps, (dSpanUs > 0.0) ? (((double)(u64Samples - 1u)*1e6)/dSpanUs) : 0.0);
+  printf("line: %.3f bytes per sample, sustained at", dBytesPerSample);
+  for(uint32_t u32Baud = 0u; u32Baud < TELEMETRY_BAUDS; u32Baud++)
+  {
+    printf("%s %u baud %.0f samples/s", (u32Baud == 0u) ? "" : ",", au32TelemetryBauds[u32Baud],
+           ((double)au32TelemetryBauds[u32Baud]/(double)CPS_FRAME_BITS_PER_BYTE)/dBytesPerSample);
+  }
+  printf("\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* void vTelemetryFrame(FILE *pxWaveform)
+*   A frame parsed intact. Samples frames are written out at their stamp, unwrapped from the 32 bit RTI count.
+*
+*/
+static void vTelemetryFrame(FILE *pxWaveform)
+{
+  uint32_t u32Stamp;
+  uint32_t u32Count;
+  int64_t i64Counts;
+  if(xParser.u8Type != (uint8_t)eFRAME_Samples)
+  {
+    u32Others++;
+    return;
+  }
+  u32Count = CPS_u32FrameSamplesDecode(xParser.au8Payload, xParser.u8Length, &u32Stamp, au16Samples,
+                                       CPS_TELEMETRY_FRAME_SAMPLES + 1u);
+  if(u32Count == 0u)
+  {
+    u32Rejected++;
+    return;
+  }
+  i64Counts = bStarted ? (i64LastCounts + (int32_t)(u32Stamp - u32LastStamp)) : 0; //Frames are seconds apart at most
+  if(bStarted && (((i64Counts - i64NextCounts) > (int64_t)(CPS_TELEMETRY_PERIOD_COUNTS/2u)) ||
+                  ((i64NextCounts - i64Counts) > (int64_t)(CPS_TELEMETRY_PERIOD_COUNTS/2u))))
+  {
+    fprintf(pxWaveform, "\n");
+    u32Gaps++;
+  }
+  for(uint32_t u32Sample = 0u; u32Sample < u32Count; u32Sample++)
+  {
+    fprintf(pxWaveform, "%.1f,%u\n",
+            (double)(i64Counts + ((int64_t)u32Sample*CPS_TELEMETRY_PERIOD_COUNTS))/(double)CPS_TIME_COUNTS_PER_US,
+            au16Samples[u32Sample]);
+  }
+  bStarted = 1;
+  u32LastStamp = u32Stamp;
+  i64LastCounts = i64Counts;
+  i64NextCounts = i64Counts + ((int64_t)u32Count*CPS_TELEMETRY_PERIOD_COUNTS);
+  u32Frames++;
+  u64Samples += u32Count;
+  u64FrameBytes += (uint64_t)xParser.u8Length + CPS_FRAME_OVERHEAD;
+}
@@ -0,0 +1,171 @@
+/** @file HOST_time.c
+*   @brief Host test of the 64 bit monotonic clock
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Runs CPS_time.c on the host simulation for TIME_RUN_S, past two wraps of RTI FRC0, and reads CPS_u64TimeNow every
+*   TIME_STEP_MS with the epoch timer interrupt enabled. Every read must lie between the virtual clock before and
+*   after the call and no read may be below the one before it. The wraps land between two epoch snapshots, so reads
+*   take the "counter below the snapshot" path for most of a minute each time.
+*
+*   Around every epoch snapshot CPS_u64TimeNow is called back to back until the epoch interrupt has run inside one of
+*   the calls. A call the interrupt lands in between its first and last sequence read has to read the snapshot again:
+*   it costs more cycles outside the ISR than a plain call, and its result must still be in range. The test fails if
+*   no epoch hit such a window, as the retry would then not have been covered.
+*
+*   Usage: HOST_time
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include "HOST_sim.h"
+#include "CPS_time.h"
+#include "CPS_timer.h"
+#include "rti.h"
+#include "sys_core.h"
+#include "sys_vim.h"
+
+/* Defines */
+#define TIME_RUN_S 1000u //FRC0 wraps every 429.5s
+#define TIME_STEP_MS 10u
+#define TIME_CYCLES_PER_COUNT (HOST_SIM_CYCLES_PER_US/CPS_TIME_COUNTS_PER_US)
+#define TIME_EPOCH_LEAD_MS 2u //Back to back reads start this long before a snapshot is due
+#define TIME_BURST_MAX 100000u //Reads per snapshot at most, a few ms
+#define TIME_WRAP_COUNTS 0x100000000ull
+
+/* Internal Vars */
+static uint64_t u64StartCycles; //Virtual clock at the first read
+static uint64_t u64StartCounts; //And that read
+static uint64_t u64LastCounts;
+static uint64_t u64PlainCycles = HOST_SIM_NEVER; //Cheapest call, no interrupt and no retry
+static uint32_t u32Reads;
+static uint32_t u32OutOfRange;
+static uint32_t u32Backwards;
+static uint32_t u32Failures;
+
+/* Local Function Prototypes */
+static uint64_t u64TimeRead(bool *pbIrq, uint64_t *pu64Cycles);
+static void vTimeCheck(bool bPass, const char *pcWhat);
+
+/* Global Functions */
+int main(void)
+{
+  xHostSimConfig_t xConfig = {0, 0, 0, 0, HOST_SIM_ADC_GAIN_UNITY};
+  uint64_t u64EndCycles;
+  uint64_t u64NextEpoch;
+  uint64_t u64Counts;
+  uint64_t u64Cycles;
+  uint32_t u32Wraps = 0u;
+  uint32_t u32Epochs = 0u;
+  uint32_t u32Hit = 0u; //Epochs that ran inside a call
+  uint32_t u32Retried = 0u; //Of those, calls that read the snapshot again
+  uint32_t u32Burst;
+  bool bIrq;
+  char acWhat[96];
+  HOST_vSimInit(&xConfig);
+  vimInit();
+  rtiInit();
+  CPS_vTimerInit();
+  CPS_vTimeInit();
+  rtiStartCounter(rtiCOUNTER_BLOCK0);
+  _enable_interrupt_();
+  u64StartCycles = HOST_u64SimCycles();
+  u64StartCounts = CPS_u64TimeNow();
+  u64LastCounts = u64StartCounts;
+  u64NextEpoch = u64StartCycles + ((uint64_t)CPS_TIME_EPOCH_MS*HOST_SIM_CYCLES_PER_MS);
+  u64EndCycles = u64StartCycles + ((uint64_t)TIME_RUN_S*1000u*HOST_SIM_CYCLES_PER_MS);
+  printf("CPS_u64TimeNow over %u s, epoch snapshot every %u ms\n", TIME_RUN_S, CPS_TIME_EPOCH_MS);
+  (void)u64TimeRead(&bIrq, &u64Cycles); //Warm, so the cheapest call is known before the first epoch
+  while(HOST_u64SimCycles() < u64EndCycles)
+  {
+    if((HOST_u64SimCycles() + ((uint64_t)(TIME_STEP_MS + TIME_EPOCH_LEAD_MS)*HOST_SIM_CYCLES_PER_MS)) >= u64NextEpoch)
+    {
+      u64Cycles = u64NextEpoch - ((uint64_t)TIME_EPOCH_LEAD_MS*HOST_SIM_CYCLES_PER_MS);
+      if(u64Cycles > HOST_u64SimCycles())
+      {
+        HOST_vSimAdvance(u64Cycles - HOST_u64SimCycles());
+      }
+      u32Epochs++;
+      bIrq = false;
+      for(u32Burst = 0u; (u32Burst < TIME_BURST_MAX) && !bIrq; u32Burst++)
+      {
+        (void)u64TimeRead(&bIrq, &u64Cycles);
+      }
+      if(bIrq)
+      {
+        u32Hit++;
+        u32Retried += (u64Cycles > u64PlainCycles) ? 1u : 0u;
+      }
+      u64NextEpoch = HOST_u64SimCycles() + ((uint64_t)CPS_TIME_EPOCH_MS*HOST_SIM_CYCLES_PER_MS);
+    }
+    HOST_vSimAdvance((uint64_t)TIME_STEP_MS*HOST_SIM_CYCLES_PER_MS);
+    u64Counts = u64TimeRead(&bIrq, &u64Cycles);
+    u32Wraps = (uint32_t)(u64Counts/TIME_WRAP_COUNTS);
+  }
+  _disable_interrupt_();
+
+  (void)snprintf(acWhat, sizeof(acWhat), "%u reads over %u FRC0 wraps, all within the virtual clock", u32Reads,
+                 u32Wraps);
+  vTimeCheck((u32Wraps >= 2u) && (u32OutOfRange == 0u), acWhat);
+  (void)snprintf(acWhat, sizeof(acWhat), "no read below the one before it, %u were", u32Backwards);
+  vTimeCheck(u32Backwards == 0u, acWhat);
+  (void)snprintf(acWhat, sizeof(acWhat), "%u of %u snapshots landed inside a read, %u of those read it again",
+                 u32Hit, u32Epochs, u32Retried);
+  vTimeCheck(u32Retried != 0u, acWhat);
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* uint64_t u64TimeRead(bool *pbIrq, uint64_t *pu64Cycles)
+*   One CPS_u64TimeNow call, checked against the virtual clock before and after it and against the previous read.
+*   Reports whether an interrupt ran inside the call and the cycles the call took outside of it.
+*
+*/
+static uint64_t u64TimeRead(bool *pbIrq, uint64_t *pu64Cycles)
+{
+  uint64_t u64Irqs = HOST_xSimStats.u64Irqs;
+  uint64_t u64IrqCycles = HOST_xSimStats.u64IrqCycles;
+  uint64_t u64Before = HOST_u64SimCycles();
+  uint64_t u64Counts = CPS_u64TimeNow();
+  uint64_t u64After = HOST_u64SimCycles();
+  uint64_t u64Low = u64StartCounts + ((u64Before - u64StartCycles)/TIME_CYCLES_PER_COUNT);
+  uint64_t u64High = u64StartCounts + ((u64After - u64StartCycles)/TIME_CYCLES_PER_COUNT) + 1u;
+  *pbIrq = HOST_xSimStats.u64Irqs != u64Irqs;
+  *pu64Cycles = (u64After - u64Before) - (HOST_xSimStats.u64IrqCycles - u64IrqCycles);
+  if(!*pbIrq && (*pu64Cycles < u64PlainCycles))
+  {
+    u64PlainCycles = *pu64Cycles;
+  }
+  u32Reads++;
+  if(((u64Counts + 1u) < u64Low) || (u64Counts > u64High))
+  {
+    u32OutOfRange++;
+  }
+  if(u64Counts < u64LastCounts)
+  {
+    u32Backwards++;
+  }
+  u64LastCounts = u64Counts;
+  return(u64Counts);
+}
+
+/* void vTimeCheck(bool bPass, const char *pcWhat)
+*   Prints and counts one check.
+*
+*/
+static void vTimeCheck(bool bPass, const char *pcWhat)
+{
+  printf("  %-90s %s\n", pcWhat, bPass ? "ok" : "FAILED");
+  u32Failures += bPass ? 0u : 1u;
+}
@@ -0,0 +1,402 @@
+/** @file HOST_timer.c
+*   @brief Host test of the CPS software timers
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   Arms, cancels and re-arms timers from the harness and from inside timer callbacks and checks every callback
+*   against a model of what should be armed: no callback before its deadline or later than TIMER_LATE_US after it, no
+*   callback of a timer that was cancelled or re-armed, and CPS_bTimerArmed in step with the model throughout. Two
+*   fixed cases cover callbacks that cancel or re-arm timers expiring on the same tick, then TIMER_RANDOM_MS of random
+*   traffic with deadlines on the same tick and across the wheel levels.
+*
+*   Built twice: HOST_timer runs the tickless backend on the host simulation, compare1 interrupts included, and
+*   HOST_timer_wheel builds CPS_timer.c natively with CPS_TIMER_TICKLESS=0 and calls CPS_vTimerTick itself.
+*
+*   Usage: HOST_timer [seed]
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include <stdio.h>
+#include <stdlib.h>
+#include "CPS_timer.h"
+#if CPS_TIMER_TICKLESS
+#include "HOST_sim.h"
+#include "rti.h"
+#include "sys_core.h"
+#include "sys_vim.h"
+#endif
+
+/* Defines */
+#define TIMER_COUNT 8u
+#define TIMER_STEP_MS 2u //Harness step, one wheel tick
+#define TIMER_RANDOM_MS 600000u
+#define TIMER_SHORT_MS 20u //Most delays are short so timers keep landing on the same tick
+#define TIMER_LONG_MS 1000u //The rest reach into wheel level 1
+#define TIMER_REPORT_MAX 10u
+#if CPS_TIMER_TICKLESS
+#define TIMER_EARLY_US 1u //Deadlines resolve to one RTI count
+#define TIMER_LATE_US 50u //Compare1 interrupt latency
+#define TIMER_BACKEND "tickless, on the host simulation"
+#else
+#define TIMER_EARLY_US 0u
+#define TIMER_LATE_US (CPS_TIMER_TICK_MS*1000u) //Delays round up to whole ticks
+#define TIMER_BACKEND "wheel"
+#endif
+
+/* Internal Types */
+typedef struct
+{
+  bool bArmed;
+  uint64_t u64DeadlineUs;
+  uint32_t u32Fired;
+} xTimerModel_t;
+
+typedef void (*xTimerAction_t)(uint32_t u32Timer);
+
+/* Internal Vars */
+static xCPSTimer_t axTimer[TIMER_COUNT];
+static xTimerModel_t axModel[TIMER_COUNT];
+static xTimerAction_t pvTimerAction; //What a callback does once it has been checked
+static uint32_t u32Random = 0x6C078965u;
+static uint32_t u32Failures;
+static uint32_t u32Fires;
+static uint32_t u32CallbackArms;
+static uint32_t u32CallbackCancels;
+#if !CPS_TIMER_TICKLESS
+static uint64_t u64WheelUs; //Time of the last CPS_vTimerTick
+#endif
+
+/* Local Function Prototypes */
+static uint64_t u64TimerNowUs(void);
+static void vTimerRun(uint32_t u32Ms);
+static void vTimerArm(uint32_t u32Timer, uint32_t u32Ms);
+static void vTimerCancel(uint32_t u32Timer);
+static void vTimerFired(uint32_t u32Timer);
+static void vTimerFail(const char *pcWhat, uint32_t u32Timer);
+static void vTimerCheckArmed(void);
+static bool bTimerSettle(void);
+static uint32_t u32TimerRandom(uint32_t u32Range);
+static void vTimerCancelOthers(uint32_t u32Timer);
+static void vTimerRearmOther(uint32_t u32Timer);
+static void vTimerRandomAction(uint32_t u32Timer);
+static void vTimerCallback0(void);
+static void vTimerCallback1(void);
+static void vTimerCallback2(void);
+static void vTimerCallback3(void);
+static void vTimerCallback4(void);
+static void vTimerCallback5(void);
+static void vTimerCallback6(void);
+static void vTimerCallback7(void);
+
+static const xCPSTimerCallback_t apvTimerCallback[TIMER_COUNT] =
+{
+  vTimerCallback0, vTimerCallback1, vTimerCallback2, vTimerCallback3,
+  vTimerCallback4, vTimerCallback5, vTimerCallback6, vTimerCallback7
+};
+
+/* Global Functions */
+int main(int argc, char **argv)
+{
+  uint32_t u32Fired;
+  uint64_t u64StartUs;
+#if CPS_TIMER_TICKLESS
+  xHostSimConfig_t xConfig = {0, 0, 0, 0, HOST_SIM_ADC_GAIN_UNITY};
+#endif
+  if(argc > 1)
+  {
+    u32Random = ((uint32_t)strtoul(argv[1], 0, 0)*0x9E3779B9u) ^ 0x6C078965u;
+  }
+#if CPS_TIMER_TICKLESS
+  HOST_vSimInit(&xConfig);
+  vimInit();
+  rtiInit();
+  CPS_vTimerInit();
+  rtiStartCounter(rtiCOUNTER_BLOCK0);
+#else
+  CPS_vTimerInit();
+#endif
+  printf("CPS software timers, %s backend\n", TIMER_BACKEND);
+
+  //Three timers on the same tick, the first callback cancels the other two
+  pvTimerAction = vTimerCancelOthers;
+  vTimerArm(0u, 10u);
+  vTimerArm(1u, 10u);
+  vTimerArm(2u, 10u);
+  u32Fired = u32Fires;
+  vTimerRun(30u);
+  printf("  callback cancels two timers due on its own tick: %u of 3 fired\n", u32Fires - u32Fired);
+  if((u32Fires - u32Fired) != 1u)
+  {
+    vTimerFail("cancelled timer fired", TIMER_COUNT);
+  }
+
+  //Two timers on the same tick, the first callback re-arms the other 20ms on
+  pvTimerAction = vTimerRearmOther;
+  u64StartUs = u64TimerNowUs();
+  vTimerArm(3u, 10u);
+  vTimerArm(4u, 10u);
+  u32Fired = u32Fires;
+  vTimerRun(50u);
+  printf("  callback re-arms a timer due on its own tick: %u fired, last %llu us after the arm\n", u32Fires - u32Fired,
+         (unsigned long long)(((axModel[3].u32Fired > axModel[4].u32Fired) ? axModel[3].u64DeadlineUs :
+                                                                           axModel[4].u64DeadlineUs) - u64StartUs));
+  if((u32Fires - u32Fired) != 2u)
+  {
+    vTimerFail("re-armed timer fired on its old deadline or not at all", TIMER_COUNT);
+  }
+
+  //Random traffic from the harness and from the callbacks
+  pvTimerAction = vTimerRandomAction;
+  u32Fired = u32Fires;
+  for(uint32_t u32Ms = 0u; u32Ms < TIMER_RANDOM_MS; u32Ms += TIMER_STEP_MS)
+  {
+    if(u32TimerRandom(4u) == 0u)
+    {
+      if(u32TimerRandom(4u) == 0u)
+      {
+        vTimerCancel(u32TimerRandom(TIMER_COUNT));
+      }
+      else
+      {
+        vTimerArm(u32TimerRandom(TIMER_COUNT), 0u);
+      }
+    }
+    vTimerRun(TIMER_STEP_MS);
+    vTimerCheckArmed();
+  }
+  pvTimerAction = 0;
+  printf("  %u ms of random traffic: %u callbacks, %u arms and %u cancels from inside callbacks\n", TIMER_RANDOM_MS,
+         u32Fires - u32Fired, u32CallbackArms, u32CallbackCancels);
+  if(!bTimerSettle())
+  {
+    vTimerFail("timer still armed long after its deadline", TIMER_COUNT);
+  }
+  if(u32Failures != 0u)
+  {
+    printf("FAIL\n");
+    return(EXIT_FAILURE);
+  }
+  printf("PASS\n");
+  return(EXIT_SUCCESS);
+}
+
+/* Local Functions */
+
+/* uint64_t u64TimerNowUs(void)
+*   Harness time: the virtual clock, or the wheel ticks given so far.
+*
+*/
+static uint64_t u64TimerNowUs(void)
+{
+#if CPS_TIMER_TICKLESS
+  return(HOST_u64SimCycles()/HOST_SIM_CYCLES_PER_US);
+#else
+  return(u64WheelUs);
+#endif
+}
+
+/* void vTimerRun(uint32_t u32Ms)
+*   Lets u32Ms pass with the timer interrupt enabled. Timers due on the way fire.
+*
+*/
+static void vTimerRun(uint32_t u32Ms)
+{
+#if CPS_TIMER_TICKLESS
+  _enable_interrupt_();
+  HOST_vSimAdvance((uint64_t)u32Ms*HOST_SIM_CYCLES_PER_MS);
+  _disable_interrupt_();
+#else
+  for(uint32_t u32Tick = 0u; u32Tick < (u32Ms/CPS_TIMER_TICK_MS); u32Tick++)
+  {
+    u64WheelUs += CPS_TIMER_TICK_MS*1000u;
+    CPS_vTimerTick();
+  }
+#endif
+}
+
+/* void vTimerArm(uint32_t u32Timer, uint32_t u32Ms)
+*   Arms a timer in the firmware and in the model. u32Ms 0 picks a random delay.
+*
+*/
+static void vTimerArm(uint32_t u32Timer, uint32_t u32Ms)
+{
+  if(u32Ms == 0u)
+  {
+    u32Ms = (u32TimerRandom(4u) != 0u) ? (1u + u32TimerRandom(TIMER_SHORT_MS)) : (1u + u32TimerRandom(TIMER_LONG_MS));
+  }
+  axModel[u32Timer].bArmed = true;
+  axModel[u32Timer].u64DeadlineUs = u64TimerNowUs() + ((uint64_t)u32Ms*1000u);
+  CPS_vTimerArm(&axTimer[u32Timer], u32Ms, apvTimerCallback[u32Timer]);
+}
+
+/* void vTimerCancel(uint32_t u32Timer)
+*   Cancels a timer in the firmware and in the model, armed or not.
+*
+*/
+static void vTimerCancel(uint32_t u32Timer)
+{
+  axModel[u32Timer].bArmed = false;
+  CPS_vTimerCancel(&axTimer[u32Timer]);
+}
+
+/* void vTimerFired(uint32_t u32Timer)
+*   Body of every callback: the timer must be armed in the model and due, then the scenario's action runs.
+*
+*/
+static void vTimerFired(uint32_t u32Timer)
+{
+  uint64_t u64NowUs = u64TimerNowUs();
+  xTimerModel_t *pxModel = &axModel[u32Timer];
+  u32Fires++;
+  if(!pxModel->bArmed)
+  {
+    vTimerFail("callback of a cancelled or already fired timer", u32Timer);
+  }
+  else if((u64NowUs + TIMER_EARLY_US) < pxModel->u64DeadlineUs)
+  {
+    vTimerFail("callback before the deadline", u32Timer);
+  }
+  else if(u64NowUs > (pxModel->u64DeadlineUs + TIMER_LATE_US))
+  {
+    vTimerFail("callback late", u32Timer);
+  }
+  pxModel->bArmed = false;
+  pxModel->u64DeadlineUs = u64NowUs;
+  pxModel->u32Fired = u32Fires;
+  if(CPS_bTimerArmed(&axTimer[u32Timer]))
+  {
+    vTimerFail("timer still armed in its own callback", u32Timer);
+  }
+  if(pvTimerAction != 0)
+  {
+    pvTimerAction(u32Timer);
+  }
+}
+
+/* void vTimerFail(const char *pcWhat, uint32_t u32Timer)
+*   Reports a failure, TIMER_COUNT for one that is not about a single timer.
+*
+*/
+static void vTimerFail(const char *pcWhat, uint32_t u32Timer)
+{
+  if(u32Failures < TIMER_REPORT_MAX)
+  {
+    if(u32Timer < TIMER_COUNT)
+    {
+      printf("  %s: timer %u at %llu us, deadline %llu us\n", pcWhat, u32Timer, (unsigned long long)u64TimerNowUs(),
+             (unsigned long long)axModel[u32Timer].u64DeadlineUs);
+    }
+    else
+    {
+      printf("  %s\n", pcWhat);
+    }
+  }
+  u32Failures++;
+}
+
+/* void vTimerCheckArmed(void)
+*   CPS_bTimerArmed must match the model, and no armed timer may be overdue.
+*
+*/
+static void vTimerCheckArmed(void)
+{
+  for(uint32_t u32Timer = 0u; u32Timer < TIMER_COUNT; u32Timer++)
+  {
+    if(CPS_bTimerArmed(&axTimer[u32Timer]) != axModel[u32Timer].bArmed)
+    {
+      vTimerFail("CPS_bTimerArmed out of step", u32Timer);
+      axModel[u32Timer].bArmed = CPS_bTimerArmed(&axTimer[u32Timer]); //Report once
+    }
+    else if(axModel[u32Timer].bArmed && (u64TimerNowUs() > (axModel[u32Timer].u64DeadlineUs + TIMER_LATE_US)))
+    {
+      vTimerFail("timer missed its deadline", u32Timer);
+      vTimerCancel(u32Timer);
+    }
+  }
+}
+
+/* bool bTimerSettle(void)
+*   Runs on with no new arms past the longest delay. Returns 1 when every timer has fired.
+*
+*/
+static bool bTimerSettle(void)
+{
+  bool bIdle = true;
+  vTimerRun(TIMER_LONG_MS + TIMER_STEP_MS);
+  vTimerCheckArmed();
+  for(uint32_t u32Timer = 0u; u32Timer < TIMER_COUNT; u32Timer++)
+  {
+    bIdle = bIdle && !CPS_bTimerArmed(&axTimer[u32Timer]);
+  }
+  return(bIdle);
+}
+
+/* uint32_t u32TimerRandom(uint32_t u32Range)
+*   xorshift, 0..u32Range-1.
+*
+*/
+static uint32_t u32TimerRandom(uint32_t u32Range)
+{
+  u32Random ^= u32Random << 13;
+  u32Random ^= u32Random >> 17;
+  u32Random ^= u32Random << 5;
+  return(u32Random % u32Range);
+}
+
+static void vTimerCancelOthers(uint32_t u32Timer)
+{
+  for(uint32_t u32Other = 0u; u32Other < TIMER_COUNT; u32Other++)
+  {
+    if(u32Other != u32Timer)
+    {
+      vTimerCancel(u32Other);
+    }
+  }
+}
+
+static void vTimerRearmOther(uint32_t u32Timer)
+{
+  uint32_t u32Other = (u32Timer == 3u) ? 4u : 3u;
+  if(axModel[u32Other].bArmed)
+  {
+    vTimerArm(u32Other, 20u);
+  }
+}
+
+/* void vTimerRandomAction(uint32_t u32Timer)
+*   Random traffic from inside a callback: re-arm itself, arm or cancel another timer, or nothing.
+*
+*/
+static void vTimerRandomAction(uint32_t u32Timer)
+{
+  uint32_t u32Other = u32TimerRandom(TIMER_COUNT);
+  switch(u32TimerRandom(4u))
+  {
+  case 0u:
+    vTimerArm(u32Timer, 0u);
+    u32CallbackArms++;
+    break;
+  case 1u:
+    vTimerArm(u32Other, 0u);
+    u32CallbackArms++;
+    break;
+  case 2u:
+    vTimerCancel(u32Other);
+    u32CallbackCancels++;
+    break;
+  default:
+    break;
+  }
+}
+
+static void vTimerCallback0(void) { vTimerFired(0u); }
+static void vTimerCallback1(void) { vTimerFired(1u); }
+static void vTimerCallback2(void) { vTimerFired(2u); }
+static void vTimerCallback3(void) { vTimerFired(3u); }
+static void vTimerCallback4(void) { vTimerFired(4u); }
+static void vTimerCallback5(void) { vTimerFired(5u); }
+static void vTimerCallback6(void) { vTimerFired(6u); }
+static void vTimerCallback7(void) { vTimerFired(7u); }
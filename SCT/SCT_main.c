@@ -0,0 +1,210 @@
+/** @file SCT_main.c
+*   @brief Shifter controller (SCT) application
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   The link transport hands every received byte to vSCTReceive in the SCI interrupt. The byte that completes an event
+*   frame applies all of its records to an output image and the port is updated with one DCLR and one DSET store, so
+*   the actuators see the commands of one CPS control cycle together. The work per frame is bounded by
+*   CPS_FRAME_RECORDS_MAX records. Each event frame is then acknowledged with its SEQ; the CPS times the round trip.
+*
+*   The SCT does not rely on the CPS to end what it started. RTI compare0 ticks every SCT_TICK_MS: a shift output
+*   goes off CPS_FRAME_PULSE_MS after it was set, timed here alone so the pulse width does not depend on when the
+*   CPS paddle release reaches the line, and every output goes off when no intact frame has arrived for
+*   CPS_FRAME_TIMEOUT_MS (the CPS keepalive comes every CPS_FRAME_KEEPALIVE_MS). A frame that shows a SEQ gap drops
+*   every output before its own records are applied, the lost frame may have been the horn off. Horn off, a SEQ gap
+*   and the timeout are the only things that cut a shift pulse short. Both interrupts are IRQs and do not nest, so
+*   the output image needs no locking.
+*
+*   The actuator outputs use GIOA pins HALCoGen already configures as outputs.
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+/* Include Files */
+#include "SCT_main.h"
+#include "CPS_sci.h"
+#include "sys_core.h"
+#include "sys_pmu.h"
+
+/* Defines */
+#define IO_PORT gioPORTA //Actuator drivers, active high
+#define IO_HORN (1u << 4u)
+#define IO_SHIFTUP (1u << 6u)
+#define IO_SHIFTDOWN (1u << 7u)
+#define IO_ALL (IO_HORN | IO_SHIFTUP | IO_SHIFTDOWN)
+#define IO_SHIFT (IO_SHIFTUP | IO_SHIFTDOWN)
+
+#define SCT_TICK_MS 1u //RTI compare0 period
+#define SCT_TICK_COUNTS (SCT_TICK_MS*10000u) //RTI FRC0 runs at 10MHz from the shared HALCoGen set up
+#define SCT_PULSE_TICKS ((CPS_FRAME_PULSE_MS/SCT_TICK_MS) + 1u) //The first tick comes early, never cut the pulse short
+#define SCT_TIMEOUT_TICKS (CPS_FRAME_TIMEOUT_MS/SCT_TICK_MS)
+
+/* Global Vars */
+xSCTStats_t SCT_xStats;
+xCPSFrameParser_t SCT_xLinkParser;
+
+/* Internal Vars */
+static uint32_t u32Outputs; //Image of the actuator pins, SCI and RTI interrupts only
+static uint32_t u32PulseTicks; //Ticks left of the shift pulse, 0: none running
+static uint32_t u32SilentTicks; //Ticks since the last intact frame
+static uint32_t u32SeqGaps; //SCT_xLinkParser.u32SeqGaps already acted on
+static uint8_t au8Ack[CPS_FRAME_MAX];
+
+/* Local Function Prototypes */
+static void vInitSCT(void);
+static void vSCTReceive(uint8_t u8Byte);
+static void vSCTDispatch(const uint8_t *pu8Payload, uint32_t u32Length);
+static void vSCTWrite(uint32_t u32Image);
+
+/* Global Functions */
+void SCT_vMain(void)
+{
+  vInitSCT();
+  for(;;)
+  {
+    _gotoCPUIdle_(); //Everything happens in the SCI and RTI interrupts
+  }
+}
+
+/* void SCT_vISRRTICompare0(void)
+*   Tick, every SCT_TICK_MS. Ends the shift pulse after SCT_PULSE_TICKS and drops every output on link silence.
+*
+*/
+void SCT_vISRRTICompare0(void)
+{
+  if(u32PulseTicks != 0u)
+  {
+    u32PulseTicks--;
+    if((u32PulseTicks == 0u) && ((u32Outputs & IO_SHIFT) != 0u))
+    {
+      SCT_xStats.u32PulseEnds++;
+      vSCTWrite(u32Outputs & ~IO_SHIFT);
+    }
+  }
+  if(u32SilentTicks < SCT_TIMEOUT_TICKS)
+  {
+    u32SilentTicks++;
+    if((u32SilentTicks == SCT_TIMEOUT_TICKS) && (u32Outputs != 0u))
+    {
+      SCT_xStats.u32Timeouts++;
+      vSCTWrite(0u);
+    }
+  }
+}
+
+/* Local Functions */
+static void vInitSCT(void)
+{
+  gioInit();
+  IO_PORT->DCLR = IO_ALL;
+  u32Outputs = 0u;
+  _pmuInit_();
+  _pmuEnableCountersGlobal_();
+  _pmuResetCycleCounter_();
+  _pmuStartCounters_(pmuCYCLE_COUNTER);
+  CPS_vFrameParserReset(&SCT_xLinkParser);
+  u32PulseTicks = 0u;
+  u32SilentTicks = 0u;
+  u32SeqGaps = 0u;
+  rtiInit();
+  rtiREG1->CMP[0u].COMPx = SCT_TICK_COUNTS;
+  rtiREG1->CMP[0u].UDCPx = SCT_TICK_COUNTS;
+  rtiEnableNotification(rtiNOTIFICATION_COMPARE0);
+  rtiStartCounter(rtiCOUNTER_BLOCK0);
+  sciInit();
+  sciSetBaudrate(CPS_SCI_PORT, CPS_SCI_BAUD); //The CPS sets the same rate
+  CPS_vSciInit(vSCTReceive);
+  _enable_interrupt_();
+}
+
+/* void vSCTReceive(uint8_t u8Byte)
+*   Transport receive hook, SCI interrupt. Parses the byte and acts on the frame it completes. Any intact frame
+*   restarts the silence count.
+*
+*/
+static void vSCTReceive(uint8_t u8Byte)
+{
+  uint32_t u32StartCycles = _pmuGetCycleCount_();
+  uint32_t u32Cycles;
+  uint32_t u32Length;
+  if(!CPS_bFrameParse(&SCT_xLinkParser, u8Byte))
+  {
+    return;
+  }
+  u32SilentTicks = 0u;
+  if(SCT_xLinkParser.u8Type != (uint8_t)eFRAME_Events)
+  {
+    return;
+  }
+  vSCTDispatch(SCT_xLinkParser.au8Payload, SCT_xLinkParser.u8Length);
+  u32Cycles = _pmuGetCycleCount_() - u32StartCycles;
+  SCT_xStats.u32Frames++;
+  SCT_xStats.u32LastDispatchCycles = u32Cycles;
+  if(u32Cycles > SCT_xStats.u32MaxDispatchCycles)
+  {
+    SCT_xStats.u32MaxDispatchCycles = u32Cycles;
+  }
+  u32Length = CPS_u32FrameEncode(au8Ack, CPS_u8FrameSeq(), eFRAME_Ack, &SCT_xLinkParser.u8Seq, 1u);
+  if(!CPS_bSciWrite(au8Ack, u32Length))
+  {
+    SCT_xStats.u32AckDropped++;
+  }
+}
+
+/* void vSCTDispatch(const uint8_t *pu8Payload, uint32_t u32Length)
+*   Applies the records of an event frame in order and writes the pins that changed. Same meaning as the CPS output
+*   requests: horn off also releases the paddles. A shift starts the pulse timer, which alone ends it, so a paddle
+*   release changes nothing. After a SEQ gap the records are applied to an image with every output off.
+*
+*/
+static void vSCTDispatch(const uint8_t *pu8Payload, uint32_t u32Length)
+{
+  uint32_t u32Image = u32Outputs;
+  uint32_t u32Offset;
+  if(SCT_xLinkParser.u32SeqGaps != u32SeqGaps)
+  {
+    u32SeqGaps = SCT_xLinkParser.u32SeqGaps;
+    u32Image = 0u;
+    SCT_xStats.u32GapDrops += (u32Outputs != 0u) ? 1u : 0u;
+  }
+  for(u32Offset = CPS_FRAME_STAMP_BYTES; (u32Offset + CPS_FRAME_RECORD_BYTES) <= u32Length;
+      u32Offset += CPS_FRAME_RECORD_BYTES)
+  {
+    switch(pu8Payload[u32Offset])
+    {
+    case eLINK_ShiftUp:
+      u32Image |= IO_SHIFTUP;
+      u32PulseTicks = SCT_PULSE_TICKS;
+      break;
+    case eLINK_ShiftDown:
+      u32Image |= IO_SHIFTDOWN;
+      u32PulseTicks = SCT_PULSE_TICKS;
+      break;
+    case eLINK_HornOn:
+      u32Image |= IO_HORN;
+      break;
+    case eLINK_HornOff:
+      u32Image &= ~IO_ALL;
+      break;
+    case eLINK_PaddleRelease: //The pulse timer ends the shift
+      break;
+    default:
+      SCT_xStats.u32Unknown++;
+      continue;
+    }
+    SCT_xStats.u32Commands++;
+  }
+  vSCTWrite(u32Image);
+}
+
+/* void vSCTWrite(uint32_t u32Image)
+*   Writes the pins that differ from the image, one DCLR and one DSET store.
+*
+*/
+static void vSCTWrite(uint32_t u32Image)
+{
+  IO_PORT->DCLR = u32Outputs & ~u32Image;
+  IO_PORT->DSET = u32Image & ~u32Outputs;
+  u32Outputs = u32Image;
+}
@@ -0,0 +1,47 @@
+/** @file SCT_main.h
+*   @brief Shifter controller (SCT) application
+*   @date 16 OCT 2026
+*   @version 0.01
+*
+*   This header contains the main interface for the SCT processor. The SCT receives the event frames of the CPS over
+*   the SCI link and drives the horn and shift actuators from them. Commands are acted on inside the SCI receive
+*   interrupt, as soon as the last byte of a frame has passed the CRC check; the main loop only sleeps. An RTI tick
+*   ends shift pulses and drops the outputs when the link goes quiet.
+*
+*/
+
+/* (c) Jonathan Thomson, Vancouver, BC */
+
+#ifndef __SCT_MAIN_H__
+#define __SCT_MAIN_H__
+
+/* Include Files */
+#include "CPS_common.h"
+#include "CPS_frame.h"
+
+/* Defines */
+
+/* Global Types */
+typedef struct
+{
+  uint32_t u32Frames; //Event frames received intact
+  uint32_t u32Commands; //Records acted on
+  uint32_t u32Unknown; //Records with an unknown type, skipped
+  uint32_t u32AckDropped; //Acknowledgements the transmit ring had no room for
+  uint32_t u32PulseEnds; //Shift pulses ended by the pulse timer
+  uint32_t u32GapDrops; //Outputs dropped on a SEQ gap
+  uint32_t u32Timeouts; //Outputs dropped on CPS_FRAME_TIMEOUT_MS of link silence
+  uint32_t u32LastDispatchCycles; //PMU cycles from the last frame byte to the pins being written
+  uint32_t u32MaxDispatchCycles;
+} xSCTStats_t;
+
+/* Global Vars */
+extern xSCTStats_t SCT_xStats;
+extern xCPSFrameParser_t SCT_xLinkParser; //Receive error and SEQ gap counts
+
+/* Global Function Prototypes */
+
+void SCT_vMain(void);
+void SCT_vISRRTICompare0(void);
+
+#endif